@@ -515,6 +515,13 @@ void	CombatManager::Post_Load_Level( void )
 	//	Generate the unit coordination zones
 	//
 	UnitCoordinationZoneMgr::Build_Zones ();
+
+	//
+	//	Memory snapshot for comparing level rotations (only if a snapshot file is set)
+	//
+	StringClass label;
+	label.Format ("Post_Load_Level %s", (const char *)_load_map_name);
+	WWMemoryLogClass::Snapshot (label);
 	return ;
 }
 
@@ -615,6 +622,13 @@ void	CombatManager::Unload_Level( void )
 	//
 	AnimatedSoundMgrClass::Shutdown();
 	WWLOG_INTERMEDIATE("AnimatedSoundMgrClass::Shutdown");
+
+	//
+	//	Whatever the level leaves behind shows up in the diff between these snapshots
+	//
+	StringClass label;
+	label.Format ("Unload_Level %s", (const char *)_load_map_name);
+	WWMemoryLogClass::Snapshot (label);
 	return ;
 }
 
@@ -53,6 +53,8 @@
 #include "vehicle.h"
 #include "persistentgameobjobserver.h"
 #include "weapons.h"
+#include "simlod.h"
+#include "scripttimer.h"
 #include <algorithm>
 
 /*
@@ -277,6 +279,8 @@ int _HibernatingSoldiers = 0;
 */
 int	GameObjManager::Think()
 {
+	SimLODManager::Begin_Frame();
+
 	// Allow each object in the master list to think
 	SLNode<BaseGameObj> *objnode;
 	for (	objnode = GameObjList.Head(); objnode; objnode = objnode->Next()) {
@@ -296,8 +300,10 @@ int	GameObjManager::Think()
 			continue;
 		}
 
-		if ( !objnode->Data()->Is_Hibernating() ) {
+		// Distant objects may sit some frames out (see simlod.h)
+		if ( !objnode->Data()->Is_Hibernating() && SimLODManager::Begin_Think( objnode->Data() ) ) {
 			objnode->Data()->Think();
+			SimLODManager::End_Think( objnode->Data() );
 		}
 
 		if ( objnode->Data()->As_SmartGameObj() ) {
@@ -314,23 +320,39 @@ int	GameObjManager::Think()
 	return 0;
 }
 
+/*
+** Script timers only count down while their object post_thinks
+*/
+static void Pause_Script_Timers( BaseGameObj * obj )
+{
+	if ( obj->As_ScriptableGameObj() != NULL ) {
+		ScriptTimerManager::Pause( obj->As_ScriptableGameObj(), TimeManager::Get_Frame_Seconds() );
+	}
+}
+
 /*
 **	GameObjectManager::PostThink()
 ** This static routine allows each GameObject to think after the rest
 */
 int	GameObjManager::Post_Think()
 {
+	// Find the script timers that are due, they fire as their objects post_think
+	ScriptTimerManager::Advance( TimeManager::Get_Frame_Seconds() );
+
 	// Allow each object in the master list to think
 	SLNode<BaseGameObj> *objnode;
 	for (	objnode = GameObjList.Head(); objnode; objnode = objnode->Next()) {
 
 		// Don't post_think when cinematic frozen
 		if ( Is_Cinematic_Freeze_Active() && objnode->Data()->Is_Cinematic_Freeze_Enabled() ) {
+			Pause_Script_Timers( objnode->Data() );
 			continue;
 		}
 
 		if ( !objnode->Data()->Is_Hibernating() && objnode->Data()->Is_Post_Think_Allowed() ) {
 			objnode->Data()->Post_Think();
+		} else {
+			Pause_Script_Timers( objnode->Data() );
 		}
 	}
 
@@ -267,6 +267,9 @@ PhysicalGameObj::PhysicalGameObj( void ) :
 	//TintColor(1, 1, 1),
 	HibernationTimer( 0 ),		// Start alseep
 	HibernationEnable( true ),
+	SimLODTier( 0 ),
+	SimLODSkippedSeconds( 0 ),
+	SimLODSkippedTicks( 0 ),
 	HostGameObjBone( 0 ),
 	RadarBlipShapeType( 0 ),
 	RadarBlipColorType( 0 ),
@@ -205,6 +205,9 @@ public:
 	virtual	void	Begin_Hibernation( void );
 	virtual	void	End_Hibernation( void );
 
+	// Simulation LOD (see SimLODManager)
+	int				Get_Sim_LOD_Tier( void ) const					{ return SimLODTier; }
+
 	// Radar Blips
 	int				Get_Radar_Blip_Shape_Type( void )				{ return RadarBlipShapeType; }
 	void				Set_Radar_Blip_Shape_Type( int type )			{ RadarBlipShapeType = type; }
@@ -268,6 +271,12 @@ private:
 	float						HibernationTimer;
 	bool						HibernationEnable;
 
+	// Simulation LOD: current tier and the frame time saved up while not thinking
+	int						SimLODTier;
+	float						SimLODSkippedSeconds;
+	int						SimLODSkippedTicks;
+	friend class SimLODManager;
+
 	GameObjReference		HostGameObj;
 	int						HostGameObjBone;
 
@@ -810,56 +810,37 @@ PilotClass::Determine_Preferred_Height (void)
 	Vector3 curr_pos4 = curr_pos + Vector3 (bounding_box.Extent.X, -bounding_box.Extent.Y, 0);
 	Vector3 curr_pos5 = curr_pos + Vector3 (-bounding_box.Extent.X, bounding_box.Extent.Y, 0);
 
-	Vector3 future_pos1 = curr_pos1 + (vel_vector_world * 1.25F);
-	Vector3 future_pos2 = curr_pos2 + (vel_vector_world * 1.25F);
-	Vector3 future_pos3 = curr_pos3 + (vel_vector_world * 1.25F);
-	Vector3 future_pos4 = curr_pos4 + (vel_vector_world * 1.25F);
-	Vector3 future_pos5 = curr_pos5 + (vel_vector_world * 1.25F);
-
-	Vector3 future_pos6 = curr_pos1 + (vel_vector_world * 2.25F);
-	Vector3 future_pos7 = curr_pos2 + (vel_vector_world * 2.25F);
-	Vector3 future_pos8 = curr_pos3 + (vel_vector_world * 2.25F);
-	Vector3 future_pos9 = curr_pos4 + (vel_vector_world * 2.25F);
-	Vector3 future_pos10 = curr_pos5 + (vel_vector_world * 2.25F);
-
-	future_pos1.Z = curr_pos.Z;
-	future_pos2.Z = curr_pos.Z;
-	future_pos3.Z = curr_pos.Z;
-	future_pos4.Z = curr_pos.Z;
-	future_pos5.Z = curr_pos.Z;
-	future_pos6.Z = curr_pos.Z;
-	future_pos7.Z = curr_pos.Z;
-	future_pos8.Z = curr_pos.Z;
-	future_pos9.Z = curr_pos.Z;
-	future_pos10.Z = curr_pos.Z;
+	Vector3 future_pos[10];
+	future_pos[0] = curr_pos1 + (vel_vector_world * 1.25F);
+	future_pos[1] = curr_pos2 + (vel_vector_world * 1.25F);
+	future_pos[2] = curr_pos3 + (vel_vector_world * 1.25F);
+	future_pos[3] = curr_pos4 + (vel_vector_world * 1.25F);
+	future_pos[4] = curr_pos5 + (vel_vector_world * 1.25F);
+
+	future_pos[5] = curr_pos1 + (vel_vector_world * 2.25F);
+	future_pos[6] = curr_pos2 + (vel_vector_world * 2.25F);
+	future_pos[7] = curr_pos3 + (vel_vector_world * 2.25F);
+	future_pos[8] = curr_pos4 + (vel_vector_world * 2.25F);
+	future_pos[9] = curr_pos5 + (vel_vector_world * 2.25F);
+
+	for (int index = 0; index < 10; index ++) {
+		future_pos[index].Z = curr_pos.Z;
+	}
 
 
 	//
 	//	Now, lookup the preferred height for these future positions
 	//
-	float height1 = HeightDBClass::Get_Height (future_pos1);
-	float height2 = HeightDBClass::Get_Height (future_pos2);
-	float height3 = HeightDBClass::Get_Height (future_pos3);
-	float height4 = HeightDBClass::Get_Height (future_pos4);
-	float height5 = HeightDBClass::Get_Height (future_pos5);
-	float height6 = HeightDBClass::Get_Height (future_pos6);
-	float height7 = HeightDBClass::Get_Height (future_pos7);
-	float height8 = HeightDBClass::Get_Height (future_pos8);
-	float height9 = HeightDBClass::Get_Height (future_pos9);
-	float height10 = HeightDBClass::Get_Height (future_pos10);
+	float heights[10];
+	HeightDBClass::Get_Heights (future_pos, heights, 10);
 
 	//
 	//	Return the largest height to the caller
 	//
-	height	= std::max (height1, height2);
-	height	= std::max (height, height3);
-	height	= std::max (height, height4);
-	height	= std::max (height, height5);
-	height	= std::max (height, height6);
-	height	= std::max (height, height7);
-	height	= std::max (height, height8);
-	height	= std::max (height, height9);
-	height	= std::max (height, height10);
+	height = heights[0];
+	for (int index = 1; index < 10; index ++) {
+		height = std::max (height, heights[index]);
+	}
 	return height;
 }
 
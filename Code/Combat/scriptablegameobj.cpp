@@ -59,6 +59,8 @@
 #include "pscene.h"
 #include "SoundSceneObj.h"
 #include "wwprofile.h"
+#include "scripttimer.h"
+#include "mempool.h"
 
 /*
 ** ScriptableGameObjDef - Defintion class for a ScriptableGameObj
@@ -142,22 +144,29 @@ bool	ScriptableGameObjDef::Load( ChunkLoadClass &cload )
 /*
 ** Game Object Observer Timer (used in Scripts)
 */
-class	GameObjObserverTimerClass {
+enum	{
+	TIMER_KIND_OBSERVER,
+	TIMER_KIND_CUSTOM,
+};
+
+class	GameObjObserverTimerClass : public ScriptTimerClass, public AutoPoolClass<GameObjObserverTimerClass,256> {
 public:
-	GameObjObserverTimerClass( int observer_id = 0, float time = 0, int timer_id = 0 )
+	GameObjObserverTimerClass( int observer_id = 0, float time = 0, int timer_id = 0 ) :
+		ScriptTimerClass( TIMER_KIND_OBSERVER )
 		{	ObserverID = observer_id;  RemainingTime = time; TimerID = timer_id; }
 
 	bool	Save( ChunkSaveClass & csave );
 	bool	Load( ChunkLoadClass & cload );
 
-	bool	Update( void )		{ RemainingTime -= TimeManager::Get_Frame_Seconds(); return RemainingTime <= 0; }
-	bool	Expired( void )	{ return RemainingTime <= 0; }
+	virtual void	Fire( ScriptableGameObj * owner ) override;
 
 	int					ObserverID;
-	float					RemainingTime;
+	float					RemainingTime;		// only used to start and save the timer
 	int					TimerID;
 };
 
+DEFINE_AUTO_POOL(GameObjObserverTimerClass,256);
+
 enum	{
 	CHUNKID_TIMER_VARIABLES				=	922991755,
 	CHUNKID_TIMER_SENDER,
@@ -171,6 +180,8 @@ enum	{
 
 bool	GameObjObserverTimerClass::Save( ChunkSaveClass & csave )
 {
+	RemainingTime = Get_Remaining_Time();
+
 	csave.Begin_Chunk( CHUNKID_TIMER_VARIABLES );
 		WRITE_MICRO_CHUNK( csave, MICROCHUNKID_REMAINING_TIME, RemainingTime );
 		WRITE_MICRO_CHUNK( csave, MICROCHUNKID_TIMER_ID, TimerID );
@@ -202,29 +213,59 @@ bool	GameObjObserverTimerClass::Load( ChunkLoadClass & cload )
 }
 
 
+void	GameObjObserverTimerClass::Fire( ScriptableGameObj * owner )
+{
+//	Debug_Say(( "Timer Expired for %d\n", ObserverID ));
+
+	bool found = false;
+
+	WWASSERT( ObserverID != 0 );
+	const GameObjObserverList & observer_list = owner->Get_Observers();
+	for( int index = 0; index < observer_list.Count(); index++ ) {
+		if ( observer_list[ index ]->Get_ID() == ObserverID ) {
+			observer_list[ index ]->Timer_Expired( owner, TimerID );
+			found = true;
+		}
+	}
+
+	if ( !found ) {
+		Debug_Say(( "Failed to find observer id %d for timer expired....\n", ObserverID ));
+
+		const GameObjObserverList & observer_list = owner->Get_Observers();
+		for( int index = 0; index < observer_list.Count(); index++ ) {
+			Debug_Say(( "have %d\n", observer_list[ index ]->Get_ID() ));
+		}
+	}
+}
+
+
 /*
 ** Game Object Custom Timer (used in Scripts)
 */
-class	GameObjCustomTimerClass {
+class	GameObjCustomTimerClass : public ScriptTimerClass, public AutoPoolClass<GameObjCustomTimerClass,256> {
 public:
 
 	GameObjCustomTimerClass( ScriptableGameObj *sender = NULL, float time = 0, int type = 0, int param = 0 ) :
+		ScriptTimerClass( TIMER_KIND_CUSTOM ),
 		RemainingTime( time ), Type( type ), Param( param)		{ if ( sender != NULL ) Sender = sender; }
 
 	bool	Save( ChunkSaveClass & csave );
 	bool	Load( ChunkLoadClass & cload );
 
-	bool	Update( void )		{ RemainingTime -= TimeManager::Get_Frame_Seconds(); return RemainingTime <= 0; }
-	bool	Expired( void )	{ return RemainingTime <= 0; }
+	virtual void	Fire( ScriptableGameObj * owner ) override;
 
-	float					RemainingTime;
+	float					RemainingTime;		// only used to start and save the timer
 	GameObjReference	Sender;
 	int					Type;
 	int					Param;
 };
 
+DEFINE_AUTO_POOL(GameObjCustomTimerClass,256);
+
 bool	GameObjCustomTimerClass::Save( ChunkSaveClass & csave )
 {
+	RemainingTime = Get_Remaining_Time();
+
 	csave.Begin_Chunk( CHUNKID_TIMER_VARIABLES );
 		WRITE_MICRO_CHUNK( csave, MICROCHUNKID_REMAINING_TIME, RemainingTime );
 		WRITE_MICRO_CHUNK( csave, MICROCHUNKID_TYPE, Type );
@@ -275,13 +316,26 @@ bool	GameObjCustomTimerClass::Load( ChunkLoadClass & cload )
 	return true;
 }
 
+void	GameObjCustomTimerClass::Fire( ScriptableGameObj * owner )
+{
+	ScriptableGameObj *sender = Sender;
+
+	const GameObjObserverList & observer_list = owner->Get_Observers();
+	for( int index = 0; index < observer_list.Count(); index++ ) {
+		observer_list[ index ]->Custom( owner, Type, Param, sender );
+	}
+}
+
 
 /*
 ** ScriptableGameObj
 */
 ScriptableGameObj::ScriptableGameObj( void ) :
 	ReferenceableGameObj( this ),
-	ObserverCreatedPending( false )
+	ObserverCreatedPending( false ),
+	TimerList( NULL ),
+	DueTimerList( NULL ),
+	TimerPausedTime( 0 )
 {
 }
 
@@ -290,20 +344,9 @@ ScriptableGameObj::~ScriptableGameObj( void )
 	Remove_All_Observers();
 
 	/*
-	** Delete the ObserverTimerList. ST - 6/11/2001 9:20PM
+	** Delete the timers. ST - 6/11/2001 9:20PM
 	*/
-	while (ObserverTimerList.Count()) {
-		delete ObserverTimerList[0];
-		ObserverTimerList.Delete(0);
-	}
-
-	/*
-	** Delete the CustomTimerList. ST - 6/11/2001 9:20PM
-	*/
-	while (CustomTimerList.Count()) {
-		delete CustomTimerList[0];
-		CustomTimerList.Delete(0);
-	}
+	ScriptTimerManager::Remove_All( this );
 }
 
 
@@ -444,17 +487,18 @@ bool	ScriptableGameObj::Save( ChunkSaveClass & csave )
 		WRITE_MICRO_CHUNK( csave, MICROCHUNKID_OBSERVER_CREATED_PENDING, ObserverCreatedPending );
 	csave.End_Chunk();
 
-	int i;
-	for ( i = 0; i < ObserverTimerList.Count(); i++ ) {
-		csave.Begin_Chunk( CHUNKID_OBSERVER_TIMER );
-			ObserverTimerList[i]->Save( csave );
-		csave.End_Chunk();
-	}
-
-	for ( i = 0; i < CustomTimerList.Count(); i++ ) {
-		csave.Begin_Chunk( CHUNKID_CUSTOM_TIMER );
-			CustomTimerList[i]->Save( csave );
-		csave.End_Chunk();
+	// Oldest first, so the timers are started in the same order when they are loaded
+	ScriptTimerClass * timer;
+	for ( timer = ScriptTimerManager::Get_First( this ); timer != NULL; timer = ScriptTimerManager::Get_Next( timer ) ) {
+		if ( timer->Get_Kind() == TIMER_KIND_OBSERVER ) {
+			csave.Begin_Chunk( CHUNKID_OBSERVER_TIMER );
+				((GameObjObserverTimerClass *)timer)->Save( csave );
+			csave.End_Chunk();
+		} else {
+			csave.Begin_Chunk( CHUNKID_CUSTOM_TIMER );
+				((GameObjCustomTimerClass *)timer)->Save( csave );
+			csave.End_Chunk();
+		}
 	}
 
 	return true;
@@ -502,14 +546,14 @@ bool	ScriptableGameObj::Load( ChunkLoadClass &cload )
 				GameObjObserverTimerClass * otimer;
 				otimer = new GameObjObserverTimerClass();
 				otimer->Load( cload );
-				ObserverTimerList.Add( otimer );
+				ScriptTimerManager::Start( this, otimer, otimer->RemainingTime );
 				break;
 
 			case CHUNKID_CUSTOM_TIMER:
 				GameObjCustomTimerClass * ctimer;
 				ctimer = new GameObjCustomTimerClass();
 				ctimer->Load( cload );
-				CustomTimerList.Add( ctimer );
+				ScriptTimerManager::Start( this, ctimer, ctimer->RemainingTime );
 				break;
 
 			default:
@@ -601,12 +645,12 @@ void ScriptableGameObj::Remove_All_Observers(void)
 
 void	ScriptableGameObj::Start_Observer_Timer( int observer_id, float duration, int timer_id )
 {
-	ObserverTimerList.Add( new GameObjObserverTimerClass( observer_id, duration, timer_id ) );
+	ScriptTimerManager::Start( this, new GameObjObserverTimerClass( observer_id, duration, timer_id ), duration );
 }
 
 void	ScriptableGameObj::Start_Custom_Timer( ScriptableGameObj * from, float delay, int type, int param )
 {
-	CustomTimerList.Add( new GameObjCustomTimerClass( from, delay, type, param ) );
+	ScriptTimerManager::Start( this, new GameObjCustomTimerClass( from, delay, type, param ), delay );
 }
 
 void	ScriptableGameObj::Think( void )
@@ -634,51 +678,11 @@ void	ScriptableGameObj::Post_Think( void )
 	// This means that objects the script creates when it thinks (via timers) dont think
 	// (bump animation forward) until the next frame.  Be wary of changing this order.
 
-	// Check Timers
-	int i;
-	for ( i = ObserverTimerList.Count() - 1; i >= 0; i-- ) {
-		if ( ObserverTimerList[i]->Update() ) {
-
-//			Debug_Say(( "Timer Expired for %d\n", ObserverTimerList[i]->ObserverID ));
-
-			bool found = false;
-
-			WWASSERT( ObserverTimerList[i]->ObserverID != 0 );
-			const GameObjObserverList & observer_list = Get_Observers();
-			for( int index = 0; index < observer_list.Count(); index++ ) {
-				if ( observer_list[ index ]->Get_ID() == ObserverTimerList[i]->ObserverID ) {
-					observer_list[ index ]->Timer_Expired( this, ObserverTimerList[i]->TimerID );
-					found = true;
-				}
-			}
-
-			if ( !found ) {
-				Debug_Say(( "Failed to find observer id %d for timer expired....\n", ObserverTimerList[i]->ObserverID ));
-
-				const GameObjObserverList & observer_list = Get_Observers();
-				for( int index = 0; index < observer_list.Count(); index++ ) {
-					Debug_Say(( "have %d\n", observer_list[ index ]->Get_ID() ));
-				}
-			}
-
-			delete ObserverTimerList[i];
-			ObserverTimerList.Delete( i );
-		}
-	}
-
-	for ( i = CustomTimerList.Count() - 1; i >= 0; i-- ) {
-		if ( CustomTimerList[i]->Update() ) {
-
-			ScriptableGameObj *sender = CustomTimerList[i]->Sender;
-
-			const GameObjObserverList & observer_list = Get_Observers();
-			for( int index = 0; index < observer_list.Count(); index++ ) {
-				observer_list[ index ]->Custom( this, CustomTimerList[i]->Type, CustomTimerList[i]->Param, sender );
-			}
-
-			delete CustomTimerList[i];
-			CustomTimerList.Delete( i );
-		}
+	// Fire the timers the timer wheel found due this frame
+	ScriptTimerClass * timer;
+	while ( (timer = ScriptTimerManager::Pop_Due( this )) != NULL ) {
+		timer->Fire( this );
+		delete timer;
 	}
 }
 
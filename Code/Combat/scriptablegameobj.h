@@ -72,8 +72,7 @@
 
 typedef	SimpleDynVecClass<GameObjObserverClass *>		GameObjObserverList;
 
-class	GameObjObserverTimerClass;
-class	GameObjCustomTimerClass;
+class	ScriptTimerClass;
 class	DamageableGameObj;
 class	BuildingGameObj;
 class	SoldierGameObj;
@@ -167,8 +166,14 @@ public:
 protected:
 	bool															ObserverCreatedPending;
 	GameObjObserverList										Observers;
-	DynamicVectorClass<GameObjObserverTimerClass *>	ObserverTimerList;
-	DynamicVectorClass<GameObjCustomTimerClass *>	CustomTimerList;
+
+	// Timers are kept by ScriptTimerManager (see scripttimer.h)
+	ScriptTimerClass *										TimerList;
+	ScriptTimerClass *										DueTimerList;
+	double														TimerPausedTime;
+
+	friend	class												ScriptTimerClass;
+	friend	class												ScriptTimerManager;
 };
 
 
@@ -0,0 +1,300 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "scripttimer.h"
+#include "scriptablegameobj.h"
+#include "wwdebug.h"
+
+#include <math.h>
+
+
+double					ScriptTimerManager::Clock = 0.0;
+int64_t					ScriptTimerManager::CurrentTick = 0;
+unsigned					ScriptTimerManager::NextSerial = 0;
+ScriptTimerClass *	ScriptTimerManager::Slots[LEVEL_COUNT][SLOT_COUNT];
+ScriptTimerClass *	ScriptTimerManager::Overflow = NULL;
+ScriptTimerManager::StatsStruct	ScriptTimerManager::Stats;
+
+
+/*
+** ScriptTimerClass
+*/
+ScriptTimerClass::ScriptTimerClass( int kind ) :
+	Kind( kind ),
+	Serial( 0 ),
+	Expiry( 0 ),
+	PausedTime( 0 ),
+	Owner( NULL ),
+	List( NULL ),
+	Prev( NULL ),
+	Next( NULL ),
+	OwnerPrev( NULL ),
+	OwnerNext( NULL )
+{
+}
+
+ScriptTimerClass::~ScriptTimerClass( void )
+{
+	WWASSERT( List == NULL );
+}
+
+float	ScriptTimerClass::Get_Remaining_Time( void ) const
+{
+	WWASSERT( Owner != NULL );
+	return (float)( Expiry + ( Owner->TimerPausedTime - PausedTime ) - ScriptTimerManager::Get_Clock() );
+}
+
+
+/*
+** ScriptTimerManager
+*/
+int64_t	ScriptTimerManager::Time_To_Tick( double time )
+{
+	return (int64_t)floor( time * (double)WHEEL_TICKS_PER_SECOND );
+}
+
+void	ScriptTimerManager::Link( ScriptTimerClass ** list, ScriptTimerClass * timer )
+{
+	WWASSERT( timer->List == NULL );
+	timer->List = list;
+	timer->Prev = NULL;
+	timer->Next = *list;
+	if ( *list != NULL ) {
+		(*list)->Prev = timer;
+	}
+	*list = timer;
+}
+
+void	ScriptTimerManager::Unlink( ScriptTimerClass * timer )
+{
+	WWASSERT( timer->List != NULL );
+	if ( timer->Prev != NULL ) {
+		timer->Prev->Next = timer->Next;
+	} else {
+		*timer->List = timer->Next;
+	}
+	if ( timer->Next != NULL ) {
+		timer->Next->Prev = timer->Prev;
+	}
+	timer->List = NULL;
+	timer->Prev = NULL;
+	timer->Next = NULL;
+}
+
+/*
+** A timer goes in the lowest level whose range covers it, in the slot for its tick at that
+** level.  Timers for ticks that have already gone go in the current tick's slot, which is
+** looked at first thing next frame.
+*/
+void	ScriptTimerManager::Insert( ScriptTimerClass * timer )
+{
+	int64_t tick = MAX( Time_To_Tick( timer->Expiry ), CurrentTick );
+	int64_t delta = tick - CurrentTick;
+
+	for ( int level = 0; level < LEVEL_COUNT; level++ ) {
+		if ( delta < ((int64_t)1 << (SLOT_BITS * (level + 1))) ) {
+			Link( &Slots[level][(tick >> (SLOT_BITS * level)) & (SLOT_COUNT - 1)], timer );
+			return;
+		}
+	}
+	Link( &Overflow, timer );
+}
+
+/*
+** Re-inserts the timers in the current slot of a level, which moves them down to the levels
+** below.  The level above is cascaded first when this level wraps, so anything it drops into
+** the current slot gets moved down too.
+*/
+void	ScriptTimerManager::Cascade( int level )
+{
+	int index = (int)( (CurrentTick >> (SLOT_BITS * level)) & (SLOT_COUNT - 1) );
+	if ( index == 0 ) {
+		if ( level + 1 < LEVEL_COUNT ) {
+			Cascade( level + 1 );
+		} else {
+			ScriptTimerClass * list = Overflow;
+			Overflow = NULL;
+			while ( list != NULL ) {
+				ScriptTimerClass * timer = list;
+				list = timer->Next;
+				timer->List = NULL;
+				Insert( timer );
+			}
+		}
+	}
+
+	ScriptTimerClass * list = Slots[level][index];
+	Slots[level][index] = NULL;
+	while ( list != NULL ) {
+		ScriptTimerClass * timer = list;
+		list = timer->Next;
+		timer->List = NULL;
+		Insert( timer );
+		Stats.Cascaded++;
+	}
+}
+
+/*
+** Every timer in a slot the clock has gone past is due.  The slot the clock is in only has
+** the timers whose time has actually come taken out.
+*/
+void	ScriptTimerManager::Expire_Slot( ScriptTimerClass ** slot, bool all )
+{
+	ScriptTimerClass * timer = *slot;
+	while ( timer != NULL ) {
+		ScriptTimerClass * next = timer->Next;
+		if ( all || timer->Expiry <= Clock ) {
+			Unlink( timer );
+			Make_Due( timer );
+		}
+		timer = next;
+	}
+}
+
+/*
+** The due list is kept in firing order: by kind, then newest first, which is the order the
+** per-object timer lists used to fire in.
+*/
+void	ScriptTimerManager::Make_Due( ScriptTimerClass * timer )
+{
+	ScriptTimerClass ** list = &timer->Owner->DueTimerList;
+	ScriptTimerClass * prev = NULL;
+	ScriptTimerClass * next = *list;
+	while (	next != NULL &&
+				( next->Kind < timer->Kind || ( next->Kind == timer->Kind && next->Serial > timer->Serial ) ) ) {
+		prev = next;
+		next = next->Next;
+	}
+
+	if ( prev == NULL ) {
+		Link( list, timer );
+	} else {
+		timer->List = list;
+		timer->Prev = prev;
+		timer->Next = next;
+		prev->Next = timer;
+		if ( next != NULL ) {
+			next->Prev = timer;
+		}
+	}
+	Stats.Due++;
+}
+
+void	ScriptTimerManager::Start( ScriptableGameObj * owner, ScriptTimerClass * timer, float delay )
+{
+	WWASSERT( owner != NULL && timer != NULL && timer->Owner == NULL );
+
+	timer->Owner = owner;
+	timer->Serial = NextSerial++;
+	timer->Expiry = Clock + delay;
+	timer->PausedTime = owner->TimerPausedTime;
+
+	timer->OwnerPrev = NULL;
+	timer->OwnerNext = owner->TimerList;
+	if ( owner->TimerList != NULL ) {
+		owner->TimerList->OwnerPrev = timer;
+	}
+	owner->TimerList = timer;
+
+	Insert( timer );
+	Stats.Pending++;
+}
+
+void	ScriptTimerManager::Remove_All( ScriptableGameObj * owner )
+{
+	while ( owner->TimerList != NULL ) {
+		ScriptTimerClass * timer = owner->TimerList;
+		owner->TimerList = timer->OwnerNext;
+		Unlink( timer );
+		delete timer;
+		Stats.Pending--;
+	}
+	WWASSERT( owner->DueTimerList == NULL );
+}
+
+void	ScriptTimerManager::Advance( float seconds )
+{
+	Stats.Due = 0;
+	Stats.Rescheduled = 0;
+	Stats.Cascaded = 0;
+
+	Clock += seconds;
+	int64_t target = Time_To_Tick( Clock );
+	for (;;) {
+		Expire_Slot( &Slots[0][CurrentTick & (SLOT_COUNT - 1)], CurrentTick < target );
+		if ( CurrentTick >= target ) {
+			break;
+		}
+		CurrentTick++;
+		if ( (CurrentTick & (SLOT_COUNT - 1)) == 0 ) {
+			Cascade( 1 );
+		}
+	}
+}
+
+void	ScriptTimerManager::Pause( ScriptableGameObj * owner, float seconds )
+{
+	if ( owner->TimerList != NULL ) {
+		owner->TimerPausedTime += seconds;
+	}
+}
+
+/*
+** A due timer whose owner has been paused since it was scheduled hasn't had all its think
+** time yet, so it goes back in the wheel for the time the owner missed.
+*/
+ScriptTimerClass *	ScriptTimerManager::Pop_Due( ScriptableGameObj * owner )
+{
+	while ( owner->DueTimerList != NULL ) {
+		ScriptTimerClass * timer = owner->DueTimerList;
+		Unlink( timer );
+
+		if ( timer->PausedTime != owner->TimerPausedTime ) {
+			timer->Expiry += owner->TimerPausedTime - timer->PausedTime;
+			timer->PausedTime = owner->TimerPausedTime;
+			if ( timer->Expiry > Clock ) {
+				Insert( timer );
+				Stats.Rescheduled++;
+				continue;
+			}
+		}
+
+		if ( timer->OwnerPrev != NULL ) {
+			timer->OwnerPrev->OwnerNext = timer->OwnerNext;
+		} else {
+			owner->TimerList = timer->OwnerNext;
+		}
+		if ( timer->OwnerNext != NULL ) {
+			timer->OwnerNext->OwnerPrev = timer->OwnerPrev;
+		}
+		timer->OwnerPrev = NULL;
+		timer->OwnerNext = NULL;
+		Stats.Pending--;
+		return timer;
+	}
+	return NULL;
+}
+
+ScriptTimerClass *	ScriptTimerManager::Get_First( ScriptableGameObj * owner )
+{
+	ScriptTimerClass * timer = owner->TimerList;
+	while ( timer != NULL && timer->OwnerNext != NULL ) {
+		timer = timer->OwnerNext;
+	}
+	return timer;
+}
@@ -0,0 +1,155 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "always.h"
+
+#include <stdint.h>
+
+class ScriptableGameObj;
+
+
+/**
+** ScriptTimerClass
+** Base class for the observer and custom timers that scripts start on game objects.  The
+** timers live in ScriptTimerManager's wheel until they come due, then sit on their owner's
+** due list until the owner's Post_Think fires them.
+*/
+class ScriptTimerClass
+{
+public:
+
+	ScriptTimerClass( int kind );
+	virtual ~ScriptTimerClass( void );
+
+	/*
+	** Timers due on the same frame fire in order of Kind, then newest first
+	*/
+	int						Get_Kind( void ) const		{ return Kind; }
+
+	/*
+	** Seconds of its owner's think time left before the timer fires
+	*/
+	float						Get_Remaining_Time( void ) const;
+
+	virtual void			Fire( ScriptableGameObj * owner )		= 0;
+
+private:
+
+	int						Kind;
+	unsigned					Serial;
+	double					Expiry;				// wheel clock time the timer fires at
+	double					PausedTime;			// owner's paused time when Expiry was worked out
+	ScriptableGameObj *	Owner;
+
+	ScriptTimerClass **	List;					// wheel slot or due list the timer is in
+	ScriptTimerClass *	Prev;
+	ScriptTimerClass *	Next;
+	ScriptTimerClass *	OwnerPrev;			// every timer the owner has pending
+	ScriptTimerClass *	OwnerNext;
+
+	friend class ScriptTimerManager;
+};
+
+
+/**
+** ScriptTimerManager
+** Hierarchical timer wheel for the script timers.  The wheel turns once a frame by the frame
+** time and only visits the slots that time covers, so a frame costs the same however many
+** timers are waiting and nothing is done for a timer until it comes due.  Timers that come
+** due are moved to their owner's due list in one batch and fired from the owner's Post_Think
+** in the same order the old per-object lists fired them.
+**
+** A timer counts its owner's think time, not game time: frames where the owner doesn't
+** Post_Think (hibernating, frozen by a cinematic) add to the owner's paused time, and a due
+** timer whose owner was paused since it was scheduled is pushed back by that much instead
+** of firing.
+*/
+class ScriptTimerManager
+{
+public:
+
+	static constexpr int WHEEL_TICKS_PER_SECOND = 128;
+
+	enum
+	{
+		SLOT_BITS			= 6,
+		SLOT_COUNT			= 1 << SLOT_BITS,
+		LEVEL_COUNT			= 4,				// covers 64^4 ticks, about 36 hours
+	};
+
+	struct StatsStruct
+	{
+		int				Pending;					// timers waiting
+		int				Due;						// timers that came due last frame
+		int				Rescheduled;			// due timers pushed back because their owner was paused
+		int				Cascaded;				// timers moved down a level of the wheel last frame
+	};
+
+	/*
+	** Add a timer for the owner that fires after delay seconds of the owner's think time
+	*/
+	static void						Start( ScriptableGameObj * owner, ScriptTimerClass * timer, float delay );
+
+	/*
+	** Delete every timer the object has, due or not
+	*/
+	static void						Remove_All( ScriptableGameObj * owner );
+
+	/*
+	** Called once a frame by GameObjManager::Post_Think before the objects Post_Think
+	*/
+	static void						Advance( float seconds );
+
+	/*
+	** Called for objects that don't Post_Think this frame
+	*/
+	static void						Pause( ScriptableGameObj * owner, float seconds );
+
+	/*
+	** Next timer due on the object, NULL when there are none left.  The caller fires and
+	** deletes it.
+	*/
+	static ScriptTimerClass *	Pop_Due( ScriptableGameObj * owner );
+
+	/*
+	** Timers of the object in the order they were started, for saving
+	*/
+	static ScriptTimerClass *	Get_First( ScriptableGameObj * owner );
+	static ScriptTimerClass *	Get_Next( ScriptTimerClass * timer )		{ return timer->OwnerPrev; }
+
+	static double					Get_Clock( void )									{ return Clock; }
+	static const StatsStruct &	Get_Stats( void )									{ return Stats; }
+
+private:
+
+	static int64_t					Time_To_Tick( double time );
+	static void						Link( ScriptTimerClass ** list, ScriptTimerClass * timer );
+	static void						Unlink( ScriptTimerClass * timer );
+	static void						Insert( ScriptTimerClass * timer );
+	static void						Cascade( int level );
+	static void						Expire_Slot( ScriptTimerClass ** slot, bool all );
+	static void						Make_Due( ScriptTimerClass * timer );
+
+	static double					Clock;
+	static int64_t					CurrentTick;
+	static unsigned				NextSerial;
+	static ScriptTimerClass *	Slots[LEVEL_COUNT][SLOT_COUNT];
+	static ScriptTimerClass *	Overflow;
+	static StatsStruct			Stats;
+};
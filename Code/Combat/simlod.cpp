@@ -0,0 +1,200 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "simlod.h"
+#include "gameobjmanager.h"
+#include "movephys.h"
+#include "physicalgameobj.h"
+#include "smartgameobj.h"
+#include "soldier.h"
+#include "timemgr.h"
+#include "vehicle.h"
+#include "weapons.h"
+
+
+/*
+** Objects moving faster than this (meters per second) never drop below TIER_NEAR
+*/
+static const float SIM_LOD_MOVING_SPEED2 = 0.25f * 0.25f;
+
+bool									SimLODManager::Enabled = false;
+unsigned								SimLODManager::FrameCount = 0;
+float									SimLODManager::TierDistance[TIER_COUNT - 1] = { 40.0f, 80.0f, 150.0f };
+SimLODManager::TierStatsStruct	SimLODManager::Stats[TIER_COUNT];
+DynamicVectorClass<Vector3>		SimLODManager::PlayerPositions;
+bool									SimLODManager::FrameStretched = false;
+float									SimLODManager::SavedFrameSeconds = 0.0f;
+int									SimLODManager::SavedFrameTicks = 0;
+
+
+/*
+** Turning it off puts every object back to running every frame.  Any time they had saved
+** up is dropped; the physics objects catch theirs up on their next timestep.
+*/
+void	SimLODManager::Enable( bool onoff )
+{
+	if ( Enabled == onoff ) {
+		return;
+	}
+	Enabled = onoff;
+
+	SLNode<BaseGameObj> *objnode;
+	for ( objnode = GameObjManager::Get_Game_Obj_List()->Head(); objnode; objnode = objnode->Next() ) {
+		PhysicalGameObj * obj = objnode->Data()->As_PhysicalGameObj();
+		if ( obj != NULL ) {
+			Reset_Object( obj );
+		}
+	}
+	memset( Stats, 0, sizeof( Stats ) );
+}
+
+void	SimLODManager::Set_Tier_Distance( int tier, float distance )
+{
+	WWASSERT( tier >= 0 && tier < TIER_COUNT - 1 );
+	TierDistance[tier] = distance;
+}
+
+void	SimLODManager::Reset_Object( PhysicalGameObj * obj )
+{
+	obj->SimLODTier = TIER_FULL;
+	obj->SimLODSkippedSeconds = 0;
+	obj->SimLODSkippedTicks = 0;
+	if ( obj->Peek_Physical_Object() != NULL ) {
+		obj->Peek_Physical_Object()->Set_Simulation_Period( 1, 0 );
+	}
+}
+
+void	SimLODManager::Begin_Frame( void )
+{
+	if ( !Enabled ) {
+		return;
+	}
+
+	FrameCount++;
+	memset( Stats, 0, sizeof( Stats ) );
+
+	PlayerPositions.Delete_All();
+	SLNode<SoldierGameObj> *objnode;
+	for ( objnode = GameObjManager::Get_Star_Game_Obj_List()->Head(); objnode; objnode = objnode->Next() ) {
+		Vector3 pos;
+		objnode->Data()->Get_Position( &pos );
+		PlayerPositions.Add( pos );
+	}
+}
+
+/*
+** The tier is the distance tier of the nearest player, capped by what the object is doing.
+** With no players at all (a dedicated server between games) everything is dormant.
+*/
+int	SimLODManager::Compute_Tier( PhysicalGameObj * obj )
+{
+	SmartGameObj * smart = obj->As_SmartGameObj();
+	if ( smart != NULL ) {
+		if ( smart->Has_Player() ) {
+			return TIER_FULL;
+		}
+		if ( smart->Get_Weapon() != NULL && smart->Get_Weapon()->Is_Firing() ) {
+			return TIER_FULL;
+		}
+	}
+	if ( obj->As_VehicleGameObj() != NULL && obj->As_VehicleGameObj()->Get_Driver() != NULL ) {
+		return TIER_FULL;
+	}
+	if ( obj->Is_In_Conversation() ) {
+		return TIER_FULL;
+	}
+
+	Vector3 pos;
+	obj->Get_Position( &pos );
+	float nearest2 = FLT_MAX;
+	for ( int i = 0; i < PlayerPositions.Count(); i++ ) {
+		nearest2 = MIN( nearest2, ( PlayerPositions[i] - pos ).Length2() );
+	}
+
+	int tier = TIER_FULL;
+	while ( tier < TIER_COUNT - 1 && nearest2 > TierDistance[tier] * TierDistance[tier] ) {
+		tier++;
+	}
+
+	PhysClass * phys_obj = obj->Peek_Physical_Object();
+	MoveablePhysClass * move_obj = phys_obj->As_MoveablePhysClass();
+	if ( move_obj != NULL && !move_obj->Is_Asleep() ) {
+		Vector3 vel;
+		move_obj->Get_Velocity( &vel );
+		tier = MIN( tier, ( vel.Length2() > SIM_LOD_MOVING_SPEED2 ) ? (int)TIER_NEAR : (int)TIER_FAR );
+	}
+	return tier;
+}
+
+/*
+** An object runs when the frame count plus its ID is a multiple of its tier's period, so
+** the objects in a tier are spread evenly over the frames.  When it runs the frame time is
+** stretched to cover the frames it skipped.
+*/
+bool	SimLODManager::Begin_Think( BaseGameObj * base_obj )
+{
+	if ( !Enabled ) {
+		return true;
+	}
+	PhysicalGameObj * obj = base_obj->As_PhysicalGameObj();
+	if ( obj == NULL || obj->Peek_Physical_Object() == NULL ) {
+		return true;
+	}
+
+	int tier = Compute_Tier( obj );
+	Stats[tier].Objects++;
+
+	int period = Get_Tier_Period( tier );
+	bool due = (tier < obj->SimLODTier) || ((FrameCount + (unsigned)obj->Get_ID()) % period == 0);
+	if ( !due ) {
+		obj->SimLODSkippedSeconds += TimeManager::Get_Frame_Seconds();
+		obj->SimLODSkippedTicks += TimeManager::Get_Frame_Ticks();
+		Stats[tier].ThinksSkipped++;
+		return false;
+	}
+
+	if ( tier != obj->SimLODTier ) {
+		obj->SimLODTier = tier;
+		obj->Peek_Physical_Object()->Set_Simulation_Period( period, obj->Get_ID() );
+	}
+	Stats[tier].Thinks++;
+
+	if ( obj->SimLODSkippedTicks > 0 ) {
+		SavedFrameSeconds = TimeManager::FrameSeconds;
+		SavedFrameTicks = TimeManager::FrameTicks;
+		TimeManager::FrameSeconds += obj->SimLODSkippedSeconds;
+		TimeManager::FrameTicks += obj->SimLODSkippedTicks;
+		FrameStretched = true;
+	}
+	return true;
+}
+
+void	SimLODManager::End_Think( BaseGameObj * base_obj )
+{
+	if ( FrameStretched ) {
+		TimeManager::FrameSeconds = SavedFrameSeconds;
+		TimeManager::FrameTicks = SavedFrameTicks;
+		FrameStretched = false;
+	}
+
+	PhysicalGameObj * obj = base_obj->As_PhysicalGameObj();
+	if ( obj != NULL ) {
+		obj->SimLODSkippedSeconds = 0;
+		obj->SimLODSkippedTicks = 0;
+	}
+}
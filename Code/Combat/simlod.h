@@ -0,0 +1,101 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "always.h"
+#include "vector.h"
+#include "vector3.h"
+
+class BaseGameObj;
+class PhysicalGameObj;
+
+
+/**
+** SimLODManager
+** Simulation level of detail.  Every physical game object is given a tier from how far it
+** is from the nearest player and what it is doing.  Objects in the lower tiers only think
+** and timestep once every few frames, with the frame time they missed saved up and handed
+** to them the next time they run, so a turret sitting far from anyone still turns at the
+** right speed, just in bigger steps.
+**
+** Which frame an object runs on only depends on the frame count, its ID and its tier, and
+** the tier only depends on the game state, so the schedule is the same every time the same
+** game is played.  An object that moves up a tier runs straight away rather than waiting
+** for its next turn.
+**
+** Players, anything a player controls, objects that are firing or talking and objects near
+** a player always run every frame.  The manager is off by default.
+*/
+class SimLODManager
+{
+public:
+
+	enum TierType
+	{
+		TIER_FULL = 0,			// every frame
+		TIER_NEAR,				// every second frame
+		TIER_FAR,				// every fourth frame
+		TIER_DORMANT,			// every eighth frame
+		TIER_COUNT,
+	};
+
+	struct TierStatsStruct
+	{
+		int				Objects;				// objects in this tier last frame
+		int				Thinks;				// objects that thought
+		int				ThinksSkipped;		// objects that sat the frame out
+	};
+
+	static void						Enable( bool onoff );
+	static bool						Is_Enabled( void )						{ return Enabled; }
+
+	/*
+	** Objects further than a tier's distance from every player drop to the next tier
+	*/
+	static void						Set_Tier_Distance( int tier, float distance );
+	static float					Get_Tier_Distance( int tier )			{ return TierDistance[tier]; }
+	static int						Get_Tier_Period( int tier )			{ return 1 << tier; }
+
+	/*
+	** Called by GameObjManager::Think.  Begin_Think returns false if the object should sit
+	** this frame out; if it returns true, End_Think has to be called after the object thinks.
+	*/
+	static void						Begin_Frame( void );
+	static bool						Begin_Think( BaseGameObj * obj );
+	static void						End_Think( BaseGameObj * obj );
+
+	static const TierStatsStruct &	Get_Tier_Stats( int tier )		{ return Stats[tier]; }
+
+private:
+
+	static int						Compute_Tier( PhysicalGameObj * obj );
+	static void						Reset_Object( PhysicalGameObj * obj );
+
+	static bool						Enabled;
+	static unsigned				FrameCount;
+	static float					TierDistance[TIER_COUNT - 1];
+	static TierStatsStruct		Stats[TIER_COUNT];
+	static DynamicVectorClass<Vector3>	PlayerPositions;
+
+	/*
+	** Frame time while an object that is catching up thinks
+	*/
+	static bool						FrameStretched;
+	static float					SavedFrameSeconds;
+	static int						SavedFrameTicks;
+};
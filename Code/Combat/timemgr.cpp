@@ -46,6 +46,8 @@
 #include "persistfactory.h"
 #include "combatchunkid.h"
 #include "wwprofile.h"
+#include "wwmetrics.h"
+#include "framearena.h"
 
 #include "win.h"
 //#include "systimer.h"		// for timegettime
@@ -70,18 +72,30 @@ float			TimeManager::RealFrameSeconds = 0.0f;
 #define		TIME_DESTABILIZING_TECHNOLOGY_ENABLED		0
 #define		SLOWEST_FPS									      5
 
-FrameTimeHistogramClass::FrameTimeHistogramClass(unsigned slot_count, float step)
+FrameTimeHistogramClass::FrameTimeHistogramClass(unsigned slot_count, float step, const char* metric_name)
 	:
 	SlotCount(slot_count),
-	Step(step)
+	Step(step),
+	Metric(NULL)
 {
 	Counts=new unsigned[SlotCount];
 	Reset();
+
+	if (metric_name!=NULL) {
+		// The last slot catches everything slower, which maps to the implicit +Inf bucket.
+		float bounds[WWHistogramClass::MAX_BUCKETS];
+		unsigned bound_count=MIN(SlotCount-1,(unsigned)WWHistogramClass::MAX_BUCKETS);
+		for (unsigned i=0;i<bound_count;++i) {
+			bounds[i]=Step*float(i+1)/1000.0f;
+		}
+		Metric=new WWHistogramClass(metric_name,"Frame time in seconds.",bounds,bound_count);
+	}
 }
 
 FrameTimeHistogramClass::~FrameTimeHistogramClass()
 {
 	delete[] Counts;
+	delete Metric;
 }
 
 // Report normalized counts for each frame time slot, packed to unsigned bytes.
@@ -125,10 +139,14 @@ void FrameTimeHistogramClass::Add(float frame_time)
 	unsigned int slot=WWMath::Float_To_Long(frame_time*(1000.0f/Step));
 	if (slot>=SlotCount) slot=SlotCount-1;
 	Counts[slot]++;
+
+	if (Metric!=NULL) {
+		Metric->Observe(frame_time);
+	}
 }
 
 
-FrameTimeHistogramClass FrameTimeHistogram(16,15.0f);
+FrameTimeHistogramClass FrameTimeHistogram(16,15.0f,"w3d_frame_time_seconds");
 
 FrameTimeHistogramClass& TimeManager::Peek_Frame_Time_Histogram()
 {
@@ -303,6 +321,9 @@ void	TimeManager::Update( void )
 	// tell the profiling code that another frame has gone by
 	WWProfileManager::Increment_Frame_Counter();
 
+	// frame scratch memory from the last frame can be reused
+	FrameArenaClass::Begin_Frame();
+
 
 #ifdef WWDEBUG
 	//
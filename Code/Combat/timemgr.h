@@ -47,15 +47,18 @@
 
 class	ChunkSaveClass;
 class	ChunkLoadClass;
+class	WWHistogramClass;
 
-// Framerate histogram utility class
+// Framerate histogram utility class. If a metric name is given the frame times are also
+// exported through WWMetricsManager, using the same slots as buckets.
 class FrameTimeHistogramClass
 {
 	unsigned* Counts;
 	unsigned SlotCount;
 	float Step;
+	WWHistogramClass* Metric;
 public:
-	FrameTimeHistogramClass(unsigned slot_count, float step);	// Number of millisecond-slots, step in milliseconds
+	FrameTimeHistogramClass(unsigned slot_count, float step, const char* metric_name = NULL);	// Number of millisecond-slots, step in milliseconds
 	~FrameTimeHistogramClass();
 
 	void Reset();
@@ -116,6 +119,8 @@ private:
 	static	float			AveragedFPS;
 	static	int			AveragedFPSTicks;
 	static	int			AveragedFPSCounter;
+
+	friend class SimLODManager;		// stretches the frame for objects catching up
 };
 
 
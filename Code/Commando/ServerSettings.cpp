@@ -75,6 +75,8 @@ ServerSettingsClass::GameModeTypeEnum ServerSettingsClass::GameMode = MODE_NONE;
 unsigned int ServerSettingsClass::MasterBandwidth = 0;
 char ServerSettingsClass::PreferredLoginServer[256];
 int ServerSettingsClass::DiskLogSize = -1;
+char ServerSettingsClass::MetricsFile[MAX_PATH];
+unsigned int ServerSettingsClass::MetricsInterval = 5000;
 
 const char *ServerListTag = "Available Westwood Servers:";
 const char *ServerListEnd = ";  End generated section.";
@@ -370,6 +372,19 @@ bool ServerSettingsClass::Parse(bool apply)
 			return(false);
 		}
 
+		/*
+		** Get the metrics dump settings. No file means the metrics aren't written out.
+		*/
+		ini.Get_String(MasterServerSection, "MetricsFile", "", MetricsFile, sizeof(MetricsFile));
+		int metrics_interval = ini.Get_Int(MasterServerSection, "MetricsInterval", 5000);
+		if (metrics_interval < 100) {
+			WWDEBUG_SAY(("Error - Bad MetricsInterval specified - aborting\n"));
+			ConsoleBox.Print("Error - MetricsInterval must be at least 100 milliseconds - aborting\n");
+			ConsoleBox.Wait_For_Keypress();
+			return(false);
+		}
+		MetricsInterval = metrics_interval;
+
 		/*
 		** Get the preferred login server. No preference means use default from ping profile.
 		*/
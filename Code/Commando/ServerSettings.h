@@ -65,6 +65,8 @@ class ServerSettingsClass
 		static bool Check_Game_Settings_File(char *config_file);
 		static GameModeTypeEnum Get_Game_Mode(void) {return(GameMode);}
 		static int Get_Disk_Log_Size(void) {return(DiskLogSize);}
+		static const char *Get_Metrics_File(void) {return(MetricsFile);}
+		static unsigned int Get_Metrics_Interval(void) {return(MetricsInterval);}
 
 		/*
 		** Populating ini file with server list.
@@ -80,6 +82,8 @@ class ServerSettingsClass
 		static char PreferredLoginServer[256];
 		static GameModeTypeEnum GameMode;
 		static int DiskLogSize;
+		static char MetricsFile[MAX_PATH];
+		static unsigned int MetricsInterval;
 
 };
 
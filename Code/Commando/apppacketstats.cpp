@@ -43,6 +43,7 @@
 #include "mathutil.h"
 #include "networkobjectmgr.h"
 #include "wwprofile.h"
+#include "wwmetrics.h"
 
 //
 // Class statics
@@ -52,6 +53,8 @@ DWORD				cAppPacketStats::BitsSent[];
 DWORD				cAppPacketStats::BitsSentTier[][PACKET_TIER_COUNT];
 DWORD				cAppPacketStats::ObjectTally[];
 StringClass		cAppPacketStats::WorkingString;
+WWCounterClass *	cAppPacketStats::PacketsSentMetric[];
+WWCounterClass *	cAppPacketStats::BitsSentMetric[];
 
 //-----------------------------------------------------------------------------
 void
@@ -99,6 +102,11 @@ cAppPacketStats::Increment_Packets_Sent
 	PacketsSent[app_packet_type]++;
 
 	PacketsSent[APPPACKETTYPE_ALL]++;
+
+	if (PacketsSentMetric[app_packet_type] == NULL) {
+		Create_Metrics(app_packet_type);
+	}
+	PacketsSentMetric[app_packet_type]->Increment();
 }
 
 //-----------------------------------------------------------------------------
@@ -115,6 +123,11 @@ cAppPacketStats::Increment_Bits_Sent
 	BitsSent[app_packet_type] += bits;
 
 	BitsSent[APPPACKETTYPE_ALL] += bits;
+
+	if (BitsSentMetric[app_packet_type] == NULL) {
+		Create_Metrics(app_packet_type);
+	}
+	BitsSentMetric[app_packet_type]->Increment(bits);
 }
 
 //-----------------------------------------------------------------------------
@@ -134,6 +147,32 @@ cAppPacketStats::Increment_Bits_Sent_Tier
 	BitsSentTier[APPPACKETTYPE_ALL][tier] += bits;
 }
 
+//-----------------------------------------------------------------------------
+void
+cAppPacketStats::Create_Metrics
+(
+	BYTE app_packet_type
+)
+{
+	WWASSERT(app_packet_type != APPPACKETTYPE_ALL && app_packet_type < APPPACKETTYPE_COUNT);
+
+	//
+	// Strip the leading "APPPACKETTYPE_". The metrics live for the rest of the process
+	// and are never reset, so Reset() doesn't disturb a scraper's rate calculations.
+	//
+	StringClass labels;
+	labels.Format("type=\"%s\"", &Interpret_Type(app_packet_type)[14]);
+
+	if (PacketsSentMetric[app_packet_type] == NULL) {
+		PacketsSentMetric[app_packet_type] = new WWCounterClass("w3d_app_packets_sent_total",
+			"Application packets sent, by packet type.", labels);
+	}
+	if (BitsSentMetric[app_packet_type] == NULL) {
+		BitsSentMetric[app_packet_type] = new WWCounterClass("w3d_app_bits_sent_total",
+			"Application packet bits sent, by packet type.", labels);
+	}
+}
+
 //-----------------------------------------------------------------------------
 DWORD
 cAppPacketStats::Get_Packets_Sent
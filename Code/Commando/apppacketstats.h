@@ -41,6 +41,8 @@
 #include "apppackettypes.h"
 #include "networkobject.h"
 
+class WWCounterClass;
+
 //-----------------------------------------------------------------------------
 //
 // Record and report app packet stats
@@ -67,12 +69,20 @@ public:
 	static StringClass &	Get_Description(BYTE app_packet_type);
 
 private:
+	static void				Create_Metrics(BYTE app_packet_type);
+
 	static DWORD			PacketsSent[APPPACKETTYPE_COUNT];
 	static DWORD			BitsSent[APPPACKETTYPE_COUNT];
 	static DWORD			BitsSentTier[APPPACKETTYPE_COUNT][PACKET_TIER_COUNT];
 	static DWORD			ObjectTally[APPPACKETTYPE_COUNT];
 
 	static StringClass	WorkingString;
+
+	//
+	// Exported through WWMetricsManager, created the first time a type is sent
+	//
+	static WWCounterClass *	PacketsSentMetric[APPPACKETTYPE_COUNT];
+	static WWCounterClass *	BitsSentMetric[APPPACKETTYPE_COUNT];
 };
 
 //-----------------------------------------------------------------------------
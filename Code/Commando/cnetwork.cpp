@@ -87,6 +87,7 @@
 #include "gamespyadmin.h"
 #include "demosupport.h"
 #include "ServerSettings.h"
+#include "wwmetrics.h"
 #include "DlgMPConnectionRefused.h"
 
 #include <wwui/dialogmgr.h>
@@ -588,6 +589,8 @@ void cNetwork::Onetime_Shutdown(void)
 {
    WWDEBUG_SAY(("cNetwork::Onetime_Shutdown\n"));
 
+	WWMetricsManager::Stop_Dump_Thread();
+
    Set_Receiver(NULL);
 	delete NetworkReceiver;
 
@@ -715,6 +718,13 @@ void cNetwork::Init_Server(void)
 
 	cAppPacketStats::Reset();
 
+	//
+	// The metrics file outlives individual games, so only start the writer once.
+	//
+	if (ServerSettingsClass::Get_Metrics_File()[0] != 0 && !WWMetricsManager::Is_Dump_Thread_Running()) {
+		WWMetricsManager::Start_Dump_Thread(ServerSettingsClass::Get_Metrics_File(), ServerSettingsClass::Get_Metrics_Interval());
+	}
+
 #endif // not BETACLIENT
 }
 
@@ -1704,15 +1704,18 @@ void	ConsoleGameModeClass::Update_Memory_Log( void )
 	StringClass	memory_string(2048);
 	StringClass temp_string(true);
 
-	memory_string.Format("Memory Category     Current(Mb)    Peak(Mb)\n");
+	WWMemoryLogClass::Update_Allocation_Rates();
+
+	memory_string.Format("Memory Category     Current(Mb)    Peak(Mb)       Allocs/s\n");
 	int total = 0;
 	for (int i=0; i<WWMemoryLogClass::Get_Category_Count(); i++) {
 
 		// (gth) to compute Mb should I divide by the nearest power of two to a million?
-		temp_string.Format("%-18s  %-10.2f     %-10.2f\r\n",
+		temp_string.Format("%-18s  %-10.2f     %-10.2f     %-10.0f\r\n",
 										WWMemoryLogClass::Get_Category_Name(i),
 										(float)WWMemoryLogClass::Get_Current_Allocated_Memory(i) * OOMEGABYTE,
-										(float)WWMemoryLogClass::Get_Peak_Allocated_Memory(i) * OOMEGABYTE);
+										(float)WWMemoryLogClass::Get_Peak_Allocated_Memory(i) * OOMEGABYTE,
+										WWMemoryLogClass::Get_Allocation_Rate(i));
 		memory_string += temp_string;
 		total += WWMemoryLogClass::Get_Current_Allocated_Memory(i);
 	}
@@ -160,6 +160,11 @@
 #include "lightsolve.h"
 #include "lightsolvecontext.h"
 #include "openw3d.h"
+#include "simlod.h"
+#include "jobsystem.h"
+#include "aabtree.h"
+#include "predlod.h"
+#include "wwmemlog.h"
 
 
 
@@ -275,6 +280,55 @@ public:
 };
 
 
+class MemLogSnapshotFileConsoleFunctionClass : public ConsoleFunctionClass {
+public:
+	virtual	const char * Get_Name( void ) override	{ return "memlog_snapshot_file"; }
+	virtual	const char * Get_Help( void ) override	{ return "MEMLOG_SNAPSHOT_FILE <filename> - memory snapshots (level loads too) are appended to this file. No filename turns them off."; }
+	virtual	void Activate( const char * input ) override {
+		char filename[260] = { 0 };
+		sscanf( input, "%259s", filename );
+		WWMemoryLogClass::Set_Snapshot_File( filename );
+		if ( filename[0] != 0 ) {
+			Print( "Memory snapshots go to %s\n", filename );
+		} else {
+			Print( "Memory snapshots off\n" );
+		}
+	}
+};
+
+
+class MemLogSnapshotConsoleFunctionClass : public ConsoleFunctionClass {
+public:
+	virtual	const char * Get_Name( void ) override	{ return "memlog_snapshot"; }
+	virtual	const char * Get_Help( void ) override	{ return "MEMLOG_SNAPSHOT [label] - takes a memory snapshot and shows what changed since the last one."; }
+	virtual	void Activate( const char * input ) override {
+		static WWMemorySnapshotStruct _last_snapshot;
+		static bool _have_last_snapshot = false;
+
+		while ( *input == ' ' ) {
+			input++;
+		}
+		WWMemorySnapshotStruct snapshot;
+		WWMemoryLogClass::Take_Snapshot( snapshot, (*input != 0) ? input : "console" );
+		if ( *WWMemoryLogClass::Get_Snapshot_File() != 0 ) {
+			WWMemoryLogClass::Write_Snapshot( WWMemoryLogClass::Get_Snapshot_File(), snapshot );
+		}
+
+		if ( _have_last_snapshot ) {
+			char diff[4096];
+			WWMemoryLogClass::Format_Snapshot_Diff( _last_snapshot, snapshot, diff, sizeof( diff ) );
+			for ( char * line = strtok( diff, "\n" ); line != NULL; line = strtok( NULL, "\n" ) ) {
+				Print( "%s\n", line );
+			}
+		} else {
+			Print( "Memory snapshot taken\n" );
+		}
+		_last_snapshot = snapshot;
+		_have_last_snapshot = true;
+	}
+};
+
+
 class MeshDebuggerEnableConsoleFunctionClass : public ConsoleFunctionClass {
 public:
 	virtual	const char * Get_Name( void ) override	{ return "mesh_debugger_enable"; }
@@ -3559,6 +3613,91 @@ public:
 };
 #endif
 
+class SimLODConsoleFunctionClass : public ConsoleFunctionClass {
+public:
+	virtual	const char * Get_Name( void ) override	{ return "sim_lod"; }
+	virtual	const char * Get_Help( void ) override	{ return "SIM_LOD [0|1] - Think and timestep distant objects less often. No argument prints the tier counts."; }
+	virtual	void Activate( const char * input) override {
+		int state = 0;
+		if (::sscanf(input, "%d", &state) == 1) {
+			SimLODManager::Enable(state != 0);
+			Print( "Simulation LOD %s\n", state ? "ENABLED" : "DISABLED");
+			return;
+		}
+
+		Print( "Simulation LOD %s\n", SimLODManager::Is_Enabled() ? "ENABLED" : "DISABLED");
+		for (int tier = 0; tier < SimLODManager::TIER_COUNT; tier++) {
+			const SimLODManager::TierStatsStruct & stats = SimLODManager::Get_Tier_Stats(tier);
+			Print( "Tier %d (1/%d): %d objects, %d thought, %d skipped\n",
+				tier, SimLODManager::Get_Tier_Period(tier), stats.Objects, stats.Thinks, stats.ThinksSkipped);
+		}
+		const PhysicsSceneClass::SimulationLODStatsStruct & phys_stats = COMBAT_SCENE->Get_Simulation_LOD_Statistics();
+		Print( "Physics: %d stepped, %d caught up, %d deferred\n", phys_stats.Stepped, phys_stats.CaughtUp, phys_stats.Deferred);
+	}
+};
+
+class JobThreadsConsoleFunctionClass : public ConsoleFunctionClass {
+public:
+	virtual	const char * Get_Name( void ) override	{ return "job_threads"; }
+	virtual	const char * Get_Help( void ) override	{ return "JOB_THREADS [count] - Threads the shared job system uses, 1 runs every job in order on the main thread. No argument prints the count."; }
+	virtual	void Activate( const char * input) override {
+		JobSystemClass & jobs = JobSystemClass::Get_Shared();
+		int count = 0;
+		if (::sscanf(input, "%d", &count) == 1) {
+			jobs.Set_Thread_Count(count);
+		}
+		Print( "Job system: %d threads, %d jobs run, %d stolen\n", jobs.Get_Thread_Count(), jobs.Get_Jobs_Run(), jobs.Get_Jobs_Stolen());
+	}
+};
+
+class IncrementalCullConsoleFunctionClass : public ConsoleFunctionClass {
+public:
+	virtual	const char * Get_Name( void ) override	{ return "incremental_cull"; }
+	virtual	const char * Get_Help( void ) override	{ return "INCREMENTAL_CULL [0|1] - Update moved lights and projectors in place instead of re-inserting them from the root. No argument toggles."; }
+	virtual	void Activate( const char * input) override {
+		int state = 0;
+		if (::sscanf(input, "%d", &state) == 1) {
+			state = !!state;
+		} else {
+			state = !COMBAT_SCENE->Is_Incremental_Cull_Update_Enabled();
+		}
+		COMBAT_SCENE->Enable_Incremental_Cull_Update(state == 1);
+		Print( "Incremental cull update %s\n", state ? "ENABLED" : "DISABLED");
+	}
+};
+
+class WideAABTreeConsoleFunctionClass : public ConsoleFunctionClass {
+public:
+	virtual	const char * Get_Name( void ) override	{ return "wide_aabtree"; }
+	virtual	const char * Get_Help( void ) override	{ return "WIDE_AABTREE [0|1] - Collision trees loaded from now on use 4-wide nodes for casts. No argument toggles."; }
+	virtual	void Activate( const char * input) override {
+		int state = 0;
+		if (::sscanf(input, "%d", &state) == 1) {
+			state = !!state;
+		} else {
+			state = !AABTreeClass::Are_Wide_Nodes_Enabled();
+		}
+		AABTreeClass::Set_Wide_Nodes_Enabled(state == 1);
+		Print( "Wide collision trees %s\n", state ? "ENABLED" : "DISABLED");
+	}
+};
+
+class IncrementalLODConsoleFunctionClass : public ConsoleFunctionClass {
+public:
+	virtual	const char * Get_Name( void ) override	{ return "incremental_lod"; }
+	virtual	const char * Get_Help( void ) override	{ return "INCREMENTAL_LOD [0|1] - Keep the predictive lod queues from frame to frame instead of rebuilding them. No argument toggles."; }
+	virtual	void Activate( const char * input) override {
+		int state = 0;
+		if (::sscanf(input, "%d", &state) == 1) {
+			state = !!state;
+		} else {
+			state = !PredictiveLODOptimizerClass::Is_Incremental_Enabled();
+		}
+		PredictiveLODOptimizerClass::Enable_Incremental(state == 1);
+		Print( "Incremental lod optimizer %s\n", state ? "ENABLED" : "DISABLED");
+	}
+};
+
 class StatsConsoleFunctionClass : public ConsoleFunctionClass
 {
 public:
@@ -5097,6 +5236,8 @@ void	ConsoleFunctionManager::Init( void )
 	FunctionList.Add( new TeleportStarConsoleFunctionClass() );
 	FunctionList.Add( new TextureFilterModeConsoleFunctionClass() );
 	FunctionList.Add( new TextureMemoryCounterConsoleFunctionClass() );
+	FunctionList.Add( new MemLogSnapshotFileConsoleFunctionClass() );
+	FunctionList.Add( new MemLogSnapshotConsoleFunctionClass() );
 	FunctionList.Add( new TexturingEnableConsoleFunctionClass() );
 	FunctionList.Add( new TimeOfDayConsoleFunctionClass() );
 	FunctionList.Add( new ToggleAssetPreloadingConsoleFunctionClass() );
@@ -5166,6 +5307,11 @@ void	ConsoleFunctionManager::Init( void )
 	FunctionList.Add( new EditVehicleConsoleFunctionClass() );
 	FunctionList.Add( new NetUpdateRateConsoleFunctionClass() );
 	FunctionList.Add( new ClientPhysicsOptimizationConsoleFunctionClass() );
+	FunctionList.Add( new SimLODConsoleFunctionClass() );
+	FunctionList.Add( new JobThreadsConsoleFunctionClass() );
+	FunctionList.Add( new IncrementalCullConsoleFunctionClass() );
+	FunctionList.Add( new WideAABTreeConsoleFunctionClass() );
+	FunctionList.Add( new IncrementalLODConsoleFunctionClass() );
 #ifndef FREEDEDICATEDSERVER
 	FunctionList.Add( new FPSConsoleFunctionClass() );		// Steve W wanted this.
 #endif //FREEDEDICATEDSERVER
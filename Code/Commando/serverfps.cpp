@@ -39,12 +39,15 @@
 #include "cnetwork.h"
 #include "gameobjmanager.h"
 #include "apppackettypes.h"
+#include "wwmetrics.h"
 
 //
 // Class statics
 //
 cServerFps *	cServerFps::TheInstance	= NULL;
 
+static WWGaugeClass	_ServerFpsMetric("w3d_server_fps", "Server frames per second, sampled once a second.");
+
 //-----------------------------------------------------------------------------
 cServerFps::cServerFps(void)
 {
@@ -63,6 +66,7 @@ cServerFps::Set_Fps(int fps)
 	WWASSERT(cNetwork::I_Am_Server());
 
 	Fps = fps;
+	_ServerFpsMetric.Set(fps);
 
 	Set_Object_Dirty_Bit(NetworkObjectClass::BIT_FREQUENT, true);
 }
@@ -0,0 +1,289 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// AABTreeBench.cpp : Headless collision tree build benchmark. Pulls the meshes out
+// of .w3d files (or every .w3d inside a .mix file) and builds an AABTree for each
+// one with the original random plane builder and with the binned SAH builder on one
+// thread and up, reporting the build times and the expected query cost of the trees.
+// The SAH trees have to come out the same whatever the thread count. Usage:
+//
+//   aabtreebench [-t max_threads] [-v] file.w3d|file.mix ...
+//
+// -v prints a line for every mesh as well as the totals.
+
+#include "aabtreebuilder.h"
+#include "chunkio.h"
+#include "ffactory.h"
+#include "jobsystem.h"
+#include "mixfile.h"
+#include "rawfile.h"
+#include "w3d_file.h"
+#include "wwstring.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+struct BenchMeshStruct
+{
+	bool operator== (const BenchMeshStruct &)	{ return false; }
+	bool operator!= (const BenchMeshStruct &)	{ return true; }
+
+	char						Name[2 * W3D_NAME_LEN];
+	int						PolyCount;
+	int						VertCount;
+	TriIndex *				Polys;
+	Vector3 *				Verts;
+};
+
+struct BenchResultStruct
+{
+	bool operator== (const BenchResultStruct &)	{ return false; }
+	bool operator!= (const BenchResultStruct &)	{ return true; }
+
+	double					Ms;
+	float						Cost;
+	int						Nodes;
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+/*
+** Reads the vertices and triangles of one W3D_CHUNK_MESH.  Meshes with more vertices than
+** a TriIndex can address are skipped, the game can't load those either.
+*/
+static void Load_Mesh(ChunkLoadClass & cload,DynamicVectorClass<BenchMeshStruct> & meshes)
+{
+	W3dMeshHeader3Struct header;
+	memset(&header,0,sizeof(header));
+	W3dVectorStruct * verts = NULL;
+	W3dTriStruct * tris = NULL;
+
+	while (cload.Open_Chunk()) {
+		switch (cload.Cur_Chunk_ID()) {
+		case W3D_CHUNK_MESH_HEADER3:
+			cload.Read(&header,sizeof(header));
+			break;
+		case W3D_CHUNK_VERTICES:
+			if (verts == NULL && header.NumVertices > 0) {
+				verts = new W3dVectorStruct[header.NumVertices];
+				cload.Read(verts,header.NumVertices * sizeof(W3dVectorStruct));
+			}
+			break;
+		case W3D_CHUNK_TRIANGLES:
+			if (tris == NULL && header.NumTris > 0) {
+				tris = new W3dTriStruct[header.NumTris];
+				cload.Read(tris,header.NumTris * sizeof(W3dTriStruct));
+			}
+			break;
+		}
+		cload.Close_Chunk();
+	}
+
+	if (verts != NULL && tris != NULL && header.NumVertices <= 0xFFFF) {
+		BenchMeshStruct mesh;
+		snprintf(mesh.Name,sizeof(mesh.Name),"%.*s.%.*s",W3D_NAME_LEN,header.ContainerName,W3D_NAME_LEN,header.MeshName);
+		mesh.PolyCount = header.NumTris;
+		mesh.VertCount = header.NumVertices;
+		mesh.Polys = new TriIndex[mesh.PolyCount];
+		mesh.Verts = new Vector3[mesh.VertCount];
+		for (int i = 0; i < mesh.VertCount; i++) {
+			mesh.Verts[i].Set(verts[i].X,verts[i].Y,verts[i].Z);
+		}
+		bool valid = true;
+		for (int i = 0; i < mesh.PolyCount; i++) {
+			for (int j = 0; j < 3; j++) {
+				valid &= (tris[i].Vindex[j] < header.NumVertices);
+				mesh.Polys[i][j] = (unsigned short)tris[i].Vindex[j];
+			}
+		}
+		if (valid) {
+			meshes.Add(mesh);
+		} else {
+			printf("%s: bad vertex index, skipped\n",mesh.Name);
+			delete [] mesh.Polys;
+			delete [] mesh.Verts;
+		}
+	}
+
+	delete [] verts;
+	delete [] tris;
+}
+
+static void Load_Meshes(FileClass & file,DynamicVectorClass<BenchMeshStruct> & meshes)
+{
+	ChunkLoadClass cload(&file);
+	while (cload.Open_Chunk()) {
+		if (cload.Cur_Chunk_ID() == W3D_CHUNK_MESH) {
+			Load_Mesh(cload,meshes);
+		}
+		cload.Close_Chunk();
+	}
+}
+
+static bool Is_Mix_File(const char * filename)
+{
+	int length = (int)strlen(filename);
+	return (length > 4) && (stricmp(filename + length - 4,".mix") == 0);
+}
+
+static void Load_File(const char * filename,DynamicVectorClass<BenchMeshStruct> & meshes)
+{
+	if (!Is_Mix_File(filename)) {
+		RawFileClass file(filename);
+		if (!file.Open(FileClass::READ)) {
+			printf("%s: can't open\n",filename);
+			return;
+		}
+		Load_Meshes(file,meshes);
+		file.Close();
+		return;
+	}
+
+	MixFileFactoryClass mix(filename,_TheFileFactory);
+	DynamicVectorClass<StringClass> names;
+	if (!mix.Is_Valid() || !mix.Build_Filename_List(names)) {
+		printf("%s: not a mix file\n",filename);
+		return;
+	}
+	for (int i = 0; i < names.Count(); i++) {
+		int length = names[i].Get_Length();
+		if (length < 4 || stricmp((const char *)names[i] + length - 4,".w3d") != 0) {
+			continue;
+		}
+		FileClass * file = mix.Get_File(names[i]);
+		if (file != NULL && file->Open(FileClass::READ)) {
+			Load_Meshes(*file,meshes);
+			file->Close();
+		}
+		mix.Return_File(file);
+	}
+}
+
+/*
+** Builds a tree for the mesh.  The random plane builder uses rand(), so it's seeded the
+** same way every time to keep its trees repeatable.
+*/
+static BenchResultStruct Build(const BenchMeshStruct & mesh,AABTreeBuilderClass::BuildModeType mode,JobSystemClass & jobs)
+{
+	AABTreeBuilderClass builder;
+	builder.Set_Build_Mode(mode);
+	builder.Set_Job_System(&jobs);
+	srand(1);
+
+	BenchResultStruct result;
+	BenchClock::time_point start = BenchClock::now();
+	builder.Build_AABTree(mesh.PolyCount,mesh.Polys,mesh.VertCount,mesh.Verts);
+	result.Ms = Elapsed_Ms(start);
+	result.Cost = builder.Compute_SAH_Cost();
+	result.Nodes = builder.Node_Count();
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	int max_threads = 8;
+	bool verbose = false;
+	int first_file = 1;
+	while (first_file < argc && argv[first_file][0] == '-') {
+		if (strcmp(argv[first_file],"-v") == 0) {
+			verbose = true;
+			first_file += 1;
+		} else if (strcmp(argv[first_file],"-t") == 0 && first_file + 1 < argc) {
+			max_threads = atoi(argv[first_file + 1]);
+			first_file += 2;
+		} else {
+			break;
+		}
+	}
+	if (first_file >= argc || max_threads < 1 || max_threads > JobSystemClass::MAX_THREADS) {
+		printf("Usage - aabtreebench [-t max_threads] [-v] file.w3d|file.mix ...\n");
+		return 1;
+	}
+
+	DynamicVectorClass<BenchMeshStruct> meshes;
+	for (int i = first_file; i < argc; i++) {
+		Load_File(argv[i],meshes);
+	}
+	if (meshes.Count() == 0) {
+		printf("no meshes found\n");
+		return 1;
+	}
+
+	int poly_count = 0;
+	for (int i = 0; i < meshes.Count(); i++) {
+		poly_count += meshes[i].PolyCount;
+	}
+	printf("%d meshes, %d polys\n",meshes.Count(),poly_count);
+
+	/*
+	** The costs are averaged over the meshes weighted by their poly counts, so the big
+	** meshes that most of the queries end up in count for the most.
+	*/
+	double random_ms = 0.0;
+	double random_cost = 0.0;
+	double sah_ms = 0.0;
+	double sah_cost = 0.0;
+	DynamicVectorClass<BenchResultStruct> sah_results;
+	JobSystemClass jobs;
+	for (int i = 0; i < meshes.Count(); i++) {
+		const BenchMeshStruct & mesh = meshes[i];
+		BenchResultStruct random = Build(mesh,AABTreeBuilderClass::BUILD_RANDOM_PLANES,jobs);
+		BenchResultStruct sah = Build(mesh,AABTreeBuilderClass::BUILD_BINNED_SAH,jobs);
+		random_ms += random.Ms;
+		random_cost += (double)random.Cost * mesh.PolyCount;
+		sah_ms += sah.Ms;
+		sah_cost += (double)sah.Cost * mesh.PolyCount;
+		sah_results.Add(sah);
+
+		if (verbose) {
+			printf("%-40s %6d polys  random %8.3f ms cost %7.2f  sah %8.3f ms cost %7.2f\n",
+				mesh.Name,mesh.PolyCount,random.Ms,random.Cost,sah.Ms,sah.Cost);
+		}
+	}
+
+	printf("random planes:          %9.3f ms, cost %.3f\n",random_ms,random_cost / poly_count);
+	printf("binned SAH, 1 thread:   %9.3f ms, cost %.3f, speedup %.2fx\n",sah_ms,sah_cost / poly_count,random_ms / sah_ms);
+
+	bool all_match = true;
+	for (int threads = 2; threads <= max_threads; threads *= 2) {
+		double ms = 0.0;
+		bool match = true;
+		jobs.Set_Thread_Count(threads);
+		for (int i = 0; i < meshes.Count(); i++) {
+			BenchResultStruct result = Build(meshes[i],AABTreeBuilderClass::BUILD_BINNED_SAH,jobs);
+			ms += result.Ms;
+			match &= (result.Nodes == sah_results[i].Nodes) && (result.Cost == sah_results[i].Cost);
+		}
+		all_match &= match;
+		printf("binned SAH, %2d threads: %9.3f ms, speedup %.2fx (%s)\n",
+			threads,ms,sah_ms / ms,match ? "trees match" : "TREES DIFFER");
+	}
+
+	for (int i = 0; i < meshes.Count(); i++) {
+		delete [] meshes[i].Polys;
+		delete [] meshes[i].Verts;
+	}
+	return all_match ? 0 : 2;
+}
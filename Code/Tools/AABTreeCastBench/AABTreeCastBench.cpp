@@ -0,0 +1,315 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// AABTreeCastBench.cpp : Headless collision cast benchmark. Loads the meshes out of .w3d
+// files (or every .w3d inside a .mix file) twice, once with the binary AABTree nodes only
+// and once with the 4-wide nodes, then runs the same random rays, box casts and box
+// intersections against both and reports the time each took. The two traversals have to
+// give the same answers. Usage:
+//
+//   aabtreecastbench [-q queries_per_mesh] file.w3d|file.mix ...
+
+#include "aabtree.h"
+#include "chunkio.h"
+#include "coltest.h"
+#include "ffactory.h"
+#include "inttest.h"
+#include "meshgeometry.h"
+#include "mixfile.h"
+#include "random.h"
+#include "rawfile.h"
+#include "w3d_file.h"
+#include "wwstring.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+enum
+{
+	QUERY_RAY = 0,
+	QUERY_AABOX,
+	QUERY_OBBOX,
+	QUERY_OBBOX_INTERSECT,
+	QUERY_TYPE_COUNT
+};
+
+static const char * QueryNames[QUERY_TYPE_COUNT] =
+{
+	"ray cast",
+	"AABox cast",
+	"OBBox cast",
+	"OBBox intersect",
+};
+
+struct BenchQueryStruct
+{
+	Vector3					Start;
+	Vector3					Move;
+	Vector3					Extent;
+	Matrix3					Basis;
+};
+
+struct BenchHitStruct
+{
+	bool						Hit;
+	CastResultStruct		Result;
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static float Random_Float(RandomClass & random,float min,float max)
+{
+	return min + (max - min) * (float)random(0,32767) / 32767.0f;
+}
+
+static Vector3 Random_Point(RandomClass & random,const AABoxClass & box,float scale)
+{
+	return Vector3(	box.Center.X + scale * Random_Float(random,-box.Extent.X,box.Extent.X),
+						box.Center.Y + scale * Random_Float(random,-box.Extent.Y,box.Extent.Y),
+						box.Center.Z + scale * Random_Float(random,-box.Extent.Z,box.Extent.Z)	);
+}
+
+/*
+** Loads every mesh in the file that ends up with a cull tree.  The wide node setting is
+** picked up by the trees as they are loaded or generated.
+*/
+static void Load_Meshes(FileClass & file,DynamicVectorClass<MeshGeometryClass *> & meshes)
+{
+	ChunkLoadClass cload(&file);
+	while (cload.Open_Chunk()) {
+		if (cload.Cur_Chunk_ID() == W3D_CHUNK_MESH) {
+			MeshGeometryClass * mesh = new MeshGeometryClass;
+			if (mesh->Load_W3D(cload) == WW3D_ERROR_OK && mesh->Has_Cull_Tree()) {
+				meshes.Add(mesh);
+			} else {
+				mesh->Release_Ref();
+			}
+		}
+		cload.Close_Chunk();
+	}
+}
+
+static bool Is_Mix_File(const char * filename)
+{
+	int length = (int)strlen(filename);
+	return (length > 4) && (stricmp(filename + length - 4,".mix") == 0);
+}
+
+static void Load_File(const char * filename,DynamicVectorClass<MeshGeometryClass *> & meshes)
+{
+	if (!Is_Mix_File(filename)) {
+		RawFileClass file(filename);
+		if (!file.Open(FileClass::READ)) {
+			printf("%s: can't open\n",filename);
+			return;
+		}
+		Load_Meshes(file,meshes);
+		file.Close();
+		return;
+	}
+
+	MixFileFactoryClass mix(filename,_TheFileFactory);
+	DynamicVectorClass<StringClass> names;
+	if (!mix.Is_Valid() || !mix.Build_Filename_List(names)) {
+		printf("%s: not a mix file\n",filename);
+		return;
+	}
+	for (int i = 0; i < names.Count(); i++) {
+		int length = names[i].Get_Length();
+		if (length < 4 || stricmp((const char *)names[i] + length - 4,".w3d") != 0) {
+			continue;
+		}
+		FileClass * file = mix.Get_File(names[i]);
+		if (file != NULL && file->Open(FileClass::READ)) {
+			Load_Meshes(*file,meshes);
+			file->Close();
+		}
+		mix.Return_File(file);
+	}
+}
+
+/*
+** Queries start anywhere in or around the mesh's bounding box and head for another point in
+** it, so most of them reach the tree and a good share of them hit something.
+*/
+static void Make_Queries(MeshGeometryClass * mesh,RandomClass & random,BenchQueryStruct * queries,int count)
+{
+	AABoxClass bounds;
+	mesh->Get_Bounding_Box(&bounds);
+
+	for (int i = 0; i < count; i++) {
+		BenchQueryStruct & query = queries[i];
+		query.Start = Random_Point(random,bounds,1.5f);
+		query.Move = Random_Point(random,bounds,1.0f) - query.Start;
+		query.Extent = Vector3(	Random_Float(random,0.01f,0.1f) * bounds.Extent.X,
+										Random_Float(random,0.01f,0.1f) * bounds.Extent.Y,
+										Random_Float(random,0.01f,0.1f) * bounds.Extent.Z	);
+
+		Vector3 axis(Random_Float(random,-1.0f,1.0f),Random_Float(random,-1.0f,1.0f),Random_Float(random,-1.0f,1.0f));
+		if (axis.Length2() < 0.01f) {
+			axis.Set(0,0,1);
+		}
+		axis.Normalize();
+		query.Basis = Matrix3(axis,Random_Float(random,0.0f,2.0f * WWMATH_PI));
+	}
+}
+
+static bool Run_Query(MeshGeometryClass * mesh,int type,const BenchQueryStruct & query,CastResultStruct * result)
+{
+	switch (type)
+	{
+	case QUERY_RAY:
+		{
+			LineSegClass ray(query.Start,query.Start + query.Move);
+			RayCollisionTestClass raytest(ray,result);
+			return mesh->Cast_Ray(raytest);
+		}
+	case QUERY_AABOX:
+		{
+			AABoxClass box(query.Start,query.Extent);
+			AABoxCollisionTestClass boxtest(box,query.Move,result);
+			return mesh->Cast_AABox(boxtest);
+		}
+	case QUERY_OBBOX:
+		{
+			OBBoxClass box(query.Start,query.Extent,query.Basis);
+			OBBoxCollisionTestClass boxtest(box,query.Move,result);
+			return mesh->Cast_OBBox(boxtest);
+		}
+	case QUERY_OBBOX_INTERSECT:
+		{
+			OBBoxClass box(query.Start,query.Extent,query.Basis);
+			OBBoxIntersectionTestClass boxtest(box,COLLISION_TYPE_ALL);
+			return mesh->Intersect_OBBox(boxtest);
+		}
+	}
+	return false;
+}
+
+/*
+** Runs one type of query over every mesh and returns the time it took.  The results are
+** kept for comparing the two traversals.
+*/
+static double Run_Queries(DynamicVectorClass<MeshGeometryClass *> & meshes,int type,BenchQueryStruct * queries,int queries_per_mesh,BenchHitStruct * hits)
+{
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < meshes.Count(); i++) {
+		for (int j = 0; j < queries_per_mesh; j++) {
+			int index = i * queries_per_mesh + j;
+			hits[index].Result.Reset();
+			hits[index].Hit = Run_Query(meshes[i],type,queries[index],&hits[index].Result);
+		}
+	}
+	return Elapsed_Ms(start);
+}
+
+static bool Hits_Match(const BenchHitStruct & a,const BenchHitStruct & b)
+{
+	return	(a.Hit == b.Hit) &&
+				(a.Result.StartBad == b.Result.StartBad) &&
+				(a.Result.Fraction == b.Result.Fraction) &&
+				(a.Result.Normal == b.Result.Normal) &&
+				(a.Result.SurfaceType == b.Result.SurfaceType);
+}
+
+int main(int argc, char* argv[])
+{
+	int queries_per_mesh = 2000;
+	int first_file = 1;
+	while (first_file < argc && argv[first_file][0] == '-') {
+		if (strcmp(argv[first_file],"-q") == 0 && first_file + 1 < argc) {
+			queries_per_mesh = atoi(argv[first_file + 1]);
+			first_file += 2;
+		} else {
+			break;
+		}
+	}
+	if (first_file >= argc || queries_per_mesh < 1) {
+		printf("Usage - aabtreecastbench [-q queries_per_mesh] file.w3d|file.mix ...\n");
+		return 1;
+	}
+
+	DynamicVectorClass<MeshGeometryClass *> binary_meshes;
+	DynamicVectorClass<MeshGeometryClass *> wide_meshes;
+	bool wide_enabled = AABTreeClass::Are_Wide_Nodes_Enabled();
+	for (int i = first_file; i < argc; i++) {
+		AABTreeClass::Set_Wide_Nodes_Enabled(false);
+		Load_File(argv[i],binary_meshes);
+		AABTreeClass::Set_Wide_Nodes_Enabled(true);
+		Load_File(argv[i],wide_meshes);
+	}
+	AABTreeClass::Set_Wide_Nodes_Enabled(wide_enabled);
+	if (binary_meshes.Count() == 0 || binary_meshes.Count() != wide_meshes.Count()) {
+		printf("no meshes with collision trees found\n");
+		return 1;
+	}
+
+	int poly_count = 0;
+	for (int i = 0; i < binary_meshes.Count(); i++) {
+		poly_count += binary_meshes[i]->Get_Polygon_Count();
+	}
+	printf("%d meshes, %d polys, %d queries per mesh\n",binary_meshes.Count(),poly_count,queries_per_mesh);
+
+	int query_count = binary_meshes.Count() * queries_per_mesh;
+	BenchQueryStruct * queries = new BenchQueryStruct[query_count];
+	BenchHitStruct * binary_hits = new BenchHitStruct[query_count];
+	BenchHitStruct * wide_hits = new BenchHitStruct[query_count];
+
+	RandomClass random(1);
+	for (int i = 0; i < binary_meshes.Count(); i++) {
+		Make_Queries(binary_meshes[i],random,&queries[i * queries_per_mesh],queries_per_mesh);
+	}
+
+	bool all_match = true;
+	for (int type = 0; type < QUERY_TYPE_COUNT; type++) {
+		double binary_ms = Run_Queries(binary_meshes,type,queries,queries_per_mesh,binary_hits);
+		double wide_ms = Run_Queries(wide_meshes,type,queries,queries_per_mesh,wide_hits);
+
+		int hit_count = 0;
+		int mismatches = 0;
+		for (int i = 0; i < query_count; i++) {
+			hit_count += binary_hits[i].Hit ? 1 : 0;
+			mismatches += Hits_Match(binary_hits[i],wide_hits[i]) ? 0 : 1;
+		}
+		all_match &= (mismatches == 0);
+
+		if (mismatches == 0) {
+			printf("%-16s binary %9.3f ms, wide %9.3f ms, speedup %.2fx, %d hits (results match)\n",
+				QueryNames[type],binary_ms,wide_ms,binary_ms / wide_ms,hit_count);
+		} else {
+			printf("%-16s binary %9.3f ms, wide %9.3f ms, speedup %.2fx, %d hits (RESULTS DIFFER in %d queries)\n",
+				QueryNames[type],binary_ms,wide_ms,binary_ms / wide_ms,hit_count,mismatches);
+		}
+	}
+
+	delete [] queries;
+	delete [] binary_hits;
+	delete [] wide_hits;
+	for (int i = 0; i < binary_meshes.Count(); i++) {
+		binary_meshes[i]->Release_Ref();
+		wide_meshes[i]->Release_Ref();
+	}
+	return all_match ? 0 : 2;
+}
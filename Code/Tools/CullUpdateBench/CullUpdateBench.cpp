@@ -0,0 +1,192 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// CullUpdateBench.cpp : AAB-tree culling update benchmark. Fills an AABTreeCullSystemClass
+// with boxes, partitions it, then moves the boxes a little every frame and teleports a few
+// of them, the way lights and projectors that follow things get moved, once with the usual
+// re-insertion from the root and once with Set_Incremental_Update. Reports the time spent
+// updating and querying, and checks every query against a brute force search. Usage:
+//
+//   cullupdatebench [-n objects] [-f frames] [-p teleport_percent]
+
+#include "aabtreecull.h"
+#include "colmath.h"
+#include "colmathinlines.h"
+#include "random.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static const float WORLD_SIZE = 100.0f;
+static const int QUERY_INTERVAL = 20;
+
+struct BenchConfigStruct
+{
+	int	Objects;
+	int	Frames;
+	int	TeleportPercent;
+};
+
+class BenchObjClass : public CullableClass
+{
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static float Random_Float(RandomClass & random,float min,float max)
+{
+	return min + (max - min) * (float)random(0,32767) / 32767.0f;
+}
+
+static Vector3 Random_Point(RandomClass & random)
+{
+	return Vector3(	Random_Float(random,-WORLD_SIZE,WORLD_SIZE),
+						Random_Float(random,-WORLD_SIZE,WORLD_SIZE),
+						Random_Float(random,-WORLD_SIZE,WORLD_SIZE)	);
+}
+
+/*
+** Collects the objects touching an object's box and checks that the tree found exactly
+** the ones a brute force search does.  Returns false if it didn't.
+*/
+static bool Check_Query(TypedAABTreeCullSystemClass<BenchObjClass> & tree,BenchObjClass ** objects,int count,const AABoxClass & box)
+{
+	tree.Reset_Collection();
+	tree.Collect_Objects(box);
+
+	int collected = 0;
+	for (BenchObjClass * obj = tree.Get_First_Collected_Object(); obj != NULL; obj = tree.Get_Next_Collected_Object(obj)) {
+		if (CollisionMath::Overlap_Test(box,obj->Get_Cull_Box()) == CollisionMath::OUTSIDE) {
+			return false;
+		}
+		collected++;
+	}
+
+	int expected = 0;
+	for (int i = 0; i < count; i++) {
+		if (CollisionMath::Overlap_Test(box,objects[i]->Get_Cull_Box()) != CollisionMath::OUTSIDE) {
+			expected++;
+		}
+	}
+	return collected == expected;
+}
+
+/*
+** Runs the whole scene once.  Every run uses the same random numbers, so both modes see
+** the same moves.
+*/
+static bool Run(const BenchConfigStruct & config,bool incremental)
+{
+	RandomClass random(1);
+	TypedAABTreeCullSystemClass<BenchObjClass> tree;
+
+	BenchObjClass ** objects = new BenchObjClass *[config.Objects];
+	for (int i = 0; i < config.Objects; i++) {
+		Vector3 extent(Random_Float(random,0.5f,3.0f),Random_Float(random,0.5f,3.0f),Random_Float(random,0.5f,3.0f));
+		objects[i] = new BenchObjClass;
+		objects[i]->Set_Cull_Box(AABoxClass(Random_Point(random),extent));
+		tree.Add_Object(objects[i]);
+	}
+	tree.Re_Partition();
+	tree.Set_Incremental_Update(incremental);
+	tree.Reset_Statistics();
+
+	const int teleport_interval = (config.TeleportPercent > 0) ? MAX(100 / config.TeleportPercent,1) : 0;
+	double update_ms = 0.0;
+	double query_ms = 0.0;
+	int queries = 0;
+	int bad_queries = 0;
+
+	for (int frame = 0; frame < config.Frames; frame++) {
+		BenchClock::time_point start = BenchClock::now();
+		for (int i = 0; i < config.Objects; i++) {
+			AABoxClass box = objects[i]->Get_Cull_Box();
+			if (teleport_interval > 0 && (i % teleport_interval) == (frame % teleport_interval)) {
+				box.Center = Random_Point(random);
+			} else {
+				box.Center += Vector3(Random_Float(random,-1.0f,1.0f),Random_Float(random,-1.0f,1.0f),Random_Float(random,-1.0f,1.0f));
+			}
+			objects[i]->Set_Cull_Box(box);
+		}
+		update_ms += Elapsed_Ms(start);
+
+		if ((frame % QUERY_INTERVAL) == QUERY_INTERVAL - 1 || frame == config.Frames - 1) {
+			start = BenchClock::now();
+			for (int i = 0; i < config.Objects; i++) {
+				tree.Reset_Collection();
+				tree.Collect_Objects(objects[i]->Get_Cull_Box());
+			}
+			query_ms += Elapsed_Ms(start);
+			queries += config.Objects;
+
+			for (int i = 0; i < config.Objects; i += 7) {
+				if (!Check_Query(tree,objects,config.Objects,objects[i]->Get_Cull_Box())) {
+					bad_queries++;
+				}
+			}
+		}
+	}
+
+	const AABTreeCullSystemClass::StatsStruct & stats = tree.Get_Statistics();
+	printf("%s: %.3f ms/frame updating, %.2f us/query (%s)\n",
+		incremental ? "incremental update" : "root re-insertion",
+		update_ms / config.Frames,query_ms * 1000.0 / queries,
+		(bad_queries == 0) ? "results match" : "RESULTS DIFFER");
+	if (incremental) {
+		printf("  %d updates: %d kept, %d re-inserted (%d levels climbed), %d leaves moved, %d nodes refit, %d rotations\n",
+			stats.ObjectsUpdated,stats.ObjectsKept,stats.ObjectsReinserted,stats.ReinsertClimbSteps,
+			stats.LeavesMoved,stats.NodesRefit,stats.NodesRotated);
+	}
+
+	for (int i = 0; i < config.Objects; i++) {
+		tree.Remove_Object(objects[i]);
+		objects[i]->Release_Ref();
+	}
+	delete [] objects;
+	return bad_queries == 0;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 2000, 200, 2 };
+	for (int i = 1; i + 1 < argc; i += 2) {
+		int value = atoi(argv[i + 1]);
+		if (strcmp(argv[i],"-n") == 0)			config.Objects = value;
+		else if (strcmp(argv[i],"-f") == 0)		config.Frames = value;
+		else if (strcmp(argv[i],"-p") == 0)		config.TeleportPercent = value;
+	}
+	if (	(argc % 2) == 0 || config.Objects < 1 || config.Frames < 1 ||
+			config.TeleportPercent < 0 || config.TeleportPercent > 100)
+	{
+		printf("Usage - cullupdatebench [-n objects] [-f frames] [-p teleport_percent]\n");
+		return 1;
+	}
+
+	printf("%d objects, %d frames, %d%% teleported per frame\n",config.Objects,config.Frames,config.TeleportPercent);
+
+	bool all_match = Run(config,false);
+	all_match &= Run(config,true);
+	return all_match ? 0 : 2;
+}
@@ -0,0 +1,165 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FrameArenaBench.cpp : Frame arena benchmark. Runs frames of scratch work shaped like
+// the places the engine takes it from the frame arena (depth keys for the dirty nodes of
+// an AABTree refit, CRC staging for each outgoing packet and the buffer for a formatted
+// string too long for the stack) once with everything on the heap and once out of a
+// FrameArenaClass that is reset every frame, and reports the time per frame for each along
+// with the arena's overflow statistics. Both runs have to come up with the same checksum.
+// The arena starts at the given capacity, so a small one shows it growing. Usage:
+//
+//   framearenabench [-f frames] [-q queries] [-c capacity_kb]
+
+#include "framearena.h"
+#include "random.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+struct BenchConfigStruct
+{
+	int	Frames;
+	int	Queries;
+	int	CapacityKB;
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+/*
+** One query's worth of work: sort the depth keys of some dirty nodes, stage a CRC and
+** payload for a few packets and format a long string, summing everything up so that the
+** runs can be compared.  The sizes come from the random generator, which both runs seed
+** the same way.  Scratch comes from alloc and is handed back to release when the query
+** is done with it.
+*/
+template<class ALLOC_FUNC,class RELEASE_FUNC>
+static unsigned Run_Query(RandomClass & random,const char * payload,ALLOC_FUNC alloc,RELEASE_FUNC release)
+{
+	unsigned sum = 0;
+
+	int node_count = random(4,64);
+	int * depths = (int *)alloc(node_count * sizeof(int));
+	for (int i = 0; i < node_count; i++) {
+		depths[i] = random(0,24);
+	}
+	for (int i = 1; i < node_count; i++) {
+		int depth = depths[i];
+		int j = i;
+		for (; (j > 0) && (depths[j - 1] < depth); j--) {
+			depths[j] = depths[j - 1];
+		}
+		depths[j] = depth;
+	}
+	sum += depths[0] * 31 + depths[node_count - 1] + node_count;
+	release(depths);
+
+	int packet_count = random(1,8);
+	for (int packet = 0; packet < packet_count; packet++) {
+		int length = random(64,1400);
+		unsigned crc = (unsigned)length * 2654435761u;
+		char * crc_and_buffer = (char *)alloc(length + sizeof(crc));
+		*((unsigned *)crc_and_buffer) = crc;
+		memcpy(crc_and_buffer + sizeof(crc),payload,length);
+		sum += (unsigned char)crc_and_buffer[sizeof(crc) + length - 1] + crc_and_buffer[0];
+		release(crc_and_buffer);
+	}
+
+	int text_length = random(512,2048);
+	char * text = (char *)alloc(text_length + 16);
+	int written = snprintf(text,text_length + 16,"%.*s %d",text_length,payload,text_length);
+	sum += written + (unsigned char)text[written / 2];
+	release(text);
+
+	return sum;
+}
+
+static unsigned Run_Heap(const BenchConfigStruct & config,const char * payload,double & ms)
+{
+	RandomClass random(1);
+	unsigned sum = 0;
+	BenchClock::time_point start = BenchClock::now();
+	for (int frame = 0; frame < config.Frames; frame++) {
+		for (int query = 0; query < config.Queries; query++) {
+			sum += Run_Query(random,payload,[](size_t size) { return (void *)new char[size]; },[](void * memory) { delete [] (char *)memory; });
+		}
+	}
+	ms = Elapsed_Ms(start);
+	return sum;
+}
+
+static unsigned Run_Arena(const BenchConfigStruct & config,const char * payload,FrameArenaClass & arena,double & ms)
+{
+	RandomClass random(1);
+	unsigned sum = 0;
+	BenchClock::time_point start = BenchClock::now();
+	for (int frame = 0; frame < config.Frames; frame++) {
+		for (int query = 0; query < config.Queries; query++) {
+			FrameArenaScopeClass arena_scope(arena);
+			sum += Run_Query(random,payload,[&](size_t size) { return arena.Alloc(size); },[](void *) {});
+		}
+		arena.Reset();
+	}
+	ms = Elapsed_Ms(start);
+	return sum;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 1000, 64, 64 };
+	int arg = 1;
+	while (arg + 1 < argc && argv[arg][0] == '-') {
+		int value = atoi(argv[arg + 1]);
+		if (strcmp(argv[arg],"-f") == 0)			config.Frames = value;
+		else if (strcmp(argv[arg],"-q") == 0)	config.Queries = value;
+		else if (strcmp(argv[arg],"-c") == 0)	config.CapacityKB = value;
+		else break;
+		arg += 2;
+	}
+	if (arg < argc || config.Frames < 1 || config.Queries < 1 || config.CapacityKB < 1) {
+		printf("Usage - framearenabench [-f frames] [-q queries] [-c capacity_kb]\n");
+		return 1;
+	}
+
+	static char payload[2048];
+	for (int i = 0; i < (int)sizeof(payload); i++) {
+		payload[i] = (char)('a' + (i % 26));
+	}
+
+	double heap_ms = 0.0;
+	double arena_ms = 0.0;
+	FrameArenaClass arena(config.CapacityKB * 1024);
+	unsigned heap_sum = Run_Heap(config,payload,heap_ms);
+	unsigned arena_sum = Run_Arena(config,payload,arena,arena_ms);
+
+	const FrameArenaClass::StatsStruct & stats = arena.Get_Stats();
+	printf("%d frames, %d queries per frame\n",config.Frames,config.Queries);
+	printf("heap:  %.3f ms/frame\n",heap_ms / config.Frames);
+	printf("arena: %.3f ms/frame, speedup %.2fx (%s)\n",arena_ms / config.Frames,heap_ms / arena_ms,
+		heap_sum == arena_sum ? "results match" : "RESULTS DIFFER");
+	printf("arena: capacity %d KB (from %d KB), high water %d KB, %d of %d frames overflowed, grown %d time(s)\n",
+		(int)(stats.Capacity / 1024),config.CapacityKB,(int)(stats.HighWater / 1024),stats.OverflowFrames,stats.Frames,stats.Grows);
+	return heap_sum == arena_sum ? 0 : 2;
+}
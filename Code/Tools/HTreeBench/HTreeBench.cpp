@@ -0,0 +1,283 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// HTreeBench.cpp : Headless hierarchy update benchmark. Loads the hierarchies and
+// animations out of real .w3d files, gives every animation a crowd of trees each
+// playing it from a different frame, and times updating them all one at a time and
+// through HTreeBatchClass with one thread and up. Every batched run has to end up
+// bit for bit where the plain run did. Usage:
+//
+//   htreebench [-n trees_per_anim] [-f frames] [-t max_threads] file.w3d ...
+//
+// Hierarchies are loaded from every file before any animations, so the skeleton and
+// its animations can come from different files.
+
+#include "assetmgr.h"
+#include "htree.h"
+#include "htreebatch.h"
+#include "jobsystem.h"
+#include "hanim.h"
+#include "rawfile.h"
+#include "ramfile.h"
+#include "w3d_file.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+struct BenchConfigStruct
+{
+	int	TreesPerAnim;
+	int	Frames;
+	int	MaxThreads;
+};
+
+struct BenchTreeStruct
+{
+	bool operator== (const BenchTreeStruct &)	{ return false; }
+	bool operator!= (const BenchTreeStruct &)	{ return true; }
+
+	HTreeClass *			Tree;
+	HAnimClass *			Anim;
+	HAnimCursorClass *	Cursor;
+	float						StartFrame;
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+/*
+** Feeds the asset manager just the top level chunks of one kind out of a .w3d file, so
+** the meshes and textures (which want a device) never get loaded.
+*/
+static bool Load_Chunks(WW3DAssetManager & assets,const char * filename,bool hierarchies)
+{
+	RawFileClass file(filename);
+	if (!file.Open(FileClass::READ)) {
+		printf("%s: can't open\n",filename);
+		return false;
+	}
+	int size = file.Size();
+	unsigned char * data = new unsigned char[size > 0 ? size : 1];
+	bool ok = (file.Read(data,size) == size);
+	file.Close();
+
+	unsigned char * filtered = new unsigned char[size > 0 ? size : 1];
+	int filtered_size = 0;
+	for (int offset = 0; ok && offset + 8 <= size; ) {
+		uint32 id;
+		uint32 length;
+		memcpy(&id,data + offset,4);
+		memcpy(&length,data + offset + 4,4);
+		length &= 0x7FFFFFFF;
+		if (length > (uint32)(size - offset - 8)) {
+			printf("%s: truncated chunk\n",filename);
+			break;
+		}
+
+		bool wanted = hierarchies ?
+			(id == W3D_CHUNK_HIERARCHY) :
+			(id == W3D_CHUNK_ANIMATION || id == W3D_CHUNK_COMPRESSED_ANIMATION);
+		if (wanted) {
+			memcpy(filtered + filtered_size,data + offset,length + 8);
+			filtered_size += length + 8;
+		}
+		offset += length + 8;
+	}
+
+	if (ok && filtered_size > 0) {
+		RAMFileClass ramfile(filtered,filtered_size);
+		assets.Load_3D_Assets(ramfile);
+	}
+
+	delete [] data;
+	delete [] filtered;
+	return ok;
+}
+
+static float Frame_For(const BenchTreeStruct & entry,int frame)
+{
+	int frame_count = entry.Anim->Get_Num_Frames();
+	return (frame_count > 1) ? fmodf(entry.StartFrame + frame * 0.5f,(float)(frame_count - 1)) : 0.0f;
+}
+
+/*
+** Runs every tree through the frames. threads == 0 calls Anim_Update on each tree in
+** turn, otherwise the trees go through HTreeBatchClass with that many threads.
+*/
+static double Run(const DynamicVectorClass<BenchTreeStruct> & trees,const BenchConfigStruct & config,int threads,DynamicVectorClass<Matrix3D> & results)
+{
+	JobSystemClass jobs;
+	jobs.Set_Thread_Count(threads > 0 ? threads : 1);
+
+	HTreeBatchClass batch;
+	batch.Set_Job_System(&jobs);
+
+	Matrix3D root(true);
+	BenchClock::time_point start = BenchClock::now();
+	for (int frame = 0; frame < config.Frames; frame++) {
+		for (int i = 0; i < trees.Count(); i++) {
+			const BenchTreeStruct & entry = trees[i];
+			if (threads == 0) {
+				entry.Tree->Anim_Update(root,entry.Anim,Frame_For(entry,frame),entry.Cursor);
+			} else {
+				batch.Add_Anim_Update(entry.Tree,root,entry.Anim,Frame_For(entry,frame),entry.Cursor);
+			}
+		}
+		batch.Update();
+	}
+	double ms = Elapsed_Ms(start);
+
+	results.Reset_Active();
+	for (int i = 0; i < trees.Count(); i++) {
+		for (int pivot = 0; pivot < trees[i].Tree->Num_Pivots(); pivot++) {
+			results.Add(trees[i].Tree->Get_Transform(pivot));
+		}
+	}
+	return ms;
+}
+
+static bool Results_Match(const DynamicVectorClass<Matrix3D> & a,const DynamicVectorClass<Matrix3D> & b)
+{
+	return (a.Count() == b.Count()) && (a.Count() == 0 || memcmp(&a[0],&b[0],a.Count() * sizeof(Matrix3D)) == 0);
+}
+
+/*
+** The largest difference between the updated trees and Simple_Evaluate_Pivot, which
+** builds each pivot up from scratch without touching the tree. It adds things up in a
+** different order, so it only has to come close.
+*/
+static float Max_Deviation(const DynamicVectorClass<BenchTreeStruct> & trees,int last_frame)
+{
+	Matrix3D root(true);
+	float max_error = 0.0f;
+	for (int i = 0; i < trees.Count(); i++) {
+		const BenchTreeStruct & entry = trees[i];
+		if (entry.Anim->Get_Num_Pivots() < entry.Tree->Num_Pivots()) {
+			continue;
+		}
+		for (int pivot = 1; pivot < entry.Tree->Num_Pivots(); pivot++) {
+			Matrix3D tm;
+			entry.Tree->Simple_Evaluate_Pivot(entry.Anim,pivot,Frame_For(entry,last_frame),root,&tm);
+			const Matrix3D & updated = entry.Tree->Get_Transform(pivot);
+			for (int row = 0; row < 3; row++) {
+				for (int col = 0; col < 4; col++) {
+					max_error = WWMath::Max(max_error,WWMath::Fabs(tm[row][col] - updated[row][col]));
+				}
+			}
+		}
+	}
+	return max_error;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 64, 300, 8 };
+	int first_file = 1;
+	while (first_file + 1 < argc && argv[first_file][0] == '-') {
+		int value = atoi(argv[first_file + 1]);
+		if (strcmp(argv[first_file],"-n") == 0)			config.TreesPerAnim = value;
+		else if (strcmp(argv[first_file],"-f") == 0)		config.Frames = value;
+		else if (strcmp(argv[first_file],"-t") == 0)		config.MaxThreads = value;
+		else break;
+		first_file += 2;
+	}
+	if (	first_file >= argc || config.TreesPerAnim < 1 || config.Frames < 1 ||
+			config.MaxThreads < 1 || config.MaxThreads > JobSystemClass::MAX_THREADS)
+	{
+		printf("Usage - htreebench [-n trees_per_anim] [-f frames] [-t max_threads] file.w3d ...\n");
+		return 1;
+	}
+
+	WW3DAssetManager assets;
+	for (int i = first_file; i < argc; i++) {
+		Load_Chunks(assets,argv[i],true);
+	}
+	for (int i = first_file; i < argc; i++) {
+		Load_Chunks(assets,argv[i],false);
+	}
+
+	/*
+	** A crowd of trees for every animation whose hierarchy was found.
+	*/
+	DynamicVectorClass<BenchTreeStruct> trees;
+	int anim_count = 0;
+	int pivot_count = 0;
+	AssetIterator * iterator = assets.Create_HAnim_Iterator();
+	for (iterator->First(); !iterator->Is_Done(); iterator->Next()) {
+		HAnimClass * anim = assets.Get_HAnim(iterator->Current_Item_Name());
+		if (anim == NULL) {
+			continue;
+		}
+		HTreeClass * tree = assets.Get_HTree(anim->Get_HName());
+		if (tree == NULL) {
+			printf("%s: hierarchy %s not loaded, skipped\n",anim->Get_Name(),anim->Get_HName());
+			anim->Release_Ref();
+			continue;
+		}
+
+		for (int i = 0; i < config.TreesPerAnim; i++) {
+			BenchTreeStruct entry;
+			entry.Tree = new HTreeClass(*tree);
+			entry.Anim = anim;
+			entry.Anim->Add_Ref();
+			entry.Cursor = anim->Create_Cursor();
+			entry.StartFrame = (float)(i * anim->Get_Num_Frames()) / config.TreesPerAnim;
+			trees.Add(entry);
+			pivot_count += tree->Num_Pivots();
+		}
+		anim->Release_Ref();
+		anim_count++;
+	}
+	delete iterator;
+
+	if (trees.Count() == 0) {
+		printf("no animations with a loaded hierarchy\n");
+		return 1;
+	}
+	printf("%d animations, %d trees, %d pivots, %d frames\n",anim_count,trees.Count(),pivot_count,config.Frames);
+
+	DynamicVectorClass<Matrix3D> serial;
+	double serial_ms = Run(trees,config,0,serial);
+	printf("Anim_Update one tree at a time: %.3f ms/frame, %.1f ns/pivot\n",
+		serial_ms / config.Frames,serial_ms * 1000000.0 / ((double)config.Frames * pivot_count));
+	printf("  max deviation from Simple_Evaluate_Pivot: %g\n",Max_Deviation(trees,config.Frames - 1));
+
+	bool all_match = true;
+	for (int threads = 1; threads <= config.MaxThreads; threads *= 2) {
+		DynamicVectorClass<Matrix3D> batched;
+		double ms = Run(trees,config,threads,batched);
+		bool match = Results_Match(serial,batched);
+		all_match &= match;
+		printf("HTreeBatchClass, %d thread(s): %.3f ms/frame, speedup %.2fx (%s)\n",
+			threads,ms / config.Frames,serial_ms / ms,match ? "results match" : "RESULTS DIFFER");
+	}
+
+	for (int i = 0; i < trees.Count(); i++) {
+		delete trees[i].Cursor;
+		trees[i].Anim->Release_Ref();
+		delete trees[i].Tree;
+	}
+	return all_match ? 0 : 2;
+}
@@ -0,0 +1,345 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// JobBench.cpp : Job system test and benchmark. Runs the same work through JobSystemClass
+// with one thread (the deterministic mode) and up: a Parallel_For over an array, a
+// quicksort which splits itself with Fork_Join, a three stage reduction chained with
+// Run_After, and a flood of empty jobs to show what one job costs. Every run has to come
+// out the same as the plain loops, and the job times the system hands to the profiler
+// are listed at the end. Usage:
+//
+//   jobbench [-n items] [-b batch_size] [-r repeats] [-t max_threads]
+
+#include "jobsystem.h"
+#include "wwprofile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+struct BenchConfigStruct
+{
+	int	Items;
+	int	BatchSize;
+	int	Repeats;
+	int	MaxThreads;
+};
+
+struct BenchResultStruct
+{
+	std::vector<float>	Values;
+	std::vector<int>		Sorted;
+	std::vector<float>	Normalized;
+	double					Total;
+};
+
+enum
+{
+	WORK_ITERATIONS = 64,
+	SORT_CUTOFF = 2048,
+	REDUCE_BLOCK = 4096,
+};
+
+static const int EMPTY_JOBS = 100000;
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+/*
+** Some floating point work per item that only depends on the item.
+*/
+static float Work(int i)
+{
+	float x = (float)(i % 1000) * 0.001f;
+	for (int k = 0; k < WORK_ITERATIONS; k++) {
+		x = sinf(x + (float)k) * 0.5f + x * 0.5f;
+	}
+	return x;
+}
+
+static void Make_Keys(int count,std::vector<int> & keys)
+{
+	keys.resize(count);
+	unsigned seed = 12345;
+	for (int i = 0; i < count; i++) {
+		seed = seed * 1664525 + 1013904223;
+		keys[i] = (int)(seed >> 8) % (count / 4 + 1);
+	}
+}
+
+/*
+** Quicksort that sorts the two sides of each partition at the same time.  The middle run
+** of keys equal to the pivot is already in place.
+*/
+static void Parallel_Sort(JobSystemClass & jobs,int * first,int * last)
+{
+	if (last - first <= SORT_CUTOFF) {
+		std::sort(first,last);
+		return;
+	}
+	int a = first[0];
+	int b = first[(last - first) / 2];
+	int c = last[-1];
+	int pivot = std::max(std::min(a,b),std::min(std::max(a,b),c));
+	int * low = std::partition(first,last,[pivot](int key) { return key < pivot; });
+	int * high = std::partition(low,last,[pivot](int key) { return !(pivot < key); });
+
+	jobs.Fork_Join(
+		[&] { Parallel_Sort(jobs,first,low); },
+		[&] { Parallel_Sort(jobs,high,last); },
+		"Sort");
+}
+
+/*
+** The reduction: sum blocks of the values, add up the block sums in order, then divide
+** every value by the total.  Each stage waits for the one before through Run_After.
+*/
+struct ReduceStruct
+{
+	std::vector<float> *	Values;
+	std::vector<double>	Sums;
+	double					Total;
+};
+
+struct BlockJobStruct
+{
+	ReduceStruct *	Reduce;
+	int				Block;
+};
+
+static void Sum_Block_Job(void * data)
+{
+	BlockJobStruct * job = (BlockJobStruct *)data;
+	const std::vector<float> & values = *job->Reduce->Values;
+	int first = job->Block * REDUCE_BLOCK;
+	int last = std::min(first + REDUCE_BLOCK,(int)values.size());
+	double sum = 0.0;
+	for (int i = first; i < last; i++) {
+		sum += values[i];
+	}
+	job->Reduce->Sums[job->Block] = sum;
+}
+
+static void Total_Job(void * data)
+{
+	ReduceStruct * reduce = (ReduceStruct *)data;
+	reduce->Total = 0.0;
+	for (size_t i = 0; i < reduce->Sums.size(); i++) {
+		reduce->Total += reduce->Sums[i];
+	}
+}
+
+static void Normalize_Block_Job(void * data)
+{
+	BlockJobStruct * job = (BlockJobStruct *)data;
+	std::vector<float> & values = *job->Reduce->Values;
+	int first = job->Block * REDUCE_BLOCK;
+	int last = std::min(first + REDUCE_BLOCK,(int)values.size());
+	float scale = (float)(1.0 / job->Reduce->Total);
+	for (int i = first; i < last; i++) {
+		values[i] *= scale;
+	}
+}
+
+static void Reduce(JobSystemClass & jobs,std::vector<float> & values,double & total)
+{
+	ReduceStruct reduce;
+	reduce.Values = &values;
+	int blocks = ((int)values.size() + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+	reduce.Sums.resize(blocks);
+	std::vector<BlockJobStruct> block_jobs(blocks);
+
+	JobCounterClass sums;
+	JobCounterClass totals;
+	JobCounterClass normals;
+	for (int i = 0; i < blocks; i++) {
+		block_jobs[i].Reduce = &reduce;
+		block_jobs[i].Block = i;
+		jobs.Run(&Sum_Block_Job,&block_jobs[i],&sums,"Sum Block");
+	}
+	jobs.Run_After(sums,&Total_Job,&reduce,&totals,"Total");
+	for (int i = 0; i < blocks; i++) {
+		jobs.Run_After(totals,&Normalize_Block_Job,&block_jobs[i],&normals,"Normalize Block");
+	}
+	jobs.Wait_For(normals);
+	total = reduce.Total;
+}
+
+static void Empty_Job(void *)
+{
+}
+
+/*
+** The same work with plain loops.
+*/
+static void Run_Serial(const BenchConfigStruct & config,BenchResultStruct & result)
+{
+	result.Values.resize(config.Items);
+	for (int i = 0; i < config.Items; i++) {
+		result.Values[i] = Work(i);
+	}
+
+	Make_Keys(config.Items,result.Sorted);
+	std::sort(result.Sorted.begin(),result.Sorted.end());
+
+	result.Normalized = result.Values;
+	int blocks = (config.Items + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+	result.Total = 0.0;
+	for (int block = 0; block < blocks; block++) {
+		double sum = 0.0;
+		for (int i = block * REDUCE_BLOCK; i < std::min((block + 1) * REDUCE_BLOCK,config.Items); i++) {
+			sum += result.Normalized[i];
+		}
+		result.Total += sum;
+	}
+	float scale = (float)(1.0 / result.Total);
+	for (int i = 0; i < config.Items; i++) {
+		result.Normalized[i] *= scale;
+	}
+}
+
+struct BenchTimesStruct
+{
+	double	ParallelForMs;
+	double	SortMs;
+	double	ReduceMs;
+	double	EmptyJobNs;
+};
+
+static void Run(JobSystemClass & jobs,const BenchConfigStruct & config,BenchResultStruct & result,BenchTimesStruct & times)
+{
+	memset(&times,0,sizeof(times));
+	result.Values.assign(config.Items,0.0f);
+	std::vector<int> keys;
+	Make_Keys(config.Items,keys);
+
+	for (int repeat = 0; repeat < config.Repeats; repeat++) {
+		BenchClock::time_point start = BenchClock::now();
+		jobs.Parallel_For(config.Items,config.BatchSize,
+			[&](int first,int last) {
+				for (int i = first; i < last; i++) {
+					result.Values[i] = Work(i);
+				}
+			},
+			"Parallel For");
+		times.ParallelForMs += Elapsed_Ms(start);
+
+		result.Sorted = keys;
+		start = BenchClock::now();
+		Parallel_Sort(jobs,result.Sorted.data(),result.Sorted.data() + result.Sorted.size());
+		times.SortMs += Elapsed_Ms(start);
+
+		result.Normalized = result.Values;
+		start = BenchClock::now();
+		Reduce(jobs,result.Normalized,result.Total);
+		times.ReduceMs += Elapsed_Ms(start);
+
+		JobCounterClass counter;
+		start = BenchClock::now();
+		for (int i = 0; i < EMPTY_JOBS; i++) {
+			jobs.Run(&Empty_Job,NULL,&counter);
+		}
+		jobs.Wait_For(counter);
+		times.EmptyJobNs += Elapsed_Ms(start) * 1000000.0 / EMPTY_JOBS;
+	}
+
+	times.ParallelForMs /= config.Repeats;
+	times.SortMs /= config.Repeats;
+	times.ReduceMs /= config.Repeats;
+	times.EmptyJobNs /= config.Repeats;
+}
+
+static bool Results_Match(const BenchResultStruct & a,const BenchResultStruct & b)
+{
+	return	a.Values == b.Values &&
+				a.Sorted == b.Sorted &&
+				a.Normalized == b.Normalized &&
+				a.Total == b.Total;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 1 << 18, 1024, 5, 8 };
+	int arg = 1;
+	while (arg + 1 < argc && argv[arg][0] == '-') {
+		int value = atoi(argv[arg + 1]);
+		if (strcmp(argv[arg],"-n") == 0)			config.Items = value;
+		else if (strcmp(argv[arg],"-b") == 0)	config.BatchSize = value;
+		else if (strcmp(argv[arg],"-r") == 0)	config.Repeats = value;
+		else if (strcmp(argv[arg],"-t") == 0)	config.MaxThreads = value;
+		else break;
+		arg += 2;
+	}
+	if (	arg < argc || config.Items < 1 || config.BatchSize < 1 || config.Repeats < 1 ||
+			config.MaxThreads < 1 || config.MaxThreads > JobSystemClass::MAX_THREADS)
+	{
+		printf("Usage - jobbench [-n items] [-b batch_size] [-r repeats] [-t max_threads]\n");
+		return 1;
+	}
+
+	WWProfileManager::Reset();
+
+	BenchResultStruct serial;
+	BenchClock::time_point start = BenchClock::now();
+	Run_Serial(config,serial);
+	printf("%d items, batches of %d: plain loops %.3f ms\n",config.Items,config.BatchSize,Elapsed_Ms(start));
+
+	bool all_match = true;
+	BenchTimesStruct base;
+	JobSystemClass jobs;
+	for (int threads = 1; threads <= config.MaxThreads; threads *= 2) {
+		jobs.Set_Thread_Count(threads);
+		jobs.Reset_Stats();
+
+		BenchResultStruct result;
+		BenchTimesStruct times;
+		Run(jobs,config,result,times);
+		if (threads == 1) {
+			base = times;
+		}
+
+		bool match = Results_Match(serial,result);
+		all_match &= match;
+		printf("%2d thread(s)%s: parallel for %.3f ms (%.2fx), sort %.3f ms (%.2fx), reduce %.3f ms (%.2fx), "
+			"%.0f ns/empty job, %d jobs, %d stolen (%s)\n",
+			threads,jobs.Is_Deterministic() ? " [deterministic]" : "",
+			times.ParallelForMs,base.ParallelForMs / times.ParallelForMs,
+			times.SortMs,base.SortMs / times.SortMs,
+			times.ReduceMs,base.ReduceMs / times.ReduceMs,
+			times.EmptyJobNs,jobs.Get_Jobs_Run(),jobs.Get_Jobs_Stolen(),
+			match ? "results match" : "RESULTS DIFFER");
+	}
+
+	/*
+	** Named jobs land in the profile tree under whatever was being profiled when they
+	** were waited for, here the root.
+	*/
+	printf("Profiled jobs:\n");
+	for (WWProfileHierachyNodeClass * node = WWProfileManager::Get_Root()->Get_Child(); node != NULL; node = node->Get_Sibling()) {
+		printf("  %-16s %8d calls %10.3f ms\n",node->Get_Name(),node->Get_Total_Calls(),node->Get_Total_Time() * 1000.0f);
+	}
+	return all_match ? 0 : 2;
+}
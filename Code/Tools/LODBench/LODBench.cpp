@@ -0,0 +1,287 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// LODBench.cpp : Predictive lod optimizer benchmark. Gives a crowd of objects lod
+// tables the way HLodClass has them, moves them towards and away from the camera a
+// little every frame, hides a few now and then, and runs PredictiveLODOptimizerClass
+// over them once rebuilding its queues every frame and twice keeping them (with no
+// area threshold and with the given one). Without a threshold the kept queues have to
+// pick exactly the lods the rebuilt ones do, and no run may leave an object below the
+// lowest lod its screen size allows. The cost budget is given per object. Usage:
+//
+//   lodbench [-n objects] [-f frames] [-a area_threshold_percent] [-c cost_per_object]
+
+#include "rendobj.h"
+#include "predlod.h"
+#include "random.h"
+
+#include <chrono>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static const int LOD_COUNT = 4;
+static const float MAX_SCREEN_SIZE[LOD_COUNT] = { 0.002f, 0.008f, 0.03f, FLT_MAX };
+static const float NON_PIXEL_COST[LOD_COUNT] = { 50.0f, 200.0f, 800.0f, 3200.0f };
+static const float BENEFIT_FACTOR[LOD_COUNT] = { 0.2f, 0.5f, 0.8f, 1.0f };
+static const float PIXEL_COST_PER_AREA = 20000.0f;
+
+struct BenchConfigStruct
+{
+	int	Objects;
+	int	Frames;
+	int	AreaThresholdPercent;
+	int	CostPerObject;
+};
+
+struct BenchTotalsStruct
+{
+	int	Added;
+	int	Removed;
+	int	Updated;
+	int	LODChanges;
+	int	BelowMinLOD;
+};
+
+/*
+** An object with the lod handling of HLodClass: Prepare does what Prepare_LOD does
+** with the screen area it's given, including raising the lod to the lowest one the
+** area allows before adding the object to the optimizer.
+*/
+class BenchLODObjClass : public RenderObjClass
+{
+public:
+	BenchLODObjClass(float base_area,float phase,float speed) :
+		BaseArea(base_area),
+		Phase(phase),
+		Speed(speed),
+		CurLod(0),
+		MinLod(0)
+	{
+		memset(Value,0,sizeof(Value));
+		memset(Cost,0,sizeof(Cost));
+	}
+
+	virtual RenderObjClass *	Clone(void) const override											{ return new BenchLODObjClass(*this); }
+	virtual void					Render(RenderInfoClass & /*rinfo*/) override						{ }
+
+	virtual void	Increment_LOD(void) override			{ if (CurLod < LOD_COUNT - 1) CurLod++; }
+	virtual void	Decrement_LOD(void) override			{ if (CurLod > 0) CurLod--; }
+	virtual float	Get_Cost(void) const override			{ return Cost[CurLod]; }
+	virtual float	Get_Value(void) const override		{ return Value[CurLod]; }
+	virtual float	Get_Post_Increment_Value(void) const override	{ return Value[CurLod + 1]; }
+	virtual void	Set_LOD_Level(int lod) override		{ CurLod = (lod < 0) ? 0 : ((lod >= LOD_COUNT) ? LOD_COUNT - 1 : lod); }
+	virtual int		Get_LOD_Level(void) const override	{ return CurLod; }
+	virtual int		Get_LOD_Count(void) const override	{ return LOD_COUNT; }
+
+	virtual int		Calculate_Cost_Value_Arrays(float screen_area,float *values,float *costs) const override
+	{
+		int lod;
+		for (lod = 0; lod < LOD_COUNT; lod++) {
+			costs[lod] = NON_PIXEL_COST[lod] + PIXEL_COST_PER_AREA * screen_area;
+		}
+		for (lod = 0; lod < LOD_COUNT && MAX_SCREEN_SIZE[lod] < screen_area; lod++) {
+			values[lod] = AT_MIN_LOD;
+		}
+		if (lod >= LOD_COUNT) {
+			lod = LOD_COUNT - 1;
+		} else {
+			values[lod] = AT_MIN_LOD;
+		}
+		int minlod = lod;
+		for (lod++; lod < LOD_COUNT; lod++) {
+			values[lod] = (BENEFIT_FACTOR[lod] * screen_area) / costs[lod];
+		}
+		values[LOD_COUNT] = AT_MAX_LOD;
+		return minlod;
+	}
+
+	void Prepare(float screen_area)
+	{
+		MinLod = Calculate_Cost_Value_Arrays(screen_area,Value,Cost);
+		if (CurLod < MinLod) Set_LOD_Level(MinLod);
+		PredictiveLODOptimizerClass::Add_Object(this,screen_area);
+	}
+
+	float Area_At(int frame) const	{ return BaseArea * (1.0f + 0.6f * sinf(Phase + frame * Speed)); }
+	int Get_Min_LOD(void) const		{ return MinLod; }
+
+private:
+	float		BaseArea;
+	float		Phase;
+	float		Speed;
+	int		CurLod;
+	int		MinLod;
+	float		Value[LOD_COUNT + 1];
+	float		Cost[LOD_COUNT];
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static float Random_Float(RandomClass & random,float min,float max)
+{
+	return min + (max - min) * (float)random(0,32767) / 32767.0f;
+}
+
+static bool Is_Visible(int index,int frame)
+{
+	return ((index + frame / 16) % 8) != 0;
+}
+
+/*
+** Runs the optimizer over the objects for every frame, starting them all at lod 0, and
+** records the lod every object ends each frame at (objects * frames of them). Returns
+** the time spent optimizing.
+*/
+static double Run(BenchLODObjClass ** objects,const BenchConfigStruct & config,bool incremental,float threshold,int * lods,BenchTotalsStruct & totals)
+{
+	PredictiveLODOptimizerClass::Enable_Incremental(incremental);
+	PredictiveLODOptimizerClass::Set_Area_Threshold(threshold);
+	memset(&totals,0,sizeof(totals));
+
+	for (int i = 0; i < config.Objects; i++) {
+		objects[i]->Set_LOD_Level(0);
+	}
+
+	double ms = 0.0;
+	for (int frame = 0; frame < config.Frames; frame++) {
+		PredictiveLODOptimizerClass::Clear();
+		for (int i = 0; i < config.Objects; i++) {
+			if (Is_Visible(i,frame)) {
+				objects[i]->Prepare(objects[i]->Area_At(frame));
+			}
+		}
+
+		BenchClock::time_point start = BenchClock::now();
+		PredictiveLODOptimizerClass::Optimize_LODs((float)config.CostPerObject * config.Objects);
+		ms += Elapsed_Ms(start);
+
+		const PredictiveLODOptimizerClass::StatsStruct & stats = PredictiveLODOptimizerClass::Get_Statistics();
+		totals.Added += stats.Added;
+		totals.Removed += stats.Removed;
+		totals.Updated += stats.Updated;
+		totals.LODChanges += stats.LODChanges;
+
+		for (int i = 0; i < config.Objects; i++) {
+			int lod = objects[i]->Get_LOD_Level();
+			*lods++ = lod;
+			if (Is_Visible(i,frame) && lod < objects[i]->Get_Min_LOD()) {
+				totals.BelowMinLOD++;
+			}
+		}
+	}
+
+	// Turning incremental mode off releases the objects the kept queues hold.
+	PredictiveLODOptimizerClass::Enable_Incremental(false);
+	return ms;
+}
+
+static int Count_Differences(const int * a,const int * b,const BenchConfigStruct & config)
+{
+	int count = 0;
+	for (int i = 0; i < config.Objects * config.Frames; i++) {
+		if (a[i] != b[i]) count++;
+	}
+	return count;
+}
+
+static void Print_Run(const char * name,double ms,double rebuild_ms,const BenchTotalsStruct & totals,const BenchConfigStruct & config)
+{
+	printf("%s: %.3f ms/frame, speedup %.2fx\n",name,ms / config.Frames,rebuild_ms / ms);
+	printf("  per frame: %.1f added, %.1f removed, %.1f keys updated, %.1f lod changes\n",
+		(double)totals.Added / config.Frames,(double)totals.Removed / config.Frames,
+		(double)totals.Updated / config.Frames,(double)totals.LODChanges / config.Frames);
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 2000, 600, 10, 1500 };
+	int arg = 1;
+	while (arg + 1 < argc && argv[arg][0] == '-') {
+		int value = atoi(argv[arg + 1]);
+		if (strcmp(argv[arg],"-n") == 0)			config.Objects = value;
+		else if (strcmp(argv[arg],"-f") == 0)	config.Frames = value;
+		else if (strcmp(argv[arg],"-a") == 0)	config.AreaThresholdPercent = value;
+		else if (strcmp(argv[arg],"-c") == 0)	config.CostPerObject = value;
+		else break;
+		arg += 2;
+	}
+	if (arg < argc || config.Objects < 1 || config.Frames < 1 || config.AreaThresholdPercent < 0 || config.CostPerObject < 1) {
+		printf("Usage - lodbench [-n objects] [-f frames] [-a area_threshold_percent] [-c cost_per_object]\n");
+		return 1;
+	}
+
+	RandomClass random(1);
+	BenchLODObjClass ** objects = new BenchLODObjClass *[config.Objects];
+	for (int i = 0; i < config.Objects; i++) {
+		objects[i] = new BenchLODObjClass(	Random_Float(random,0.0005f,0.03f),
+														Random_Float(random,0.0f,6.28f),
+														Random_Float(random,0.005f,0.05f)	);
+	}
+	printf("%d objects, %d frames, %d lods each, budget %d per object\n",config.Objects,config.Frames,LOD_COUNT,config.CostPerObject);
+
+	int * rebuilt = new int[config.Objects * config.Frames];
+	int * exact = new int[config.Objects * config.Frames];
+	int * approx = new int[config.Objects * config.Frames];
+
+	BenchTotalsStruct rebuild_totals;
+	double rebuild_ms = Run(objects,config,false,0.0f,rebuilt,rebuild_totals);
+	Print_Run("Queues rebuilt every frame",rebuild_ms,rebuild_ms,rebuild_totals,config);
+
+	BenchTotalsStruct exact_totals;
+	double exact_ms = Run(objects,config,true,0.0f,exact,exact_totals);
+	Print_Run("Queues kept, no area threshold",exact_ms,rebuild_ms,exact_totals,config);
+	bool match = (Count_Differences(rebuilt,exact,config) == 0);
+	printf("  %s\n",match ? "results match" : "RESULTS DIFFER");
+
+	char name[64];
+	snprintf(name,sizeof(name),"Queues kept, %d%% area threshold",config.AreaThresholdPercent);
+	BenchTotalsStruct approx_totals;
+	double approx_ms = Run(objects,config,true,config.AreaThresholdPercent / 100.0f,approx,approx_totals);
+	Print_Run(name,approx_ms,rebuild_ms,approx_totals,config);
+	printf("  %.2f%% of lods differ from the rebuilt queues\n",
+		100.0 * Count_Differences(rebuilt,approx,config) / ((double)config.Objects * config.Frames));
+
+	int below = rebuild_totals.BelowMinLOD + exact_totals.BelowMinLOD + approx_totals.BelowMinLOD;
+	if (below > 0) {
+		printf("%d LODS BELOW THE LOWEST ALLOWED\n",below);
+	}
+
+	int leaked = 0;
+	for (int i = 0; i < config.Objects; i++) {
+		if (objects[i]->Num_Refs() != 1) leaked++;
+		objects[i]->Release_Ref();
+	}
+	delete [] objects;
+	delete [] rebuilt;
+	delete [] exact;
+	delete [] approx;
+	PredictiveLODOptimizerClass::Free();
+	if (leaked > 0) {
+		printf("%d OBJECTS STILL REFERENCED\n",leaked);
+	}
+
+	return (match && below == 0 && leaked == 0) ? 0 : 2;
+}
@@ -208,7 +208,9 @@ CLevelEditApp::InitInstance (void)
 	SetRegistryKey(_T("Westwood Studios"));
 
 	//
-	//	Handle the command line
+	//	Handle the command line.  -j=<job file> runs a farm job (VIS or
+	// Pathfind, see Perform_Job) without asking for input.  The editor
+	// still starts up in full, so this is not a headless mode.
 	//
 	LPCTSTR cmd_line = ::strstr (m_lpCmdLine, "-j=");
 	if (cmd_line != NULL) {
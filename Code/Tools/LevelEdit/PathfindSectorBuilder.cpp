@@ -57,7 +57,9 @@
 #include "soldier.h"
 #include "humanphys.h"
 #include "combatchunkid.h"
+#include "physislands.h"
 #include <algorithm>
+#include <float.h>
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -101,6 +103,13 @@ Clip_Point (Vector3 *point, const AABoxClass &box)
 //	Local constants
 //////////////////////////////////////////////////////////////////////////
 const float ONE_SEC_FALL_DIST		= 4.9F;
+const int JOB_BATCH_SIZE			= 8;
+
+enum
+{
+	JOB_PROBE	= 0,
+	JOB_HEIGHT,
+};
 
 
 class SimDirInfoClass
@@ -148,8 +157,16 @@ PathfindSectorBuilderClass::PathfindSectorBuilderClass (void)
 		m_TotalBoxGuess (0),
 		m_BeforeUpdateCount (0),
 		m_AllowWaterFloodfill (false),
-		m_MaxSectorDim (28000.0F)
+		m_MaxSectorDim (28000.0F),
+		m_ProbeList (NULL),
+		m_ProbeStart (0),
+		m_ProbeCount (0),
+		m_CurrentProbe (-1),
+		m_Jobs (&JobSystemClass::Get_Shared ()),
+		m_HeightJobStart (0)
 {
+	m_ProbeList = new PATHFIND_PROBE[PROBE_BATCH_SIZE * DIR_MAX];
+
 	RenderObjClass *commando_obj = NULL;
 
 	//
@@ -253,6 +270,8 @@ PathfindSectorBuilderClass::~PathfindSectorBuilderClass (void)
 		m_DirInfo = NULL;
 	}
 
+	delete [] m_ProbeList;
+	m_ProbeList = NULL;
 	return ;
 }
 
@@ -514,6 +533,12 @@ PathfindSectorBuilderClass::Compress_Sectors_For_Pathfind (void)
 void
 PathfindSectorBuilderClass::Generate_Sectors (void)
 {
+	DWORD before_ticks = ::GetTickCount ();
+
+	m_ProbeStart	= 0;
+	m_ProbeCount	= 0;
+	m_CurrentProbe	= -1;
+
 	//
 	//	Start floodfilling from each of the start points
 	//
@@ -539,22 +564,149 @@ PathfindSectorBuilderClass::Generate_Sectors (void)
 	}
 
 	//
-	//	Process all the floodfill boxes that have been queued up
+	//	Process all the floodfill boxes that have been queued up, in the order
+	// they were queued.  When the job system has threads, the step probes for
+	// the boxes at the front of the queue are run as jobs ahead of time.  The probes
+	// only read the level, and their results are still used in the order the
+	// single threaded floodfill makes them, so the boxes come out the same.
 	//
-	while (m_FloodFillProcessList.Count () > 0) {
+	int head = 0;
+	while (head < m_FloodFillProcessList.Count ()) {
+
+		if (	m_Jobs->Is_Deterministic () == false &&
+				head >= m_ProbeStart + m_ProbeCount &&
+				m_pDialog->Was_Cancelled () == false)
+		{
+			Probe_Batch (head);
+		}
 
 		//
-		//	Pop a floodfill box off the list and process its neighbors
+		//	Take the next floodfill box off the list and process its neighbors
 		//
-		m_CurrentSector = m_FloodFillProcessList[0];
-		m_FloodFillProcessList.Delete (0);
+		m_CurrentSector	= m_FloodFillProcessList[head];
+		m_CurrentProbe		= (head < m_ProbeStart + m_ProbeCount) ? (head - m_ProbeStart) : -1;
+		head ++;
 
-		AABoxClass box	= Get_Body_Box_Bounds (m_CurrentSector);
-		Vector3 pos		= box.Center;
-		pos.Z				= box.Center.Z - box.Extent.Z + (m_SimBoundingBox.Z * 0.5F);
-		Floodfill (pos);
+		Floodfill (Get_Floodfill_Pos (m_CurrentSector));
 	}
 
+	m_FloodFillProcessList.Delete_All ();
+	m_ProbeCount	= 0;
+	m_CurrentProbe	= -1;
+
+	DWORD after_ticks = ::GetTickCount ();
+	WWDEBUG_SAY(("Time spent floodfilling: %d secs (%d threads).\r\n", (after_ticks-before_ticks)/1000, m_Jobs->Get_Thread_Count ()));
+	return ;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+//	Probe_Batch
+//
+//	Runs the step probes for the next batch of boxes in the floodfill
+// queue as jobs.  Directions that already have a neighbor are skipped;
+// if one of them loses it before the box is processed, the floodfill
+// makes that probe itself.
+//
+//////////////////////////////////////////////////////////////////////////
+void
+PathfindSectorBuilderClass::Probe_Batch (int first_box)
+{
+	m_ProbeStart = first_box;
+	m_ProbeCount = std::min (m_FloodFillProcessList.Count () - first_box, (int)PROBE_BATCH_SIZE);
+
+	for (int index = 0; index < m_ProbeCount; index ++) {
+		FloodfillBoxClass *body_box = m_FloodFillProcessList[first_box + index];
+		for (int dir = 0; dir < DIR_MAX; dir ++) {
+			PATHFIND_PROBE &probe	= m_ProbeList[(index * DIR_MAX) + dir];
+			probe.is_probed			= (body_box->Peek_Neighbor (PATHFIND_DIR(dir)) == NULL);
+			probe.is_valid				= false;
+		}
+	}
+
+	//
+	//	Let the dynamic culling system know it will be queried from several
+	// threads at once.
+	//
+	PhysParallelQueryClass parallel_query;
+	Run_Parallel_Jobs (JOB_PROBE, m_ProbeCount);
+	return ;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+//	Run_Parallel_Jobs
+//
+//	Runs the given jobs on the job system and returns once they are all
+// done.  The jobs run with the floating point settings of the calling
+// thread, so the probes come out exactly the same on any thread.
+//
+//////////////////////////////////////////////////////////////////////////
+void
+PathfindSectorBuilderClass::Run_Parallel_Jobs (int job_type, int job_count)
+{
+	unsigned int fp_control = ::_controlfp (0, 0);
+
+	m_Jobs->Parallel_For (job_count, JOB_BATCH_SIZE, [this, job_type, fp_control] (int first_job, int last_job)
+	{
+#if defined(_M_IX86)
+		unsigned int mask = _MCW_PC | _MCW_RC;
+#else
+		unsigned int mask = _MCW_RC;
+#endif
+		unsigned int old_control = ::_controlfp (0, 0);
+		::_controlfp (fp_control, mask);
+		Run_Jobs (job_type, first_job, last_job);
+		::_controlfp (old_control, mask);
+	}, "Pathfind Build");
+
+	return ;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+//	Run_Jobs
+//
+//////////////////////////////////////////////////////////////////////////
+void
+PathfindSectorBuilderClass::Run_Jobs (int job_type, int first_job, int last_job)
+{
+	BODY_BOX_LIST list;
+
+	for (int job = first_job; job < last_job; job ++) {
+
+		if (job_type == JOB_PROBE) {
+
+			//
+			//	Probe every direction the floodfill will want to step in
+			//
+			Vector3 start_pos = Get_Floodfill_Pos (m_FloodFillProcessList[m_ProbeStart + job]);
+			for (int dir = 0; dir < DIR_MAX; dir ++) {
+				PATHFIND_PROBE &probe = m_ProbeList[(job * DIR_MAX) + dir];
+				if (probe.is_probed) {
+					Vector3 new_pos	= start_pos + m_DirInfo[dir].move;
+					probe.is_valid		= Try_Moving_Here (start_pos, new_pos, &probe.real_pos);
+				}
+			}
+
+		} else {
+
+			//
+			//	Find how far this box's sector can reach up and down
+			//
+			FloodfillBoxClass *body_box = m_BodyBoxReleaseList[m_HeightJobStart + job];
+
+			Vector3 pos	= body_box->Get_Position ();
+			float min_z	= pos.Z - (m_SimBoundingBox.Z * 500.0F);
+			float max_z	= pos.Z + (m_SimBoundingBox.Z * 500.0F);
+			Determine_Height (body_box, &min_z, &max_z, list);
+			body_box->Set_Min_Z_Pos (min_z);
+			body_box->Set_Max_Z_Pos (max_z);
+		}
+	}
 
 	return ;
 }
@@ -831,9 +983,21 @@ PathfindSectorBuilderClass::Do_Physics_Sim
 		Vector3 move_vector	= (m_DirInfo[direction].move);
 		Vector3 new_pos		= start_pos + move_vector;
 
+		//
+		//	Use the worker threads' probe if there is one
+		//
 		AABoxClass new_box;
+		bool is_valid = false;
+		if (m_CurrentProbe >= 0 && m_ProbeList[(m_CurrentProbe * DIR_MAX) + direction].is_probed) {
+			const PATHFIND_PROBE &probe	= m_ProbeList[(m_CurrentProbe * DIR_MAX) + direction];
+			is_valid								= probe.is_valid;
+			new_box								= probe.real_pos;
+		} else {
+			is_valid = Try_Moving_Here (start_pos, new_pos, &new_box);
+		}
+
 		//if (Try_Standing_Here (new_pos, &new_box)) {
-		if (Try_Moving_Here (start_pos, new_pos, &new_box)) {
+		if (is_valid) {
 			Submit_Box (m_CurrentSector, new_box, direction);
 		}
 	}
@@ -1179,7 +1343,8 @@ PathfindSectorBuilderClass::Determine_Height
 (
 	FloodfillBoxClass *	start_box,
 	float	*			min_z_pos,
-	float	*			max_z_pos
+	float	*			max_z_pos,
+	BODY_BOX_LIST &	list
 )
 {
 	AABoxClass box = Get_Body_Box_Bounds (start_box);
@@ -1191,8 +1356,7 @@ PathfindSectorBuilderClass::Determine_Height
 	//
 	//	Loop over all the body-boxes that exist above or below the starting box
 	//
-	m_BodyBoxCullingSystem.Collect_Boxes (box);
-	DynamicVectorClass<FloodfillBoxClass *> &list = m_BodyBoxCullingSystem.Get_Collection_List ();
+	m_BodyBoxCullingSystem.Collect_Boxes (box, list);
 	for (int index = 0; index < list.Count (); index ++) {
 		FloodfillBoxClass *body_box = list[index];
 
@@ -1258,22 +1422,21 @@ PathfindSectorBuilderClass::Build_Height_Values (void)
 	//
 	//	Backup the body-box list to ensure we delete them all...
 	//
+	m_HeightJobStart = m_BodyBoxReleaseList.Count ();
 	for (	FloodfillBoxClass *body_box = FloodfillBoxClass::Get_First ();
 			body_box != NULL;
 			body_box = body_box->Get_Next ())
 	{
 		m_BodyBoxReleaseList.Add (body_box);
-
-		Vector3 pos	= body_box->Get_Position ();
-		float min_z	= pos.Z - (m_SimBoundingBox.Z * 500.0F);
-		float max_z	= pos.Z + (m_SimBoundingBox.Z * 500.0F);
-		Determine_Height (body_box, &min_z, &max_z);
-		body_box->Set_Min_Z_Pos (min_z);
-		body_box->Set_Max_Z_Pos (max_z);
-
 		total_box_count ++;
 	}
 
+	//
+	//	Each box's height values only depend on the boxes around it, which
+	// nobody changes from here on, so they can all be found at once.
+	//
+	Run_Parallel_Jobs (JOB_HEIGHT, total_box_count);
+
 	int after_ticks = ::GetTickCount ();
 	WWDEBUG_SAY(("Time spent generating z-values: %d secs.\r\n", (after_ticks-before_ticks)/1000));
 
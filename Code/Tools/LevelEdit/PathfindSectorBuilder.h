@@ -48,6 +48,8 @@
 #include "floodfillgrid.h"
 #include "heightwatcher.h"
 #include "levelfeature.h"
+#include "jobsystem.h"
+
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -86,6 +88,21 @@ typedef DynamicVectorClass<LevelFeatureClass *>				LEVEL_FEATURE_LIST;
 typedef TypedAABTreeCullSystemClass<LevelFeatureClass>	LEVEL_FEATURE_CULLING_SYSTEM;
 
 
+//////////////////////////////////////////////////////////////////////////
+//	PATHFIND_PROBE
+//
+//	Result of one step probe (Try_Moving_Here) that a worker thread ran
+// ahead of the floodfill.
+//////////////////////////////////////////////////////////////////////////
+typedef struct _PATHFIND_PROBE
+{
+	bool			is_probed;
+	bool			is_valid;
+	AABoxClass	real_pos;
+
+} PATHFIND_PROBE;
+
+
 //////////////////////////////////////////////////////////////////////////
 //
 //	PathfindSectorBuilderClass
@@ -95,6 +112,14 @@ class PathfindSectorBuilderClass
 {
 public:
 
+	////////////////////////////////////////////////////////////////////
+	//	Public constants
+	////////////////////////////////////////////////////////////////////
+	enum
+	{
+		PROBE_BATCH_SIZE	= 1024,
+	};
+
 	////////////////////////////////////////////////////////////////////
 	//	Public constructors/destructors
 	////////////////////////////////////////////////////////////////////
@@ -129,6 +154,15 @@ public:
 	//
 	void						Allow_Water_Floodfill (bool onoff);
 
+	//
+	//	Threading.  The step probes of the floodfill and the height values
+	// of the compression run as jobs on this job system (the shared one
+	// unless told otherwise).  The generated sectors are the same whatever
+	// its thread count.
+	//
+	void						Set_Job_System (JobSystemClass *jobs)	{ WWASSERT (jobs != NULL); m_Jobs = jobs; }
+	JobSystemClass *		Get_Job_System (void) const				{ return m_Jobs; }
+
 protected:
 
 	////////////////////////////////////////////////////////////////////
@@ -153,7 +187,7 @@ protected:
 	void							Generate_Portals (void);
 	void							Free_Floodfill_Boxes (void);
 
-	void							Determine_Height (FloodfillBoxClass *start_box, float *min_z_pos, float *max_z_pos);
+	void							Determine_Height (FloodfillBoxClass *start_box, float *min_z_pos, float *max_z_pos, BODY_BOX_LIST &list);
 	int							Build_Height_Values (void);
 
 	void							Compress_Sectors (DynamicVectorClass<AABoxClass> *box_list = NULL);
@@ -192,6 +226,7 @@ protected:
 	//	Floodfill box methods
 	//
 	AABoxClass					Get_Body_Box_Bounds (FloodfillBoxClass *box);
+	Vector3						Get_Floodfill_Pos (FloodfillBoxClass *box);
 
 	//
 	//	User interface methods
@@ -202,6 +237,13 @@ protected:
 
 	bool							Is_Valid_Sector (FloodfillBoxClass **upper_left_ptr, int &cells_right, int &cells_down);
 
+	//
+	//	Job methods
+	//
+	void							Probe_Batch (int first_box);
+	void							Run_Parallel_Jobs (int job_type, int job_count);
+	void							Run_Jobs (int job_type, int first_job, int last_job);
+
 private:
 
 	////////////////////////////////////////////////////////////////////
@@ -239,6 +281,20 @@ private:
 	int									m_TotalBoxGuess;
 
 	float									m_MaxSectorDim;
+
+	//
+	//	Step probes for the boxes at the front of the floodfill queue
+	//
+	PATHFIND_PROBE *					m_ProbeList;
+	int									m_ProbeStart;
+	int									m_ProbeCount;
+	int									m_CurrentProbe;
+
+	//
+	//	Jobs
+	//
+	JobSystemClass *					m_Jobs;
+	int									m_HeightJobStart;
 };
 
 
@@ -251,6 +307,21 @@ PathfindSectorBuilderClass::Get_Body_Box_Bounds (FloodfillBoxClass *box)
 	return AABoxClass (box->Get_Position (), m_SimBoxExtents);
 }
 
+////////////////////////////////////////////////////////////////////
+//	Get_Floodfill_Pos
+//
+//	Where the floodfill steps out from: the middle of the box,
+// half a character above its floor.
+////////////////////////////////////////////////////////////////////
+inline Vector3
+PathfindSectorBuilderClass::Get_Floodfill_Pos (FloodfillBoxClass *box)
+{
+	AABoxClass bounds	= Get_Body_Box_Bounds (box);
+	Vector3 pos			= bounds.Center;
+	pos.Z					= bounds.Center.Z - bounds.Extent.Z + (m_SimBoundingBox.Z * 0.5F);
+	return pos;
+}
+
 ////////////////////////////////////////////////////////////////////
 //	Allow_Water_Floodfill
 ////////////////////////////////////////////////////////////////////
@@ -108,7 +108,9 @@
 #include "heightfieldeditor.h"
 #include "heightfieldmgr.h"
 #include "pathmgr.h"
+#include "jobsystem.h"
 #include <algorithm>
+#include <thread>
 
 
 //////////////////////////////////////////////////////////////////////
@@ -1884,10 +1886,22 @@ SceneEditorClass::Get_Render_Camera (void)
 //
 ////////////////////////////////////////////////////////////////
 void
-SceneEditorClass::Generate_Pathfind_Portals (void)
+SceneEditorClass::Generate_Pathfind_Portals (int thread_count)
 {
 	CWaitCursor wait_cursor;
 
+	//
+	//	The floodfiller runs its jobs on the shared job system.  Give it the
+	// requested number of threads for the build (zero means one per
+	// processor) and put it back afterwards.
+	//
+	JobSystemClass &jobs = JobSystemClass::Get_Shared ();
+	int old_thread_count = jobs.Get_Thread_Count ();
+	if (thread_count <= 0) {
+		thread_count = std::thread::hardware_concurrency ();
+	}
+	jobs.Set_Thread_Count (thread_count);
+
 	//
 	//	Create a pathfind floodfiller object
 	//
@@ -1924,6 +1938,7 @@ SceneEditorClass::Generate_Pathfind_Portals (void)
 	//	Cleanup
 	//
 	builder.Shutdown ();
+	jobs.Set_Thread_Count (old_thread_count);
 	return ;
 }
 
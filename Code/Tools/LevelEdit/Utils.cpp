@@ -2220,6 +2220,13 @@ Check_Editor_Version (void)
 //
 // Perform_Job
 //
+//	Runs a farm job file.  Its [Job Description] section names the level
+// to load (LVL), the file to write (Output) and the Type of job: VIS (the
+// default) or Pathfind.  LevelEdit runs one silently with -j=<job file>.
+// This is not headless: the whole editor still starts up (MFC, the main
+// frame and a render device), it just doesn't wait for any input, so
+// jobs need a Windows machine with a display.
+//
 /////////////////////////////////////////////////////////////////////////////
 void
 Perform_Job (LPCTSTR filename, bool delete_on_completion)
@@ -2237,7 +2244,27 @@ Perform_Job (LPCTSTR filename, bool delete_on_completion)
 	CString output_file;
 	::GetPrivateProfileString ("Job Description", "Output", "", output_file.GetBufferSetLength (MAX_PATH), MAX_PATH, filename);
 
-	if (level_file.GetLength () > 0) {
+	CString job_type;
+	::GetPrivateProfileString ("Job Description", "Type", "VIS", job_type.GetBufferSetLength (20), 20, filename);
+
+	if (level_file.GetLength () > 0 && job_type.CompareNoCase ("Pathfind") == 0) {
+
+		//
+		//	Load the requested level
+		//
+		::Get_Main_View ()->Allow_Repaint (false);
+		EditorSaveLoadClass::Load_Level (level_file);
+		::Get_Main_View ()->Allow_Repaint (true);
+
+		//
+		//	Floodfill the level and export the pathfind data to the given file.
+		// Threads=0 (the default) uses one thread per processor.
+		//
+		int thread_count = ::GetPrivateProfileInt ("Job Description", "Threads", 0, filename);
+		::Get_Scene_Editor ()->Generate_Pathfind_Portals (thread_count);
+		PathfindImportExportSaveLoadClass::Export_Pathfind (output_file);
+
+	} else if (level_file.GetLength () > 0) {
 
 		//
 		//	Load the requested level
@@ -0,0 +1,105 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// MemLogDiff.cpp : Compares memory snapshots written by WWMemoryLogClass (the game appends
+// one on every level load and unload once memlog_snapshot_file is set). Shows what each
+// memory category gained or lost between the first and last snapshot, or between every
+// pair of consecutive snapshots, optionally only the snapshots whose label contains some
+// text. Diffing the Unload_Level snapshots of a server that has been through a few map
+// rotations shows which categories don't come back down. Usage:
+//
+//   memlogdiff [-l] [-a] [-m label_text] snapshots.txt [more_snapshots.txt ...]
+
+#include "wwmemlog.h"
+#include "vector.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static void Print_Diff(const WWMemorySnapshotStruct & before,const WWMemorySnapshotStruct & after)
+{
+	char buffer[8192];
+	WWMemoryLogClass::Format_Snapshot_Diff(before,after,buffer,sizeof(buffer));
+	printf("%s\n",buffer);
+}
+
+int main(int argc, char* argv[])
+{
+	bool list = false;
+	bool all_pairs = false;
+	const char * match = NULL;
+	int arg = 1;
+	while (arg < argc && argv[arg][0] == '-') {
+		if (strcmp(argv[arg],"-l") == 0)								list = true;
+		else if (strcmp(argv[arg],"-a") == 0)						all_pairs = true;
+		else if (strcmp(argv[arg],"-m") == 0 && arg + 1 < argc)	match = argv[++arg];
+		else break;
+		arg++;
+	}
+	if (arg >= argc || argv[arg][0] == '-') {
+		printf("Usage - memlogdiff [-l] [-a] [-m label_text] snapshots.txt [more_snapshots.txt ...]\n");
+		return 1;
+	}
+
+	DynamicVectorClass<WWMemorySnapshotStruct> snapshots;
+	for (; arg < argc; arg++) {
+		if (WWMemoryLogClass::Read_Snapshots(argv[arg],snapshots) < 0) {
+			printf("%s: can't open\n",argv[arg]);
+			return 2;
+		}
+	}
+
+	DynamicVectorClass<int> selected;
+	for (int i = 0; i < snapshots.Count(); i++) {
+		if (match == NULL || strstr(snapshots[i].Label,match) != NULL) {
+			selected.Add(i);
+		}
+	}
+
+	if (list) {
+		for (int i = 0; i < selected.Count(); i++) {
+			const WWMemorySnapshotStruct & snapshot = snapshots[selected[i]];
+			int total = 0;
+			for (int c = 0; c < MEM_COUNT; c++) {
+				total += snapshot.Categories[c].Current;
+			}
+			time_t when = (time_t)snapshot.Time;
+			char when_text[64];
+			strftime(when_text,sizeof(when_text),"%Y-%m-%d %H:%M:%S",localtime(&when));
+			printf("%4d  %s  %10.1f KB  %s\n",i,when_text,total / 1024.0f,snapshot.Label);
+		}
+		printf("\n");
+	}
+
+	if (selected.Count() < 2) {
+		printf("%d snapshot(s) found, need two to compare\n",selected.Count());
+		return list ? 0 : 2;
+	}
+
+	if (all_pairs) {
+		for (int i = 1; i < selected.Count(); i++) {
+			Print_Diff(snapshots[selected[i - 1]],snapshots[selected[i]]);
+		}
+	}
+	if (!all_pairs || selected.Count() > 2) {
+		Print_Diff(snapshots[selected[0]],snapshots[selected[selected.Count() - 1]]);
+	}
+	return 0;
+}
@@ -0,0 +1,250 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ParticleBench.cpp : Headless particle update benchmark. Builds a field of moving
+// emitters with keyframed color, opacity, size, rotation and frame, then runs them for
+// a number of frames, timing how long it takes to bring the particle buffers up to
+// date (kinematic and visual state) one buffer at a time and through
+// ParticleBatchClass with one thread and up. No device is needed. Every batched run has
+// to end up with the same particles as the plain run. Usage:
+//
+//   particlebench [-e emitters] [-f frames] [-t max_threads]
+
+#include "jobsystem.h"
+#include "part_buf.h"
+#include "part_emt.h"
+#include "partbatch.h"
+#include "shader.h"
+#include "v3_rnd.h"
+#include "w3d_file.h"
+#include "ww3d.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+struct BenchConfigStruct
+{
+	int	Emitters;
+	int	Frames;
+	int	MaxThreads;
+};
+
+struct BenchResultStruct
+{
+	bool operator== (const BenchResultStruct &)	{ return false; }
+	bool operator!= (const BenchResultStruct &)	{ return true; }
+
+	int						Count;
+	AABoxClass				Box;
+};
+
+enum
+{
+	START_TIME = 1000,
+	FRAME_TIME = 33,
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+/*
+** Emitter i of the field.  The position and velocity randomizers have no extent, so
+** emitting is repeatable; the spread comes from the emitters moving and from the
+** keyframe randomizer tables, which the clones in each run share with these.
+*/
+static ParticleEmitterClass * Create_Emitter(int i)
+{
+	float color_times[2] = { 0.5f, 1.5f };
+	Vector3 color_values[2] = { Vector3(1.0f,0.5f,0.1f), Vector3(0.2f,0.2f,0.2f) };
+	ParticlePropertyStruct<Vector3> color = { Vector3(1,1,0.5f), Vector3(0.1f,0.1f,0.1f), 2, color_times, color_values };
+
+	float opacity_times[2] = { 0.25f, 2.0f };
+	float opacity_values[2] = { 1.0f, 0.0f };
+	ParticlePropertyStruct<float> opacity = { 0.5f, 0.1f, 2, opacity_times, opacity_values };
+
+	float size_times[1] = { 1.0f };
+	float size_values[1] = { 2.0f };
+	ParticlePropertyStruct<float> size = { 0.25f, 0.1f, 1, size_times, size_values };
+
+	float rotation_times[1] = { 1.0f };
+	float rotation_values[1] = { 0.5f };
+	ParticlePropertyStruct<float> rotation = { 2.0f, 0.5f, 1, rotation_times, rotation_values };
+
+	float frame_times[1] = { 2.0f };
+	float frame_values[1] = { 15.0f };
+	ParticlePropertyStruct<float> frames = { 0.0f, 2.0f, 1, frame_times, frame_values };
+
+	ParticlePropertyStruct<float> blur_times = { 0.0f, 0.0f, 0, NULL, NULL };
+
+	float emit_rate = 60.0f + 20.0f * (i % 5);
+	float max_age = 2.0f + (float)(i % 3);
+	Vector3 base_vel(0.5f * (i % 7) - 1.5f,0.5f * (i % 3) - 0.5f,4.0f);
+	Vector3 accel(0.0f,0.0f,(i & 1) ? -9.8f : 0.0f);
+
+	ParticleEmitterClass * emitter = new ParticleEmitterClass(
+		emit_rate,1 + (i % 3),
+		new Vector3SolidBoxRandomizer(Vector3(0,0,0)),base_vel,
+		new Vector3SolidBoxRandomizer(Vector3(0,0,0)),0.0f,0.0f,
+		color,opacity,size,rotation,0.25f,frames,blur_times,
+		accel,max_age,NULL,ShaderClass::_PresetAdditiveSpriteShader,0,0,false,
+		W3D_EMITTER_RENDER_MODE_QUAD_PARTICLES,W3D_EMITTER_FRAME_MODE_4x4,NULL);
+	return emitter;
+}
+
+static void Move_Emitter(ParticleEmitterClass * emitter,int i,int frame)
+{
+	float angle = 0.05f * frame + 0.7f * i;
+	Matrix3D tm(true);
+	tm.Rotate_Z(angle);
+	tm.Set_Translation(Vector3(10.0f * (i % 16) + 3.0f * cosf(angle),10.0f * (i / 16) + 3.0f * sinf(angle),0.0f));
+	emitter->Set_Transform(tm);
+}
+
+/*
+** Runs clones of the emitters through the frames. threads == 0 updates each buffer in
+** turn, otherwise the buffers go through ParticleBatchClass with that many threads. Only
+** the buffer updates are timed, not the emitting.
+*/
+static double Run(const DynamicVectorClass<ParticleEmitterClass *> & emitters,const BenchConfigStruct & config,int threads,DynamicVectorClass<BenchResultStruct> & results,int & particle_count)
+{
+	WW3D::Sync(START_TIME);
+	WW3D::Sync(START_TIME);
+
+	DynamicVectorClass<ParticleEmitterClass *> clones;
+	for (int i = 0; i < emitters.Count(); i++) {
+		ParticleEmitterClass * clone = (ParticleEmitterClass *)emitters[i]->Clone();
+		Move_Emitter(clone,i,0);
+		clone->Start();
+		clones.Add(clone);
+	}
+
+	JobSystemClass jobs;
+	jobs.Set_Thread_Count(threads > 0 ? threads : 1);
+
+	ParticleBatchClass batch;
+	batch.Set_Job_System(&jobs);
+
+	double ms = 0.0;
+	particle_count = 0;
+	for (int frame = 1; frame <= config.Frames; frame++) {
+		WW3D::Sync(START_TIME + frame * FRAME_TIME);
+		for (int i = 0; i < clones.Count(); i++) {
+			Move_Emitter(clones[i],i,frame);
+			clones[i]->Emit();
+		}
+
+		BenchClock::time_point start = BenchClock::now();
+		for (int i = 0; i < clones.Count(); i++) {
+			if (threads == 0) {
+				clones[i]->Peek_Buffer()->Update_State(true);
+			} else {
+				batch.Add(clones[i]->Peek_Buffer(),true);
+			}
+		}
+		batch.Update();
+		ms += Elapsed_Ms(start);
+
+		for (int i = 0; i < clones.Count(); i++) {
+			particle_count += clones[i]->Peek_Buffer()->Get_Particle_Count();
+		}
+	}
+
+	results.Reset_Active();
+	for (int i = 0; i < clones.Count(); i++) {
+		ParticleBufferClass * buffer = clones[i]->Peek_Buffer();
+		BenchResultStruct result;
+		result.Count = buffer->Get_Particle_Count();
+		buffer->Get_Obj_Space_Bounding_Box(result.Box);
+		results.Add(result);
+		clones[i]->Release_Ref();
+	}
+	return ms;
+}
+
+static bool Results_Match(const DynamicVectorClass<BenchResultStruct> & a,const DynamicVectorClass<BenchResultStruct> & b)
+{
+	if (a.Count() != b.Count()) {
+		return false;
+	}
+	for (int i = 0; i < a.Count(); i++) {
+		if (	a[i].Count != b[i].Count ||
+				memcmp(&a[i].Box.Center,&b[i].Box.Center,sizeof(Vector3)) != 0 ||
+				memcmp(&a[i].Box.Extent,&b[i].Box.Extent,sizeof(Vector3)) != 0	)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 256, 300, 8 };
+	int arg = 1;
+	while (arg + 1 < argc && argv[arg][0] == '-') {
+		int value = atoi(argv[arg + 1]);
+		if (strcmp(argv[arg],"-e") == 0)			config.Emitters = value;
+		else if (strcmp(argv[arg],"-f") == 0)	config.Frames = value;
+		else if (strcmp(argv[arg],"-t") == 0)	config.MaxThreads = value;
+		else break;
+		arg += 2;
+	}
+	if (	arg < argc || config.Emitters < 1 || config.Frames < 1 ||
+			config.MaxThreads < 1 || config.MaxThreads > JobSystemClass::MAX_THREADS)
+	{
+		printf("Usage - particlebench [-e emitters] [-f frames] [-t max_threads]\n");
+		return 1;
+	}
+
+	WW3D::Sync(START_TIME);
+	DynamicVectorClass<ParticleEmitterClass *> emitters;
+	for (int i = 0; i < config.Emitters; i++) {
+		emitters.Add(Create_Emitter(i));
+	}
+
+	DynamicVectorClass<BenchResultStruct> serial;
+	int particle_count = 0;
+	double serial_ms = Run(emitters,config,0,serial,particle_count);
+	printf("%d emitters, %d frames, %.0f particles per frame\n",
+		config.Emitters,config.Frames,(double)particle_count / config.Frames);
+	printf("Update_State one buffer at a time: %.3f ms/frame, %.1f ns/particle\n",
+		serial_ms / config.Frames,serial_ms * 1000000.0 / (particle_count > 0 ? particle_count : 1));
+
+	bool all_match = true;
+	for (int threads = 1; threads <= config.MaxThreads; threads *= 2) {
+		DynamicVectorClass<BenchResultStruct> batched;
+		int batched_count = 0;
+		double ms = Run(emitters,config,threads,batched,batched_count);
+		bool match = (batched_count == particle_count) && Results_Match(serial,batched);
+		all_match &= match;
+		printf("ParticleBatchClass, %d thread(s): %.3f ms/frame, speedup %.2fx (%s)\n",
+			threads,ms / config.Frames,serial_ms / ms,match ? "results match" : "RESULTS DIFFER");
+	}
+
+	for (int i = 0; i < emitters.Count(); i++) {
+		emitters[i]->Release_Ref();
+	}
+	return all_match ? 0 : 2;
+}
@@ -0,0 +1,214 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// PhysBench.cpp : Headless physics timestep benchmark. Builds a scene of
+// piles of rigid bodies dropped onto a ground box, runs it once with the
+// serial timestep and once per thread count with the island timestep, and
+// checks that every body ends up within a small distance of where the
+// serial run put it. The island timestep changes the order islands are
+// stepped in, so the runs aren't expected to agree to the last bit. Usage:
+//
+//   physbench [-p piles] [-n bodies_per_pile] [-f frames] [-t max_threads]
+
+#include "pscene.h"
+#include "rbody.h"
+#include "staticphys.h"
+#include "boxrobj.h"
+#include "wwphys.h"
+#include "jobsystem.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static const float FRAME_TIME = 1.0f / 30.0f;
+static const float MAX_DRIFT = 0.001f;
+
+struct BenchConfigStruct
+{
+	int	Piles;
+	int	BodiesPerPile;
+	int	Frames;
+	int	MaxThreads;
+};
+
+struct BodyStateStruct
+{
+	Matrix3D	Transform;
+	Vector3	Velocity;
+	Vector3	AngularVelocity;
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+/*
+** Runs the scene once. Without a job system it uses the serial timestep, otherwise
+** the island timestep on the given job system.
+*/
+static double Run_Scene(const BenchConfigStruct & config,JobSystemClass * jobs,DynamicVectorClass<BodyStateStruct> & results)
+{
+	PhysicsSceneClass * scene = new PhysicsSceneClass;
+	scene->Enable_Collision_Detection(0,0);
+
+	/*
+	** A ground box big enough for all of the piles.
+	*/
+	int piles_per_row = 1;
+	while (piles_per_row * piles_per_row < config.Piles) {
+		piles_per_row++;
+	}
+	const float pile_spacing = 12.0f;
+	const float ground_size = piles_per_row * pile_spacing;
+
+	RenderObjClass * ground_model = new OBBoxRenderObjClass(OBBoxClass(Vector3(0,0,-1.0f),Vector3(ground_size,ground_size,1.0f)));
+	ground_model->Set_Collision_Type(COLLISION_TYPE_PHYSICAL);
+	StaticPhysClass * ground = new StaticPhysClass;
+	ground->Set_Model(ground_model);
+	ground_model->Release_Ref();
+	scene->Add_Static_Object(ground);
+	scene->Re_Partition_Static_Objects();
+
+	/*
+	** Each pile is a loose stack of boxes with a little jitter, so they tumble
+	** into each other but the piles stay apart.
+	*/
+	DynamicVectorClass<RigidBodyClass *> bodies;
+	srand(1);
+	for (int pile = 0; pile < config.Piles; pile++) {
+		Vector3 base(	(pile % piles_per_row) * pile_spacing - ground_size * 0.5f + pile_spacing * 0.5f,
+							(pile / piles_per_row) * pile_spacing - ground_size * 0.5f + pile_spacing * 0.5f,
+							0.5f	);
+
+		for (int i = 0; i < config.BodiesPerPile; i++) {
+			Vector3 pos = base + Vector3(	(rand() % 100) * 0.004f - 0.2f,
+													(rand() % 100) * 0.004f - 0.2f,
+													i * 1.1f	);
+
+			RenderObjClass * model = new OBBoxRenderObjClass(OBBoxClass(Vector3(0,0,0),Vector3(0.5f,0.5f,0.5f)));
+			model->Set_Collision_Type(COLLISION_TYPE_PHYSICAL);
+
+			RigidBodyClass * body = new RigidBodyClass;
+			body->Set_Model(model);
+			model->Release_Ref();
+			body->Set_Mass(1.0f);
+			body->Set_Position(pos);
+			scene->Add_Dynamic_Object(body);
+			bodies.Add(body);
+		}
+	}
+	scene->Re_Partition_Dynamic_Culling_System();
+
+	if (jobs != NULL) {
+		scene->Enable_Island_Timestep(true);
+		scene->Set_Job_System(jobs);
+	}
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int frame = 0; frame < config.Frames; frame++) {
+		scene->Update(FRAME_TIME,frame + 1);
+	}
+	double ms = Elapsed_Ms(start);
+
+	if (jobs != NULL) {
+		const PhysIslandSchedulerClass::StatsStruct & stats = scene->Get_Island_Statistics();
+		printf("  last frame: %d objects, %d islands (%d serial), largest island %d\n",
+			stats.ObjectCount,stats.IslandCount,stats.SerialIslandCount,stats.LargestIsland);
+	}
+
+	results.Delete_All();
+	for (int i = 0; i < bodies.Count(); i++) {
+		BodyStateStruct state;
+		state.Transform = bodies[i]->Get_Transform();
+		bodies[i]->Get_Velocity(&state.Velocity);
+		bodies[i]->Get_Angular_Velocity(&state.AngularVelocity);
+		results.Add(state);
+
+		scene->Remove_Object(bodies[i]);
+		bodies[i]->Release_Ref();
+	}
+	scene->Remove_Object(ground);
+	ground->Release_Ref();
+	scene->Release_Ref();
+	return ms;
+}
+
+/*
+** Largest distance between where a body ended up in the two runs.
+*/
+static float Max_Drift(const DynamicVectorClass<BodyStateStruct> & a,const DynamicVectorClass<BodyStateStruct> & b)
+{
+	if (a.Count() != b.Count()) {
+		return HUGE_VALF;
+	}
+	float drift = 0.0f;
+	for (int i = 0; i < a.Count(); i++) {
+		Vector3 delta = a[i].Transform.Get_Translation() - b[i].Transform.Get_Translation();
+		drift = MAX(drift,delta.Length());
+	}
+	return drift;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 64, 8, 300, 8 };
+	for (int i = 1; i + 1 < argc; i += 2) {
+		int value = atoi(argv[i + 1]);
+		if (strcmp(argv[i],"-p") == 0)			config.Piles = value;
+		else if (strcmp(argv[i],"-n") == 0)		config.BodiesPerPile = value;
+		else if (strcmp(argv[i],"-f") == 0)		config.Frames = value;
+		else if (strcmp(argv[i],"-t") == 0)		config.MaxThreads = value;
+	}
+	if (	(argc % 2) == 0 || config.Piles < 1 || config.BodiesPerPile < 1 || config.Frames < 1 ||
+			config.MaxThreads < 1 || config.MaxThreads > JobSystemClass::MAX_THREADS)
+	{
+		printf("Usage - physbench [-p piles] [-n bodies_per_pile] [-f frames] [-t max_threads]\n");
+		return 1;
+	}
+
+	WWPhys::Init();
+
+	printf("%d piles of %d bodies, %d frames\n",config.Piles,config.BodiesPerPile,config.Frames);
+
+	DynamicVectorClass<BodyStateStruct> serial;
+	double serial_ms = Run_Scene(config,NULL,serial);
+	printf("serial timestep: %.3f ms/frame\n",serial_ms / config.Frames);
+
+	bool all_match = true;
+	for (int threads = 1; threads <= config.MaxThreads; threads *= 2) {
+		JobSystemClass jobs;
+		jobs.Set_Thread_Count(threads);
+
+		DynamicVectorClass<BodyStateStruct> islands;
+		double ms = Run_Scene(config,&jobs,islands);
+		float drift = Max_Drift(serial,islands);
+		bool match = (drift <= MAX_DRIFT);
+		all_match &= match;
+		printf("island timestep, %d thread(s): %.3f ms/frame, speedup %.2fx, max drift %g (%s)\n",
+			threads,ms / config.Frames,serial_ms / ms,drift,match ? "results match" : "RESULTS DIFFER");
+	}
+
+	WWPhys::Shutdown();
+	return all_match ? 0 : 2;
+}
@@ -0,0 +1,238 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// RefCountBench.cpp : Reference counting benchmark. Times Add_Ref/Release_Ref pairs on
+// RefCountClass objects as this build counts them (plain or atomic, see
+// W3D_BUILD_OPTION_ATOMIC_REFCOUNTS), next to the same loop on a plain int and on a
+// std::atomic<int>, so the cost of the atomic policy can be read off one run. Then each
+// thread count from one up releases and add-refs its own objects and, in atomic builds,
+// a set of shared objects; every count has to end up back where it started. Usage:
+//
+//   refcountbench [-n objects] [-r repeats] [-t max_threads]
+
+#include "refcount.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+struct BenchConfigStruct
+{
+	int	Objects;
+	int	Repeats;
+	int	MaxThreads;
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+class BenchObjectClass : public RefCountClass
+{
+public:
+	int	Payload[4];
+};
+
+/*
+** Stand-ins for the two count policies, laid out like a small ref counted object so the
+** loops touch memory the same way.
+*/
+struct PlainCountStruct
+{
+	void *	VTable;
+	int		NumRefs;
+	int		Payload[4];
+};
+
+struct AtomicCountStruct
+{
+	void *				VTable;
+	std::atomic<int>	NumRefs;
+	int					Payload[4];
+};
+
+/*
+** Add-ref and release each object, as passing a pointer around does.  The objects are
+** walked in a scrambled order so the loop isn't just streaming memory.
+*/
+static void Ref_Objects(BenchObjectClass ** objects,int count,int repeats)
+{
+	for (int repeat = 0; repeat < repeats; repeat++) {
+		for (int i = 0; i < count; i++) {
+			BenchObjectClass * obj = objects[(i * 7919) % count];
+			obj->Add_Ref();
+			obj->Release_Ref();
+		}
+	}
+}
+
+static double Time_Ref_Counts(std::vector<BenchObjectClass *> & objects,const BenchConfigStruct & config)
+{
+	BenchClock::time_point start = BenchClock::now();
+	Ref_Objects(&objects[0],(int)objects.size(),config.Repeats);
+	return Elapsed_Ms(start);
+}
+
+static double Time_Plain_Counts(std::vector<PlainCountStruct> & counts,const BenchConfigStruct & config)
+{
+	int count = (int)counts.size();
+	BenchClock::time_point start = BenchClock::now();
+	for (int repeat = 0; repeat < config.Repeats; repeat++) {
+		for (int i = 0; i < count; i++) {
+			volatile int * refs = &counts[(i * 7919) % count].NumRefs;
+			*refs = *refs + 1;
+			int count_left = *refs - 1;
+			*refs = count_left;
+			if (count_left == 0) abort();
+		}
+	}
+	return Elapsed_Ms(start);
+}
+
+static double Time_Atomic_Counts(std::vector<AtomicCountStruct> & counts,const BenchConfigStruct & config)
+{
+	int count = (int)counts.size();
+	BenchClock::time_point start = BenchClock::now();
+	for (int repeat = 0; repeat < config.Repeats; repeat++) {
+		for (int i = 0; i < count; i++) {
+			std::atomic<int> & refs = counts[(i * 7919) % count].NumRefs;
+			refs.fetch_add(1,std::memory_order_relaxed);
+			if (refs.fetch_sub(1,std::memory_order_acq_rel) == 1) abort();
+		}
+	}
+	return Elapsed_Ms(start);
+}
+
+/*
+** Runs the threads, each on objects of its own and, if shared isn't empty, on the shared
+** objects as well.  Every object still holds only the reference it was created with.
+*/
+static double Run_Threads(int threads,std::vector<BenchObjectClass *> & objects,std::vector<BenchObjectClass *> & shared,const BenchConfigStruct & config,bool & match)
+{
+	int per_thread = (int)objects.size() / threads;
+	std::vector<std::thread> workers;
+	BenchClock::time_point start = BenchClock::now();
+	for (int t = 0; t < threads; t++) {
+		workers.emplace_back([&,t] {
+			Ref_Objects(&objects[t * per_thread],per_thread,config.Repeats);
+			if (!shared.empty()) {
+				Ref_Objects(&shared[0],(int)shared.size(),config.Repeats);
+			}
+		});
+	}
+	for (std::thread & worker : workers) {
+		worker.join();
+	}
+	double ms = Elapsed_Ms(start);
+
+	match = true;
+	for (BenchObjectClass * obj : objects) {
+		match &= (obj->Num_Refs() == 1);
+	}
+	for (BenchObjectClass * obj : shared) {
+		match &= (obj->Num_Refs() == 1);
+	}
+	return ms;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 100000, 200, 8 };
+	int arg = 1;
+	while (arg + 1 < argc && argv[arg][0] == '-') {
+		int value = atoi(argv[arg + 1]);
+		if (strcmp(argv[arg],"-n") == 0)			config.Objects = value;
+		else if (strcmp(argv[arg],"-r") == 0)	config.Repeats = value;
+		else if (strcmp(argv[arg],"-t") == 0)	config.MaxThreads = value;
+		else break;
+		arg += 2;
+	}
+	if (arg < argc || config.Objects < 1 || config.Repeats < 1 || config.MaxThreads < 1) {
+		printf("Usage - refcountbench [-n objects] [-r repeats] [-t max_threads]\n");
+		return 1;
+	}
+
+#ifdef WWLIB_ATOMIC_REFCOUNTS
+	const bool atomic_build = true;
+#else
+	const bool atomic_build = false;
+#endif
+#ifdef NDEBUG
+	const char * build_name = "release";
+#else
+	const char * build_name = "debug";
+#endif
+	printf("%d objects, %d repeats, %s build with %s reference counts\n",
+		config.Objects,config.Repeats,build_name,atomic_build ? "atomic" : "plain");
+
+	std::vector<BenchObjectClass *> objects;
+	for (int i = 0; i < config.Objects; i++) {
+		objects.push_back(new BenchObjectClass);
+	}
+	std::vector<PlainCountStruct> plain_counts(config.Objects);
+	std::vector<AtomicCountStruct> atomic_counts(config.Objects);
+	for (int i = 0; i < config.Objects; i++) {
+		plain_counts[i].NumRefs = 1;
+		atomic_counts[i].NumRefs = 1;
+	}
+
+	double pairs = (double)config.Objects * config.Repeats;
+	double ref_ms = Time_Ref_Counts(objects,config);
+	double plain_ms = Time_Plain_Counts(plain_counts,config);
+	double atomic_ms = Time_Atomic_Counts(atomic_counts,config);
+	printf("RefCountClass:    %6.2f ns/pair\n",ref_ms * 1000000.0 / pairs);
+	printf("plain int:        %6.2f ns/pair\n",plain_ms * 1000000.0 / pairs);
+	printf("std::atomic<int>: %6.2f ns/pair (%.2fx plain)\n",atomic_ms * 1000000.0 / pairs,atomic_ms / plain_ms);
+
+	/*
+	** Plain counts can only be shared between threads that take turns, so only atomic
+	** builds hammer on the shared objects.
+	*/
+	std::vector<BenchObjectClass *> shared;
+	if (atomic_build) {
+		for (int i = 0; i < 16; i++) {
+			shared.push_back(new BenchObjectClass);
+		}
+	}
+
+	bool all_match = true;
+	for (int threads = 1; threads <= config.MaxThreads; threads *= 2) {
+		bool match = false;
+		double ms = Run_Threads(threads,objects,shared,config,match);
+		all_match &= match;
+		double thread_pairs = ((double)(config.Objects / threads) + shared.size()) * config.Repeats * threads;
+		printf("%d thread(s)%s: %.3f ms, %.2f ns/pair (%s)\n",
+			threads,shared.empty() ? "" : " with shared objects",ms,ms * 1000000.0 / thread_pairs,
+			match ? "results match" : "RESULTS DIFFER");
+	}
+
+	for (BenchObjectClass * obj : objects) {
+		obj->Release_Ref();
+	}
+	for (BenchObjectClass * obj : shared) {
+		obj->Release_Ref();
+	}
+	return all_match ? 0 : 2;
+}
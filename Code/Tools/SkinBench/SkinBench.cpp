@@ -0,0 +1,396 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// SkinBench.cpp : Headless skin deformation benchmark. Loads the skins, hierarchies
+// and animations out of real .w3d files, gives every skin a crowd of copies of its
+// hierarchy each playing an animation from a different frame, and times deforming
+// them all into vertex buffers the way the renderer did before skins were grouped by
+// bone (one bone lookup and matrix multiply per vertex) and through SkinBatchClass
+// with one thread and up. No device is needed. Every batched run has to end up bit
+// for bit where the per vertex run did. Usage:
+//
+//   skinbench [-n copies_per_skin] [-f frames] [-t max_threads] file.w3d ...
+//
+// Hierarchies are loaded from every file before any animations, so the skeleton and
+// its animations can come from different files. A skin uses the hierarchy named by
+// the HLod it belongs to, or the one with its container's name.
+
+#include "assetmgr.h"
+#include "chunkio.h"
+#include "dx8fvf.h"
+#include "hanim.h"
+#include "htree.h"
+#include "jobsystem.h"
+#include "meshmdl.h"
+#include "rawfile.h"
+#include "ramfile.h"
+#include "simplevec.h"
+#include "skinbatch.h"
+#include "w3d_file.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+struct BenchConfigStruct
+{
+	int	CopiesPerSkin;
+	int	Frames;
+	int	MaxThreads;
+};
+
+struct BenchHLodStruct
+{
+	bool operator== (const BenchHLodStruct &)	{ return false; }
+	bool operator!= (const BenchHLodStruct &)	{ return true; }
+
+	char						Name[W3D_NAME_LEN];
+	char						HierarchyName[W3D_NAME_LEN];
+};
+
+struct BenchSkinStruct
+{
+	bool operator== (const BenchSkinStruct &)	{ return false; }
+	bool operator!= (const BenchSkinStruct &)	{ return true; }
+
+	MeshModelClass *		Model;
+	HTreeClass *			Tree;
+	HAnimClass *			Anim;
+	HAnimCursorClass *	Cursor;
+	float						StartFrame;
+	int						FirstVertex;
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+/*
+** Feeds the asset manager just the top level chunks of one kind out of a .w3d file, so
+** the meshes and textures (which want a device) never get loaded.
+*/
+static bool Load_Chunks(WW3DAssetManager & assets,const char * filename,bool hierarchies)
+{
+	RawFileClass file(filename);
+	if (!file.Open(FileClass::READ)) {
+		printf("%s: can't open\n",filename);
+		return false;
+	}
+	int size = file.Size();
+	unsigned char * data = new unsigned char[size > 0 ? size : 1];
+	bool ok = (file.Read(data,size) == size);
+	file.Close();
+
+	unsigned char * filtered = new unsigned char[size > 0 ? size : 1];
+	int filtered_size = 0;
+	for (int offset = 0; ok && offset + 8 <= size; ) {
+		uint32 id;
+		uint32 length;
+		memcpy(&id,data + offset,4);
+		memcpy(&length,data + offset + 4,4);
+		length &= 0x7FFFFFFF;
+		if (length > (uint32)(size - offset - 8)) {
+			printf("%s: truncated chunk\n",filename);
+			break;
+		}
+
+		bool wanted = hierarchies ?
+			(id == W3D_CHUNK_HIERARCHY) :
+			(id == W3D_CHUNK_ANIMATION || id == W3D_CHUNK_COMPRESSED_ANIMATION);
+		if (wanted) {
+			memcpy(filtered + filtered_size,data + offset,length + 8);
+			filtered_size += length + 8;
+		}
+		offset += length + 8;
+	}
+
+	if (ok && filtered_size > 0) {
+		RAMFileClass ramfile(filtered,filtered_size);
+		assets.Load_3D_Assets(ramfile);
+	}
+
+	delete [] data;
+	delete [] filtered;
+	return ok;
+}
+
+/*
+** Loads the geometry of every skin in a .w3d file, skipping the materials, and the
+** headers of its HLods so the skins can be matched up with their hierarchies.
+*/
+static void Load_Skins(const char * filename,DynamicVectorClass<MeshModelClass *> & models,DynamicVectorClass<BenchHLodStruct> & hlods)
+{
+	RawFileClass file(filename);
+	if (!file.Open(FileClass::READ)) {
+		return;
+	}
+
+	ChunkLoadClass cload(&file);
+	while (cload.Open_Chunk()) {
+		if (cload.Cur_Chunk_ID() == W3D_CHUNK_MESH) {
+			MeshModelClass * model = NEW_REF(MeshModelClass,());
+			if (	model->MeshGeometryClass::Load_W3D(cload) == WW3D_ERROR_OK &&
+					model->Get_Flag(MeshGeometryClass::SKIN) && model->Get_Vertex_Bone_Links() != NULL	)
+			{
+				model->Update_Skin_Runs();
+				models.Add(model);
+			} else {
+				model->Release_Ref();
+			}
+		} else if (cload.Cur_Chunk_ID() == W3D_CHUNK_HLOD) {
+			W3dHLodHeaderStruct header;
+			if (	cload.Open_Chunk() && cload.Cur_Chunk_ID() == W3D_CHUNK_HLOD_HEADER &&
+					cload.Read(&header,sizeof(header)) == sizeof(header)	)
+			{
+				BenchHLodStruct hlod;
+				memcpy(hlod.Name,header.Name,W3D_NAME_LEN);
+				memcpy(hlod.HierarchyName,header.HierarchyName,W3D_NAME_LEN);
+				hlod.Name[W3D_NAME_LEN - 1] = 0;
+				hlod.HierarchyName[W3D_NAME_LEN - 1] = 0;
+				hlods.Add(hlod);
+				cload.Close_Chunk();
+			}
+		}
+		cload.Close_Chunk();
+	}
+	file.Close();
+}
+
+static HTreeClass * Find_Tree(WW3DAssetManager & assets,MeshModelClass * model,const DynamicVectorClass<BenchHLodStruct> & hlods)
+{
+	char container[2 * W3D_NAME_LEN];
+	strncpy(container,model->Get_Name(),sizeof(container) - 1);
+	container[sizeof(container) - 1] = 0;
+	char * dot = strchr(container,'.');
+	if (dot != NULL) {
+		*dot = 0;
+	}
+
+	for (int i = 0; i < hlods.Count(); i++) {
+		if (stricmp(hlods[i].Name,container) == 0 && hlods[i].HierarchyName[0] != 0) {
+			return assets.Get_HTree(hlods[i].HierarchyName);
+		}
+	}
+	return assets.Get_HTree(container);
+}
+
+static HAnimClass * Find_Anim(WW3DAssetManager & assets,const HTreeClass * tree)
+{
+	HAnimClass * found = NULL;
+	AssetIterator * iterator = assets.Create_HAnim_Iterator();
+	for (iterator->First(); found == NULL && !iterator->Is_Done(); iterator->Next()) {
+		HAnimClass * anim = assets.Get_HAnim(iterator->Current_Item_Name());
+		if (anim != NULL && stricmp(anim->Get_HName(),tree->Get_Name()) == 0) {
+			found = anim;
+		} else if (anim != NULL) {
+			anim->Release_Ref();
+		}
+	}
+	delete iterator;
+	return found;
+}
+
+static void Pose(const BenchSkinStruct & skin,int frame)
+{
+	Matrix3D root(true);
+	if (skin.Anim == NULL) {
+		skin.Tree->Base_Update(root);
+		return;
+	}
+	int frame_count = skin.Anim->Get_Num_Frames();
+	float anim_frame = (frame_count > 1) ? fmodf(skin.StartFrame + frame * 0.5f,(float)(frame_count - 1)) : 0.0f;
+	skin.Tree->Anim_Update(root,skin.Anim,anim_frame,skin.Cursor);
+}
+
+/*
+** What the renderer used to do for every skin: look up the bone of each vertex and
+** transform it on its own.
+*/
+static void Deform_Per_Vertex(const BenchSkinStruct & skin,VertexFormatXYZNDUV2 * verts)
+{
+	MeshModelClass * model = skin.Model;
+	const Vector3 * src_vert = model->Get_Vertex_Array();
+	const Vector3 * src_norm = model->Get_Vertex_Normal_Array();
+	const uint16 * bonelink = model->Get_Vertex_Bone_Links();
+	for (int vi = 0; vi < model->Get_Vertex_Count(); vi++) {
+		const Matrix3D & tm = skin.Tree->Get_Transform(bonelink[vi]);
+		Vector3 loc;
+		Vector3 norm;
+		Matrix3D::Transform_Vector(tm,src_vert[vi],&loc);
+		Matrix3D::Rotate_Vector(tm,src_norm[vi],&norm);
+		verts[vi].x = loc.X;
+		verts[vi].y = loc.Y;
+		verts[vi].z = loc.Z;
+		verts[vi].nx = norm.X;
+		verts[vi].ny = norm.Y;
+		verts[vi].nz = norm.Z;
+		verts[vi].diffuse = 0;
+		verts[vi].u1 = verts[vi].v1 = 0.0f;
+		verts[vi].u2 = verts[vi].v2 = 0.0f;
+	}
+}
+
+/*
+** Runs every skin through the frames. threads == 0 deforms them one vertex at a time,
+** otherwise the skins go through SkinBatchClass with that many threads. Only the
+** deforming is timed, not the posing.
+*/
+static double Run(const DynamicVectorClass<BenchSkinStruct> & skins,const BenchConfigStruct & config,int threads,SimpleVecClass<VertexFormatXYZNDUV2> & verts)
+{
+	JobSystemClass jobs;
+	jobs.Set_Thread_Count(threads > 0 ? threads : 1);
+
+	SkinBatchClass batch;
+	batch.Set_Job_System(&jobs);
+	memset(&verts[0],0,verts.Length() * sizeof(VertexFormatXYZNDUV2));
+
+	double ms = 0.0;
+	for (int frame = 0; frame < config.Frames; frame++) {
+		for (int i = 0; i < skins.Count(); i++) {
+			Pose(skins[i],frame);
+		}
+
+		BenchClock::time_point start = BenchClock::now();
+		for (int i = 0; i < skins.Count(); i++) {
+			if (threads == 0) {
+				Deform_Per_Vertex(skins[i],&verts[skins[i].FirstVertex]);
+			} else {
+				batch.Add(skins[i].Model,skins[i].Tree,&verts[skins[i].FirstVertex]);
+			}
+		}
+		batch.Update();
+		ms += Elapsed_Ms(start);
+	}
+	return ms;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 32, 300, 8 };
+	int first_file = 1;
+	while (first_file + 1 < argc && argv[first_file][0] == '-') {
+		int value = atoi(argv[first_file + 1]);
+		if (strcmp(argv[first_file],"-n") == 0)			config.CopiesPerSkin = value;
+		else if (strcmp(argv[first_file],"-f") == 0)		config.Frames = value;
+		else if (strcmp(argv[first_file],"-t") == 0)		config.MaxThreads = value;
+		else break;
+		first_file += 2;
+	}
+	if (	first_file >= argc || config.CopiesPerSkin < 1 || config.Frames < 1 ||
+			config.MaxThreads < 1 || config.MaxThreads > JobSystemClass::MAX_THREADS)
+	{
+		printf("Usage - skinbench [-n copies_per_skin] [-f frames] [-t max_threads] file.w3d ...\n");
+		return 1;
+	}
+
+	WW3DAssetManager assets;
+	DynamicVectorClass<MeshModelClass *> models;
+	DynamicVectorClass<BenchHLodStruct> hlods;
+	for (int i = first_file; i < argc; i++) {
+		Load_Chunks(assets,argv[i],true);
+	}
+	for (int i = first_file; i < argc; i++) {
+		Load_Chunks(assets,argv[i],false);
+		Load_Skins(argv[i],models,hlods);
+	}
+
+	/*
+	** A crowd of copies for every skin whose hierarchy was found.
+	*/
+	DynamicVectorClass<BenchSkinStruct> skins;
+	int skin_count = 0;
+	int vertex_count = 0;
+	int skin_vertex_count = 0;
+	int run_count = 0;
+	for (int mi = 0; mi < models.Count(); mi++) {
+		MeshModelClass * model = models[mi];
+		HTreeClass * tree = Find_Tree(assets,model,hlods);
+		if (tree == NULL) {
+			printf("%s: hierarchy not loaded, skipped\n",model->Get_Name());
+			continue;
+		}
+		HAnimClass * anim = Find_Anim(assets,tree);
+
+		for (int i = 0; i < config.CopiesPerSkin; i++) {
+			BenchSkinStruct skin;
+			skin.Model = model;
+			skin.Tree = new HTreeClass(*tree);
+			skin.Anim = anim;
+			skin.Cursor = NULL;
+			skin.StartFrame = 0.0f;
+			if (anim != NULL) {
+				anim->Add_Ref();
+				skin.Cursor = anim->Create_Cursor();
+				skin.StartFrame = (float)(i * anim->Get_Num_Frames()) / config.CopiesPerSkin;
+			}
+			skin.FirstVertex = vertex_count;
+			skins.Add(skin);
+			vertex_count += model->Get_Vertex_Count();
+		}
+		printf("%s: %d vertices in %d bone runs%s, %s\n",model->Get_Name(),model->Get_Vertex_Count(),
+			model->Get_Skin_Run_Count(),model->Is_Skin_Bone_Sorted() ? " (bone sorted)" : "",
+			anim != NULL ? anim->Get_Name() : "base pose");
+		skin_vertex_count += model->Get_Vertex_Count();
+		run_count += model->Get_Skin_Run_Count();
+		skin_count++;
+
+		if (anim != NULL) {
+			anim->Release_Ref();
+		}
+	}
+
+	if (skins.Count() == 0) {
+		printf("no skins with a loaded hierarchy\n");
+		return 1;
+	}
+	printf("%d skins, %d copies, %d vertices per frame, %.1f vertices per bone run, %d frames\n",
+		skin_count,skins.Count(),vertex_count,(double)skin_vertex_count / run_count,config.Frames);
+
+	SimpleVecClass<VertexFormatXYZNDUV2> serial(vertex_count);
+	double serial_ms = Run(skins,config,0,serial);
+	printf("Per vertex deform: %.3f ms/frame, %.2f ns/vertex\n",
+		serial_ms / config.Frames,serial_ms * 1000000.0 / ((double)config.Frames * vertex_count));
+
+	bool all_match = true;
+	SimpleVecClass<VertexFormatXYZNDUV2> batched(vertex_count);
+	for (int threads = 1; threads <= config.MaxThreads; threads *= 2) {
+		double ms = Run(skins,config,threads,batched);
+		bool match = (memcmp(&serial[0],&batched[0],vertex_count * sizeof(VertexFormatXYZNDUV2)) == 0);
+		all_match &= match;
+		printf("SkinBatchClass, %d thread(s): %.3f ms/frame, %.2f ns/vertex, speedup %.2fx (%s)\n",
+			threads,ms / config.Frames,ms * 1000000.0 / ((double)config.Frames * vertex_count),
+			serial_ms / ms,match ? "results match" : "RESULTS DIFFER");
+	}
+
+	for (int i = 0; i < skins.Count(); i++) {
+		delete skins[i].Cursor;
+		if (skins[i].Anim != NULL) {
+			skins[i].Anim->Release_Ref();
+		}
+		delete skins[i].Tree;
+	}
+	for (int i = 0; i < models.Count(); i++) {
+		models[i]->Release_Ref();
+	}
+	return all_match ? 0 : 2;
+}
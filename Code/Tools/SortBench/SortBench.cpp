@@ -0,0 +1,222 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// SortBench.cpp : Translucent polygon sort benchmark. Sorts depth keys the way the
+// sorting renderer does, with RadixSortClass and with std::sort and std::stable_sort on
+// an index array, and reports the time per key for each. The radix order has to match
+// the stable sort exactly. The keys come from synthetic distributions shaped like
+// what the renderer sees, plus any files given on the command line, which hold raw
+// floats as written by SortingRendererClass::Capture_Sort_Keys. Usage:
+//
+//   sortbench [-n keys] [-r repeats] [captured.keys ...]
+
+#include "radixsort.h"
+#include "random.h"
+#include "rawfile.h"
+#include "simplevec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+struct BenchConfigStruct
+{
+	int	Keys;
+	int	Repeats;
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static float Random_Float(RandomClass & random,float min,float max)
+{
+	return min + (max - min) * (float)random(0,32767) / 32767.0f;
+}
+
+/*
+** Synthetic key sets. View space depths are negative in front of the camera; the pool
+** is mostly built up far to near, with particle systems and glass panes adding clumps
+** of polygons at nearly the same depth.
+*/
+enum
+{
+	KEYS_UNIFORM,
+	KEYS_SORTED,
+	KEYS_REVERSED,
+	KEYS_NEARLY_SORTED,
+	KEYS_CLUSTERED,
+	KEYS_FEW_DEPTHS,
+	KEYS_COUNT
+};
+
+static const char * Key_Set_Name(int set)
+{
+	static const char * _names[KEYS_COUNT] = { "uniform", "sorted", "reversed", "nearly sorted", "clustered", "few depths" };
+	return _names[set];
+}
+
+static void Make_Keys(int set,int count,SimpleDynVecClass<float> & keys)
+{
+	RandomClass random(set + 1);
+	keys.Delete_All();
+	for (int i = 0; i < count; i++) {
+		switch (set) {
+		case KEYS_UNIFORM:
+		case KEYS_CLUSTERED:
+			keys.Add(Random_Float(random,-1000.0f,-1.0f));
+			break;
+		case KEYS_SORTED:
+		case KEYS_NEARLY_SORTED:
+			keys.Add(-1000.0f + 999.0f * i / count);
+			break;
+		case KEYS_REVERSED:
+			keys.Add(-1.0f - 999.0f * i / count);
+			break;
+		case KEYS_FEW_DEPTHS:
+			keys.Add(-10.0f * (float)random(1,16));
+			break;
+		}
+	}
+
+	if (set == KEYS_NEARLY_SORTED) {
+		for (int i = 0; i < count / 20; i++) {
+			std::swap(keys[random(0,32767) % count],keys[random(0,32767) % count]);
+		}
+	}
+
+	// Runs of a few hundred polygons within a unit of each other
+	if (set == KEYS_CLUSTERED) {
+		for (int i = 0; i < count; ) {
+			int run = std::min(random(64,512),count - i);
+			float center = keys[i];
+			for (int j = 0; j < run; j++) {
+				keys[i + j] = center + Random_Float(random,-0.5f,0.5f);
+			}
+			i += run;
+		}
+	}
+}
+
+static bool Load_Keys(const char * filename,SimpleDynVecClass<float> & keys)
+{
+	RawFileClass file(filename);
+	if (!file.Open(FileClass::READ)) {
+		printf("%s: can't open\n",filename);
+		return false;
+	}
+	int count = file.Size() / (int)sizeof(float);
+	keys.Delete_All();
+	keys.Resize(count);
+	for (int i = 0; i < count; i++) {
+		float key;
+		file.Read(&key,sizeof(key));
+		keys.Add(key);
+	}
+	file.Close();
+	return count > 0;
+}
+
+/*
+** Time each sort over the keys and check the radix order against the stable sort. The
+** comparison sorts compare the mapped keys so that -0 and 0 (and NaNs) end up in the same
+** order as the radix sort puts them.
+*/
+static bool Run(const char * name,const SimpleDynVecClass<float> & keys,const BenchConfigStruct & config,RadixSortClass & sorter)
+{
+	int count = keys.Count();
+	SimpleDynVecClass<unsigned> mapped(count);
+	SimpleDynVecClass<unsigned> order(count);
+	for (int i = 0; i < count; i++) {
+		mapped.Add(RadixSortClass::Float_To_Key(keys[i]));
+		order.Add(i);
+	}
+	auto less = [&](unsigned a,unsigned b) { return mapped[a] < mapped[b]; };
+
+	double radix_ms = 0.0;
+	double sort_ms = 0.0;
+	double stable_ms = 0.0;
+	const unsigned * radix_order = NULL;
+	for (int repeat = 0; repeat < config.Repeats; repeat++) {
+		BenchClock::time_point start = BenchClock::now();
+		radix_order = sorter.Sort(&keys[0],count);
+		radix_ms += Elapsed_Ms(start);
+
+		for (int i = 0; i < count; i++) {
+			order[i] = i;
+		}
+		start = BenchClock::now();
+		std::sort(&order[0],&order[0] + count,less);
+		sort_ms += Elapsed_Ms(start);
+
+		for (int i = 0; i < count; i++) {
+			order[i] = i;
+		}
+		start = BenchClock::now();
+		std::stable_sort(&order[0],&order[0] + count,less);
+		stable_ms += Elapsed_Ms(start);
+	}
+
+	bool match = (memcmp(radix_order,&order[0],count * sizeof(unsigned)) == 0);
+	double scale = 1000000.0 / ((double)config.Repeats * count);
+	printf("%-24s %8d keys  radix %6.2f ns/key  std::sort %6.2f (%.2fx)  std::stable_sort %6.2f (%.2fx)  %s\n",
+		name,count,radix_ms * scale,sort_ms * scale,sort_ms / radix_ms,stable_ms * scale,stable_ms / radix_ms,
+		match ? "order matches" : "ORDER DIFFERS");
+	return match;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfigStruct config = { 50000, 50 };
+	int first_file = 1;
+	while (first_file + 1 < argc && argv[first_file][0] == '-') {
+		int value = atoi(argv[first_file + 1]);
+		if (strcmp(argv[first_file],"-n") == 0)			config.Keys = value;
+		else if (strcmp(argv[first_file],"-r") == 0)		config.Repeats = value;
+		else break;
+		first_file += 2;
+	}
+	if (	(first_file < argc && argv[first_file][0] == '-') || config.Keys < 1 || config.Repeats < 1) {
+		printf("Usage - sortbench [-n keys] [-r repeats] [captured.keys ...]\n");
+		return 1;
+	}
+
+	RadixSortClass sorter;
+	SimpleDynVecClass<float> keys;
+	bool all_match = true;
+	for (int set = 0; set < KEYS_COUNT; set++) {
+		Make_Keys(set,config.Keys,keys);
+		all_match &= Run(Key_Set_Name(set),keys,config,sorter);
+	}
+
+	// A small pool too, where the insertion sort takes over
+	Make_Keys(KEYS_UNIFORM,20,keys);
+	all_match &= Run("uniform (small)",keys,config,sorter);
+
+	for (int i = first_file; i < argc; i++) {
+		if (Load_Keys(argv[i],keys)) {
+			all_match &= Run(argv[i],keys,config,sorter);
+		}
+	}
+	return all_match ? 0 : 2;
+}
@@ -0,0 +1,159 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// TexBench.cpp : Times the CPU side of texture loading (DXT decode and mipmap
+// generation) without needing a device. Usage:
+//
+//   texbench [-i iterations] [file.dds ...]
+//
+// With no files only the synthetic mipmap test is run.
+
+#include "bitmaphandler.h"
+#include "ddsfile.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static void Bench_Mipmap(unsigned width, unsigned height, int iterations)
+{
+	unsigned* src=new unsigned[width*height];
+	unsigned* dest=new unsigned[width*height];
+	unsigned* mip=new unsigned[(width/2)*(height/2)];
+	unsigned* ref=new unsigned[(width/2)*(height/2)];
+	srand(1);
+	for (unsigned i=0;i<width*height;++i) {
+		src[i]=(unsigned(rand())<<16)^unsigned(rand());
+	}
+
+	// Reference: the per pixel filter the row kernel replaced.
+	BenchClock::time_point start=BenchClock::now();
+	for (int it=0;it<iterations;++it) {
+		for (unsigned y=0;y<height/2;++y) {
+			const unsigned* row0=src+2*y*width;
+			const unsigned* row1=row0+width;
+			for (unsigned x=0;x<width/2;++x) {
+				ref[y*(width/2)+x]=BitmapHandlerClass::Combine_A8R8G8B8(row0[2*x],row0[2*x+1],row1[2*x],row1[2*x+1]);
+			}
+		}
+	}
+	double scalar_ms=Elapsed_Ms(start)/iterations;
+
+	start=BenchClock::now();
+	for (int it=0;it<iterations;++it) {
+		for (unsigned y=0;y<height/2;++y) {
+			BitmapHandlerClass::Mipmap_Row_A8R8G8B8(mip+y*(width/2),src+2*y*width,src+(2*y+1)*width,width/2);
+		}
+	}
+	double row_ms=Elapsed_Ms(start)/iterations;
+	bool match=memcmp(mip,ref,(width/2)*(height/2)*4)==0;
+
+	start=BenchClock::now();
+	for (int it=0;it<iterations;++it) {
+		BitmapHandlerClass::Copy_Image_Generate_Mipmap(
+			width,height,
+			(unsigned char*)dest,width*4,WW3D_FORMAT_A8R8G8B8,
+			(unsigned char*)src,width*4,WW3D_FORMAT_A8R8G8B8,
+			(unsigned char*)mip,(width/2)*4);
+	}
+	double copy_ms=Elapsed_Ms(start)/iterations;
+
+	start=BenchClock::now();
+	for (int it=0;it<iterations;++it) {
+		BitmapHandlerClass::Copy_Image_Generate_Mipmap(
+			width,height,
+			(unsigned char*)dest,width*2,WW3D_FORMAT_R5G6B5,
+			(unsigned char*)src,width*4,WW3D_FORMAT_A8R8G8B8,
+			(unsigned char*)mip,(width/2)*2);
+	}
+	double convert_ms=Elapsed_Ms(start)/iterations;
+
+	printf("mipmap %ux%u: scalar filter %.3f ms, row filter %.3f ms (%s), copy+mip A8R8G8B8 %.3f ms, copy+mip to R5G6B5 %.3f ms\n",
+		width,height,scalar_ms,row_ms,match ? "results match" : "RESULTS DIFFER",copy_ms,convert_ms);
+
+	delete[] src;
+	delete[] dest;
+	delete[] mip;
+	delete[] ref;
+}
+
+static void Bench_DDS(const char* filename, int iterations)
+{
+	DDSFileClass dds(filename,0);
+	BenchClock::time_point start=BenchClock::now();
+	bool loaded=dds.Load();
+	double load_ms=Elapsed_Ms(start);
+	if (!loaded) {
+		printf("%s: can't load\n",filename);
+		return;
+	}
+
+	unsigned width=dds.Get_Width(0);
+	unsigned height=dds.Get_Height(0);
+	unsigned char* surface=new unsigned char[width*height*4];
+
+	static const WW3DFormat _formats[]={ WW3D_FORMAT_A8R8G8B8, WW3D_FORMAT_R5G6B5 };
+	printf("%s: %ux%u, %u levels, load %.3f ms\n",filename,width,height,dds.Get_Mip_Level_Count(),load_ms);
+	for (unsigned f=0;f<sizeof(_formats)/sizeof(_formats[0]);++f) {
+		unsigned bpp=Get_Bytes_Per_Pixel(_formats[f]);
+		start=BenchClock::now();
+		for (int it=0;it<iterations;++it) {
+			for (unsigned level=0;level<dds.Get_Mip_Level_Count();++level) {
+				dds.Copy_Level_To_Surface(
+					level,
+					_formats[f],
+					dds.Get_Width(level),
+					dds.Get_Height(level),
+					surface,
+					dds.Get_Width(level)*bpp);
+			}
+		}
+		printf("  decode all levels to %d bpp: %.3f ms\n",bpp*8,Elapsed_Ms(start)/iterations);
+	}
+	delete[] surface;
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations=20;
+	int first_file=1;
+	if (argc>2 && strcmp(argv[1],"-i")==0) {
+		iterations=atoi(argv[2]);
+		first_file=3;
+	}
+	if (iterations<1) {
+		printf("Usage - texbench [-i iterations] [file.dds ...]\n");
+		return 1;
+	}
+
+	Bench_Mipmap(1024,1024,iterations);
+	Bench_Mipmap(257,129,iterations);
+
+	for (int i=first_file;i<argc;++i) {
+		Bench_DDS(argv[i],iterations);
+	}
+	return 0;
+}
@@ -0,0 +1,330 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// VertexCacheBench.cpp : Offline vertex cache report. Pulls the meshes out of .w3d
+// files (or every .w3d inside a .mix file), runs their triangle lists through the
+// StripOptimizerClass vertex cache, overdraw and vertex fetch passes and reports the
+// average cache miss ratio (transformed vertices per triangle) before and after,
+// along with the time the passes took. Every optimized list has to hold the same
+// triangles, with the same winding, as the original. Usage:
+//
+//   vertexcachebench [-c cache_size] [-v] file.w3d|file.mix ...
+//
+// -v prints a line for every mesh as well as the totals.
+
+#include "chunkio.h"
+#include "ffactory.h"
+#include "mixfile.h"
+#include "rawfile.h"
+#include "stripoptimizer.h"
+#include "vector3.h"
+#include "w3d_file.h"
+#include "wwstring.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+struct BenchMeshStruct
+{
+	bool operator== (const BenchMeshStruct &)	{ return false; }
+	bool operator!= (const BenchMeshStruct &)	{ return true; }
+
+	char						Name[2 * W3D_NAME_LEN];
+	int						PolyCount;
+	int						VertCount;
+	int *						Polys;
+	Vector3 *				Verts;
+};
+
+struct BenchResultStruct
+{
+	float						Original;
+	float						VertexCache;
+	float						Overdraw;
+	int						Clusters;
+	int						UsedVerts;
+	double					Ms;
+	bool						Match;
+};
+
+static double Elapsed_Ms(BenchClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+/*
+** Reads the vertices and triangles of one W3D_CHUNK_MESH.
+*/
+static void Load_Mesh(ChunkLoadClass & cload,DynamicVectorClass<BenchMeshStruct> & meshes)
+{
+	W3dMeshHeader3Struct header;
+	memset(&header,0,sizeof(header));
+	W3dVectorStruct * verts = NULL;
+	W3dTriStruct * tris = NULL;
+
+	while (cload.Open_Chunk()) {
+		switch (cload.Cur_Chunk_ID()) {
+		case W3D_CHUNK_MESH_HEADER3:
+			cload.Read(&header,sizeof(header));
+			break;
+		case W3D_CHUNK_VERTICES:
+			if (verts == NULL && header.NumVertices > 0) {
+				verts = new W3dVectorStruct[header.NumVertices];
+				cload.Read(verts,header.NumVertices * sizeof(W3dVectorStruct));
+			}
+			break;
+		case W3D_CHUNK_TRIANGLES:
+			if (tris == NULL && header.NumTris > 0) {
+				tris = new W3dTriStruct[header.NumTris];
+				cload.Read(tris,header.NumTris * sizeof(W3dTriStruct));
+			}
+			break;
+		}
+		cload.Close_Chunk();
+	}
+
+	if (verts != NULL && tris != NULL) {
+		BenchMeshStruct mesh;
+		snprintf(mesh.Name,sizeof(mesh.Name),"%.*s.%.*s",W3D_NAME_LEN,header.ContainerName,W3D_NAME_LEN,header.MeshName);
+		mesh.PolyCount = header.NumTris;
+		mesh.VertCount = header.NumVertices;
+		mesh.Polys = new int[mesh.PolyCount * 3];
+		mesh.Verts = new Vector3[mesh.VertCount];
+		for (int i = 0; i < mesh.VertCount; i++) {
+			mesh.Verts[i].Set(verts[i].X,verts[i].Y,verts[i].Z);
+		}
+		bool valid = true;
+		for (int i = 0; i < mesh.PolyCount; i++) {
+			for (int j = 0; j < 3; j++) {
+				valid &= (tris[i].Vindex[j] < header.NumVertices);
+				mesh.Polys[i * 3 + j] = (int)tris[i].Vindex[j];
+			}
+		}
+		if (valid) {
+			meshes.Add(mesh);
+		} else {
+			printf("%s: bad vertex index, skipped\n",mesh.Name);
+			delete [] mesh.Polys;
+			delete [] mesh.Verts;
+		}
+	}
+
+	delete [] verts;
+	delete [] tris;
+}
+
+static void Load_Meshes(FileClass & file,DynamicVectorClass<BenchMeshStruct> & meshes)
+{
+	ChunkLoadClass cload(&file);
+	while (cload.Open_Chunk()) {
+		if (cload.Cur_Chunk_ID() == W3D_CHUNK_MESH) {
+			Load_Mesh(cload,meshes);
+		}
+		cload.Close_Chunk();
+	}
+}
+
+static bool Is_Mix_File(const char * filename)
+{
+	int length = (int)strlen(filename);
+	return (length > 4) && (stricmp(filename + length - 4,".mix") == 0);
+}
+
+static void Load_File(const char * filename,DynamicVectorClass<BenchMeshStruct> & meshes)
+{
+	if (!Is_Mix_File(filename)) {
+		RawFileClass file(filename);
+		if (!file.Open(FileClass::READ)) {
+			printf("%s: can't open\n",filename);
+			return;
+		}
+		Load_Meshes(file,meshes);
+		file.Close();
+		return;
+	}
+
+	MixFileFactoryClass mix(filename,_TheFileFactory);
+	DynamicVectorClass<StringClass> names;
+	if (!mix.Is_Valid() || !mix.Build_Filename_List(names)) {
+		printf("%s: not a mix file\n",filename);
+		return;
+	}
+	for (int i = 0; i < names.Count(); i++) {
+		int length = names[i].Get_Length();
+		if (length < 4 || stricmp((const char *)names[i] + length - 4,".w3d") != 0) {
+			continue;
+		}
+		FileClass * file = mix.Get_File(names[i]);
+		if (file != NULL && file->Open(FileClass::READ)) {
+			Load_Meshes(*file,meshes);
+			file->Close();
+		}
+		mix.Return_File(file);
+	}
+}
+
+/*
+** Triangles rotated so the smallest index comes first (which keeps the winding) and sorted,
+** so two lists holding the same triangles in a different order come out equal.
+*/
+static void Canonical_Triangles(const int * tris,int count,const int * remap,int * out)
+{
+	for (int i = 0; i < count; i++) {
+		int a = remap[tris[i * 3]];
+		int b = remap[tris[i * 3 + 1]];
+		int c = remap[tris[i * 3 + 2]];
+		int * o = out + i * 3;
+		if (a <= b && a <= c) {
+			o[0] = a; o[1] = b; o[2] = c;
+		} else if (b <= a && b <= c) {
+			o[0] = b; o[1] = c; o[2] = a;
+		} else {
+			o[0] = c; o[1] = a; o[2] = b;
+		}
+	}
+
+	int * order = new int[count];
+	int * copy = new int[count * 3];
+	memcpy(copy,out,count * 3 * sizeof(int));
+	for (int i = 0; i < count; i++) {
+		order[i] = i;
+	}
+	std::sort(order,order + count,[copy](int x,int y) { return memcmp(copy + x * 3,copy + y * 3,3 * sizeof(int)) < 0; });
+	for (int i = 0; i < count; i++) {
+		memcpy(out + i * 3,copy + order[i] * 3,3 * sizeof(int));
+	}
+	delete [] copy;
+	delete [] order;
+}
+
+static BenchResultStruct Optimize(const BenchMeshStruct & mesh,int cache_size)
+{
+	int index_count = mesh.PolyCount * 3;
+	int * tris = new int[index_count];
+	int * cluster_starts = new int[mesh.PolyCount];
+	int * remap = new int[mesh.VertCount];
+	memcpy(tris,mesh.Polys,index_count * sizeof(int));
+
+	BenchResultStruct result;
+	result.Original = StripOptimizerClass::Compute_ACMR(tris,mesh.PolyCount,mesh.VertCount,cache_size);
+
+	BenchClock::time_point start = BenchClock::now();
+	result.Clusters = StripOptimizerClass::Optimize_Vertex_Cache(tris,mesh.PolyCount,mesh.VertCount,cache_size,cluster_starts);
+	result.VertexCache = StripOptimizerClass::Compute_ACMR(tris,mesh.PolyCount,mesh.VertCount,cache_size);
+	StripOptimizerClass::Optimize_Overdraw(tris,mesh.PolyCount,mesh.Verts,mesh.VertCount,cluster_starts,result.Clusters);
+	result.UsedVerts = StripOptimizerClass::Optimize_Vertex_Fetch(tris,mesh.PolyCount,mesh.VertCount,remap);
+	result.Ms = Elapsed_Ms(start);
+	result.Overdraw = StripOptimizerClass::Compute_ACMR(tris,mesh.PolyCount,mesh.VertCount,cache_size);
+
+	// map the original list through the vertex renumbering and compare the triangle sets
+	int * identity = new int[mesh.VertCount];
+	for (int i = 0; i < mesh.VertCount; i++) {
+		identity[i] = i;
+	}
+	int * before = new int[index_count];
+	int * after = new int[index_count];
+	Canonical_Triangles(mesh.Polys,mesh.PolyCount,remap,before);
+	Canonical_Triangles(tris,mesh.PolyCount,identity,after);
+	result.Match = (memcmp(before,after,index_count * sizeof(int)) == 0);
+
+	delete [] after;
+	delete [] before;
+	delete [] identity;
+	delete [] remap;
+	delete [] cluster_starts;
+	delete [] tris;
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	int cache_size = StripOptimizerClass::DEFAULT_CACHE_SIZE;
+	bool verbose = false;
+	int first_file = 1;
+	while (first_file < argc && argv[first_file][0] == '-') {
+		if (strcmp(argv[first_file],"-v") == 0) {
+			verbose = true;
+			first_file += 1;
+		} else if (strcmp(argv[first_file],"-c") == 0 && first_file + 1 < argc) {
+			cache_size = atoi(argv[first_file + 1]);
+			first_file += 2;
+		} else {
+			break;
+		}
+	}
+	if (first_file >= argc || cache_size < 3) {
+		printf("Usage - vertexcachebench [-c cache_size] [-v] file.w3d|file.mix ...\n");
+		return 1;
+	}
+
+	DynamicVectorClass<BenchMeshStruct> meshes;
+	for (int i = first_file; i < argc; i++) {
+		Load_File(argv[i],meshes);
+	}
+	if (meshes.Count() == 0) {
+		printf("no meshes found\n");
+		return 1;
+	}
+
+	/*
+	** The totals are weighted by poly count, which makes them the miss ratio of drawing
+	** every mesh once.
+	*/
+	int poly_count = 0;
+	double original = 0.0;
+	double vertex_cache = 0.0;
+	double overdraw = 0.0;
+	double ms = 0.0;
+	bool all_match = true;
+	for (int i = 0; i < meshes.Count(); i++) {
+		const BenchMeshStruct & mesh = meshes[i];
+		BenchResultStruct result = Optimize(mesh,cache_size);
+		poly_count += mesh.PolyCount;
+		original += (double)result.Original * mesh.PolyCount;
+		vertex_cache += (double)result.VertexCache * mesh.PolyCount;
+		overdraw += (double)result.Overdraw * mesh.PolyCount;
+		ms += result.Ms;
+		all_match &= result.Match;
+
+		if (verbose || !result.Match) {
+			printf("%-40s %6d polys %6d verts  ACMR %5.3f -> %5.3f, %5.3f after %d cluster(s)%s\n",
+				mesh.Name,mesh.PolyCount,mesh.VertCount,result.Original,result.VertexCache,result.Overdraw,result.Clusters,
+				result.Match ? "" : "  TRIANGLES DIFFER");
+		}
+		if (result.UsedVerts < mesh.VertCount && verbose) {
+			printf("%-40s %d unused vertices\n",mesh.Name,mesh.VertCount - result.UsedVerts);
+		}
+	}
+
+	printf("%d meshes, %d polys, %d entry FIFO cache\n",meshes.Count(),poly_count,cache_size);
+	printf("ACMR original:              %.3f\n",original / poly_count);
+	printf("ACMR vertex cache order:    %.3f\n",vertex_cache / poly_count);
+	printf("ACMR overdraw order:        %.3f (%.3f ms to optimize, %s)\n",overdraw / poly_count,ms,
+		all_match ? "triangles match" : "TRIANGLES DIFFER");
+
+	for (int i = 0; i < meshes.Count(); i++) {
+		delete [] meshes[i].Polys;
+		delete [] meshes[i].Verts;
+	}
+	return all_match ? 0 : 2;
+}
@@ -42,6 +42,7 @@
 #include "sphere.h"
 #include "colmath.h"
 #include "colmathinlines.h"
+#include "framearena.h"
 
 
 
@@ -91,6 +92,15 @@ struct IOAABNodeStruct
 };
 
 
+/*
+** Incremental update tuning.  Refit runs once REFIT_DIRTY_LIMIT nodes have changed, and
+** only rotates a subtree when that saves at least ROTATION_MIN_GAIN of the cost of the
+** box it changes.
+*/
+static const float	ROTATION_MIN_GAIN				= 0.05f;
+static const int		REFIT_DIRTY_LIMIT				= 64;
+
+
 /*************************************************************************
 **
 ** Utility functions for walking the object list in an AABTree Node
@@ -106,6 +116,25 @@ static inline CullableClass * get_next_object(CullableClass * obj)
 	return ((AABTreeLinkClass *)obj->Get_Cull_Link())->NextObject;
 }
 
+/*
+** Cost of a node's box for the incremental update; proportional to its surface area,
+** which is what decides how often queries have to look inside it.
+*/
+static inline float box_cost(const Vector3 & extent)
+{
+	return extent.X * extent.Y + extent.Y * extent.Z + extent.Z * extent.X;
+}
+
+static inline float box_cost(const MinMaxAABoxClass & box)
+{
+	return box_cost((box.MaxCorner - box.MinCorner) * 0.5f);
+}
+
+static inline bool box_equal(const AABoxClass & a,const AABoxClass & b)
+{
+	return (a.Center == b.Center) && (a.Extent == b.Extent);
+}
+
 
 /*************************************************************************
 **
@@ -115,7 +144,8 @@ static inline CullableClass * get_next_object(CullableClass * obj)
 AABTreeCullSystemClass::AABTreeCullSystemClass(void) :
 	ObjectCount(0),
 	NodeCount(0),
-	IndexedNodes(NULL)
+	IndexedNodes(NULL),
+	IncrementalUpdate(false)
 {
 	RootNode = new AABTreeNodeClass;
 	Re_Index_Nodes();
@@ -189,11 +219,19 @@ void AABTreeCullSystemClass::Update_Culling(CullableClass * obj)
 	WWASSERT(obj);
 	WWASSERT(obj->Get_Culling_System() == this);
 
+	Stats.ObjectsUpdated++;
+
 	// unlink it from the node it is currently in
 	AABTreeLinkClass * link = (AABTreeLinkClass *)obj->Get_Cull_Link();
 	WWASSERT(link);
 	AABTreeNodeClass * node = link->Node;
 	WWASSERT(node);
+
+	if (IncrementalUpdate) {
+		Update_Culling_Incremental(obj,node);
+		return;
+	}
+
 	node->Remove_Object(obj);
 	// decrement the object counter, the node can't
 	// decrement it for us...
@@ -203,6 +241,213 @@ void AABTreeCullSystemClass::Update_Culling(CullableClass * obj)
 	Add_Object_Recursive(RootNode,obj);
 }
 
+void AABTreeCullSystemClass::Set_Incremental_Update(bool onoff)
+{
+	if (IncrementalUpdate && !onoff) {
+		Refit();
+	}
+	IncrementalUpdate = onoff;
+}
+
+void AABTreeCullSystemClass::Update_Culling_Incremental(CullableClass * obj,AABTreeNodeClass * node)
+{
+	const AABoxClass & box = obj->Get_Cull_Box();
+
+	/*
+	** Still inside its node: the only place it can go is further down, and it only
+	** needs to be unlinked if one of the children will take it.
+	*/
+	if (node->Box.Contains(box)) {
+		Stats.ObjectsKept++;
+		if (	((node->Front != NULL) && node->Front->Box.Contains(box)) ||
+				((node->Back != NULL) && node->Back->Box.Contains(box))	) {
+			node->Remove_Object(obj);
+			ObjectCount--;
+			Add_Object_Recursive(node,obj);
+		}
+		return;
+	}
+
+	/*
+	** A leaf holding nothing but this object just follows it around as long as its
+	** parent still contains it.
+	*/
+	if (	(node != RootNode) && (node->Front == NULL) && (node->Back == NULL) &&
+			(node->Object == obj) && (get_next_object(obj) == NULL) && node->Parent->Box.Contains(box)	) {
+		node->Box = box;
+		Mark_Dirty(node);
+		Stats.LeavesMoved++;
+	} else {
+
+		/*
+		** Otherwise re-insert it from the nearest ancestor that still contains it and let
+		** the refit shrink the boxes it left behind.
+		*/
+		int steps = 0;
+		AABTreeNodeClass * ancestor = node;
+		while ((ancestor != RootNode) && !ancestor->Box.Contains(box)) {
+			ancestor = ancestor->Parent;
+			steps++;
+		}
+
+		node->Remove_Object(obj);
+		ObjectCount--;
+		Mark_Dirty(node);
+		Add_Object_Recursive(ancestor,obj);
+		Stats.ObjectsReinserted++;
+		Stats.ReinsertClimbSteps += steps;
+	}
+
+	// refit rearranges the tree, so it waits until we're done walking it
+	if (DirtyNodes.Count() >= REFIT_DIRTY_LIMIT) {
+		Refit();
+	}
+}
+
+void AABTreeCullSystemClass::Mark_Dirty(AABTreeNodeClass * node)
+{
+	if (node->Dirty || node == RootNode) {
+		return;
+	}
+	node->Dirty = true;
+	DirtyNodes.Add(node);
+}
+
+void AABTreeCullSystemClass::Refit(void)
+{
+	if (DirtyNodes.Count() == 0) {
+		return;
+	}
+
+	/*
+	** Deepest nodes first, so every parent is refit around its children's final boxes.
+	** Each node walks up until a box comes out unchanged.  This runs every frame things
+	** move, so the depth keys are frame arena scratch rather than a heap array.
+	*/
+	FrameArenaScopeClass arena_scope;
+	int * depths = arena_scope.Get_Arena().Alloc_Array<int>(DirtyNodes.Count());
+	for (int i=0; i<DirtyNodes.Count(); i++) {
+		int depth = 0;
+		for (AABTreeNodeClass * cur = DirtyNodes[i]; cur != RootNode; cur = cur->Parent) {
+			depth++;
+		}
+		depths[i] = depth;
+	}
+	for (int i=1; i<DirtyNodes.Count(); i++) {
+		AABTreeNodeClass * node = DirtyNodes[i];
+		int depth = depths[i];
+		int j = i;
+		for (; (j > 0) && (depths[j - 1] < depth); j--) {
+			DirtyNodes[j] = DirtyNodes[j - 1];
+			depths[j] = depths[j - 1];
+		}
+		DirtyNodes[j] = node;
+		depths[j] = depth;
+	}
+
+	bool rotated = false;
+	for (int i=0; i<DirtyNodes.Count(); i++) {
+		DirtyNodes[i]->Dirty = false;
+	}
+	for (int i=0; i<DirtyNodes.Count(); i++) {
+		for (AABTreeNodeClass * cur = DirtyNodes[i]; cur != RootNode; cur = cur->Parent) {
+			if (!Refit_Node(cur) && (cur != DirtyNodes[i])) {
+				break;
+			}
+			rotated |= Rotate_Node(cur);
+		}
+	}
+	DirtyNodes.Delete_All(false);
+
+	/*
+	** The node indices follow the layout of the tree; keep them that way so saved
+	** object linkage still matches the saved nodes.
+	*/
+	if (rotated) {
+		Re_Index_Nodes();
+	}
+}
+
+bool AABTreeCullSystemClass::Refit_Node(AABTreeNodeClass * node)
+{
+	if ((node->Front == NULL) && (node->Back == NULL) && (node->Object == NULL)) {
+		return false;	// nothing to bound, leave the empty leaf where it was
+	}
+
+	AABoxClass old_box = node->Box;
+	node->Compute_Local_Bounding_Box();
+	if (box_equal(old_box,node->Box)) {
+		return false;
+	}
+	Stats.NodesRefit++;
+	return true;
+}
+
+/*
+** Tree rotation: swap one child of the node with a grandchild on the other side when
+** that shrinks the box of the child in between.  The node's own box doesn't change
+** since it bounds the same things either way.
+*/
+bool AABTreeCullSystemClass::Rotate_Node(AABTreeNodeClass * node)
+{
+	if ((node->Front == NULL) || (node->Back == NULL)) {
+		return false;
+	}
+
+	AABTreeNodeClass ** best_child = NULL;
+	AABTreeNodeClass ** best_grandchild = NULL;
+	AABTreeNodeClass * best_middle = NULL;
+	MinMaxAABoxClass best_box;
+	float best_gain = 0.0f;
+
+	for (int side=0; side<2; side++) {
+		AABTreeNodeClass ** child = (side == 0) ? &node->Front : &node->Back;
+		AABTreeNodeClass * middle = (side == 0) ? node->Back : node->Front;
+		if ((middle->Front == NULL) || (middle->Back == NULL)) {
+			continue;
+		}
+
+		MinMaxAABoxClass objects_box(Vector3(FLT_MAX,FLT_MAX,FLT_MAX),Vector3(-FLT_MAX,-FLT_MAX,-FLT_MAX));
+		for (CullableClass * obj = get_first_object(middle); obj != NULL; obj = get_next_object(obj)) {
+			objects_box.Add_Box(obj->Get_Cull_Box());
+		}
+
+		const float old_cost = box_cost(middle->Box.Extent);
+		for (int grand=0; grand<2; grand++) {
+			AABTreeNodeClass ** grandchild = (grand == 0) ? &middle->Front : &middle->Back;
+			AABTreeNodeClass * kept = (grand == 0) ? middle->Back : middle->Front;
+
+			MinMaxAABoxClass new_box(objects_box);
+			new_box.Add_Box((*child)->Box);
+			new_box.Add_Box(kept->Box);
+
+			float gain = old_cost - box_cost(new_box);
+			if ((gain > ROTATION_MIN_GAIN * old_cost) && (gain > best_gain)) {
+				best_gain = gain;
+				best_child = child;
+				best_grandchild = grandchild;
+				best_middle = middle;
+				best_box = new_box;
+			}
+		}
+	}
+
+	if (best_child == NULL) {
+		return false;
+	}
+
+	AABTreeNodeClass * child = *best_child;
+	AABTreeNodeClass * grandchild = *best_grandchild;
+	*best_child = grandchild;
+	grandchild->Parent = node;
+	*best_grandchild = child;
+	child->Parent = best_middle;
+	best_middle->Box.Init(best_box);
+
+	Stats.NodesRotated++;
+	return true;
+}
+
 void AABTreeCullSystemClass::Collect_Objects(const Vector3 & point)
 {
 	Collect_Objects_Recursive(RootNode,point);
@@ -423,6 +668,13 @@ void AABTreeCullSystemClass::Reset_Statistics(void)
 	Stats.NodesAccepted = 0;
 	Stats.NodesTriviallyAccepted = 0;
 	Stats.NodesRejected = 0;
+	Stats.ObjectsUpdated = 0;
+	Stats.ObjectsKept = 0;
+	Stats.ObjectsReinserted = 0;
+	Stats.ReinsertClimbSteps = 0;
+	Stats.LeavesMoved = 0;
+	Stats.NodesRefit = 0;
+	Stats.NodesRotated = 0;
 }
 
 const AABTreeCullSystemClass::StatsStruct & AABTreeCullSystemClass::Get_Statistics(void)
@@ -884,6 +1136,9 @@ void AABTreeCullSystemClass::Save_Object_Linkage(ChunkSaveClass & csave,Cullable
 
 void AABTreeCullSystemClass::Re_Index_Nodes(void)
 {
+	// The tree has been rebuilt or rearranged, anything waiting for a refit is gone or done.
+	DirtyNodes.Delete_All(false);
+
 	if (IndexedNodes != NULL) {
 		delete[] IndexedNodes;
 		IndexedNodes = NULL;
@@ -926,7 +1181,8 @@ AABTreeNodeClass::AABTreeNodeClass(void) :
 	Front(NULL),
 	Back(NULL),
 	Object(NULL),
-	UserData(0)
+	UserData(0),
+	Dirty(false)
 {
 }
 
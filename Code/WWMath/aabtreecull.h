@@ -90,6 +90,20 @@ public:
 	*/
 	virtual void		Update_Culling(CullableClass * obj) override;
 
+	/*
+	** Incremental update mode.  Normally every moved object is re-inserted from the root.
+	** In incremental mode an object that is still inside its node's box stays in that
+	** part of the tree, a leaf holding just the moving object follows it, and anything
+	** else is re-inserted from the nearest ancestor that still contains it.  The boxes
+	** left behind are tightened by Refit(), which runs on its own once enough nodes have
+	** changed and also rotates subtrees wherever that makes a box smaller.  Rotations
+	** re-index the nodes, so don't use this on trees that attach meaning to node indices
+	** or UserData (like the vis trees).
+	*/
+	void					Set_Incremental_Update(bool onoff);
+	bool					Is_Incremental_Update(void) const			{ return IncrementalUpdate; }
+	void					Refit(void);
+
 	/*
 	** Statistics about the AAB-Tree
 	*/
@@ -133,6 +147,14 @@ public:
 		int				NodesAccepted;
 		int				NodesTriviallyAccepted;
 		int				NodesRejected;
+
+		int				ObjectsUpdated;			// Update_Culling calls
+		int				ObjectsKept;				// incremental: still inside their node, only allowed to sink
+		int				ObjectsReinserted;		// incremental: re-inserted from an ancestor
+		int				ReinsertClimbSteps;		// incremental: levels climbed to find those ancestors
+		int				LeavesMoved;				// incremental: single object leaves moved along with their object
+		int				NodesRefit;					// boxes tightened by Refit
+		int				NodesRotated;				// subtree rotations done by Refit
 	};
 
 	void					Reset_Statistics(void);
@@ -177,6 +199,11 @@ protected:
 
 	void					Update_Bounding_Boxes_Recursive(AABTreeNodeClass * node);
 
+	void					Update_Culling_Incremental(CullableClass * obj,AABTreeNodeClass * node);
+	void					Mark_Dirty(AABTreeNodeClass * node);
+	bool					Refit_Node(AABTreeNodeClass * node);
+	bool					Rotate_Node(AABTreeNodeClass * node);
+
 	void					Load_Nodes(AABTreeNodeClass * node,ChunkLoadClass & cload);
 	void					Save_Nodes(AABTreeNodeClass * node,ChunkSaveClass & csave);
 
@@ -191,6 +218,9 @@ protected:
 
 	StatsStruct				Stats;
 
+	bool										IncrementalUpdate;
+	SimpleDynVecClass<AABTreeNodeClass *>	DirtyNodes;			// nodes whose boxes Refit should tighten
+
 	friend class AABTreeIterator;
 };
 
@@ -274,6 +304,7 @@ public:
 	AABTreeNodeClass *	Back;					// back node
 	CullableClass *		Object;				// objects in this node
 	uint32					UserData;			// 32bit field for the user, initialized to 0
+	bool						Dirty;				// in the cull system's refit list
 
 	/*
 	** Construction support:
@@ -329,7 +360,7 @@ public:
 ** AABTreeLinkClass
 ** This structure is used to link objects into an AAB-Tree culling system.
 */
-class AABTreeLinkClass : public CullLinkClass, public AutoPoolClass<AABTreeLinkClass,256>
+class AABTreeLinkClass : public CullLinkClass, public AutoPoolClass<AABTreeLinkClass,256,32>
 {
 public:
 	AABTreeLinkClass(AABTreeCullSystemClass * system) : CullLinkClass(system),Node(NULL), NextObject(NULL) { }
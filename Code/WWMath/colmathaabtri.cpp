@@ -180,7 +180,8 @@ private:
 	BTCollisionStruct & operator = (const BTCollisionStruct &);
 };
 
-static BTCollisionStruct CollisionContext;
+// One per thread so boxes can be swept against triangles on several threads at once
+static thread_local BTCollisionStruct CollisionContext;
 
 /***********************************************************************************************
  * aabtri_separation_test -- test the projected extents for separation                         *
@@ -896,7 +897,8 @@ private:
 	AABTIntersectStruct & operator = (const AABTIntersectStruct &);
 };
 
-static AABTIntersectStruct IntersectContext;
+// One per thread, see CollisionContext
+static thread_local AABTIntersectStruct IntersectContext;
 
 
 /***********************************************************************************************
@@ -247,7 +247,7 @@ public:
 ** This class is should only be used by classes which derive from GridCullSystemClass
 ** not normal users.
 */
-class GridLinkClass : public CullLinkClass, public AutoPoolClass<GridLinkClass,256>
+class GridLinkClass : public CullLinkClass, public AutoPoolClass<GridLinkClass,256,32>
 {
 public:
 	GridLinkClass(GridCullSystemClass * system);
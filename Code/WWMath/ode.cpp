@@ -42,16 +42,17 @@
 #include "ode.h"
 #include <assert.h>
 
-static StateVectorClass		Y0;
-static StateVectorClass		Y1;
-static StateVectorClass		_WorkVector0;
-static StateVectorClass		_WorkVector1;
-static StateVectorClass		_WorkVector2;
-static StateVectorClass		_WorkVector3;
-static StateVectorClass		_WorkVector4;
-static StateVectorClass		_WorkVector5;
-static StateVectorClass		_WorkVector6;
-static StateVectorClass		_WorkVector7;
+// Integrator scratch state, one set per thread so objects can be integrated on several threads
+static thread_local StateVectorClass	Y0;
+static thread_local StateVectorClass	Y1;
+static thread_local StateVectorClass	_WorkVector0;
+static thread_local StateVectorClass	_WorkVector1;
+static thread_local StateVectorClass	_WorkVector2;
+static thread_local StateVectorClass	_WorkVector3;
+static thread_local StateVectorClass	_WorkVector4;
+static thread_local StateVectorClass	_WorkVector5;
+static thread_local StateVectorClass	_WorkVector6;
+static thread_local StateVectorClass	_WorkVector7;
 
 /***********************************************************************************************
  * Euler_Solve -- uses Eulers method to integrate a system of ODE's                            *
@@ -47,14 +47,104 @@ void VectorProcessorClass::Prefetch(void* /* address */)
 	/* FIXME: implement using intrinsics */
 }
 
-void VectorProcessorClass::Transform (Vector3* dst,const Vector3 *src, const Matrix3D& mtx, const int count)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VP_SSE2
+#include <emmintrin.h>
+
+// _mm_shuffle_ps taking a[i0],a[i1],b[i2],b[i3]
+#define VP_SHUFFLE(a,b,i0,i1,i2,i3)	_mm_shuffle_ps(a,b,_MM_SHUFFLE(i3,i2,i1,i0))
+
+/*
+** Four vectors at a time: three packed Vector3s are split into x, y and z lanes, run
+** through the matrix and packed back. Each lane adds its terms in the same order as
+** Matrix3D::Transform_Vector and Rotate_Vector, so the results are the same to the bit.
+*/
+static inline void Transform4(float * dst,const float * src,const __m128 * m,bool translate)
 {
-	/* FIXME: implement using intrinsics */
+	__m128 v0 = _mm_loadu_ps(src);
+	__m128 v1 = _mm_loadu_ps(src + 4);
+	__m128 v2 = _mm_loadu_ps(src + 8);
+
+	__m128 x = VP_SHUFFLE(VP_SHUFFLE(v0,v0,0,0,3,3),VP_SHUFFLE(v1,v2,2,2,1,1),0,2,0,2);
+	__m128 y = VP_SHUFFLE(VP_SHUFFLE(v0,v1,1,1,0,0),VP_SHUFFLE(v1,v2,3,3,2,2),0,2,0,2);
+	__m128 z = VP_SHUFFLE(VP_SHUFFLE(v0,v1,2,2,1,1),VP_SHUFFLE(v2,v2,0,0,3,3),0,2,0,2);
+
+	__m128 ox = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0],x),_mm_mul_ps(m[1],y)),_mm_mul_ps(m[2],z));
+	__m128 oy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[4],x),_mm_mul_ps(m[5],y)),_mm_mul_ps(m[6],z));
+	__m128 oz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[8],x),_mm_mul_ps(m[9],y)),_mm_mul_ps(m[10],z));
+	if (translate) {
+		ox = _mm_add_ps(ox,m[3]);
+		oy = _mm_add_ps(oy,m[7]);
+		oz = _mm_add_ps(oz,m[11]);
+	}
 
-	for (int i=0; i<count; i++)
-	{
-		dst[i]=mtx*src[i];
+	_mm_storeu_ps(dst,VP_SHUFFLE(VP_SHUFFLE(ox,oy,0,0,0,0),VP_SHUFFLE(oz,ox,0,0,1,1),0,2,0,2));
+	_mm_storeu_ps(dst + 4,VP_SHUFFLE(VP_SHUFFLE(oy,oz,1,1,1,1),VP_SHUFFLE(ox,oy,2,2,2,2),0,2,0,2));
+	_mm_storeu_ps(dst + 8,VP_SHUFFLE(VP_SHUFFLE(oz,ox,2,2,3,3),VP_SHUFFLE(oy,oz,3,3,3,3),0,2,0,2));
+}
+#endif
+
+static void Transform_Vectors(Vector3* dst,const Vector3 *src,const Matrix3D& mtx,const unsigned int *index,int count,bool translate)
+{
+	int i=0;
+
+#ifdef VP_SSE2
+	__m128 m[12];
+	for (int j=0; j<12; j++) {
+		m[j]=_mm_set1_ps(mtx[j/4][j%4]);
 	}
+
+	if (index==NULL) {
+		for (; i+4<=count; i+=4) {
+			Transform4(&dst[i].X,&src[i].X,m,translate);
+		}
+	} else {
+		for (; i+4<=count; i+=4) {
+			Vector3 in[4];
+			Vector3 out[4];
+			for (int j=0; j<4; j++) {
+				in[j]=src[index[i+j]];
+			}
+			Transform4(&out[0].X,&in[0].X,m,translate);
+			for (int j=0; j<4; j++) {
+				dst[index[i+j]]=out[j];
+			}
+		}
+	}
+#endif
+
+	for (; i<count; i++) {
+		unsigned int v=index ? index[i] : i;
+		if (translate) {
+			Matrix3D::Transform_Vector(mtx,src[v],&dst[v]);
+		} else {
+			Matrix3D::Rotate_Vector(mtx,src[v],&dst[v]);
+		}
+	}
+}
+
+void VectorProcessorClass::Transform (Vector3* dst,const Vector3 *src, const Matrix3D& mtx, const int count)
+{
+	if (count<=0) return;
+	Transform_Vectors(dst,src,mtx,NULL,count,true);
+}
+
+void VectorProcessorClass::Rotate (Vector3* dst,const Vector3 *src, const Matrix3D& mtx, const int count)
+{
+	if (count<=0) return;
+	Transform_Vectors(dst,src,mtx,NULL,count,false);
+}
+
+void VectorProcessorClass::TransformIndexed (Vector3* dst,const Vector3 *src, const Matrix3D& mtx, const unsigned int *index, const int count)
+{
+	if (count<=0) return;
+	Transform_Vectors(dst,src,mtx,index,count,true);
+}
+
+void VectorProcessorClass::RotateIndexed (Vector3* dst,const Vector3 *src, const Matrix3D& mtx, const unsigned int *index, const int count)
+{
+	if (count<=0) return;
+	Transform_Vectors(dst,src,mtx,index,count,false);
 }
 
 void VectorProcessorClass::Transform(Vector4* dst,const Vector3 *src, const Matrix4& matrix, const int count)
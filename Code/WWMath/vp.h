@@ -33,6 +33,8 @@
  *---------------------------------------------------------------------------------------------*
  * Functions:                                                                                  *
  * Transform - transforms a vector array given  Matrix3D                                       *
+ * Rotate - transforms a vector array by the rotation part of a Matrix3D                        *
+ * TransformIndexed/RotateIndexed - the same for dst[index[]]=matrix*src[index[]]               *
  * Copy - Copies data from source to destination                                                *
  * CopyIndexed-copies dst[]=src[index[]]                                                        *
  * Clear - clears array to zero                                                                 *
@@ -60,6 +62,9 @@ class VectorProcessorClass
 public:
 	static void Transform(Vector3* dst,const Vector3 *src, const Matrix3D& matrix, const int count);
 	static void Transform(Vector4* dst,const Vector3 *src, const Matrix4& matrix, const int count);
+	static void Rotate(Vector3* dst,const Vector3 *src, const Matrix3D& matrix, const int count);
+	static void TransformIndexed(Vector3* dst,const Vector3 *src, const Matrix3D& matrix, const unsigned int *index, const int count);
+	static void RotateIndexed(Vector3* dst,const Vector3 *src, const Matrix3D& matrix, const unsigned int *index, const int count);
 	static void Copy(unsigned *dst,const unsigned *src, const int count);
 	static void Copy(Vector2 *dst,const Vector2 *src, const int count);
 	static void Copy(Vector3 *dst,const Vector3 *src, const int count);
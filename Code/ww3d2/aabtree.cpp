@@ -59,6 +59,14 @@
  *   AABTreeClass::Read_Nodes -- Load the node array                                           *
  *   AABTreeClass::Generate_APT -- generate an apt from a box and viewdir                      *
  *   AABTreeClass::Generate_OBBox_APT_Recursive -- recurse, generate the apt for a box and vie *
+ *   AABTreeClass::Build_Wide_Nodes -- build the 4-wide version of the tree                    *
+ *   AABTreeClass::Build_Wide_Node_Recursive -- collapse binary nodes into a wide node         *
+ *   AABTreeClass::Wide_Box_Mask -- which children of a wide node overlap a box                *
+ *   AABTreeClass::Wide_Ray_Mask -- which children of a wide node a ray passes through         *
+ *   AABTreeClass::Cast_Ray_Wide -- Cast_Ray using the 4-wide tree                             *
+ *   AABTreeClass::Cast_AABox_Wide -- Cast_AABox using the 4-wide tree                         *
+ *   AABTreeClass::Cast_OBBox_Wide -- Cast_OBBox using the 4-wide tree                         *
+ *   AABTreeClass::Intersect_OBBox_Wide -- Intersect_OBBox using the 4-wide tree               *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 
@@ -73,6 +81,16 @@
 #include "colmathinlines.h"
 #include "w3d_file.h"
 #include "chunkio.h"
+#include <math.h>
+
+// The wide node tests run four children at a time with SSE2 when the compiler targets it (always true on x64)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AABTREE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+bool AABTreeClass::_WideNodesEnabled = false;
 
 
 
@@ -92,7 +110,9 @@ AABTreeClass::AABTreeClass(void) :
 	Nodes(NULL),
 	PolyCount(0),
 	PolyIndices(NULL),
-	Mesh(NULL)
+	Mesh(NULL),
+	WideNodeCount(0),
+	WideNodes(NULL)
 {
 }
 
@@ -111,7 +131,10 @@ AABTreeClass::AABTreeClass(void) :
  *   6/19/98    GTH : Created.                                                                 *
  *   5/23/2000  gth : Created.                                                                 *
  *=============================================================================================*/
-AABTreeClass::AABTreeClass(AABTreeBuilderClass * builder)
+AABTreeClass::AABTreeClass(AABTreeBuilderClass * builder) :
+	Mesh(NULL),
+	WideNodeCount(0),
+	WideNodes(NULL)
 {
 	NodeCount = builder->Node_Count();
 	Nodes = new AABTreeClass::CullNodeStruct[NodeCount];
@@ -121,6 +144,10 @@ AABTreeClass::AABTreeClass(AABTreeBuilderClass * builder)
 
 	int curpolyindex = 0;
 	Build_Tree_Recursive(builder->Root,curpolyindex);
+
+	if (_WideNodesEnabled) {
+		Build_Wide_Nodes();
+	}
 }
 
 
@@ -141,7 +168,9 @@ AABTreeClass::AABTreeClass(const AABTreeClass & that) :
 	Nodes(NULL),
 	PolyCount(0),
 	PolyIndices(0),
-	Mesh(NULL)
+	Mesh(NULL),
+	WideNodeCount(0),
+	WideNodes(NULL)
 {
 	*this = that;
 }
@@ -191,6 +220,12 @@ AABTreeClass & AABTreeClass::operator = (const AABTreeClass & that)
 		memcpy(PolyIndices,that.PolyIndices,PolyCount * sizeof(uint32));
 	}
 
+	WideNodeCount = that.WideNodeCount;
+	if (WideNodeCount > 0) {
+		WideNodes = new WideNodeStruct[WideNodeCount];
+		memcpy(WideNodes,that.WideNodes,WideNodeCount * sizeof(WideNodeStruct));
+	}
+
 	Mesh = that.Mesh;
 
 	return *this;
@@ -221,6 +256,11 @@ void AABTreeClass::Reset(void)
 		delete[] PolyIndices;
 		PolyIndices = NULL;
 	}
+	WideNodeCount = 0;
+	if (WideNodes) {
+		delete[] WideNodes;
+		WideNodes = NULL;
+	}
 	if (Mesh) {
 		Mesh = NULL;
 	}
@@ -1154,6 +1194,10 @@ void AABTreeClass::Load_W3D(ChunkLoadClass & cload)
 		}
 		cload.Close_Chunk();
 	}
+
+	if (_WideNodesEnabled) {
+		Build_Wide_Nodes();
+	}
 }
 
 
@@ -1208,4 +1252,462 @@ void AABTreeClass::Read_Nodes(ChunkLoadClass & cload)
 }
 
 
+/***********************************************************************************************
+ * AABTreeClass::Build_Wide_Nodes -- build the 4-wide version of the tree                      *
+ *                                                                                             *
+ * Collapses the binary nodes into WideNodeStructs, replacing any wide nodes the tree          *
+ * already had.  Trees too deep for the fixed traversal stack are left binary-only.            *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void AABTreeClass::Build_Wide_Nodes(void)
+{
+	if (WideNodes) {
+		delete[] WideNodes;
+		WideNodes = NULL;
+	}
+	WideNodeCount = 0;
+
+	if (NodeCount == 0) {
+		return;
+	}
+
+	SimpleDynVecClass<WideNodeStruct> wide_nodes(NodeCount / 2 + 1);
+	int max_depth = 0;
+	Build_Wide_Node_Recursive(0,wide_nodes,1,max_depth);
+
+	/*
+	** Every wide node on the way down can leave up to three siblings on the traversal stack
+	*/
+	if (3 * max_depth + 1 > WIDE_STACK_SIZE) {
+		WWDEBUG_SAY(("AABTreeClass::Build_Wide_Nodes - tree too deep (%d), using the binary nodes\n",max_depth));
+		return;
+	}
+
+	WideNodeCount = wide_nodes.Count();
+	WideNodes = new WideNodeStruct[WideNodeCount];
+	memcpy(WideNodes,&(wide_nodes[0]),WideNodeCount * sizeof(WideNodeStruct));
+}
+
+
+/***********************************************************************************************
+ * AABTreeClass::Build_Wide_Node_Recursive -- collapse binary nodes into a wide node           *
+ *                                                                                             *
+ * Starting from the given binary node, keeps opening the non-leaf child with the largest      *
+ * box until there are four children or only leaves, then quantizes their boxes into a new     *
+ * wide node and recurses into the children that have children of their own.  Opening a        *
+ * child puts its two children where it was, so the leaves stay in binary tree order.          *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * node_index - binary node to collapse                                                        *
+ * wide_nodes - wide nodes built so far                                                        *
+ * depth - depth of the new wide node                                                          *
+ * max_depth - deepest wide node so far                                                        *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+int AABTreeClass::Build_Wide_Node_Recursive
+(
+	int node_index,
+	SimpleDynVecClass<WideNodeStruct> & wide_nodes,
+	int depth,
+	int & max_depth
+)
+{
+	int children[4];
+	int count = 0;
+	if (Nodes[node_index].Is_Leaf()) {
+		children[count++] = node_index;
+	} else {
+		children[count++] = Nodes[node_index].Get_Front_Child();
+		children[count++] = Nodes[node_index].Get_Back_Child();
+	}
+
+	while (count < 4) {
+		int best = -1;
+		float best_area = -1.0f;
+		for (int i=0; i<count; i++) {
+			CullNodeStruct & child = Nodes[children[i]];
+			if (!child.Is_Leaf()) {
+				Vector3 size = child.Max - child.Min;
+				float area = size.X * size.Y + size.Y * size.Z + size.Z * size.X;
+				if (area > best_area) {
+					best_area = area;
+					best = i;
+				}
+			}
+		}
+		if (best == -1) {
+			break;
+		}
+		int front = Nodes[children[best]].Get_Front_Child();
+		int back = Nodes[children[best]].Get_Back_Child();
+		for (int i=count; i>best+1; i--) {
+			children[i] = children[i-1];
+		}
+		children[best] = front;
+		children[best+1] = back;
+		count++;
+	}
+
+	/*
+	** Quantize the children's boxes inside the box around all of them.  The scale is nudged
+	** up until the top code reaches the max, then each code is rounded outwards until its
+	** box contains the child's, using the same arithmetic as the traversal.
+	*/
+	WideNodeStruct node;
+	memset(&node,0,sizeof(node));
+
+	for (int axis=0; axis<3; axis++) {
+		float lo = Nodes[children[0]].Min[axis];
+		float hi = Nodes[children[0]].Max[axis];
+		for (int i=1; i<count; i++) {
+			lo = WWMath::Min(lo,Nodes[children[i]].Min[axis]);
+			hi = WWMath::Max(hi,Nodes[children[i]].Max[axis]);
+		}
+
+		float scale = (hi - lo) / 255.0f;
+		while (lo + 255.0f * scale < hi) {
+			scale = (scale > 0.0f) ? scale * (1.0f + FLT_EPSILON) : FLT_MIN;
+		}
+		node.Origin[axis] = lo;
+		node.Scale[axis] = scale;
+
+		for (int i=0; i<count; i++) {
+			float cmin = Nodes[children[i]].Min[axis];
+			float cmax = Nodes[children[i]].Max[axis];
+			int qmin = 0;
+			int qmax = 0;
+			if (scale > 0.0f) {
+				qmin = WWMath::Clamp_Int((int)floorf((cmin - lo) / scale),0,255);
+				qmax = WWMath::Clamp_Int((int)ceilf((cmax - lo) / scale),0,255);
+			}
+			while ((qmin > 0) && (lo + (float)qmin * scale > cmin)) qmin--;
+			while ((qmax < 255) && (lo + (float)qmax * scale < cmax)) qmax++;
+			node.QMin[axis][i] = (uint8)qmin;
+			node.QMax[axis][i] = (uint8)qmax;
+		}
+	}
+
+	int wide_index = wide_nodes.Count();
+	wide_nodes.Add(node);
+	max_depth = WWMath::Max(max_depth,depth);
+
+	for (int i=0; i<4; i++) {
+		if (i >= count) {
+			node.Child[i] = AABTREE_WIDE_EMPTY_CHILD;
+		} else if (Nodes[children[i]].Is_Leaf()) {
+			node.Child[i] = (uint32)children[i] | AABTREE_LEAF_FLAG;
+		} else {
+			node.Child[i] = (uint32)Build_Wide_Node_Recursive(children[i],wide_nodes,depth + 1,max_depth);
+		}
+	}
+
+	// the array may have moved while the children were built
+	wide_nodes[wide_index] = node;
+	return wide_index;
+}
+
+
+#ifdef AABTREE_SSE2
+static inline __m128 Load_Quantized(const uint8 * q)
+{
+	int packed;
+	memcpy(&packed,q,sizeof(packed));
+	__m128i v = _mm_cvtsi32_si128(packed);
+	v = _mm_unpacklo_epi8(v,_mm_setzero_si128());
+	v = _mm_unpacklo_epi16(v,_mm_setzero_si128());
+	return _mm_cvtepi32_ps(v);
+}
+#endif
+
+
+/***********************************************************************************************
+ * AABTreeClass::Wide_Box_Mask -- which children of a wide node overlap a box                  *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * node - wide node                                                                            *
+ * min,max - box to test the children against                                                  *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+inline int AABTreeClass::Wide_Box_Mask(const WideNodeStruct & node,const Vector3 & min,const Vector3 & max)
+{
+#ifdef AABTREE_SSE2
+	__m128 keep = _mm_castsi128_ps(_mm_set1_epi32(-1));
+	for (int axis=0; axis<3; axis++) {
+		const __m128 origin = _mm_set1_ps(node.Origin[axis]);
+		const __m128 scale = _mm_set1_ps(node.Scale[axis]);
+		const __m128 cmin = _mm_add_ps(origin,_mm_mul_ps(Load_Quantized(node.QMin[axis]),scale));
+		const __m128 cmax = _mm_add_ps(origin,_mm_mul_ps(Load_Quantized(node.QMax[axis]),scale));
+		keep = _mm_and_ps(keep,_mm_cmpge_ps(cmax,_mm_set1_ps(min[axis])));
+		keep = _mm_and_ps(keep,_mm_cmple_ps(cmin,_mm_set1_ps(max[axis])));
+	}
+	return _mm_movemask_ps(keep);
+#else
+	int mask = 0;
+	for (int i=0; i<4; i++) {
+		bool keep = true;
+		for (int axis=0; axis<3; axis++) {
+			float cmin = node.Origin[axis] + (float)node.QMin[axis][i] * node.Scale[axis];
+			float cmax = node.Origin[axis] + (float)node.QMax[axis][i] * node.Scale[axis];
+			keep = keep && (cmax >= min[axis]) && (cmin <= max[axis]);
+		}
+		mask |= keep ? (1 << i) : 0;
+	}
+	return mask;
+#endif
+}
+
+
+/***********************************************************************************************
+ * AABTreeClass::Wide_Ray_Mask -- which children of a wide node a ray passes through           *
+ *                                                                                             *
+ * Slab test of the segment p0 + t * dp, t in [0,max_t], against each child's box.             *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * node - wide node                                                                            *
+ * p0 - start of the ray                                                                       *
+ * inv_dp - reciprocals of the ray's delta vector                                              *
+ * max_t - how far along the ray to test                                                       *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+inline int AABTreeClass::Wide_Ray_Mask(const WideNodeStruct & node,const Vector3 & p0,const Vector3 & inv_dp,float max_t)
+{
+#ifdef AABTREE_SSE2
+	__m128 tnear = _mm_setzero_ps();
+	__m128 tfar = _mm_set1_ps(max_t);
+	for (int axis=0; axis<3; axis++) {
+		const __m128 origin = _mm_set1_ps(node.Origin[axis]);
+		const __m128 scale = _mm_set1_ps(node.Scale[axis]);
+		const __m128 p = _mm_set1_ps(p0[axis]);
+		const __m128 inv = _mm_set1_ps(inv_dp[axis]);
+		const __m128 cmin = _mm_add_ps(origin,_mm_mul_ps(Load_Quantized(node.QMin[axis]),scale));
+		const __m128 cmax = _mm_add_ps(origin,_mm_mul_ps(Load_Quantized(node.QMax[axis]),scale));
+		const __m128 t0 = _mm_mul_ps(_mm_sub_ps(cmin,p),inv);
+		const __m128 t1 = _mm_mul_ps(_mm_sub_ps(cmax,p),inv);
+		tnear = _mm_max_ps(tnear,_mm_min_ps(t0,t1));
+		tfar = _mm_min_ps(tfar,_mm_max_ps(t0,t1));
+	}
+	return _mm_movemask_ps(_mm_cmple_ps(tnear,tfar));
+#else
+	int mask = 0;
+	for (int i=0; i<4; i++) {
+		float tnear = 0.0f;
+		float tfar = max_t;
+		for (int axis=0; axis<3; axis++) {
+			float cmin = node.Origin[axis] + (float)node.QMin[axis][i] * node.Scale[axis];
+			float cmax = node.Origin[axis] + (float)node.QMax[axis][i] * node.Scale[axis];
+			float t0 = (cmin - p0[axis]) * inv_dp[axis];
+			float t1 = (cmax - p0[axis]) * inv_dp[axis];
+			tnear = WWMath::Max(tnear,WWMath::Min(t0,t1));
+			tfar = WWMath::Min(tfar,WWMath::Max(t0,t1));
+		}
+		mask |= (tnear <= tfar) ? (1 << i) : 0;
+	}
+	return mask;
+#endif
+}
+
+
+/***********************************************************************************************
+ * AABTreeClass::Cast_Ray_Wide -- Cast_Ray using the 4-wide tree                               *
+ *                                                                                             *
+ * Children are pushed in reverse so they come off the stack in binary tree order.  A          *
+ * polygon only changes the result if it is nearer than the current hit, so children           *
+ * further along the ray than that are skipped.                                                *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * raytest - contains all of the ray test information                                          *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool AABTreeClass::Cast_Ray_Wide(RayCollisionTestClass & raytest)
+{
+	/*
+	** Axis-parallel rays get a huge reciprocal rather than an infinite one, which keeps
+	** the slab math free of NaNs when the ray runs right along a box face.
+	*/
+	const Vector3 & p0 = raytest.Ray.Get_P0();
+	const Vector3 & dp = raytest.Ray.Get_DP();
+	Vector3 inv_dp;
+	for (int axis=0; axis<3; axis++) {
+		float d = dp[axis];
+		if (WWMath::Fabs(d) < 1.0e-20f) {
+			d = (d < 0.0f) ? -1.0e-20f : 1.0e-20f;
+		}
+		inv_dp[axis] = 1.0f / d;
+	}
+
+	uint32 stack[WIDE_STACK_SIZE];
+	int top = 0;
+	stack[top++] = 0;
+
+	bool res = false;
+	while (top > 0) {
+		uint32 ref = stack[--top];
+		if (ref & AABTREE_LEAF_FLAG) {
+			res = res | Cast_Ray_To_Polys(&(Nodes[ref & ~AABTREE_LEAF_FLAG]),raytest);
+			continue;
+		}
+
+		const WideNodeStruct & node = WideNodes[ref];
+		int mask = Wide_Ray_Mask(node,p0,inv_dp,WWMath::Min(1.0f,raytest.Result->Fraction));
+		for (int i=3; i>=0; i--) {
+			if ((mask & (1 << i)) && (node.Child[i] != AABTREE_WIDE_EMPTY_CHILD)) {
+				stack[top++] = node.Child[i];
+			}
+		}
+	}
+	return res;
+}
+
+
+/***********************************************************************************************
+ * AABTreeClass::Cast_AABox_Wide -- Cast_AABox using the 4-wide tree                           *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * boxtest - contains description of the collision test to be performed                        *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool AABTreeClass::Cast_AABox_Wide(AABoxCollisionTestClass & boxtest)
+{
+	const Vector3 & min = boxtest.SweepMin;
+	const Vector3 & max = boxtest.SweepMax;
+
+	uint32 stack[WIDE_STACK_SIZE];
+	int top = 0;
+	stack[top++] = 0;
+
+	bool res = false;
+	while (top > 0) {
+		uint32 ref = stack[--top];
+		if (ref & AABTREE_LEAF_FLAG) {
+			res = res | Cast_AABox_To_Polys(&(Nodes[ref & ~AABTREE_LEAF_FLAG]),boxtest);
+			continue;
+		}
+
+		const WideNodeStruct & node = WideNodes[ref];
+		int mask = Wide_Box_Mask(node,min,max);
+		for (int i=3; i>=0; i--) {
+			if ((mask & (1 << i)) && (node.Child[i] != AABTREE_WIDE_EMPTY_CHILD)) {
+				stack[top++] = node.Child[i];
+			}
+		}
+	}
+	return res;
+}
+
+
+/***********************************************************************************************
+ * AABTreeClass::Cast_OBBox_Wide -- Cast_OBBox using the 4-wide tree                           *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * boxtest - contains description of the collision test to be performed                        *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool AABTreeClass::Cast_OBBox_Wide(OBBoxCollisionTestClass & boxtest)
+{
+	const Vector3 & min = boxtest.SweepMin;
+	const Vector3 & max = boxtest.SweepMax;
+
+	uint32 stack[WIDE_STACK_SIZE];
+	int top = 0;
+	stack[top++] = 0;
+
+	bool res = false;
+	while (top > 0) {
+		uint32 ref = stack[--top];
+		if (ref & AABTREE_LEAF_FLAG) {
+			res = res | Cast_OBBox_To_Polys(&(Nodes[ref & ~AABTREE_LEAF_FLAG]),boxtest);
+			continue;
+		}
+
+		const WideNodeStruct & node = WideNodes[ref];
+		int mask = Wide_Box_Mask(node,min,max);
+		for (int i=3; i>=0; i--) {
+			if ((mask & (1 << i)) && (node.Child[i] != AABTREE_WIDE_EMPTY_CHILD)) {
+				stack[top++] = node.Child[i];
+			}
+		}
+	}
+	return res;
+}
+
+
+/***********************************************************************************************
+ * AABTreeClass::Intersect_OBBox_Wide -- Intersect_OBBox using the 4-wide tree                 *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * boxtest - contains description of the collision test to be performed                        *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool AABTreeClass::Intersect_OBBox_Wide(OBBoxIntersectionTestClass & boxtest)
+{
+	Vector3 min,max;
+	Vector3::Subtract(boxtest.BoundingBox.Center,boxtest.BoundingBox.Extent,&min);
+	Vector3::Add(boxtest.BoundingBox.Center,boxtest.BoundingBox.Extent,&max);
+
+	uint32 stack[WIDE_STACK_SIZE];
+	int top = 0;
+	stack[top++] = 0;
+
+	bool res = false;
+	while (top > 0) {
+		uint32 ref = stack[--top];
+		if (ref & AABTREE_LEAF_FLAG) {
+			res = res | Intersect_OBBox_With_Polys(&(Nodes[ref & ~AABTREE_LEAF_FLAG]),boxtest);
+			continue;
+		}
+
+		const WideNodeStruct & node = WideNodes[ref];
+		int mask = Wide_Box_Mask(node,min,max);
+		for (int i=3; i>=0; i--) {
+			if ((mask & (1 << i)) && (node.Child[i] != AABTREE_WIDE_EMPTY_CHILD)) {
+				stack[top++] = node.Child[i];
+			}
+		}
+	}
+	return res;
+}
+
+
 
@@ -71,6 +71,7 @@ class ChunkLoadClass;
 struct BoxRayAPTContextStruct;
 
 #define AABTREE_LEAF_FLAG 0x80000000
+#define AABTREE_WIDE_EMPTY_CHILD 0xFFFFFFFF
 
 
 /*
@@ -106,6 +107,15 @@ public:
 	bool						Cast_OBBox(OBBoxCollisionTestClass & boxtest);
 	bool						Intersect_OBBox(OBBoxIntersectionTestClass & boxtest);
 
+	/*
+	** When enabled, trees build a 4-wide copy of their nodes when they are created or loaded
+	** and use it for the ray and box casts.  Off by default; the wide_aabtree console command
+	** turns it on.  Changing it only affects trees created afterwards.
+	*/
+	static void				Set_Wide_Nodes_Enabled(bool onoff)	{ _WideNodesEnabled = onoff; }
+	static bool				Are_Wide_Nodes_Enabled(void)			{ return _WideNodesEnabled; }
+	int						Get_Wide_Node_Count(void)				{ return WideNodeCount; }
+
 private:
 
 	AABTreeClass &			operator = (const AABTreeClass & that);
@@ -118,6 +128,7 @@ private:
 	void						Set_Mesh(MeshGeometryClass * mesh);
 	void						Update_Bounding_Boxes(void);
 	void						Update_Min_Max(int index,Vector3 & min,Vector3 & max);
+	void						Build_Wide_Nodes(void);
 
 	/*
 	** CullNodeStruct - the culling tree is built out of an array of these structures
@@ -150,6 +161,29 @@ private:
 		inline void			Set_Poly_Count(uint32 count);
 	};
 
+	/*
+	** WideNodeStruct - the 4-wide form of the tree, collapsed from the binary nodes by
+	** Build_Wide_Nodes.  Each node holds the boxes of up to four children, quantized to
+	** 8 bits inside the node's own box (Origin + q * Scale, rounded outwards), so one 64
+	** byte node does the culling of up to three binary nodes.  A child is either another
+	** wide node or AABTREE_LEAF_FLAG plus the index of a binary leaf, so the polygon loops
+	** are shared with the binary traversal.  Children are kept in the order the binary
+	** traversal visits them, which keeps the results identical.
+	*/
+	struct WideNodeStruct
+	{
+		float					Origin[3];
+		float					Scale[3];
+		uint8					QMin[3][4];			// per axis, per child
+		uint8					QMax[3][4];
+		uint32				Child[4];			// AABTREE_WIDE_EMPTY_CHILD for unused slots
+	};
+
+	enum
+	{
+		WIDE_STACK_SIZE =			128,				// trees that could need more stay binary
+	};
+
 	/*
 	** OBBoxAPTContextStruct - this is a temporary datastructure used in building
 	** an APT by culling the mesh to an oriented bounding box.
@@ -191,6 +225,14 @@ private:
 	bool						Cast_OBBox_Recursive(CullNodeStruct * node,OBBoxCollisionTestClass & boxtest);
 	bool						Intersect_OBBox_Recursive(CullNodeStruct * node,OBBoxIntersectionTestClass & boxtest);
 
+	int						Build_Wide_Node_Recursive(int node_index,SimpleDynVecClass<WideNodeStruct> & wide_nodes,int depth,int & max_depth);
+	static int				Wide_Box_Mask(const WideNodeStruct & node,const Vector3 & min,const Vector3 & max);
+	static int				Wide_Ray_Mask(const WideNodeStruct & node,const Vector3 & p0,const Vector3 & inv_dp,float max_t);
+	bool						Cast_Ray_Wide(RayCollisionTestClass & raytest);
+	bool						Cast_AABox_Wide(AABoxCollisionTestClass & boxtest);
+	bool						Cast_OBBox_Wide(OBBoxCollisionTestClass & boxtest);
+	bool						Intersect_OBBox_Wide(OBBoxIntersectionTestClass & boxtest);
+
 	bool						Cast_Ray_To_Polys(CullNodeStruct * node,RayCollisionTestClass & raytest);
 	int						Cast_Semi_Infinite_Axis_Aligned_Ray_To_Polys(CullNodeStruct * node, const Vector3 & start_point,
 									int axis_r, int axis_1, int axis_2, int direction, unsigned char & flags);
@@ -205,6 +247,10 @@ private:
 	int						PolyCount;			// number of polygons in the parent mesh (and the number of indexes in our array)
 	uint32 *					PolyIndices;		// linear array of polygon indices, nodes index into this array
 	MeshGeometryClass *	Mesh;					// pointer to the parent mesh (non-ref-counted; we are a member of this mesh)
+	int						WideNodeCount;		// number of nodes in the 4-wide tree (zero if there isn't one)
+	WideNodeStruct *		WideNodes;			// 4-wide tree, root first
+
+	static bool				_WideNodesEnabled;
 
 	friend class MeshClass;
 	friend class MeshGeometryClass;
@@ -216,6 +262,7 @@ private:
 inline int AABTreeClass::Compute_Ram_Size(void)
 {
 	return	NodeCount * sizeof(CullNodeStruct) +
+				WideNodeCount * sizeof(WideNodeStruct) +
 				PolyCount * sizeof(int) +
 				sizeof(AABTreeClass);
 }
@@ -223,6 +270,9 @@ inline int AABTreeClass::Compute_Ram_Size(void)
 inline bool AABTreeClass::Cast_Ray(RayCollisionTestClass & raytest)
 {
 	WWASSERT(Nodes != NULL);
+	if (WideNodes != NULL) {
+		return Cast_Ray_Wide(raytest);
+	}
 	return Cast_Ray_Recursive(&(Nodes[0]),raytest);
 }
 
@@ -254,18 +304,27 @@ inline int AABTreeClass::Cast_Semi_Infinite_Axis_Aligned_Ray(const Vector3 & sta
 inline bool AABTreeClass::Cast_AABox(AABoxCollisionTestClass & boxtest)
 {
 	WWASSERT(Nodes != NULL);
+	if (WideNodes != NULL) {
+		return Cast_AABox_Wide(boxtest);
+	}
 	return Cast_AABox_Recursive(&(Nodes[0]),boxtest);
 }
 
 inline bool AABTreeClass::Cast_OBBox(OBBoxCollisionTestClass & boxtest)
 {
 	WWASSERT(Nodes != NULL);
+	if (WideNodes != NULL) {
+		return Cast_OBBox_Wide(boxtest);
+	}
 	return Cast_OBBox_Recursive(&(Nodes[0]),boxtest);
 }
 
 inline bool AABTreeClass::Intersect_OBBox(OBBoxIntersectionTestClass & boxtest)
 {
 	WWASSERT(Nodes != NULL);
+	if (WideNodes != NULL) {
+		return Intersect_OBBox_Wide(boxtest);
+	}
 	return Intersect_OBBox_Recursive(&(Nodes[0]),boxtest);
 }
 
@@ -273,6 +332,9 @@ inline void AABTreeClass::Update_Bounding_Boxes(void)
 {
 	WWASSERT(Nodes != NULL);
 	Update_Bounding_Boxes_Recursive(&(Nodes[0]));
+	if (WideNodes != NULL) {
+		Build_Wide_Nodes();
+	}
 }
 
 
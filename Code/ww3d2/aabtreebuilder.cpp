@@ -55,11 +55,17 @@
  *   AABTreeBuilderClass::Update_Min_Max -- ensure given vector is in min max of poly          *
  *   AABTreeBuilderClass::Export -- Saves this AABTree into a W3D chunk                        *
  *   AABTreeBuilderClass::Build_W3D_AABTree_Recursive -- Build array of indices and W3dMeshAAB *
+ *   AABTreeBuilderClass::Build_Tree_SAH -- recursively builds the tree with binned SAH splits *
+ *   AABTreeBuilderClass::Build_Tree_SAH_Parallel -- build the tree with SAH on several threads*
+ *   AABTreeBuilderClass::Split_Polys_SAH -- partition the polys with the best binned SAH split*
+ *   AABTreeBuilderClass::Compute_SAH_Cost -- expected cost of a query against the tree        *
+ *   AABTreeBuilderClass::Compute_SAH_Cost_Recursive -- internal implementation of Compute_SAH *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #include "aabtreebuilder.h"
 #include "chunkio.h"
 #include "w3d_file.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -68,6 +74,25 @@
 #define WWASSERT	assert					// can't use WWASSERT because we use this module in the MAX plugin...
 const float COINCIDENCE_EPSILON = 0.001f;
 
+/*
+** Relative costs the SAH builder weighs its splits with: visiting a node (testing the boxes
+** of its children) and testing a poly.
+*/
+const float SAH_NODE_COST = 1.0f;
+const float SAH_POLY_COST = 1.5f;
+
+AABTreeBuilderClass::BuildModeType AABTreeBuilderClass::_DefaultBuildMode = AABTreeBuilderClass::BUILD_BINNED_SAH;
+
+
+/*
+** Half the surface area of a box, inflated a tiny amount so that flat boxes still count
+*/
+static inline float Half_Area(const Vector3 & min,const Vector3 & max)
+{
+	Vector3 size = max - min + Vector3(WWMATH_EPSILON,WWMATH_EPSILON,WWMATH_EPSILON);
+	return size.X * size.Y + size.Y * size.Z + size.Z * size.X;
+}
+
 
 /***********************************************************************************************
  * AABTreeBuilderClass::AABTreeBuilderClass -- Constructor                                     *
@@ -86,7 +111,11 @@ AABTreeBuilderClass::AABTreeBuilderClass(void) :
 	PolyCount(0),
 	Polys(NULL),
 	VertCount(0),
-	Verts(NULL)
+	Verts(NULL),
+	BuildMode(_DefaultBuildMode),
+	Jobs(&JobSystemClass::Get_Shared()),
+	PolyMin(NULL),
+	PolyMax(NULL)
 {
 }
 
@@ -190,7 +219,33 @@ void AABTreeBuilderClass::Build_AABTree(int polycount,TriIndex * polys,int vertc
 	** deleted by the Build_Tree function.
 	*/
 	Root = new CullNodeStruct;
-	Build_Tree(Root,PolyCount,polyindices);
+	if (BuildMode == BUILD_BINNED_SAH) {
+
+		/*
+		** The SAH builder only looks at the box around each poly
+		*/
+		PolyMin = new Vector3[PolyCount];
+		PolyMax = new Vector3[PolyCount];
+		for (int i=0; i<PolyCount; i++) {
+			PolyMin[i].Set(FLT_MAX,FLT_MAX,FLT_MAX);
+			PolyMax[i].Set(-FLT_MAX,-FLT_MAX,-FLT_MAX);
+			Update_Min_Max(i,PolyMin[i],PolyMax[i]);
+		}
+
+		if (!Jobs->Is_Deterministic() && (PolyCount >= PARALLEL_MIN_POLYS)) {
+			Build_Tree_SAH_Parallel(Root,PolyCount,polyindices);
+		} else {
+			Build_Tree_SAH(Root,PolyCount,polyindices);
+		}
+
+		delete[] PolyMin;
+		PolyMin = NULL;
+		delete[] PolyMax;
+		PolyMax = NULL;
+
+	} else {
+		Build_Tree(Root,PolyCount,polyindices);
+	}
 	polyindices = NULL;
 
 	/*
@@ -927,5 +982,293 @@ void AABTreeBuilderClass::Build_W3D_AABTree_Recursive
 }
 
 
+/***********************************************************************************************
+ * AABTreeBuilderClass::Build_Tree_SAH -- recursively builds the tree with binned SAH splits   *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * node - node to build                                                                        *
+ * polycount - number of polys in the node                                                     *
+ * polyindices - the polys, this array is deleted or taken over by the tree                    *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void AABTreeBuilderClass::Build_Tree_SAH(CullNodeStruct * node,int polycount,int * polyindices)
+{
+	SplitArraysStruct arrays;
+	if (!Split_Polys_SAH(polycount,polyindices,&arrays)) {
+		node->PolyCount = polycount;
+		node->PolyIndices = polyindices;
+		return;
+	}
+	delete[] polyindices;
+
+	node->Front = new CullNodeStruct;
+	Build_Tree_SAH(node->Front,arrays.FrontCount,arrays.FrontPolys);
+
+	node->Back = new CullNodeStruct;
+	Build_Tree_SAH(node->Back,arrays.BackCount,arrays.BackPolys);
+}
+
+
+/***********************************************************************************************
+ * AABTreeBuilderClass::Build_Tree_SAH_Parallel -- builds the tree with SAH on several threads *
+ *                                                                                             *
+ * Each split is made here and its two halves are built as a fork/join pair on the job system *
+ * until they get down to PARALLEL_JOB_POLYS, then Build_Tree_SAH finishes them.  The splits   *
+ * are the ones Build_Tree_SAH would make, so the tree is the same whatever the thread count.  *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * node - node to build                                                                        *
+ * polycount - number of polys in the node                                                     *
+ * polyindices - the polys, this array is deleted or taken over by the tree                    *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void AABTreeBuilderClass::Build_Tree_SAH_Parallel(CullNodeStruct * node,int polycount,int * polyindices)
+{
+	if (polycount < PARALLEL_JOB_POLYS) {
+		Build_Tree_SAH(node,polycount,polyindices);
+		return;
+	}
 
+	SplitArraysStruct arrays;
+	if (!Split_Polys_SAH(polycount,polyindices,&arrays)) {
+		node->PolyCount = polycount;
+		node->PolyIndices = polyindices;
+		return;
+	}
+	delete[] polyindices;
+
+	node->Front = new CullNodeStruct;
+	node->Back = new CullNodeStruct;
+	Jobs->Fork_Join(
+		[&]() { Build_Tree_SAH_Parallel(node->Front,arrays.FrontCount,arrays.FrontPolys); },
+		[&]() { Build_Tree_SAH_Parallel(node->Back,arrays.BackCount,arrays.BackPolys); },
+		"AABTree Build");
+}
+
+
+/***********************************************************************************************
+ * AABTreeBuilderClass::Split_Polys_SAH -- partition the polys with the best binned SAH split  *
+ *                                                                                             *
+ * The centers of the polys are sorted into bins along each axis and every boundary between    *
+ * two bins is scored by the area of each side times the number of polys on it.  The polys     *
+ * are only split if the best split is expected to be cheaper than testing them all, unless    *
+ * there are too many of them for one leaf.                                                    *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * polycount - number of polys                                                                 *
+ * polyindices - the polys                                                                     *
+ * arrays - receives the front and back polys if the polys are split                           *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool AABTreeBuilderClass::Split_Polys_SAH(int polycount,int * polyindices,SplitArraysStruct * arrays)
+{
+	if (polycount <= MIN_POLYS_PER_NODE) {
+		return false;
+	}
+
+	/*
+	** Bound the polys and their centers.  The centers are kept doubled (min + max).
+	*/
+	Vector3 bmin(FLT_MAX,FLT_MAX,FLT_MAX);
+	Vector3 bmax(-FLT_MAX,-FLT_MAX,-FLT_MAX);
+	Vector3 cmin(FLT_MAX,FLT_MAX,FLT_MAX);
+	Vector3 cmax(-FLT_MAX,-FLT_MAX,-FLT_MAX);
+	for (int i=0; i<polycount; i++) {
+		const Vector3 & pmin = PolyMin[polyindices[i]];
+		const Vector3 & pmax = PolyMax[polyindices[i]];
+		Vector3 center = pmin + pmax;
+		for (int axis=0; axis<3; axis++) {
+			bmin[axis] = WWMath::Min(bmin[axis],pmin[axis]);
+			bmax[axis] = WWMath::Max(bmax[axis],pmax[axis]);
+			cmin[axis] = WWMath::Min(cmin[axis],center[axis]);
+			cmax[axis] = WWMath::Max(cmax[axis],center[axis]);
+		}
+	}
+
+	/*
+	** Score the boundaries between the bins on each axis
+	*/
+	int best_axis = -1;
+	int best_bin = 0;
+	int best_back_count = 0;
+	float best_cost = FLT_MAX;
+	float bin_scale[3];
+
+	for (int axis=0; axis<3; axis++) {
+		float extent = cmax[axis] - cmin[axis];
+		bin_scale[axis] = 0.0f;
+		if (extent <= 0.0f) {
+			continue;
+		}
+		bin_scale[axis] = (float)SAH_BIN_COUNT / extent;
+
+		SAHBinStruct bins[SAH_BIN_COUNT];
+		for (int bin=0; bin<SAH_BIN_COUNT; bin++) {
+			bins[bin].Count = 0;
+			bins[bin].Min.Set(FLT_MAX,FLT_MAX,FLT_MAX);
+			bins[bin].Max.Set(-FLT_MAX,-FLT_MAX,-FLT_MAX);
+		}
+
+		for (int i=0; i<polycount; i++) {
+			const Vector3 & pmin = PolyMin[polyindices[i]];
+			const Vector3 & pmax = PolyMax[polyindices[i]];
+			int bin = MIN((int)((pmin[axis] + pmax[axis] - cmin[axis]) * bin_scale[axis]),SAH_BIN_COUNT - 1);
+			bins[bin].Count++;
+			Update_Min_Max(polyindices[i],bins[bin].Min,bins[bin].Max);
+		}
+
+		/*
+		** Sweep from the top down to get the cost of everything above each boundary,
+		** then from the bottom up to score the boundaries.
+		*/
+		float front_cost[SAH_BIN_COUNT];
+		Vector3 fmin(FLT_MAX,FLT_MAX,FLT_MAX);
+		Vector3 fmax(-FLT_MAX,-FLT_MAX,-FLT_MAX);
+		int front_count = 0;
+		for (int bin=SAH_BIN_COUNT-1; bin>0; bin--) {
+			if (bins[bin].Count > 0) {
+				front_count += bins[bin].Count;
+				fmin.Update_Min(bins[bin].Min);
+				fmax.Update_Max(bins[bin].Max);
+			}
+			front_cost[bin] = (front_count > 0) ? Half_Area(fmin,fmax) * front_count : 0.0f;
+		}
+
+		Vector3 backmin(FLT_MAX,FLT_MAX,FLT_MAX);
+		Vector3 backmax(-FLT_MAX,-FLT_MAX,-FLT_MAX);
+		int back_count = 0;
+		for (int bin=0; bin<SAH_BIN_COUNT-1; bin++) {
+			if (bins[bin].Count > 0) {
+				back_count += bins[bin].Count;
+				backmin.Update_Min(bins[bin].Min);
+				backmax.Update_Max(bins[bin].Max);
+			}
+			if ((back_count == 0) || (back_count == polycount)) {
+				continue;
+			}
+			float cost = Half_Area(backmin,backmax) * back_count + front_cost[bin + 1];
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_bin = bin;
+				best_back_count = back_count;
+			}
+		}
+	}
+
+	/*
+	** Decide whether to split at all.  If every center is in the same place there is no
+	** boundary to split on and a leaf that's too big just gets cut in half.
+	*/
+	if (best_axis == -1) {
+		if (polycount <= SAH_MAX_LEAF_POLYS) {
+			return false;
+		}
+		arrays->BackCount = polycount / 2;
+		arrays->FrontCount = polycount - arrays->BackCount;
+		arrays->BackPolys = new int[arrays->BackCount];
+		arrays->FrontPolys = new int[arrays->FrontCount];
+		memcpy(arrays->BackPolys,polyindices,arrays->BackCount * sizeof(int));
+		memcpy(arrays->FrontPolys,polyindices + arrays->BackCount,arrays->FrontCount * sizeof(int));
+		return true;
+	}
+
+	float split_cost = SAH_NODE_COST + SAH_POLY_COST * best_cost / Half_Area(bmin,bmax);
+	float leaf_cost = SAH_POLY_COST * polycount;
+	if ((split_cost >= leaf_cost) && (polycount <= SAH_MAX_LEAF_POLYS)) {
+		return false;
+	}
+
+	/*
+	** Split the polys at the chosen boundary, binning them exactly as they were scored
+	*/
+	arrays->BackCount = 0;
+	arrays->FrontCount = 0;
+	arrays->BackPolys = new int[best_back_count];
+	arrays->FrontPolys = new int[polycount - best_back_count];
+
+	for (int i=0; i<polycount; i++) {
+		const Vector3 & pmin = PolyMin[polyindices[i]];
+		const Vector3 & pmax = PolyMax[polyindices[i]];
+		int bin = MIN((int)((pmin[best_axis] + pmax[best_axis] - cmin[best_axis]) * bin_scale[best_axis]),SAH_BIN_COUNT - 1);
+		if (bin <= best_bin) {
+			arrays->BackPolys[arrays->BackCount++] = polyindices[i];
+		} else {
+			arrays->FrontPolys[arrays->FrontCount++] = polyindices[i];
+		}
+	}
+
+	WWASSERT(arrays->BackCount == best_back_count);
+	WWASSERT(arrays->FrontCount == polycount - best_back_count);
+	return true;
+}
+
+
+/***********************************************************************************************
+ * AABTreeBuilderClass::Compute_SAH_Cost -- expected cost of a query against the tree          *
+ *                                                                                             *
+ * Sums the cost of visiting every node and testing its polys, each weighted by the odds       *
+ * of a ray that hits the root also hitting the node (the ratio of their surface areas).       *
+ * Lets trees from the different build modes be compared.                                      *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+float AABTreeBuilderClass::Compute_SAH_Cost(void)
+{
+	if (Root == NULL) {
+		return 0.0f;
+	}
+	return Compute_SAH_Cost_Recursive(Root) / Half_Area(Root->Min,Root->Max);
+}
+
+
+/***********************************************************************************************
+ * AABTreeBuilderClass::Compute_SAH_Cost_Recursive -- internal implementation of Compute_SAH_C *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * node - subtree to add up                                                                    *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+float AABTreeBuilderClass::Compute_SAH_Cost_Recursive(CullNodeStruct * node)
+{
+	float cost = SAH_POLY_COST * node->PolyCount;
+	if (node->Front || node->Back) {
+		cost += SAH_NODE_COST;
+	}
+	cost *= Half_Area(node->Min,node->Max);
+
+	if (node->Front) {
+		cost += Compute_SAH_Cost_Recursive(node->Front);
+	}
+	if (node->Back) {
+		cost += Compute_SAH_Cost_Recursive(node->Back);
+	}
+	return cost;
+}
 
@@ -50,6 +50,8 @@
 #include "aaplane.h"
 #include "bittype.h"
 #include "meshgeometry.h"
+#include "vector.h"
+#include "jobsystem.h"
 #include <float.h>
 
 class AABTreeClass;
@@ -61,6 +63,13 @@ struct W3dMeshAABTreeNode;
 ** This class serves simply to build AABTreeClasses.  It first builds a tree
 ** which uses an easier to manage data structure (but uses more memory).  Then
 ** the tree is converted into the representation used in the AABTreeClass.
+**
+** There are two ways of choosing the partitions.  The original one tries planes through
+** random vertices and keeps the one with the smallest volumes.  The binned SAH builder
+** sorts the polys into bins along each axis by their centers and picks the split that
+** minimizes the expected cost of a ray query (the surface area heuristic).  It is
+** deterministic, so the two halves of each big split can be built as separate jobs and
+** the tree still comes out the same for any thread count.
 */
 class AABTreeBuilderClass
 {
@@ -75,11 +84,45 @@ public:
 	int					Node_Count(void);
 	int					Poly_Count(void);
 
+	/*
+	** Expected cost of a query against the tree: the surface area heuristic summed over
+	** every node, relative to the area of the root.  Lower is better.
+	*/
+	float					Compute_SAH_Cost(void);
+
+	enum BuildModeType
+	{
+		BUILD_RANDOM_PLANES = 0,		// original builder, best of a few random planes
+		BUILD_BINNED_SAH,					// binned surface area heuristic
+	};
+
+	void					Set_Build_Mode(BuildModeType mode)				{ BuildMode = mode; }
+	BuildModeType		Get_Build_Mode(void) const							{ return BuildMode; }
+
+	/*
+	** Job system the SAH builder spreads big meshes over.  Defaults to the shared one.
+	** Small meshes, and every mesh with a deterministic job system, are built on the
+	** calling thread.
+	*/
+	void					Set_Job_System(JobSystemClass * jobs)			{ WWASSERT(jobs != NULL); Jobs = jobs; }
+	JobSystemClass *	Get_Job_System(void) const							{ return Jobs; }
+
+	/*
+	** Settings new builders start out with (MeshGeometryClass builds its trees with these)
+	*/
+	static void			Set_Default_Build_Mode(BuildModeType mode)	{ _DefaultBuildMode = mode; }
+	static BuildModeType	Get_Default_Build_Mode(void)					{ return _DefaultBuildMode; }
+
 	enum
 	{
 		MIN_POLYS_PER_NODE =		4,
 		SMALL_VERTEX =				-100000,
-		BIG_VERTEX =				100000
+		BIG_VERTEX =				100000,
+
+		SAH_BIN_COUNT =			16,				// bins per axis when evaluating SAH splits
+		SAH_MAX_LEAF_POLYS =		16,				// leaves are never bigger than this
+		PARALLEL_MIN_POLYS =		4096,				// meshes smaller than this are built on one thread
+		PARALLEL_JOB_POLYS =		512,				// subtrees smaller than this are built in one job
 	};
 
 private:
@@ -151,6 +194,16 @@ private:
 		int *						BackPolys;
 	};
 
+	/*
+	** SAHBinStruct - the polys whose centers fall into one bin and the box around them
+	*/
+	struct SAHBinStruct
+	{
+		int						Count;
+		Vector3					Min;
+		Vector3					Max;
+	};
+
 	enum OverlapType
 	{
 		POS				= 0x01,
@@ -181,6 +234,11 @@ private:
 	void								Update_Max(int poly_index,Vector3 & set_max);
 	void								Update_Min_Max(int poly_index, Vector3 & set_min, Vector3 & set_max);
 
+	void								Build_Tree_SAH(CullNodeStruct * node,int polycount,int * polyindices);
+	void								Build_Tree_SAH_Parallel(CullNodeStruct * node,int polycount,int * polyindices);
+	bool								Split_Polys_SAH(int polycount,int * polyindices,SplitArraysStruct * arrays);
+	float								Compute_SAH_Cost_Recursive(CullNodeStruct * node);
+
 	void								Build_W3D_AABTree_Recursive(CullNodeStruct *	node,
 											W3dMeshAABTreeNode * w3dnodes,
 											uint32 * poly_indices,
@@ -200,6 +258,21 @@ private:
 	int								VertCount;
 	Vector3 *						Verts;
 
+	/*
+	** Build settings
+	*/
+	BuildModeType					BuildMode;
+	JobSystemClass *				Jobs;
+
+	/*
+	** SAH build data.  The boxes around each poly are only kept while the tree is being
+	** built.
+	*/
+	Vector3 *						PolyMin;
+	Vector3 *						PolyMax;
+
+	static BuildModeType			_DefaultBuildMode;
+
 	friend class AABTreeClass;
 };
 
@@ -48,6 +48,10 @@
  *   Animatable3DObjClass::Set_Animation -- Set the animation state to the given anim/frame    *
  *   Animatable3DObjClass::Set_Animation -- set the animation state to a blend of two anims    *
  *   Animatable3DObjClass::Set_Animation -- Set animation state with an anim combo             *
+ *   Animatable3DObjClass::Attach_Cursor -- make sure a cursor slot belongs to the given anim  *
+ *   Animatable3DObjClass::Attach_Combo_Cursors -- cursors for each anim of a combo            *
+ *   Animatable3DObjClass::Release_Cursors -- delete the playback cursors                      *
+ *   Animatable3DObjClass::Peek_Cursor -- returns the cursor in a slot if it belongs to an     *
  *   Animatable3DObjClass::Get_Bone_Transform -- return the transform for the given bone       *
  *   Animatable3DObjClass::Get_Bone_Transform -- return the transform for the given bone       *
  *   Animatable3DObjClass::Capture_Bone -- capture the specified bone (override animation)     *
@@ -172,6 +176,7 @@ Animatable3DObjClass::Animatable3DObjClass(const Animatable3DObjClass & src) :
 Animatable3DObjClass::~Animatable3DObjClass(void)
 {
 	Release();
+	Release_Cursors();
 
 	if (HTree) {
 		delete HTree;
@@ -195,6 +200,7 @@ Animatable3DObjClass & Animatable3DObjClass::operator = (const Animatable3DObjCl
 {
 	if (&that != this) {
 		Release();
+		Release_Cursors();
 		if (HTree) {
 			delete HTree;
 		}
@@ -267,6 +273,109 @@ void Animatable3DObjClass::Release( void )
 	}
 }
 
+/***********************************************************************************************
+ * Animatable3DObjClass::Attach_Cursor -- make sure a cursor slot belongs to the given anim    *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * slot -- 0 for the single anim or the first blended anim, 1 for the second blended anim      *
+ * motion -- anim that will be played in that slot, may be NULL                                *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void Animatable3DObjClass::Attach_Cursor( int slot, HAnimClass * motion )
+{
+	WWASSERT(slot >= 0);
+
+	while (MotionCursors.Count() <= slot) {
+		MotionCursors.Add(NULL);
+	}
+
+	if (MotionCursors[slot] != NULL && MotionCursors[slot]->Peek_Anim() == motion) {
+		return;
+	}
+
+	delete MotionCursors[slot];
+	MotionCursors[slot] = (motion != NULL) ? motion->Create_Cursor() : NULL;
+}
+
+
+/***********************************************************************************************
+ * Animatable3DObjClass::Attach_Combo_Cursors -- cursors for each anim of a combo              *
+ *                                                                                             *
+ * The anims of a combo can be changed without telling us, so this is done every time the     *
+ * combo is applied.  Cursors stay with their slot as long as the anim in it doesn't change.   *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * anim -- combo that is about to be applied                                                   *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * one cursor (or NULL) per anim of the combo, to hand to HTreeClass::Combo_Update             *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+HAnimCursorClass * const * Animatable3DObjClass::Attach_Combo_Cursors( HAnimComboClass * anim )
+{
+	int count = anim->Get_Num_Anims();
+	for (int index = 0; index < count; index++) {
+		Attach_Cursor(index, anim->Peek_Motion(index));
+	}
+	Release_Cursors(count);
+
+	return (count > 0) ? &MotionCursors[0] : NULL;
+}
+
+
+/***********************************************************************************************
+ * Animatable3DObjClass::Release_Cursors -- delete the playback cursors                        *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * first_slot -- first slot to release, the ones before it are kept                            *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void Animatable3DObjClass::Release_Cursors( int first_slot )
+{
+	while (MotionCursors.Count() > first_slot) {
+		int slot = MotionCursors.Count() - 1;
+		delete MotionCursors[slot];
+		MotionCursors.Delete(slot);
+	}
+}
+
+
+/***********************************************************************************************
+ * Animatable3DObjClass::Peek_Cursor -- returns the cursor in a slot if it belongs to an anim  *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * the cursor, or NULL if the slot is empty or holds a cursor for a different anim             *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+HAnimCursorClass * Animatable3DObjClass::Peek_Cursor( int slot, HAnimClass * motion ) const
+{
+	WWASSERT(slot >= 0);
+
+	if (slot < MotionCursors.Count() && MotionCursors[slot] != NULL && MotionCursors[slot]->Peek_Anim() == motion) {
+		return MotionCursors[slot];
+	}
+	return NULL;
+}
+
+
 /***********************************************************************************************
  * Animatable3DObjClass::Render -- Update this object for rendering                            *
  *                                                                                             *
@@ -446,6 +555,7 @@ int Animatable3DObjClass::Get_Bone_Index(const char * bonename)
 void Animatable3DObjClass::Set_Animation(void)
 {
 	Release();
+	Release_Cursors();
 	CurMotionMode = BASE_POSE;
 	Set_Hierarchy_Valid(false);
 }
@@ -476,9 +586,12 @@ void Animatable3DObjClass::Set_Animation(HAnimClass * motion, float frame, int m
 		ModeAnim.Frame = frame;
 		ModeAnim.LastSyncTime = WW3D::Get_Sync_Time();
 		ModeAnim.AnimMode = mode;
+		Attach_Cursor(0, motion);
+		Release_Cursors(1);
 	} else {
 		CurMotionMode = BASE_POSE;
 		Release();
+		Release_Cursors();
 	}
 
 	Set_Hierarchy_Valid(false);
@@ -525,6 +638,10 @@ void Animatable3DObjClass::Set_Animation
 	if ( ModeInterp.Motion1 != NULL ) {
 		ModeInterp.Motion1->Add_Ref();
 	}
+
+	Attach_Cursor(0, motion0);
+	Attach_Cursor(1, motion1);
+	Release_Cursors(2);
 }
 
 
@@ -547,6 +664,9 @@ void Animatable3DObjClass::Set_Animation
 {
 	Release();
 
+	/*
+	** The cursors are kept; Combo_Update matches them up with the anims of the combo.
+	*/
 	CurMotionMode = MULTIPLE_ANIM;
 	ModeCombo.AnimCombo = anim_combo;
 	Set_Hierarchy_Valid(false);
@@ -48,6 +48,7 @@
 #include "always.h"
 #include "composite.h"
 #include "htree.h"
+#include "vector.h"
 
 class SkinClass;
 class RenderInfoClass;
@@ -155,6 +156,13 @@ protected:
 	// Release any anims
 	void								Release( void );
 
+	// Playback cursors.  Slot 0 is Motion/Motion0 and slot 1 Motion1; a combo uses one slot
+	// per anim in the combo.
+	void								Attach_Cursor( int slot, HAnimClass * motion );
+	HAnimCursorClass * const *	Attach_Combo_Cursors( HAnimComboClass * anim );
+	void								Release_Cursors( int first_slot = 0 );
+	HAnimCursorClass *			Peek_Cursor( int slot, HAnimClass * motion ) const;
+
 protected:
 
 	// Is the hierarchy tree currently valid
@@ -204,6 +212,10 @@ protected:
 
 	};
 
+	// Decode cursors owned by this object, so objects sharing an anim don't share its
+	// decode state.  They survive Set_Animation calls that keep the same anim in a slot.
+	DynamicVectorClass<HAnimCursorClass *>	MotionCursors;
+
 	friend class SkinClass;
 };
 
@@ -252,7 +264,7 @@ inline void Animatable3DObjClass::Anim_Update(const Matrix3D & root,HAnimClass *
 	** Apply motion to the base pose
 	*/
 	if ((motion) && (HTree)) {
-		HTree->Anim_Update(root,motion,frame);
+		HTree->Anim_Update(root,motion,frame,Peek_Cursor(0,motion));
 	}
 	Set_Hierarchy_Valid(true);
 }
@@ -284,7 +296,7 @@ inline void Animatable3DObjClass::Blend_Update
 	** Apply motion to the base pose
 	*/
 	if (HTree) {
-		HTree->Blend_Update(root,motion0,frame0,motion1,frame1,percentage);
+		HTree->Blend_Update(root,motion0,frame0,motion1,frame1,percentage,Peek_Cursor(0,motion0),Peek_Cursor(1,motion1));
 	}
 	Set_Hierarchy_Valid(true);
 }
@@ -305,7 +317,7 @@ inline void Animatable3DObjClass::Blend_Update
 inline void Animatable3DObjClass::Combo_Update( const Matrix3D & root, HAnimComboClass *anim )
 {
 	if (HTree) {
-		HTree->Combo_Update(root, anim);
+		HTree->Combo_Update(root, anim, Attach_Combo_Cursors(anim));
 	}
 	Set_Hierarchy_Valid(true);
 }
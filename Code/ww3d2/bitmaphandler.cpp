@@ -18,12 +18,55 @@
 
 #include "bitmaphandler.h"
 #include "wwdebug.h"
+#include <string.h>
+
+#ifdef BITMAPHANDLER_SSE2
+#include <emmintrin.h>
+#endif
 
 void Bitmap_Assert([[maybe_unused]] bool condition)
 {
 	WWASSERT(condition);
 }
 
+void BitmapHandlerClass::Mipmap_Row_A8R8G8B8(
+	unsigned* dest,
+	const unsigned* src_row0,
+	const unsigned* src_row1,
+	unsigned dest_width)
+{
+	unsigned x=0;
+
+#ifdef BITMAPHANDLER_SSE2
+	// Four destination pixels per iteration. Clearing the two low bits of every
+	// channel before the shift keeps the channels from bleeding into each other,
+	// and four values of at most 63 can't carry out of a byte.
+	const __m128i mask=_mm_set1_epi32(0xfcfcfcfc);
+	for (;x+4<=dest_width;x+=4) {
+		__m128i r0a=_mm_loadu_si128((const __m128i*)(src_row0+x*2));
+		__m128i r0b=_mm_loadu_si128((const __m128i*)(src_row0+x*2+4));
+		__m128i r1a=_mm_loadu_si128((const __m128i*)(src_row1+x*2));
+		__m128i r1b=_mm_loadu_si128((const __m128i*)(src_row1+x*2+4));
+
+		r0a=_mm_srli_epi32(_mm_and_si128(r0a,mask),2);
+		r0b=_mm_srli_epi32(_mm_and_si128(r0b,mask),2);
+		r1a=_mm_srli_epi32(_mm_and_si128(r1a,mask),2);
+		r1b=_mm_srli_epi32(_mm_and_si128(r1b,mask),2);
+
+		// Pair up the even and odd source columns
+		__m128i sum0=_mm_add_epi32(r0a,r1a);
+		__m128i sum1=_mm_add_epi32(r0b,r1b);
+		__m128 even=_mm_shuffle_ps(_mm_castsi128_ps(sum0),_mm_castsi128_ps(sum1),_MM_SHUFFLE(2,0,2,0));
+		__m128 odd=_mm_shuffle_ps(_mm_castsi128_ps(sum0),_mm_castsi128_ps(sum1),_MM_SHUFFLE(3,1,3,1));
+		_mm_storeu_si128((__m128i*)(dest+x),_mm_add_epi32(_mm_castps_si128(even),_mm_castps_si128(odd)));
+	}
+#endif
+
+	for (;x<dest_width;++x) {
+		dest[x]=Combine_A8R8G8B8(src_row0[x*2],src_row0[x*2+1],src_row1[x*2],src_row1[x*2+1]);
+	}
+}
+
 void BitmapHandlerClass::Create_Mipmap_B8G8R8A8(
 	unsigned char* dest_surface,
 	unsigned dest_surface_pitch,
@@ -32,19 +75,14 @@ void BitmapHandlerClass::Create_Mipmap_B8G8R8A8(
 	unsigned width,
 	unsigned height)
 {
-	unsigned src_pitch=src_surface_pitch/4;
 	for (unsigned y=0;y<height;y+=2) {
-		unsigned* dest=(unsigned*)dest_surface;
+		Mipmap_Row_A8R8G8B8(
+			(unsigned*)dest_surface,
+			(const unsigned*)src_surface,
+			(const unsigned*)(src_surface+src_surface_pitch),
+			width/2);
 		dest_surface+=dest_surface_pitch;
-		unsigned* src=(unsigned*)src_surface;
-		src_surface+=src_surface_pitch;
-		for (unsigned x=0;x<width;x+=2) {
-			unsigned bgra3=src[src_pitch];
-			unsigned bgra1=*src++;
-			unsigned bgra4=src[src_pitch];
-			unsigned bgra2=*src++;
-			*dest++=Combine_A8R8G8B8(bgra1,bgra2,bgra3,bgra4);
-		}
+		src_surface+=src_surface_pitch*2;
 	}
 }
 
@@ -62,33 +100,16 @@ void BitmapHandlerClass::Copy_Image_Generate_Mipmap(
 {
 	// Optimized loop if source and destination are 32 bit
 	if (src_format==dest_format && src_format==WW3D_FORMAT_A8R8G8B8) {
-		dest_pitch/=4;
-		src_pitch/=4;
-		mip_pitch/=4;
 		for (unsigned y=0;y<height/2;++y) {
-			unsigned* dest_ptr=(unsigned*)dest_surface;
-			dest_ptr+=2*y*dest_pitch;
-			unsigned* src_ptr=(unsigned*)src_surface;
-			src_ptr+=y*2*src_pitch;
-			unsigned* mip_ptr=(unsigned*)mip_surface;
-			mip_ptr+=y*mip_pitch;
-			unsigned b8g8r8a8_00;
-			unsigned b8g8r8a8_01;
-			unsigned b8g8r8a8_10;
-			unsigned b8g8r8a8_11;
-			for (unsigned x=0;x<width/2;x++) {
-				b8g8r8a8_10=src_ptr[src_pitch];
-				dest_ptr[dest_pitch]=b8g8r8a8_10;
-				b8g8r8a8_00=*src_ptr++;
-				*dest_ptr++=b8g8r8a8_00;
-
-				b8g8r8a8_11=src_ptr[src_pitch];
-				dest_ptr[dest_pitch]=b8g8r8a8_11;
-				b8g8r8a8_01=*src_ptr++;
-				*dest_ptr++=b8g8r8a8_01;
-
-				*mip_ptr++=Combine_A8R8G8B8(b8g8r8a8_00,b8g8r8a8_01,b8g8r8a8_10,b8g8r8a8_11);
-			}
+			unsigned char* dest_ptr=dest_surface+2*y*dest_pitch;
+			const unsigned char* src_ptr=src_surface+2*y*src_pitch;
+			memcpy(dest_ptr,src_ptr,(width&~1)*4);
+			memcpy(dest_ptr+dest_pitch,src_ptr+src_pitch,(width&~1)*4);
+			Mipmap_Row_A8R8G8B8(
+				(unsigned*)(mip_surface+y*mip_pitch),
+				(const unsigned*)src_ptr,
+				(const unsigned*)(src_ptr+src_pitch),
+				width/2);
 		}
 		return;
 	}
@@ -97,32 +118,34 @@ void BitmapHandlerClass::Copy_Image_Generate_Mipmap(
 	unsigned src_bpp=Get_Bytes_Per_Pixel(src_format);
 	unsigned dest_bpp=Get_Bytes_Per_Pixel(dest_format);
 
+	// Work a row pair at a time: widen both source rows to 32 bit, write them out, then
+	// filter the mip row out of the widened copies.
+	unsigned row_width=width&~1;
+	unsigned* rows=new unsigned[row_width*2+width/2+1];
+	unsigned* row0=rows;
+	unsigned* row1=rows+row_width;
+	unsigned* mip_row=rows+row_width*2;
+
 	for (unsigned y=0;y<height/2;++y) {
 		unsigned char* dest_ptr=dest_surface+2*y*dest_pitch;
 		unsigned char* src_ptr=src_surface+y*2*src_pitch;
 		unsigned char* mip_ptr=mip_surface+y*mip_pitch;
-		unsigned b8g8r8a8_00;
-		unsigned b8g8r8a8_01;
-		unsigned b8g8r8a8_10;
-		unsigned b8g8r8a8_11;
-		for (unsigned x=0;x<width/2;x++,dest_ptr+=dest_bpp*2,src_ptr+=src_bpp*2,mip_ptr+=dest_bpp) {
-			Read_B8G8R8A8(b8g8r8a8_00,src_ptr,src_format,NULL,0);
-			Write_B8G8R8A8(dest_ptr,dest_format,b8g8r8a8_00);
-
-			Read_B8G8R8A8(b8g8r8a8_01,src_ptr+src_bpp,src_format,NULL,0);
-			Write_B8G8R8A8(dest_ptr+dest_bpp,dest_format,b8g8r8a8_01);
-
-			Read_B8G8R8A8(b8g8r8a8_10,src_ptr+src_pitch,src_format,NULL,0);
-			Write_B8G8R8A8(dest_ptr+dest_pitch,dest_format,b8g8r8a8_10);
 
-			Read_B8G8R8A8(b8g8r8a8_11,src_ptr+src_bpp+src_pitch,src_format,NULL,0);
-			Write_B8G8R8A8(dest_ptr+dest_bpp+dest_pitch,dest_format,b8g8r8a8_11);
-
-			unsigned b8g8r8a8=Combine_A8R8G8B8(b8g8r8a8_00,b8g8r8a8_01,b8g8r8a8_10,b8g8r8a8_11);
+		unsigned x;
+		for (x=0;x<row_width;++x,src_ptr+=src_bpp,dest_ptr+=dest_bpp) {
+			Read_B8G8R8A8(row0[x],src_ptr,src_format,NULL,0);
+			Write_B8G8R8A8(dest_ptr,dest_format,row0[x]);
+			Read_B8G8R8A8(row1[x],src_ptr+src_pitch,src_format,NULL,0);
+			Write_B8G8R8A8(dest_ptr+dest_pitch,dest_format,row1[x]);
+		}
 
-			Write_B8G8R8A8(mip_ptr,dest_format,b8g8r8a8);
+		Mipmap_Row_A8R8G8B8(mip_row,row0,row1,width/2);
+		for (x=0;x<width/2;++x,mip_ptr+=dest_bpp) {
+			Write_B8G8R8A8(mip_ptr,dest_format,mip_row[x]);
 		}
 	}
+
+	delete[] rows;
 }
 
 // ----------------------------------------------------------------------------
@@ -26,6 +26,11 @@
 #include "always.h"
 #include "ww3dformat.h"
 
+// SSE2 row kernels are used when the compiler targets it (always true on x64)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BITMAPHANDLER_SSE2
+#endif
+
 void Bitmap_Assert(bool condition);
 
 class BitmapHandlerClass
@@ -83,6 +88,14 @@ public:
 		unsigned bgra3,
 		unsigned bgra4);
 
+	// Average 2x2 blocks of two A8R8G8B8 source rows into one mipmap row of dest_width
+	// pixels. Gives exactly the same result as Combine_A8R8G8B8.
+	static void Mipmap_Row_A8R8G8B8(
+		unsigned* dest,
+		const unsigned* src_row0,
+		const unsigned* src_row1,
+		unsigned dest_width);
+
 	static void Create_Mipmap_B8G8R8A8(
 		unsigned char* dest_surface,
 		unsigned dest_surface_pitch,
@@ -24,6 +24,14 @@
 #include "bitmaphandler.h"
 #include <string.h>
 
+#ifdef BITMAPHANDLER_SSE2
+#include <emmintrin.h>
+#endif
+
+static bool Decode_DXT1_Block(unsigned* pixels, const unsigned char* block_memory);
+static bool Decode_DXT5_Block(unsigned* pixels, const unsigned char* alpha_block);
+static void Store_4x4_Block(unsigned char* dest_ptr, unsigned dest_pitch, WW3DFormat dest_format, const unsigned* pixels);
+
 // ----------------------------------------------------------------------------
 
 DDSFileClass::DDSFileClass(const char* name,unsigned reduction_factor)
@@ -285,16 +293,26 @@ void DDSFileClass::Copy_Level_To_Surface(
 					}
 				}
 			}
-			else {
+			else if (Format==WW3D_FORMAT_DXT1 || Format==WW3D_FORMAT_DXT5) {
 				unsigned dest_bpp=Get_Bytes_Per_Pixel(dest_format);
 
-				// Copy 4x4 block at a time
+				// The sizes match so the blocks are stored in the order we write them,
+				// walk them linearly a block row at a time.
+				const unsigned char* block=Get_Memory_Pointer(level);
+				unsigned block_size=(Format==WW3D_FORMAT_DXT1) ? 8 : 16;
+				unsigned pixels[16];
 				bool contains_alpha=false;
 				for (unsigned y=0;y<dest_height;y+=4) {
 					unsigned char* dest_ptr=dest_surface;
 					dest_ptr+=y*dest_pitch;
-					for (unsigned x=0;x<dest_width;x+=4,dest_ptr+=dest_bpp*4) {
-						contains_alpha|=Get_4x4_Block(dest_ptr,dest_pitch,dest_format,level,x,y);
+					for (unsigned x=0;x<dest_width;x+=4,dest_ptr+=dest_bpp*4,block+=block_size) {
+						if (Format==WW3D_FORMAT_DXT1) {
+							contains_alpha|=Decode_DXT1_Block(pixels,block);
+						}
+						else {
+							contains_alpha|=Decode_DXT5_Block(pixels,block);
+						}
+						Store_4x4_Block(dest_ptr,dest_pitch,dest_format,pixels);
 					}
 				}
 				if (Format==WW3D_FORMAT_DXT1 && contains_alpha) {
@@ -481,6 +499,139 @@ unsigned DDSFileClass::Get_Pixel(unsigned level,unsigned x,unsigned y) const
 	return 0xffffffff;
 }
 
+// ----------------------------------------------------------------------------
+//
+// Block decoders. Each one expands a compressed block into 16 A8R8G8B8 pixels in
+// raster order and returns true if the block had any alpha in it.
+//
+// ----------------------------------------------------------------------------
+
+// Expand the four 2-bit color indices of one block row through the palette
+WWINLINE static void Decode_Color_Row(unsigned* dest, unsigned char line, const unsigned* palette)
+{
+#ifdef BITMAPHANDLER_SSE2
+	// Lane n looks at bits 2n..2n+1 of the line, the compares pick the palette entry
+	const __m128i index_mask=_mm_setr_epi32(0x03,0x0c,0x30,0xc0);
+	const __m128i index_1=_mm_setr_epi32(0x01,0x04,0x10,0x40);
+	const __m128i index_2=_mm_setr_epi32(0x02,0x08,0x20,0x80);
+	__m128i bits=_mm_and_si128(_mm_set1_epi32(line),index_mask);
+
+	__m128i result=_mm_and_si128(_mm_cmpeq_epi32(bits,_mm_setzero_si128()),_mm_set1_epi32(palette[0]));
+	result=_mm_or_si128(result,_mm_and_si128(_mm_cmpeq_epi32(bits,index_1),_mm_set1_epi32(palette[1])));
+	result=_mm_or_si128(result,_mm_and_si128(_mm_cmpeq_epi32(bits,index_2),_mm_set1_epi32(palette[2])));
+	result=_mm_or_si128(result,_mm_and_si128(_mm_cmpeq_epi32(bits,index_mask),_mm_set1_epi32(palette[3])));
+	_mm_storeu_si128((__m128i*)dest,result);
+#else
+	for (int x=0;x<4;++x) {
+		dest[x]=palette[line&3];
+		line>>=2;
+	}
+#endif
+}
+
+static bool Decode_DXT1_Block(unsigned* pixels, const unsigned char* block_memory)
+{
+	unsigned col0=RGB565_To_ARGB8888(*(unsigned short*)&block_memory[0]);
+	unsigned col1=RGB565_To_ARGB8888(*(unsigned short*)&block_memory[2]);
+
+	// Even if we don't support alpha, decompression is different if source has alpha
+	unsigned palette[4];
+	palette[0]=col0|0xff000000;
+	palette[1]=col1|0xff000000;
+	bool contains_alpha=false;
+	if (col0>col1) {
+		palette[2]=Combine_Colors(col1,col0,85)|0xff000000;
+		palette[3]=Combine_Colors(col0,col1,85)|0xff000000;
+	}
+	else {
+		palette[2]=Combine_Colors(col1,col0,128)|0xff000000;
+		palette[3]=0x00000000;
+
+		// Index 3 is transparent, look for it in the index bits
+		unsigned indices=*(unsigned*)&block_memory[4];
+		contains_alpha=((indices&(indices>>1)&0x55555555)!=0);
+	}
+
+	for (int y=0;y<4;++y) {
+		Decode_Color_Row(pixels+y*4,block_memory[4+y],palette);
+	}
+	return contains_alpha;
+}
+
+static bool Decode_DXT5_Block(unsigned* pixels, const unsigned char* alpha_block)
+{
+	// Init alphas
+	unsigned alphas[8];
+	alphas[0]=alpha_block[0];
+	alphas[1]=alpha_block[1];
+
+	// 8-alpha or 6-alpha block?
+	if (alphas[0]>alphas[1]) {
+		alphas[2]=(6*alphas[0]+1*alphas[1]+3) / 7;   // bit code 010
+		alphas[3]=(5*alphas[0]+2*alphas[1]+3) / 7;   // bit code 011
+		alphas[4]=(4*alphas[0]+3*alphas[1]+3) / 7;   // bit code 100
+		alphas[5]=(3*alphas[0]+4*alphas[1]+3) / 7;   // bit code 101
+		alphas[6]=(2*alphas[0]+5*alphas[1]+3) / 7;   // bit code 110
+		alphas[7]=(1*alphas[0]+6*alphas[1]+3) / 7;   // bit code 111
+	}
+	else {
+		alphas[2]=(4*alphas[0]+1*alphas[1]+2) / 5;   // Bit code 010
+		alphas[3]=(3*alphas[0]+2*alphas[1]+2) / 5;   // Bit code 011
+		alphas[4]=(2*alphas[0]+3*alphas[1]+2) / 5;   // Bit code 100
+		alphas[5]=(1*alphas[0]+4*alphas[1]+2) / 5;   // Bit code 101
+		alphas[6]=0; 										   // Bit code 110
+		alphas[7]=255; 									   // Bit code 111
+	}
+
+	// Init colors. The DXT5 color block always uses the four color mode.
+	const unsigned char* color_block=alpha_block+8;
+	unsigned col0=RGB565_To_ARGB8888(*(unsigned short*)&color_block[0]);
+	unsigned col1=RGB565_To_ARGB8888(*(unsigned short*)&color_block[2]);
+	unsigned palette[4];
+	palette[0]=col0;
+	palette[1]=col1;
+	palette[2]=Combine_Colors(col1,col0,85);
+	palette[3]=Combine_Colors(col0,col1,85);
+
+	for (int y=0;y<4;++y) {
+		Decode_Color_Row(pixels+y*4,color_block[4+y],palette);
+	}
+
+	// The 48 bits of 3-bit alpha indices, eight pixels per three bytes
+	unsigned contains_alpha=0xff;
+	const unsigned char* index_ptr=alpha_block+2;
+	for (int a=0;a<2;++a,index_ptr+=3) {
+		unsigned bits=index_ptr[0]|(index_ptr[1]<<8)|(index_ptr[2]<<16);
+		for (int i=0;i<8;++i,bits>>=3) {
+			unsigned alpha_value=alphas[bits&7];
+			contains_alpha&=alpha_value;
+			pixels[a*8+i]|=alpha_value<<24;
+		}
+	}
+
+	return contains_alpha!=0xff;	// Alpha block... DXT5 should only be used when the image needs alpha
+											// but for now check anyway...
+}
+
+// Write 16 decoded pixels to the destination surface
+static void Store_4x4_Block(unsigned char* dest_ptr, unsigned dest_pitch, WW3DFormat dest_format, const unsigned* pixels)
+{
+	if (dest_format==WW3D_FORMAT_A8R8G8B8 || dest_format==WW3D_FORMAT_X8R8G8B8) {
+		for (int y=0;y<4;++y,dest_ptr+=dest_pitch) {
+			memcpy(dest_ptr,pixels+y*4,16);
+		}
+		return;
+	}
+
+	unsigned dest_bpp=Get_Bytes_Per_Pixel(dest_format);
+	for (int y=0;y<4;++y,dest_ptr+=dest_pitch) {
+		unsigned char* tmp_dest_ptr=dest_ptr;
+		for (int x=0;x<4;++x,tmp_dest_ptr+=dest_bpp) {
+			BitmapHandlerClass::Write_B8G8R8A8(tmp_dest_ptr,dest_format,pixels[y*4+x]);
+		}
+	}
+}
+
 // ----------------------------------------------------------------------------
 //
 // Uncompress one 4x4 block from the compressed image.
@@ -508,7 +659,8 @@ bool DDSFileClass::Get_4x4_Block(
 	WWASSERT(source_x<Get_Width(level));
 	WWASSERT(source_y<Get_Height(level));
 
-	unsigned dest_bpp=Get_Bytes_Per_Pixel(dest_format);
+	unsigned pixels[16];
+	bool contains_alpha=false;
 
 	switch (Format) {
 	// Note that we don't currently really support alpha on DXT1 - all alpha textures should use DXT5.
@@ -517,184 +669,15 @@ bool DDSFileClass::Get_4x4_Block(
 	// basis there isn't really a way to tell if the surface has an alpha or not so either we use alpha
 	// or we don't.
 	case WW3D_FORMAT_DXT1:
-		{
-			const unsigned char* block_memory=Get_Memory_Pointer(level)+(source_x/4)*8+((source_y/4)*(Get_Width(level)/4))*8;
-
-			unsigned col0=RGB565_To_ARGB8888(*(unsigned short*)&block_memory[0]);
-			unsigned col1=RGB565_To_ARGB8888(*(unsigned short*)&block_memory[2]);
-			// Even if we don't support alpha, decompression is different if source has alpha
-			unsigned dest_pixel=0;
-			if (col0>col1) {
-				for (int y=0;y<4;++y) {
-					unsigned char* tmp_dest_ptr=dest_ptr;
-					dest_ptr+=dest_pitch;
-					unsigned char line=block_memory[4+y];
-					for (int x=0;x<4;++x) {
-						switch (line&3) {
-						case 0: dest_pixel=col0|0xff000000; break;
-						case 1: dest_pixel=col1|0xff000000; break;
-						case 2: dest_pixel=Combine_Colors(col1,col0,85)|0xff000000; break;
-						case 3: dest_pixel=Combine_Colors(col0,col1,85)|0xff000000; break;
-						}
-						line>>=2;
-
-						BitmapHandlerClass::Write_B8G8R8A8(tmp_dest_ptr,dest_format,dest_pixel);
-						tmp_dest_ptr+=dest_bpp;
-					}
-				}
-				return false;	// No alpha found in the block
-			}
-			else {
-				bool contains_alpha=false;
-				for (int y=0;y<4;++y) {
-					unsigned char* tmp_dest_ptr=dest_ptr;
-					dest_ptr+=dest_pitch;
-					unsigned char line=block_memory[4+y];
-					for (int x=0;x<4;++x) {
-						switch (line&3) {
-						case 0: dest_pixel=col0|0xff000000; break;
-						case 1: dest_pixel=col1|0xff000000; break;
-						case 2: dest_pixel=Combine_Colors(col1,col0,128)|0xff000000; break;
-						case 3: dest_pixel=0x00000000; contains_alpha=true; break;
-						}
-						line>>=2;
-
-						BitmapHandlerClass::Write_B8G8R8A8(tmp_dest_ptr,dest_format,dest_pixel);
-						tmp_dest_ptr+=dest_bpp;
-					}
-				}
-				return contains_alpha;	// Alpha block...?
-			}
-		}
+		contains_alpha=Decode_DXT1_Block(pixels,Get_Memory_Pointer(level)+(source_x/4)*8+((source_y/4)*(Get_Width(level)/4))*8);
 		break;
-	case WW3D_FORMAT_DXT2:
-		return false;
-	case WW3D_FORMAT_DXT3:
-		return false;
-	case WW3D_FORMAT_DXT4:
-		return false;
 	case WW3D_FORMAT_DXT5:
-		{
-			// Init alphas
-			const unsigned char* alpha_block=Get_Memory_Pointer(level)+(source_x/4)*16+((source_y/4)*(Get_Width(level)/4))*16;
-
-			unsigned alphas[8];
-			alphas[0]=alpha_block[0];
-			alphas[1]=alpha_block[1];
-
-			// 8-alpha or 6-alpha block?
-			if (alphas[0]>alphas[1]) {
-				alphas[2]=(6*alphas[0]+1*alphas[1]+3) / 7;   // bit code 010
-				alphas[3]=(5*alphas[0]+2*alphas[1]+3) / 7;   // bit code 011
-				alphas[4]=(4*alphas[0]+3*alphas[1]+3) / 7;   // bit code 100
-				alphas[5]=(3*alphas[0]+4*alphas[1]+3) / 7;   // bit code 101
-				alphas[6]=(2*alphas[0]+5*alphas[1]+3) / 7;   // bit code 110
-				alphas[7]=(1*alphas[0]+6*alphas[1]+3) / 7;   // bit code 111
-			}
-			else {
-				alphas[2]=(4*alphas[0]+1*alphas[1]+2) / 5;   // Bit code 010
-				alphas[3]=(3*alphas[0]+2*alphas[1]+2) / 5;   // Bit code 011
-				alphas[4]=(2*alphas[0]+3*alphas[1]+2) / 5;   // Bit code 100
-				alphas[5]=(1*alphas[0]+4*alphas[1]+2) / 5;   // Bit code 101
-				alphas[6]=0; 										   // Bit code 110
-				alphas[7]=255; 									   // Bit code 111
-			}
-
-			// Init colors
-			const unsigned char* color_block=alpha_block+8;
-			unsigned col0=RGB565_To_ARGB8888(*(unsigned short*)&color_block[0]);
-			unsigned col1=RGB565_To_ARGB8888(*(unsigned short*)&color_block[2]);
-
-			unsigned dest_pixel=0;
-			unsigned bit_idx=0;
-			unsigned contains_alpha=0xff;
-
-			unsigned alpha_indices[16];
-			unsigned* ai_ptr=alpha_indices;
-			for (int a=0;a<2;++a) {
-				ai_ptr[0]=alpha_block[2]&0x7;
-				ai_ptr[1]=(alpha_block[2]>>3)&0x7;
-				ai_ptr[2]=(alpha_block[2]>>6)|((alpha_block[3]&1)<<2);
-				ai_ptr[3]=(alpha_block[3]>>1)&0x7;
-				ai_ptr[4]=(alpha_block[3]>>4)&0x7;
-				ai_ptr[5]=(alpha_block[3]>>7)|((alpha_block[4]&3)<<1);
-				ai_ptr[6]=(alpha_block[4]>>2)&0x7;
-				ai_ptr[7]=(alpha_block[4]>>5);
-				ai_ptr+=8;
-				alpha_block+=3;
-			}
-
-			unsigned aii=0;
-			for (int y=0;y<4;++y) {
-				unsigned char* tmp_dest_ptr=dest_ptr;
-				dest_ptr+=dest_pitch;
-				unsigned char line=color_block[4+y];
-				for (int x=0;x<4;++x,bit_idx+=3) {
-					unsigned alpha_value=alphas[alpha_indices[aii++]];
-					contains_alpha&=alpha_value;
-					alpha_value<<=24;
-
-					// Extract color
-
-					switch (line&3) {
-					case 0: dest_pixel=col0|alpha_value; break;
-					case 1: dest_pixel=col1|alpha_value; break;
-					case 2: dest_pixel=Combine_Colors(col1,col0,85)|alpha_value; break;
-					case 3: dest_pixel=Combine_Colors(col0,col1,85)|alpha_value; break;
-					}
-					line>>=2;
-
-					BitmapHandlerClass::Write_B8G8R8A8(tmp_dest_ptr,dest_format,dest_pixel);
-					tmp_dest_ptr+=dest_bpp;
-				}
-			}
-
-
-
-
-/*
-			for (int y=0;y<4;++y) {
-				unsigned char* tmp_dest_ptr=dest_ptr;
-				dest_ptr+=dest_pitch;
-				unsigned char line=color_block[4+y];
-				for (int x=0;x<4;++x,bit_idx+=3) {
-					unsigned byte_idx=bit_idx/8;
-					unsigned tmp_bit_idx=bit_idx&7;
-					unsigned alpha_index=0;
-					for (int i=0;i<3;++i) {
-						WWASSERT(byte_idx<6);
-						unsigned alpha_bit=(alpha_block[2+byte_idx]>>(tmp_bit_idx))&1;
-						alpha_index|=alpha_bit<<(i);
-						tmp_bit_idx++;
-						if (tmp_bit_idx>=8) {
-							tmp_bit_idx=0;
-							byte_idx++;
-						}
-					}
-					WWASSERT(alpha_index<8);
-					unsigned alpha_value=alphas[alpha_index];
-					contains_alpha&=alpha_value;
-					alpha_value<<=24;
-
-					// Extract color
-
-					switch (line&3) {
-					case 0: dest_pixel=col0|alpha_value; break;
-					case 1: dest_pixel=col1|alpha_value; break;
-					case 2: dest_pixel=Combine_Colors(col1,col0,85)|alpha_value; break;
-					case 3: dest_pixel=Combine_Colors(col0,col1,85)|alpha_value; break;
-					}
-					line>>=2;
-
-					BitmapHandlerClass::Write_B8G8R8A8(tmp_dest_ptr,dest_format,dest_pixel);
-					tmp_dest_ptr+=dest_bpp;
-				}
-			}
-*/
-			return contains_alpha!=0xff;	// Alpha block... DXT5 should only be used when the image needs alpha
-													// but for now check anyway...
-		}
+		contains_alpha=Decode_DXT5_Block(pixels,Get_Memory_Pointer(level)+(source_x/4)*16+((source_y/4)*(Get_Width(level)/4))*16);
+		break;
+	default:
+		return false;
 	}
-	return false;
 
+	Store_4x4_Block(dest_ptr,dest_pitch,dest_format,pixels);
+	return contains_alpha;
 }
@@ -38,6 +38,7 @@
 
 //#define ENABLE_CATEGORY_LOG
 //#define ENABLE_STRIPING
+#define ENABLE_VERTEX_CACHE_OPTIMIZATION
 
 #include <bit>
 #include "dx8renderer.h"
@@ -59,6 +60,7 @@
 #include "matpass.h"
 #include "camera.h"
 #include "stripoptimizer.h"
+#include "skinbatch.h"
 #include "meshgeometry.h"
 #include "hashtemplate.h"
 
@@ -70,8 +72,7 @@ DX8MeshRendererClass TheDX8MeshRenderer;
 
 // ----------------------------------------------------------------------------
 
-static DynamicVectorClass<Vector3>				_TempVertexBuffer;
-static DynamicVectorClass<Vector3>				_TempNormalBuffer;
+static SkinBatchClass									_SkinBatch;
 
 static TextureCategoryList							texture_category_delete_list;
 static FVFCategoryList								fvf_category_container_delete_list;
@@ -1313,62 +1314,20 @@ void DX8SkinFVFCategoryContainer::Render(void)
 
 			DX8_RECORD_SKIN_RENDER(mesh->Get_Num_Polys(),mesh_vertex_count);
 
-			if (_TempVertexBuffer.Length() < mesh_vertex_count) _TempVertexBuffer.Resize(mesh_vertex_count);
-			if (_TempNormalBuffer.Length() < mesh_vertex_count) _TempNormalBuffer.Resize(mesh_vertex_count);
-
-			Vector3* loc=&(_TempVertexBuffer[0]);
-			Vector3* norm=&(_TempNormalBuffer[0]);
-			const Vector2* uv0=mmc->Get_UV_Array_By_Index(0);
-			const Vector2* uv1=mmc->Get_UV_Array_By_Index(1);
-			const unsigned* diffuse=mmc->Get_Color_Array(0,false);
-
-			VertexFormatXYZNDUV2* verts=dest_verts+vertex_offset;
-
-//			mesh->Compose_Deformed_Vertex_Buffer(verts,uv0,uv1,diffuse);
-			mesh->Get_Deformed_Vertices(loc,norm);
-
-			for (int v=0;v<mesh_vertex_count;++v) {
-				verts[v].x=(*loc)[0];
-				verts[v].y=(*loc)[1];
-				verts[v].z=(*loc)[2];
-				verts[v].nx=(*norm)[0];
-				verts[v].ny=(*norm)[1];
-				verts[v].nz=(*norm)[2];
-				if (diffuse) {
-					verts[v].diffuse=*diffuse++;
-				}
-				else {
-					verts[v].diffuse=0;
-				}
-				if (uv0) {
-					verts[v].u1=(*uv0)[0];
-					verts[v].v1=(*uv0)[1];
-					uv0++;
-				}
-				else {
-					verts[v].u1=0.0f;
-					verts[v].v1=0.0f;
-				}
-				if (uv1) {
-					verts[v].u2=(*uv1)[0];
-					verts[v].v2=(*uv1)[1];
-					uv1++;
-				}
-				else {
-					verts[v].u2=0.0f;
-					verts[v].v2=0.0f;
-				}
-
-				loc++;
-				norm++;
-			}
-
+			WWASSERT(mmc->Get_Flag(MeshGeometryClass::SKIN));
+			WWASSERT(mesh->Get_Container() != NULL && mesh->Get_Container()->Get_HTree() != NULL);
+			_SkinBatch.Add(mmc,mesh->Get_Container()->Get_HTree(),dest_verts+vertex_offset);
 
 			mesh->Set_Base_Vertex_Offset(vertex_offset);
 			vertex_offset+=mesh_vertex_count;
 
 			mesh = mesh->Peek_Next_Visible_Skin();
 		}
+
+		/*
+		** Deform them all into the locked buffer, spread over the job system's threads
+		*/
+		_SkinBatch.Update();
 	}
 	WWASSERT(vertex_offset==VisibleVertexCount);
 
@@ -1562,15 +1521,11 @@ unsigned DX8TextureCategoryClass::Add_Mesh(
 				false);
 			PolygonRendererList.Add_Tail(p_renderer);
 
-			IndexBufferClass::AppendLockClass l(index_buffer,index_offset,index_count);
-			unsigned short* dst_indices=l.Get_Index_Array();
-
-			unsigned short vmin=0xffff;
-			unsigned short vmax=0;
-
 			/*
-			** Iterate over the polys for this pass, adding each one that matches this texture+material+shader
+			** Gather the polys for this pass that match this texture+material+shader
 			*/
+			int* triangles=new int[index_count];
+			int triangle_index_count=0;
 			for (int i=0;i<poly_count;++i) {
 				bool all_textures_same = true;
 				for (unsigned int stage = 0; stage < MeshMatDescClass::MAX_TEX_STAGES; stage++) {
@@ -1580,27 +1535,44 @@ unsigned DX8TextureCategoryClass::Add_Mesh(
 				ShaderClass shd=split_table.Peek_Shader(i,texpass);
 
 				if (all_textures_same && Equal_Material(mat,material) && shd==shader) {
-					unsigned short idx;
-
-					idx=static_cast<unsigned short>(src_indices[i][0]+vertex_offset);
-					vmin=MIN(vmin,idx);
-					vmax=MAX(vmax,idx);
-					*dst_indices++=idx;
-//					WWDEBUG_SAY(("%d, ",idx));
-
-					idx=static_cast<unsigned short>(src_indices[i][1]+vertex_offset);
-					vmin=MIN(vmin,idx);
-					vmax=MAX(vmax,idx);
-					*dst_indices++=idx;
-//					WWDEBUG_SAY(("%d, ",idx));
-
-					idx=static_cast<unsigned short>(src_indices[i][2]+vertex_offset);
-					vmin=MIN(vmin,idx);
-					vmax=MAX(vmax,idx);
-					*dst_indices++=idx;
-//					WWDEBUG_SAY(("%d\n",idx));
+					triangles[triangle_index_count++]=src_indices[i][0];
+					triangles[triangle_index_count++]=src_indices[i][1];
+					triangles[triangle_index_count++]=src_indices[i][2];
 				}
 			}
+			WWASSERT(triangle_index_count==(int)index_count);
+
+#ifdef ENABLE_VERTEX_CACHE_OPTIMIZATION
+			/*
+			** Reorder the polys for the vertex cache. Opaque polys are drawn in any order, so their clusters are
+			** also sorted to cut overdraw. Sorted and blended polys keep the order the artist gave them.
+			*/
+			if (index_buffer->Type()!=BUFFER_TYPE_SORTING && index_buffer->Type()!=BUFFER_TYPE_DYNAMIC_SORTING &&
+				!shader.Uses_Alpha() && shader.Get_Dst_Blend_Func()==ShaderClass::DSTBLEND_ZERO) {
+
+				int vertex_count=split_table.Get_Vertex_Count();
+				int* cluster_starts=new int[polygons];
+				int cluster_count=StripOptimizerClass::Optimize_Vertex_Cache(triangles,polygons,vertex_count,StripOptimizerClass::DEFAULT_CACHE_SIZE,cluster_starts);
+				StripOptimizerClass::Optimize_Overdraw(triangles,polygons,split_table.Get_Vertex_Array(),vertex_count,cluster_starts,cluster_count);
+				delete[] cluster_starts;
+			}
+#endif
+
+			IndexBufferClass::AppendLockClass l(index_buffer,index_offset,index_count);
+			unsigned short* dst_indices=l.Get_Index_Array();
+
+			unsigned short vmin=0xffff;
+			unsigned short vmax=0;
+
+			for (unsigned i=0;i<index_count;++i) {
+				unsigned short idx;
+
+				idx=static_cast<unsigned short>(triangles[i]+vertex_offset);
+				vmin=MIN(vmin,idx);
+				vmax=MAX(vmax,idx);
+				*dst_indices++=idx;
+			}
+			delete[] triangles;
 
 			WWASSERT((vmax-vmin)<split_table.Get_Mesh_Model_Class()->Get_Vertex_Count());
 
@@ -60,6 +60,7 @@ class HTreeClass;
 class ChunkLoadClass;
 class ChunkSaveClass;
 class HTreeClass;
+class HAnimCursorClass;
 
 
 
@@ -99,6 +100,15 @@ public:
 	virtual void				Get_Transform(Matrix3D&, int pividx, float frame) const = 0;
 	virtual bool				Get_Visibility(int pividx,float frame) = 0;
 
+	// Playback cursors.  Formats that decode their channels incrementally return a cursor
+	// that the object playing the animation owns and passes back in, so each object keeps
+	// its own decode position.  The default is no cursor, the lookups ignore it.
+	virtual HAnimCursorClass *	Create_Cursor(void)																{ return NULL; }
+	virtual void				Get_Translation(Vector3& translation, int pividx,float frame,HAnimCursorClass * /* cursor */) const	{ Get_Translation(translation,pividx,frame); }
+	virtual void				Get_Orientation(Quaternion& orientation, int pividx,float frame,HAnimCursorClass * /* cursor */) const	{ Get_Orientation(orientation,pividx,frame); }
+	virtual void				Get_Transform(Matrix3D& transform, int pividx, float frame,HAnimCursorClass * /* cursor */) const	{ Get_Transform(transform,pividx,frame); }
+	virtual bool				Get_Visibility(int pividx,float frame,HAnimCursorClass * /* cursor */)	{ return Get_Visibility(pividx,frame); }
+
 	virtual int					Get_Num_Pivots(void) const = 0;
 	virtual bool				Is_Node_Motion_Present(int pividx) = 0;
 
@@ -118,6 +128,27 @@ protected:
 };
 
 
+/*
+** HAnimCursorClass is the per-object playback state for an animation, created by
+** HAnimClass::Create_Cursor.  It holds a reference to its animation so a cursor can
+** always tell whether it belongs to a given anim.
+*/
+class HAnimCursorClass
+{
+public:
+	HAnimCursorClass(HAnimClass * anim) : Anim(anim)		{ Anim->Add_Ref(); }
+	virtual ~HAnimCursorClass(void)								{ Anim->Release_Ref(); }
+
+	HAnimClass *				Peek_Anim(void) const			{ return Anim; }
+
+private:
+	HAnimCursorClass(const HAnimCursorClass &);
+	HAnimCursorClass & operator = (const HAnimCursorClass &);
+
+	HAnimClass *				Anim;
+};
+
+
 /*
 ** The PivotMapClass is used by the HAnimComboDataClass (sometimes) to keep track of animation
 ** weights per-pivot point.
@@ -46,6 +46,8 @@
  *   HCompressedAnimClass::read_bit_channel -- read a bit channel from the file                *
  *   HCompressedAnimClass::add_bit_channel -- install a bit channel into the animation         *
  *   HCompressedAnimClass::Get_Visibility -- return visibility state for given pivot/frame     *
+ *   HCompressedAnimClass::Create_Cursor -- create a playback cursor for this animation        *
+ *   HCompressedAnimClass::assign_cursors -- give every channel a slot in the cursors          *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 
@@ -95,6 +97,42 @@ struct NodeCompressedMotionStruct
 
 
 	TimeCodedBitChannelClass *			Vis;
+
+	enum
+	{
+		CURSOR_X = 0,
+		CURSOR_Y,
+		CURSOR_Z,
+		CURSOR_Q,
+		CURSOR_VIS,
+		CURSOR_COUNT
+	};
+
+	int										Cursor[CURSOR_COUNT];	// slot in HCompressedAnimCursorClass, -1 for missing channels
+};
+
+
+/*
+** HCompressedAnimCursorClass holds one decode cursor for each channel of the animation.
+*/
+class HCompressedAnimCursorClass : public HAnimCursorClass
+{
+public:
+	HCompressedAnimCursorClass(HCompressedAnimClass * anim,int count) :
+		HAnimCursorClass(anim),
+		Cursors(new MotionChannelCursorStruct[count > 0 ? count : 1])
+	{
+		for (int i=0; i<count; i++) {
+			Cursors[i].Reset();
+		}
+	}
+
+	~HCompressedAnimCursorClass(void) override
+	{
+		delete[] Cursors;
+	}
+
+	MotionChannelCursorStruct *		Cursors;
 };
 
 /***********************************************************************************************
@@ -115,6 +153,10 @@ NodeCompressedMotionStruct::NodeCompressedMotionStruct() :
 		vd.Y = NULL;
 		vd.Z = NULL;
 		vd.Q = NULL;
+
+		for (int i=0; i<CURSOR_COUNT; i++) {
+			Cursor[i] = -1;
+		}
 }
 
 
@@ -175,7 +217,8 @@ HCompressedAnimClass::HCompressedAnimClass(void) :
 	NumNodes(0),
 	Flavor(0),
 	FrameRate(0),
-	NodeMotion(NULL)
+	NodeMotion(NULL),
+	NumCursors(0)
 {
 	memset(Name,0,W3D_NAME_LEN);
 	memset(HierarchyName,0,W3D_NAME_LEN);
@@ -216,7 +259,9 @@ void HCompressedAnimClass::Free(void)
 {
 	if (NodeMotion != NULL) {
 		delete[] NodeMotion;
+		NodeMotion = NULL;
 	}
+	NumCursors = 0;
 }
 
 
@@ -364,6 +409,7 @@ int HCompressedAnimClass::Load_W3D(ChunkLoadClass & cload)
 		cload.Close_Chunk();
 	}
 
+	assign_cursors();
 	return OK;
 
 Error:
@@ -528,6 +574,11 @@ void HCompressedAnimClass::add_bit_channel(TimeCodedBitChannelClass * newchan)
  *   08/11/1997 GH  : Created.                                                                 *
  *=============================================================================================*/
 void HCompressedAnimClass::Get_Translation( Vector3& trans, int pividx, float frame ) const
+{
+	Get_Translation(trans, pividx, frame, NULL);
+}
+
+void HCompressedAnimClass::Get_Translation( Vector3& trans, int pividx, float frame, HAnimCursorClass * cursor ) const
 {
 	struct NodeCompressedMotionStruct * motion = &NodeMotion[pividx];
 
@@ -535,14 +586,14 @@ void HCompressedAnimClass::Get_Translation( Vector3& trans, int pividx, float fr
 
 	switch(Flavor) {
 		case ANIM_FLAVOR_TIMECODED:
-			if (motion->tc.X) motion->tc.X->Get_Vector(frame, &(trans[0]));
-			if (motion->tc.Y) motion->tc.Y->Get_Vector(frame, &(trans[1]));
-			if (motion->tc.Z) motion->tc.Z->Get_Vector(frame, &(trans[2]));
+			if (motion->tc.X) motion->tc.X->Get_Vector(frame, &(trans[0]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_X));
+			if (motion->tc.Y) motion->tc.Y->Get_Vector(frame, &(trans[1]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Y));
+			if (motion->tc.Z) motion->tc.Z->Get_Vector(frame, &(trans[2]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Z));
 			break;
 		case ANIM_FLAVOR_ADAPTIVE_DELTA:
-			if (motion->ad.X) motion->ad.X->Get_Vector(frame, &(trans[0]));
-			if (motion->ad.Y) motion->ad.Y->Get_Vector(frame, &(trans[1]));
-			if (motion->ad.Z) motion->ad.Z->Get_Vector(frame, &(trans[2]));
+			if (motion->ad.X) motion->ad.X->Get_Vector(frame, &(trans[0]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_X));
+			if (motion->ad.Y) motion->ad.Y->Get_Vector(frame, &(trans[1]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Y));
+			if (motion->ad.Z) motion->ad.Z->Get_Vector(frame, &(trans[2]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Z));
 			break;
 		default:
 			WWASSERT(0);	// unknown flavor
@@ -564,13 +615,20 @@ void HCompressedAnimClass::Get_Translation( Vector3& trans, int pividx, float fr
  *=============================================================================================*/
 void HCompressedAnimClass::Get_Orientation(Quaternion& q, int pividx,float frame) const
 {
+	Get_Orientation(q, pividx, frame, NULL);
+}
+
+void HCompressedAnimClass::Get_Orientation(Quaternion& q, int pividx,float frame,HAnimCursorClass * cursor) const
+{
+	MotionChannelCursorStruct * qcursor = peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Q);
+
 	switch(Flavor) {
 		case ANIM_FLAVOR_TIMECODED:
-			if (NodeMotion[pividx].tc.Q) q = NodeMotion[pividx].tc.Q->Get_QuatVector(frame);
+			if (NodeMotion[pividx].tc.Q) q = NodeMotion[pividx].tc.Q->Get_QuatVector(frame, qcursor);
 			else q.Make_Identity();
 			break;
 		case ANIM_FLAVOR_ADAPTIVE_DELTA:
-			if (NodeMotion[pividx].ad.Q) q = NodeMotion[pividx].ad.Q->Get_QuatVector(frame);
+			if (NodeMotion[pividx].ad.Q) q = NodeMotion[pividx].ad.Q->Get_QuatVector(frame, qcursor);
 			else q.Make_Identity();
 			break;
 		default:
@@ -592,6 +650,11 @@ void HCompressedAnimClass::Get_Orientation(Quaternion& q, int pividx,float frame
  *   08/11/1997 GH  : Created.                                                                 *
  *=============================================================================================*/
 void HCompressedAnimClass::Get_Transform( Matrix3D& mtx, int pividx, float frame ) const
+{
+	Get_Transform(mtx, pividx, frame, NULL);
+}
+
+void HCompressedAnimClass::Get_Transform( Matrix3D& mtx, int pividx, float frame, HAnimCursorClass * cursor ) const
 {
 	struct NodeCompressedMotionStruct * motion = &NodeMotion[pividx];
 
@@ -599,25 +662,25 @@ void HCompressedAnimClass::Get_Transform( Matrix3D& mtx, int pividx, float frame
 		case ANIM_FLAVOR_TIMECODED:
 			if (NodeMotion[pividx].tc.Q) {
 				Quaternion q;
-				q = NodeMotion[pividx].tc.Q->Get_QuatVector(frame);
+				q = NodeMotion[pividx].tc.Q->Get_QuatVector(frame, peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Q));
 				mtx=::Build_Matrix3D(q);
 			}
 			else mtx.Make_Identity();
-			if (motion->tc.X) motion->tc.X->Get_Vector(frame, &(mtx[0][3]));
-			if (motion->tc.Y) motion->tc.Y->Get_Vector(frame, &(mtx[1][3]));
-			if (motion->tc.Z) motion->tc.Z->Get_Vector(frame, &(mtx[2][3]));
+			if (motion->tc.X) motion->tc.X->Get_Vector(frame, &(mtx[0][3]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_X));
+			if (motion->tc.Y) motion->tc.Y->Get_Vector(frame, &(mtx[1][3]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Y));
+			if (motion->tc.Z) motion->tc.Z->Get_Vector(frame, &(mtx[2][3]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Z));
 			break;
 		case ANIM_FLAVOR_ADAPTIVE_DELTA:
 			if (NodeMotion[pividx].ad.Q) {
 				Quaternion q;
-				q = NodeMotion[pividx].ad.Q->Get_QuatVector(frame);
+				q = NodeMotion[pividx].ad.Q->Get_QuatVector(frame, peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Q));
 				mtx=::Build_Matrix3D(q);
 			}
 			else mtx.Make_Identity();
 
-			if (motion->ad.X) motion->ad.X->Get_Vector(frame, &(mtx[0][3]));
-			if (motion->ad.Y) motion->ad.Y->Get_Vector(frame, &(mtx[1][3]));
-			if (motion->ad.Z) motion->ad.Z->Get_Vector(frame, &(mtx[2][3]));
+			if (motion->ad.X) motion->ad.X->Get_Vector(frame, &(mtx[0][3]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_X));
+			if (motion->ad.Y) motion->ad.Y->Get_Vector(frame, &(mtx[1][3]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Y));
+			if (motion->ad.Z) motion->ad.Z->Get_Vector(frame, &(mtx[2][3]), peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_Z));
 			break;
 		default:
 			WWASSERT(0);	// unknown flavor
@@ -638,10 +701,15 @@ void HCompressedAnimClass::Get_Transform( Matrix3D& mtx, int pividx, float frame
  *   1/19/98    GTH : Created.                                                                 *
  *=============================================================================================*/
 bool HCompressedAnimClass::Get_Visibility(int pividx,float frame)
+{
+	return Get_Visibility(pividx, frame, NULL);
+}
+
+bool HCompressedAnimClass::Get_Visibility(int pividx,float frame,HAnimCursorClass * cursor)
 {
 
 	if (NodeMotion[pividx].Vis != NULL) {
-		return (NodeMotion[pividx].Vis->Get_Bit((int)frame) == 1);
+		return (NodeMotion[pividx].Vis->Get_Bit((int)frame, peek_cursor(cursor, pividx, NodeCompressedMotionStruct::CURSOR_VIS)) == 1);
 	}
 
 
@@ -650,6 +718,65 @@ bool HCompressedAnimClass::Get_Visibility(int pividx,float frame)
 }
 
 
+/***********************************************************************************************
+ * HCompressedAnimClass::Create_Cursor -- create a playback cursor for this animation          *
+ *                                                                                             *
+ * The channels don't keep any decode state of their own, so every object playing this        *
+ * animation should have its own cursor.  Lookups with the same cursor are cheapest when the   *
+ * frame moves forwards a little at a time.                                                    *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * new cursor, the caller deletes it                                                           *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+HAnimCursorClass * HCompressedAnimClass::Create_Cursor(void)
+{
+	return new HCompressedAnimCursorClass(this, NumCursors);
+}
+
+
+/***********************************************************************************************
+ * HCompressedAnimClass::assign_cursors -- give every channel a slot in the cursors            *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void HCompressedAnimClass::assign_cursors(void)
+{
+	NumCursors = 0;
+	for (int i=0; i<NumNodes; i++) {
+		NodeCompressedMotionStruct & motion = NodeMotion[i];
+		motion.Cursor[NodeCompressedMotionStruct::CURSOR_X] = (motion.vd.X != NULL) ? NumCursors++ : -1;
+		motion.Cursor[NodeCompressedMotionStruct::CURSOR_Y] = (motion.vd.Y != NULL) ? NumCursors++ : -1;
+		motion.Cursor[NodeCompressedMotionStruct::CURSOR_Z] = (motion.vd.Z != NULL) ? NumCursors++ : -1;
+		motion.Cursor[NodeCompressedMotionStruct::CURSOR_Q] = (motion.vd.Q != NULL) ? NumCursors++ : -1;
+		motion.Cursor[NodeCompressedMotionStruct::CURSOR_VIS] = (motion.Vis != NULL) ? NumCursors++ : -1;
+	}
+}
+
+
+MotionChannelCursorStruct * HCompressedAnimClass::peek_cursor(HAnimCursorClass * cursor, int pividx, int channel) const
+{
+	if (cursor == NULL) {
+		return NULL;
+	}
+	WWASSERT(cursor->Peek_Anim() == this);
+
+	int slot = NodeMotion[pividx].Cursor[channel];
+	return (slot >= 0) ? &((HCompressedAnimCursorClass *)cursor)->Cursors[slot] : NULL;
+}
+
+
 
 /***********************************************************************************************
  * HAnimClass::Is_Node_Motion_Present -- return true if there is motion defined for this frame *
@@ -52,6 +52,7 @@
 #include "hanim.h"
 
 struct NodeCompressedMotionStruct;
+struct MotionChannelCursorStruct;
 class TimeCodedMotionChannelClass;
 class TimeCodedBitChannelClass;
 class AdaptiveDeltaMotionChannelClass;
@@ -100,6 +101,12 @@ public:
 	void							Get_Transform(Matrix3D& transform, int pividx,float frame) const override;
 	bool							Get_Visibility(int pividx,float frame) override;
 
+	HAnimCursorClass *		Create_Cursor(void) override;
+	void							Get_Translation(Vector3& translation, int pividx,float frame,HAnimCursorClass * cursor) const override;
+	void							Get_Orientation(Quaternion& orientation, int pividx,float frame,HAnimCursorClass * cursor) const override;
+	void							Get_Transform(Matrix3D& transform, int pividx,float frame,HAnimCursorClass * cursor) const override;
+	bool							Get_Visibility(int pividx,float frame,HAnimCursorClass * cursor) override;
+
 	bool							Is_Node_Motion_Present(int pividx) override;
 	int							Get_Num_Pivots(void) const override	{ return NumNodes; }
 
@@ -121,8 +128,11 @@ private:
 	float							FrameRate;
 
 	NodeCompressedMotionStruct *		NodeMotion;
+	int							NumCursors;		// channels in the animation, one cursor each
 
 	void Free(void);
+	void assign_cursors(void);
+	MotionChannelCursorStruct * peek_cursor(HAnimCursorClass * cursor, int pividx, int channel) const;
 	bool read_channel(ChunkLoadClass & cload,TimeCodedMotionChannelClass * * newchan);
 	bool read_channel(ChunkLoadClass & cload,AdaptiveDeltaMotionChannelClass * * newchan);
 	void add_channel(TimeCodedMotionChannelClass * newchan);
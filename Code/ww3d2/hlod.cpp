@@ -2873,7 +2873,7 @@ void HLodClass::Prepare_LOD(CameraClass &camera)
 		/*
 		** Add myself to the LOD optimizer:
 		*/
-		PredictiveLODOptimizerClass::Add_Object(this);
+		PredictiveLODOptimizerClass::Add_Object(this, norm_area);
 
 	} else {
 
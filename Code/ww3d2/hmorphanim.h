@@ -101,6 +101,12 @@ public:
 	void							Get_Transform(Matrix3D& transform, int pividx,float frame) const override;
 	bool							Get_Visibility(int /*pividx*/,float /*frame*/) override		{ return true; }
 
+	// No playback cursors, keep the cursor overloads visible
+	using HAnimClass::Get_Translation;
+	using HAnimClass::Get_Orientation;
+	using HAnimClass::Get_Transform;
+	using HAnimClass::Get_Visibility;
+
 	void							Insert_Morph_Key (const int channel, uint32 morph_frame, uint32 pose_frame);
 	void							Release_Keys (void);
 
@@ -86,6 +86,12 @@ public:
 	void							Get_Transform(Matrix3D& transform, int pividx,float frame) const override;
 	bool							Get_Visibility(int pividx,float frame) override;
 
+	// No playback cursors, keep the cursor overloads visible
+	using HAnimClass::Get_Translation;
+	using HAnimClass::Get_Orientation;
+	using HAnimClass::Get_Transform;
+	using HAnimClass::Get_Visibility;
+
 	bool							Is_Node_Motion_Present(int pividx) override;
 	int							Get_Num_Pivots(void) const override { return NumNodes;  }
 
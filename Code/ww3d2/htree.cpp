@@ -42,6 +42,7 @@
  *   HTreeClass::Anim_Update -- Computes the transform for each pivot with motion              *
  *   HTreeClass::Blend_Update -- computes each pivot as a blend of two anims                   *
  *   HTreeClass::Combo_Update -- compute each pivot's transform using an anim combo            *
+ *   HTreeClass::apply_pose -- concatenates the hierarchy with a local animation pose          *
  *   HTreeClass::Get_Transform -- returns the transformation for the desired pivot             *
  *   HTreeClass::Find_Bone -- Find a bone by name                                              *
  *   HTreeClass::Get_Bone_Name -- get the name of a bone from its index                        *
@@ -61,6 +62,188 @@
 #include "w3d_file.h"
 #include "wwmemlog.h"
 
+// The pose is converted and concatenated with SSE2 when the compiler targets it (always true on x64)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HTREE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+/*
+** HTreePoseStruct
+** The local animation pose of every pivot in a tree, one array per component so the
+** orientations can be turned into matrices four pivots at a time.  The update modes
+** fill one of these with the values they used to apply to each pivot as they went, then
+** apply_pose concatenates the hierarchy in one pass.  Every thread has its own, which
+** is what lets HTreeBatchClass update trees in parallel.
+*/
+struct HTreePoseStruct
+{
+	HTreePoseStruct(void) : Capacity(0), AnimCount(0), Channels(NULL), Local(NULL), Flags(NULL) {}
+	~HTreePoseStruct(void)	{ Free(); }
+
+	void			Init(int pivot_count,int anim_count);
+	void			Free(void);
+
+	void			Set(int pivot,const Vector3 & trans,const Quaternion & q)
+	{
+		TX[pivot] = trans.X;	TY[pivot] = trans.Y;	TZ[pivot] = trans.Z;
+		QX[pivot] = q.X;		QY[pivot] = q.Y;		QZ[pivot] = q.Z;		QW[pivot] = q.W;
+		Animated[pivot] = true;
+	}
+
+	void			Build_Local_Transforms(void);
+
+	int			Capacity;
+	int			AnimCount;		// pivots below this have motion data
+
+	float *		Channels;
+	float *		TX;				// translation, already scaled by the tree
+	float *		TY;
+	float *		TZ;
+	float *		QX;
+	float *		QY;
+	float *		QZ;
+	float *		QW;
+
+	Matrix3D *	Local;			// rotation with the translation in the last column
+	bool *		Flags;
+	bool *		Animated;		// false where a combo's weights all came out zero
+	bool *		Visible;
+};
+
+static thread_local HTreePoseStruct _Pose;
+
+void HTreePoseStruct::Init(int pivot_count,int anim_count)
+{
+	if (pivot_count > Capacity) {
+		Free();
+		Capacity = (pivot_count + 3) & ~3;
+
+		// Zeroed so the unused lanes at the end of the last group of four hold real numbers.
+		Channels = new float[7 * Capacity]();
+		TX = Channels;
+		TY = TX + Capacity;
+		TZ = TY + Capacity;
+		QX = TZ + Capacity;
+		QY = QX + Capacity;
+		QZ = QY + Capacity;
+		QW = QZ + Capacity;
+		Local = new Matrix3D[Capacity];
+		Flags = new bool[2 * Capacity]();
+		Animated = Flags;
+		Visible = Flags + Capacity;
+	}
+
+	AnimCount = MAX(0,MIN(anim_count,pivot_count));
+	memset(Animated,0,AnimCount * sizeof(bool));
+}
+
+void HTreePoseStruct::Free(void)
+{
+	delete [] Channels;
+	delete [] Local;
+	delete [] Flags;
+	Channels = NULL;
+	Local = NULL;
+	Flags = NULL;
+	Capacity = 0;
+}
+
+/*
+** Build_Matrix3D for every animated pivot, with the translation dropped into the last
+** column.  Concatenating a pivot with that is the same as the Translate followed by the
+** rotation the update modes used to do.  Build_Matrix3D works in doubles but every term
+** it computes is exact or rounded once either way, so the SSE2 version matches it bit
+** for bit.
+*/
+void HTreePoseStruct::Build_Local_Transforms(void)
+{
+#ifdef HTREE_SSE2
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+
+	for (int i=0; i<AnimCount; i+=4) {
+		const __m128 x = _mm_loadu_ps(QX + i);
+		const __m128 y = _mm_loadu_ps(QY + i);
+		const __m128 z = _mm_loadu_ps(QZ + i);
+		const __m128 w = _mm_loadu_ps(QW + i);
+
+		const __m128 xx = _mm_mul_ps(x,x);
+		const __m128 yy = _mm_mul_ps(y,y);
+		const __m128 zz = _mm_mul_ps(z,z);
+		const __m128 xy = _mm_mul_ps(x,y);
+		const __m128 zw = _mm_mul_ps(z,w);
+		const __m128 zx = _mm_mul_ps(z,x);
+		const __m128 yw = _mm_mul_ps(y,w);
+		const __m128 yz = _mm_mul_ps(y,z);
+		const __m128 xw = _mm_mul_ps(x,w);
+
+		__m128 r0 = _mm_sub_ps(one,_mm_mul_ps(two,_mm_add_ps(yy,zz)));
+		__m128 r1 = _mm_mul_ps(two,_mm_sub_ps(xy,zw));
+		__m128 r2 = _mm_mul_ps(two,_mm_add_ps(zx,yw));
+		__m128 r3 = _mm_loadu_ps(TX + i);
+		_MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+		_mm_storeu_ps(&Local[i + 0][0][0],r0);
+		_mm_storeu_ps(&Local[i + 1][0][0],r1);
+		_mm_storeu_ps(&Local[i + 2][0][0],r2);
+		_mm_storeu_ps(&Local[i + 3][0][0],r3);
+
+		r0 = _mm_mul_ps(two,_mm_add_ps(xy,zw));
+		r1 = _mm_sub_ps(one,_mm_mul_ps(two,_mm_add_ps(zz,xx)));
+		r2 = _mm_mul_ps(two,_mm_sub_ps(yz,xw));
+		r3 = _mm_loadu_ps(TY + i);
+		_MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+		_mm_storeu_ps(&Local[i + 0][1][0],r0);
+		_mm_storeu_ps(&Local[i + 1][1][0],r1);
+		_mm_storeu_ps(&Local[i + 2][1][0],r2);
+		_mm_storeu_ps(&Local[i + 3][1][0],r3);
+
+		r0 = _mm_mul_ps(two,_mm_sub_ps(zx,yw));
+		r1 = _mm_mul_ps(two,_mm_add_ps(yz,xw));
+		r2 = _mm_sub_ps(one,_mm_mul_ps(two,_mm_add_ps(yy,xx)));
+		r3 = _mm_loadu_ps(TZ + i);
+		_MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+		_mm_storeu_ps(&Local[i + 0][2][0],r0);
+		_mm_storeu_ps(&Local[i + 1][2][0],r1);
+		_mm_storeu_ps(&Local[i + 2][2][0],r2);
+		_mm_storeu_ps(&Local[i + 3][2][0],r3);
+	}
+#else
+	for (int i=1; i<AnimCount; i++) {
+		Local[i] = Build_Matrix3D(Quaternion(QX[i],QY[i],QZ[i],QW[i]));
+		Local[i].Set_Translation(Vector3(TX[i],TY[i],TZ[i]));
+	}
+#endif
+}
+
+/*
+** Matrix3D::Multiply for the hierarchy.  The SSE2 version does one row of the result at
+** a time but adds the terms in the same order, so the results are identical.  Adding
+** -0 to the rotation lanes leaves them untouched.
+*/
+static WWINLINE void Concatenate(const Matrix3D & a,const Matrix3D & b,Matrix3D * res)
+{
+#ifdef HTREE_SSE2
+	const __m128 b0 = _mm_loadu_ps(&b[0][0]);
+	const __m128 b1 = _mm_loadu_ps(&b[1][0]);
+	const __m128 b2 = _mm_loadu_ps(&b[2][0]);
+
+	__m128 rows[3];
+	for (int i=0; i<3; i++) {
+		__m128 row = _mm_mul_ps(_mm_set1_ps(a[i][0]),b0);
+		row = _mm_add_ps(row,_mm_mul_ps(_mm_set1_ps(a[i][1]),b1));
+		row = _mm_add_ps(row,_mm_mul_ps(_mm_set1_ps(a[i][2]),b2));
+		rows[i] = _mm_add_ps(row,_mm_set_ps(a[i][3],-0.0f,-0.0f,-0.0f));
+	}
+	_mm_storeu_ps(&(*res)[0][0],rows[0]);
+	_mm_storeu_ps(&(*res)[1][0],rows[1]);
+	_mm_storeu_ps(&(*res)[2][0],rows[2]);
+#else
+	Matrix3D::Multiply(a,b,res);
+#endif
+}
+
 
 /***********************************************************************************************
  * HTreeClass::HTreeClass -- constructor                                                       *
@@ -509,7 +692,7 @@ void HTreeClass::Base_Update(const Matrix3D & root)
 		pivot = &Pivot[piv_idx];
 
 		assert(pivot->Parent != NULL);
-		Matrix3D::Multiply(pivot->Parent->Transform,pivot->BaseTransform,&(pivot->Transform));
+		Concatenate(pivot->Parent->Transform,pivot->BaseTransform,&(pivot->Transform));
 		pivot->IsVisible = 1;
 
 		if (pivot->IsCaptured) pivot->Capture_Update();
@@ -529,45 +712,27 @@ void HTreeClass::Base_Update(const Matrix3D & root)
  * HISTORY:                                                                                    *
  *   08/11/1997 GH  : Created.                                                                 *
  *=============================================================================================*/
-void HTreeClass::Anim_Update(const Matrix3D & root,HAnimClass * motion,float frame)
+void HTreeClass::Anim_Update(const Matrix3D & root,HAnimClass * motion,float frame,HAnimCursorClass * cursor)
 {
-	PivotClass *pivot;
-
-	Pivot[0].Transform = root;
-	Pivot[0].IsVisible = true;
-
-	int num_anim_pivots = motion->Get_Num_Pivots ();
-
-	for (int piv_idx=1; piv_idx < NumPivots; piv_idx++) {
-		pivot = &Pivot[piv_idx];
-
-		// base pose
-		assert(pivot->Parent != NULL);
-		Matrix3D::Multiply(pivot->Parent->Transform,pivot->BaseTransform,&(pivot->Transform));
+	HTreePoseStruct & pose = _Pose;
+	pose.Init(NumPivots,motion->Get_Num_Pivots());
 
-		// Don't update this pivot if the HTree doesn't have animation data for it...
-		if (piv_idx < num_anim_pivots) {
-
-			// animation
-			Vector3 trans;
-			motion->Get_Translation(trans,piv_idx,frame);
-			pivot->Transform.Translate(trans * ScaleFactor);
+	for (int piv_idx=1; piv_idx < pose.AnimCount; piv_idx++) {
 
-			Quaternion q;
-			motion->Get_Orientation(q,piv_idx,frame);
-			Matrix3D mtx=::Build_Matrix3D(q);
+		// animation
+		Vector3 trans;
+		motion->Get_Translation(trans,piv_idx,frame,cursor);
 
-			pivot->Transform = pivot->Transform * mtx;
+		Quaternion q;
+		motion->Get_Orientation(q,piv_idx,frame,cursor);
 
-			// visibility
-			pivot->IsVisible = motion->Get_Visibility(piv_idx,frame);
-		}
+		pose.Set(piv_idx,trans * ScaleFactor,q);
 
-		if (pivot->IsCaptured) {
-			pivot->Capture_Update();
-			pivot->IsVisible = true;
-		}
+		// visibility
+		pose.Visible[piv_idx] = motion->Get_Visibility(piv_idx,frame,cursor);
 	}
+
+	apply_pose(root,pose);
 }
 
 
@@ -590,49 +755,37 @@ void HTreeClass::Blend_Update
 	float									frame0,
 	HAnimClass *						motion1,
 	float									frame1,
-	float									percentage		// 0.0 = motion0.  1.0 = motion1
+	float									percentage,		// 0.0 = motion0.  1.0 = motion1
+	HAnimCursorClass *				cursor0,
+	HAnimCursorClass *				cursor1
 )
 {
-	PivotClass *pivot;
+	HTreePoseStruct & pose = _Pose;
+	pose.Init(NumPivots,MIN( motion0->Get_Num_Pivots (), motion1->Get_Num_Pivots () ));
 
-	Pivot[0].Transform = root;
-	Pivot[0].IsVisible = true;
+	for (int piv_idx=1; piv_idx < pose.AnimCount; piv_idx++) {
 
-	int num_anim_pivots = MIN( motion0->Get_Num_Pivots (), motion1->Get_Num_Pivots () );
+		// interpolated translation
+		Vector3 trans0;
+		motion0->Get_Translation(trans0,piv_idx,frame0,cursor0);
+		Vector3 trans1;
+		motion1->Get_Translation(trans1,piv_idx,frame1,cursor1);
+		Vector3 lerped = (1.0 - percentage) * trans0 + (percentage) * trans1;
 
-	for (int piv_idx=1; piv_idx < NumPivots; piv_idx++) {
-
-		pivot = &Pivot[piv_idx];
+		// interpolated rotation
+		Quaternion q0;
+		motion0->Get_Orientation(q0,piv_idx,frame0,cursor0);
+		Quaternion q1;
+		motion1->Get_Orientation(q1,piv_idx,frame1,cursor1);
+		Quaternion q;
+		Fast_Slerp(q,q0,q1,percentage);
 
-		assert(pivot->Parent != NULL);
-		Matrix3D::Multiply(pivot->Parent->Transform,pivot->BaseTransform,&(pivot->Transform));
-
-		if (piv_idx < num_anim_pivots) {
-			// interpolated translation
-			Vector3 trans0;
-			motion0->Get_Translation(trans0,piv_idx,frame0);
-			Vector3 trans1;
-			motion1->Get_Translation(trans1,piv_idx,frame1);
-			Vector3 lerped = (1.0 - percentage) * trans0 + (percentage) * trans1;
-			pivot->Transform.Translate(lerped * ScaleFactor);
-
-			// interpolated rotation
-			Quaternion q0;
-			motion0->Get_Orientation(q0,piv_idx,frame0);
-			Quaternion q1;
-			motion1->Get_Orientation(q1,piv_idx,frame1);
-			Quaternion q;
-			Fast_Slerp(q,q0,q1,percentage);
-			pivot->Transform = pivot->Transform * Build_Matrix3D(q);
-
-			pivot->IsVisible = (motion0->Get_Visibility(piv_idx,frame0) || motion1->Get_Visibility(piv_idx,frame1));
-		}
+		pose.Set(piv_idx,lerped * ScaleFactor,q);
 
-		if (pivot->IsCaptured) {
-			pivot->Capture_Update();
-			pivot->IsVisible = true;
-		}
+		pose.Visible[piv_idx] = (motion0->Get_Visibility(piv_idx,frame0,cursor0) || motion1->Get_Visibility(piv_idx,frame1,cursor1));
 	}
+
+	apply_pose(root,pose);
 }
 
 
@@ -641,6 +794,7 @@ void HTreeClass::Blend_Update
  * HTreeClass::Combo_Update -- compute each pivot's transform using an anim combo              *
  *                                                                                             *
  * INPUT:                                                                                      *
+ * cursors -- one playback cursor per anim of the combo (entries may be NULL), or NULL         *
  *                                                                                             *
  * OUTPUT:                                                                                     *
  *                                                                                             *
@@ -652,14 +806,10 @@ void HTreeClass::Blend_Update
 void HTreeClass::Combo_Update
 (
 	const Matrix3D & root,
-	HAnimComboClass *anim
+	HAnimComboClass *anim,
+	HAnimCursorClass * const * cursors
 )
 {
-	PivotClass *pivot;
-
-	Pivot[0].Transform = root;
-	Pivot[0].IsVisible = true;
-
 	int num_anim_pivots = 100000;
 	for ( int anim_num = 0; anim_num < anim->Get_Num_Anims(); anim_num++ ) {
 		num_anim_pivots = MIN( num_anim_pivots, anim->Peek_Motion( anim_num )->Get_Num_Pivots() );
@@ -668,110 +818,149 @@ void HTreeClass::Combo_Update
 		num_anim_pivots = 0;
 	}
 
-	for (int piv_idx=1; piv_idx < NumPivots; piv_idx++) {
-
-		pivot = &Pivot[piv_idx];
-		assert(pivot->Parent != NULL);
-		Matrix3D::Multiply(pivot->Parent->Transform,pivot->BaseTransform,&(pivot->Transform));
+	HTreePoseStruct & pose = _Pose;
+	pose.Init(NumPivots,num_anim_pivots);
 
-		if (piv_idx < num_anim_pivots) {
+	for (int piv_idx=1; piv_idx < pose.AnimCount; piv_idx++) {
 
 #define	ASSUME_NORMALIZED_ANIM_COMBO_WEIGHTS
 
-			Vector3 trans(0,0,0);
-			Quaternion q0;
-			Quaternion q1;
+		Vector3 trans(0,0,0);
+		Quaternion q0;
+		Quaternion q1;
 #ifndef ASSUME_NORMALIZED_ANIM_COMBO_WEIGHTS
-			float	last_weight = 0;
+		float	last_weight = 0;
 #endif
-			float	weight_total = 0;
-			int wcount = 0;
-			int anim_num;
+		float	weight_total = 0;
+		int wcount = 0;
+		int anim_num;
 
-			for ( anim_num = 0; anim_num < anim->Get_Num_Anims(); anim_num++ ) {
+		for ( anim_num = 0; anim_num < anim->Get_Num_Anims(); anim_num++ ) {
 
-				HAnimClass *motion = anim->Get_Motion( anim_num );
+			HAnimClass *motion = anim->Get_Motion( anim_num );
 
-				if ( motion != NULL ) {
+			if ( motion != NULL ) {
 
-					float frame_num = anim->Get_Frame( anim_num );
+				float frame_num = anim->Get_Frame( anim_num );
+				HAnimCursorClass * cursor = (cursors != NULL) ? cursors[anim_num] : NULL;
 
-					PivotMapClass * pivot_map = anim->Get_Pivot_Weight_Map( anim_num );
+				PivotMapClass * pivot_map = anim->Get_Pivot_Weight_Map( anim_num );
 
-					//float	*pivot_map = anim->Get_Pivot_Weight_Map( anim_num );
+				//float	*pivot_map = anim->Get_Pivot_Weight_Map( anim_num );
 
-					float	weight = anim->Get_Weight( anim_num );
+				float	weight = anim->Get_Weight( anim_num );
 
-					if ( pivot_map != NULL ) {
-						weight *= (*pivot_map)[piv_idx];
-						// GREG - Pivot maps are ref counted so shouldn't we
-						// release the rivot map here?
-						pivot_map->Release_Ref();
-					}
+				if ( pivot_map != NULL ) {
+					weight *= (*pivot_map)[piv_idx];
+					// GREG - Pivot maps are ref counted so shouldn't we
+					// release the rivot map here?
+					pivot_map->Release_Ref();
+				}
 
-					if ( weight != 0.0 ) {
+				if ( weight != 0.0 ) {
 
-						wcount++;
-						Vector3 temp_trans;
-						motion->Get_Translation( temp_trans, piv_idx, frame_num );
-						trans += weight * ScaleFactor * temp_trans;
-						weight_total += weight;
+					wcount++;
+					Vector3 temp_trans;
+					motion->Get_Translation( temp_trans, piv_idx, frame_num, cursor );
+					trans += weight * ScaleFactor * temp_trans;
+					weight_total += weight;
 
 #ifdef ASSUME_NORMALIZED_ANIM_COMBO_WEIGHTS
-						motion->Get_Orientation(q1,piv_idx, frame_num );
-						if ( wcount == 1 ) {
-							q0 = q1;
-						} else {
-							Fast_Slerp(q0, q0, q1, weight / weight_total );
-						}
-#else
+					motion->Get_Orientation(q1,piv_idx, frame_num, cursor );
+					if ( wcount == 1 ) {
 						q0 = q1;
-						motion->Get_Orientation(q1, piv_idx, frame_num );
-						last_weight = weight;
-#endif
+					} else {
+						Fast_Slerp(q0, q0, q1, weight / weight_total );
 					}
+#else
+					q0 = q1;
+					motion->Get_Orientation(q1, piv_idx, frame_num, cursor );
+					last_weight = weight;
+#endif
+				}
 
-					motion->Release_Ref();
+				motion->Release_Ref();
 
-				}
 			}
+		}
 
 #ifdef ASSUME_NORMALIZED_ANIM_COMBO_WEIGHTS
 
-			if (weight_total != 0.0f ) {
-				// SKB: Removed assert because I have a case where I don't want normalization.
-				// 	  One anim moves X, the other moves Y.  Assert was just in to warn programmers.
+		if (weight_total != 0.0f ) {
+			// SKB: Removed assert because I have a case where I don't want normalization.
+			// 	  One anim moves X, the other moves Y.  Assert was just in to warn programmers.
 //				WWASSERT(WWMath::Fabs( weight_total - 1.0 ) < WWMATH_EPSILON);
 
-				pivot->Transform.Translate(trans);
-				pivot->Transform = pivot->Transform * Build_Matrix3D(q0);
-			}
+			pose.Set(piv_idx,trans,q0);
+		}
 #else
-			if (( weight_total != 0.0f ) && (wcount >= 2)) {
+		if (( weight_total != 0.0f ) && (wcount >= 2)) {
 
-				pivot->Transform.Translate( trans / weight_total );
-				Quaternion q = Slerp_( q0, q1, last_weight / weight_total );
-				pivot->Transform = pivot->Transform * Build_Matrix3D(q);
+			Quaternion q = Slerp_( q0, q1, last_weight / weight_total );
+			pose.Set(piv_idx,trans / weight_total,q);
 
-			} else if (weight_total != 0.0f) {
+		} else if (weight_total != 0.0f) {
 
-				pivot->Transform.Translate( trans / weight_total );
-				pivot->Transform = pivot->Transform * Build_Matrix3D(q1);
-			}
+			pose.Set(piv_idx,trans / weight_total,q1);
+		}
 #endif
 
-			pivot->IsVisible = false;
+		bool visible = false;
 
-			for ( anim_num = 0; (anim_num < anim->Get_Num_Anims()) && (!pivot->IsVisible); anim_num++ ) {
-				HAnimClass *motion = anim->Get_Motion( anim_num );
-				if ( motion != NULL ) {
-					float frame_num = anim->Get_Frame( anim_num );
+		for ( anim_num = 0; (anim_num < anim->Get_Num_Anims()) && (!visible); anim_num++ ) {
+			HAnimClass *motion = anim->Get_Motion( anim_num );
+			if ( motion != NULL ) {
+				float frame_num = anim->Get_Frame( anim_num );
+				HAnimCursorClass * cursor = (cursors != NULL) ? cursors[anim_num] : NULL;
 
-					pivot->IsVisible |= motion->Get_Visibility(piv_idx,frame_num);
+				visible |= motion->Get_Visibility(piv_idx,frame_num,cursor);
 
-					motion->Release_Ref();
-				}
+				motion->Release_Ref();
+			}
+		}
+
+		pose.Visible[piv_idx] = visible;
+	}
+
+	apply_pose(root,pose);
+}
+
+
+/***********************************************************************************************
+ * HTreeClass::apply_pose -- concatenates the hierarchy with a local animation pose            *
+ *                                                                                             *
+ * Pivots below the pose's AnimCount get the animated transform and visibility, the rest       *
+ * keep their base pose.  Parents always come before their children so a single pass does      *
+ * the whole tree.                                                                             *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void HTreeClass::apply_pose(const Matrix3D & root,HTreePoseStruct & pose)
+{
+	Pivot[0].Transform = root;
+	Pivot[0].IsVisible = true;
+
+	pose.Build_Local_Transforms();
+
+	for (int piv_idx=1; piv_idx < NumPivots; piv_idx++) {
+		PivotClass *pivot = &Pivot[piv_idx];
+
+		// base pose
+		assert(pivot->Parent != NULL);
+		Concatenate(pivot->Parent->Transform,pivot->BaseTransform,&(pivot->Transform));
+
+		// Don't update this pivot if the HTree doesn't have animation data for it...
+		if (piv_idx < pose.AnimCount) {
+			if (pose.Animated[piv_idx]) {
+				Concatenate(pivot->Transform,pose.Local[piv_idx],&(pivot->Transform));
 			}
+			pivot->IsVisible = pose.Visible[piv_idx];
 		}
 
 		if (pivot->IsCaptured) {
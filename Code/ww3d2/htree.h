@@ -51,8 +51,10 @@
 #include "wwdebug.h"
 
 class HAnimClass;
+class HAnimCursorClass;
 class HAnimComboClass;
 class MeshClass;
+struct HTreePoseStruct;
 class ChunkLoadClass;
 class ChunkSaveClass;
 
@@ -97,17 +99,21 @@ public:
 
 	void					Anim_Update(		const Matrix3D &		root,
 													HAnimClass *			motion,
-													float						frame);
+													float						frame,
+													HAnimCursorClass *	cursor = NULL);
 
 	void					Blend_Update(		const Matrix3D &		root,
 													HAnimClass *			motion0,
 													float						frame0,
 													HAnimClass *			motion1,
 													float						frame1,
-													float						percentage);
+													float						percentage,
+													HAnimCursorClass *	cursor0 = NULL,
+													HAnimCursorClass *	cursor1 = NULL);
 
 	void					Combo_Update(		const Matrix3D &		root,
-													HAnimComboClass *		anim);
+													HAnimComboClass *		anim,
+													HAnimCursorClass * const * cursors = NULL);
 
 	WWINLINE const Matrix3D	&	Get_Transform(int pivot) const;
 	WWINLINE bool					Get_Visibility(int pivot) const;
@@ -160,6 +166,7 @@ private:
 
 	void					Free(void);
 	bool					read_pivots(ChunkLoadClass & cload,bool pre30);
+	void					apply_pose(const Matrix3D & root,HTreePoseStruct & pose);
 
 	friend class MeshClass;
 };
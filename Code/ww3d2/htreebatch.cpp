@@ -0,0 +1,122 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "htreebatch.h"
+#include "htree.h"
+#include "hanim.h"
+#include "jobsystem.h"
+#include "wwdebug.h"
+#include "wwprofile.h"
+
+
+/*
+** HTreeBatchClass
+*/
+HTreeBatchClass::HTreeBatchClass(void) :
+	Jobs(&JobSystemClass::Get_Shared())
+{
+}
+
+HTreeBatchClass::~HTreeBatchClass(void)
+{
+}
+
+void HTreeBatchClass::Set_Job_System(JobSystemClass * jobs)
+{
+	WWASSERT(jobs != NULL);
+	Jobs = jobs;
+}
+
+void HTreeBatchClass::Add_Anim_Update
+(
+	HTreeClass * tree,
+	const Matrix3D & root,
+	HAnimClass * motion,
+	float frame,
+	HAnimCursorClass * cursor
+)
+{
+	WWASSERT(tree != NULL && motion != NULL);
+
+	UpdateStruct update;
+	update.Tree = tree;
+	update.Root = root;
+	update.Motion0 = motion;
+	update.Frame0 = frame;
+	update.Cursor0 = cursor;
+	update.Motion1 = NULL;
+	update.Frame1 = 0.0f;
+	update.Cursor1 = NULL;
+	update.Percentage = 0.0f;
+	Updates.Add(update);
+}
+
+void HTreeBatchClass::Add_Blend_Update
+(
+	HTreeClass * tree,
+	const Matrix3D & root,
+	HAnimClass * motion0,
+	float frame0,
+	HAnimClass * motion1,
+	float frame1,
+	float percentage,
+	HAnimCursorClass * cursor0,
+	HAnimCursorClass * cursor1
+)
+{
+	WWASSERT(tree != NULL && motion0 != NULL && motion1 != NULL);
+
+	UpdateStruct update;
+	update.Tree = tree;
+	update.Root = root;
+	update.Motion0 = motion0;
+	update.Frame0 = frame0;
+	update.Cursor0 = cursor0;
+	update.Motion1 = motion1;
+	update.Frame1 = frame1;
+	update.Cursor1 = cursor1;
+	update.Percentage = percentage;
+	Updates.Add(update);
+}
+
+void HTreeBatchClass::Run_Update(const UpdateStruct & update)
+{
+	if (update.Motion1 == NULL) {
+		update.Tree->Anim_Update(update.Root,update.Motion0,update.Frame0,update.Cursor0);
+	} else {
+		update.Tree->Blend_Update(	update.Root,
+											update.Motion0,update.Frame0,
+											update.Motion1,update.Frame1,
+											update.Percentage,
+											update.Cursor0,update.Cursor1	);
+	}
+}
+
+void HTreeBatchClass::Update(void)
+{
+	WWPROFILE("HTree Batch");
+
+	Jobs->Parallel_For(Updates.Count(),TREES_PER_JOB,
+		[this](int first,int last) {
+			for (int i=first; i<last; i++) {
+				Run_Update(Updates[i]);
+			}
+		},
+		"HTree Update");
+	Updates.Reset_Active();
+}
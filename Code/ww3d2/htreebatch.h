@@ -0,0 +1,109 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "always.h"
+#include "matrix3d.h"
+#include "vector.h"
+
+class HTreeClass;
+class HAnimClass;
+class HAnimCursorClass;
+class JobSystemClass;
+
+
+/**
+** HTreeBatchClass
+** Updates a list of hierarchy trees, spreading them over the threads of the job system.  Each
+** tree is updated exactly as Anim_Update or Blend_Update would on the calling thread, so
+** the results don't depend on the thread count.
+**
+** Only the motion queries and the tree itself are touched, so several trees can share an
+** animation.  Compressed animations should be given a cursor per tree (see
+** HAnimClass::Create_Cursor) since a cursor can only be used by one thread at a time.
+** Combo updates aren't supported; HAnimComboClass hands out references that aren't
+** thread safe.
+*/
+class HTreeBatchClass
+{
+public:
+
+	enum
+	{
+		TREES_PER_JOB = 4,
+	};
+
+	HTreeBatchClass(void);
+	~HTreeBatchClass(void);
+
+	/*
+	** Job system to update the trees on, JobSystemClass::Get_Shared by default.
+	*/
+	void				Set_Job_System(JobSystemClass * jobs);
+	JobSystemClass *	Get_Job_System(void) const		{ return Jobs; }
+
+	/*
+	** Queue up trees to update.  Nothing happens until Update() is called.
+	*/
+	void				Add_Anim_Update(	HTreeClass * tree,
+												const Matrix3D & root,
+												HAnimClass * motion,
+												float frame,
+												HAnimCursorClass * cursor = NULL	);
+
+	void				Add_Blend_Update(	HTreeClass * tree,
+												const Matrix3D & root,
+												HAnimClass * motion0,
+												float frame0,
+												HAnimClass * motion1,
+												float frame1,
+												float percentage,
+												HAnimCursorClass * cursor0 = NULL,
+												HAnimCursorClass * cursor1 = NULL	);
+
+	int				Get_Count(void) const				{ return Updates.Count(); }
+	void				Reset(void)								{ Updates.Reset_Active(); }
+
+	/*
+	** Update every queued tree and empty the queue.
+	*/
+	void				Update(void);
+
+private:
+
+	struct UpdateStruct
+	{
+		bool operator== (const UpdateStruct &)	{ return false; }
+		bool operator!= (const UpdateStruct &)	{ return true; }
+
+		HTreeClass *			Tree;
+		Matrix3D					Root;
+		HAnimClass *			Motion0;
+		float						Frame0;
+		HAnimCursorClass *	Cursor0;
+		HAnimClass *			Motion1;		// NULL for a plain Anim_Update
+		float						Frame1;
+		HAnimCursorClass *	Cursor1;
+		float						Percentage;
+	};
+
+	void				Run_Update(const UpdateStruct & update);
+
+	JobSystemClass *							Jobs;
+	DynamicVectorClass<UpdateStruct>		Updates;
+};
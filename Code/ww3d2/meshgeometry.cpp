@@ -1054,7 +1054,7 @@ bool MeshGeometryClass::intersect_obbox_brute_force(OBBoxIntersectionTestClass &
 		tri.V[2] = &(loc[ polyverts[srtri][2] ]);
 
 #ifdef COMPUTE_NORMALS
-		static Vector3 _normal;
+		static thread_local Vector3 _normal;
 		tri.N = &_normal;
 		tri.Compute_Normal();
 #else
@@ -1105,7 +1105,7 @@ bool MeshGeometryClass::cast_ray_brute_force(RayCollisionTestClass & raytest)
 		tri.V[2] = &(loc[ polyverts[srtri][2] ]);
 
 #ifdef COMPUTE_NORMALS
-		static Vector3 _normal;
+		static thread_local Vector3 _normal;
 		tri.N = &_normal;
 		tri.Compute_Normal();
 #else
@@ -1159,7 +1159,7 @@ bool MeshGeometryClass::cast_aabox_brute_force(AABoxCollisionTestClass & boxtest
 		tri.V[2] = &(loc[ polyverts[srtri][2] ]);
 
 #ifdef COMPUTE_NORMALS
-		static Vector3 _normal;
+		static thread_local Vector3 _normal;
 		tri.N = &_normal;
 		tri.Compute_Normal();
 #else
@@ -1217,7 +1217,7 @@ bool MeshGeometryClass::cast_obbox_brute_force(OBBoxCollisionTestClass & boxtest
 		tri.V[2] = &(loc[ polyverts[srtri][2] ]);
 
 #ifdef COMPUTE_NORMALS
-		static Vector3 _normal;
+		static thread_local Vector3 _normal;
 		tri.N = &_normal;
 		tri.Compute_Normal();
 #else
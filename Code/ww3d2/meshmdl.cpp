@@ -70,7 +70,9 @@ MeshModelClass::MeshModelClass(void) :
 	AlternateMatDesc(NULL),
 	CurMatDesc(NULL),
 	MatInfo(NULL),
-	GapFiller(NULL)
+	GapFiller(NULL),
+	SkinRuns(NULL),
+	SkinOrder(NULL)
 {
 	Set_Flag(DIRTY_BOUNDS,true);
 
@@ -89,8 +91,13 @@ MeshModelClass::MeshModelClass(const MeshModelClass & that) :
 	CurMatDesc(NULL),
 	MatInfo(NULL),
 	GapFiller(NULL),
-	HasBeenInUse(false)
+	HasBeenInUse(false),
+	SkinRuns(NULL),
+	SkinOrder(NULL)
 {
+	REF_PTR_SET(SkinRuns,that.SkinRuns);
+	REF_PTR_SET(SkinOrder,that.SkinOrder);
+
 	DefMatDesc = new MeshMatDescClass(*(that.DefMatDesc));
 	if (that.AlternateMatDesc != NULL) {
 		AlternateMatDesc = new MeshMatDescClass(*(that.AlternateMatDesc));
@@ -142,6 +149,9 @@ MeshModelClass & MeshModelClass::operator = (const MeshModelClass & that)
 				GapFiller=NULL;
 		}
 		if (that.GapFiller) GapFiller=new GapFillerClass(*that.GapFiller);
+
+		REF_PTR_SET(SkinRuns,that.SkinRuns);
+		REF_PTR_SET(SkinOrder,that.SkinOrder);
 	}
 	return * this;
 }
@@ -162,6 +172,9 @@ void MeshModelClass::Reset(int polycount,int vertcount,int passcount)
 	delete GapFiller;
 	GapFiller=NULL;
 
+	REF_PTR_RELEASE(SkinRuns);
+	REF_PTR_RELEASE(SkinOrder);
+
 	return ;
 }
 
@@ -267,104 +280,177 @@ void MeshModelClass::Shadow_Render(SpecialRenderInfoClass & rinfo,const Matrix3D
 	}
 }
 
-// Destination pointers MUST point to arrays large enough to hold all vertices
-void MeshModelClass::get_deformed_vertices(Vector3 *dst_vert,const HTreeClass * htree)
+/*
+** Vertices per bone run below which the vertices are deformed in bone sorted order instead
+** of the order they come in. Runs that short leave the kernels nothing to work with.
+*/
+static const int MIN_AVERAGE_SKIN_RUN = 8;
+
+/*
+** Scratch for compose_deformed_vertex_buffer, one set per thread deforming skins.
+*/
+static thread_local SimpleVecClass<Vector3>	_SkinVertexScratch;
+static thread_local SimpleVecClass<Vector3>	_SkinNormalScratch;
+
+void MeshModelClass::Update_Skin_Runs(void)
 {
-	Vector3 * src_vert = Vertex->Get_Array();
-	uint16 * bonelink = VertexBoneLink->Get_Array();
-	for (int vi = 0; vi < Get_Vertex_Count(); vi++) {
-		const Matrix3D & tm = htree->Get_Transform(bonelink[vi]);
-		Matrix3D::Transform_Vector(tm, src_vert[vi], &(dst_vert[vi]));
+	REF_PTR_RELEASE(SkinRuns);
+	REF_PTR_RELEASE(SkinOrder);
+	if (!Get_Flag(SKIN) || VertexBoneLink == NULL || VertexCount <= 0) {
+		return;
 	}
-}
 
+	const uint16 * bonelink = VertexBoneLink->Get_Array();
+	int bone_count = 0;
+	int run_count = 0;
+	for (int vi = 0; vi < VertexCount; vi++) {
+		bone_count = MAX(bone_count,bonelink[vi] + 1);
+		if (vi == 0 || bonelink[vi] != bonelink[vi - 1]) {
+			run_count++;
+		}
+	}
 
-// Destination pointers MUST point to arrays large enough to hold all vertices
-void MeshModelClass::get_deformed_vertices(Vector3 *dst_vert, Vector3 *dst_norm,const HTreeClass * htree)
+	if (VertexCount >= run_count * MIN_AVERAGE_SKIN_RUN) {
+		SkinRuns = NEW_REF(ShareBufferClass<SkinRunStruct>,(run_count));
+		SkinRunStruct * runs = SkinRuns->Get_Array();
+		int run = -1;
+		for (int vi = 0; vi < VertexCount; vi++) {
+			if (vi == 0 || bonelink[vi] != bonelink[vi - 1]) {
+				run++;
+				runs[run].Bone = bonelink[vi];
+				runs[run].Start = vi;
+				runs[run].Count = 0;
+			}
+			runs[run].Count++;
+		}
+		return;
+	}
+
+	/*
+	** Counting sort of the vertices by bone, keeping the file order within each bone.
+	*/
+	int * bone_start = new int[bone_count + 1];
+	memset(bone_start,0,(bone_count + 1) * sizeof(int));
+	for (int vi = 0; vi < VertexCount; vi++) {
+		bone_start[bonelink[vi] + 1]++;
+	}
+	int used_bones = 0;
+	for (int bi = 0; bi < bone_count; bi++) {
+		if (bone_start[bi + 1] > 0) {
+			used_bones++;
+		}
+		bone_start[bi + 1] += bone_start[bi];
+	}
+
+	SkinRuns = NEW_REF(ShareBufferClass<SkinRunStruct>,(used_bones));
+	SkinRunStruct * runs = SkinRuns->Get_Array();
+	int run = 0;
+	for (int bi = 0; bi < bone_count; bi++) {
+		if (bone_start[bi + 1] > bone_start[bi]) {
+			runs[run].Bone = bi;
+			runs[run].Start = bone_start[bi];
+			runs[run].Count = bone_start[bi + 1] - bone_start[bi];
+			run++;
+		}
+	}
+
+	SkinOrder = NEW_REF(ShareBufferClass<unsigned>,(VertexCount));
+	unsigned * order = SkinOrder->Get_Array();
+	for (int vi = 0; vi < VertexCount; vi++) {
+		order[bone_start[bonelink[vi]]++] = vi;
+	}
+	delete [] bone_start;
+}
+
+void MeshModelClass::deform_skin(Vector3 *dst_vert, Vector3 *dst_norm, const HTreeClass * htree)
 {
-	int vi;
-	int vertex_count=Get_Vertex_Count();
-	Vector3 * src_vert = Vertex->Get_Array();
+	if (SkinRuns == NULL) {
+		Update_Skin_Runs();
+	}
+	WWASSERT(SkinRuns != NULL);
+
+	const Vector3 * src_vert = Vertex->Get_Array();
+	const Vector3 * src_norm = NULL;
+	if (dst_norm != NULL) {
 #if (OPTIMIZE_VNORMS)
-	Vector3 * src_norm = (Vector3 *)Get_Vertex_Normal_Array();
+		src_norm = Get_Vertex_Normal_Array();
 #else
-	Vector3 * src_norm = VertexNorm->Get_Array();
+		src_norm = VertexNorm->Get_Array();
 #endif
-	uint16 * bonelink = VertexBoneLink->Get_Array();
-
-	for (vi = 0; vi < vertex_count;) {
-		const Matrix3D & tm = htree->Get_Transform(bonelink[vi]);
-
-		// Make a copy so we can set the translation to zero
-		Matrix3D mytm=tm;
+	}
 
-		int idx=bonelink[vi];
-		int cnt;
-		for (cnt = vi; cnt < vertex_count; cnt++) {
-			if (idx!=bonelink[cnt]) {
-				break;
+	const SkinRunStruct * runs = SkinRuns->Get_Array();
+	const unsigned * order = SkinOrder ? SkinOrder->Get_Array() : NULL;
+	int run_count = SkinRuns->Get_Count();
+	for (int ri = 0; ri < run_count; ri++) {
+		const SkinRunStruct & run = runs[ri];
+		const Matrix3D & tm = htree->Get_Transform(run.Bone);
+		if (order != NULL) {
+			VectorProcessorClass::TransformIndexed(dst_vert,src_vert,tm,order + run.Start,run.Count);
+			if (dst_norm != NULL) {
+				VectorProcessorClass::RotateIndexed(dst_norm,src_norm,tm,order + run.Start,run.Count);
+			}
+		} else {
+			VectorProcessorClass::Transform(dst_vert + run.Start,src_vert + run.Start,tm,run.Count);
+			if (dst_norm != NULL) {
+				VectorProcessorClass::Rotate(dst_norm + run.Start,src_norm + run.Start,tm,run.Count);
 			}
 		}
-
-		VectorProcessorClass::Transform(dst_vert+vi,src_vert+vi,mytm,cnt-vi);
-		mytm.Set_Translation(Vector3(0.0f,0.0f,0.0f));
-		VectorProcessorClass::Transform(dst_norm+vi,src_norm+vi,mytm,cnt-vi);
-		vi=cnt;
 	}
 }
 
+// Destination pointers MUST point to arrays large enough to hold all vertices
+void MeshModelClass::get_deformed_vertices(Vector3 *dst_vert,const HTreeClass * htree)
+{
+	deform_skin(dst_vert,NULL,htree);
+}
+
+
+// Destination pointers MUST point to arrays large enough to hold all vertices
+void MeshModelClass::get_deformed_vertices(Vector3 *dst_vert, Vector3 *dst_norm,const HTreeClass * htree)
+{
+	deform_skin(dst_vert,dst_norm,htree);
+}
+
 // Destination pointer MUST point to arrays large enough to hold all vertices
 void MeshModelClass::compose_deformed_vertex_buffer(
 	VertexFormatXYZNDUV2* verts,
 	const Vector2* uv0,
-	const Vector2* /*uv1*/,
+	const Vector2* uv1,
 	const unsigned* diffuse,
 	const HTreeClass * htree)
 {
-	int vi;
 	int vertex_count=Get_Vertex_Count();
-	Vector3 * src_vert = Vertex->Get_Array();
-#if (OPTIMIZE_VNORMS)
-	Vector3 * src_norm = (Vector3 *)Get_Vertex_Normal_Array();
-#else
-	Vector3 * src_norm = VertexNorm->Get_Array();
-#endif
-	uint16 * bonelink = VertexBoneLink->Get_Array();
-
-	for (vi = 0; vi < vertex_count;) {
-		const Matrix3D & tm = htree->Get_Transform(bonelink[vi]);
-
-		// Make a copy so we can set the translation to zero
-		Matrix3D mytm=tm;
-
-		int idx=bonelink[vi];
-		int cnt;
-		for (cnt = vi; cnt < vertex_count; cnt++) {
-			if (idx!=bonelink[cnt]) {
-				break;
-			}
+	_SkinVertexScratch.Uninitialised_Grow(vertex_count);
+	_SkinNormalScratch.Uninitialised_Grow(vertex_count);
+	Vector3* loc=&(_SkinVertexScratch[0]);
+	Vector3* norm=&(_SkinNormalScratch[0]);
+	deform_skin(loc,norm,htree);
+
+	for (int v=0;v<vertex_count;++v) {
+		verts[v].x=loc[v].X;
+		verts[v].y=loc[v].Y;
+		verts[v].z=loc[v].Z;
+		verts[v].nx=norm[v].X;
+		verts[v].ny=norm[v].Y;
+		verts[v].nz=norm[v].Z;
+		verts[v].diffuse=diffuse ? diffuse[v] : 0;
+		if (uv0) {
+			verts[v].u1=uv0[v].U;
+			verts[v].v1=uv0[v].V;
 		}
-
-		for (int pidx=0;pidx<cnt-vi;++pidx) {
-			const Matrix3D& A=mytm;
-			VertexFormatXYZNDUV2* out=verts+vi+pidx;
-			const Vector3& v=*(src_vert+vi+pidx);
-			out->x = (A[0][0] * v.X + A[0][1] * v.Y + A[0][2] * v.Z + A[0][3]);
-			out->y = (A[1][0] * v.X + A[1][1] * v.Y + A[1][2] * v.Z + A[1][3]);
-			out->z = (A[2][0] * v.X + A[2][1] * v.Y + A[2][2] * v.Z + A[2][3]);
-
-			const Vector3& n=*(src_norm+vi+pidx);
-			out->nx = (A[0][0] * n.X + A[0][1] * n.Y + A[0][2] * n.Z);
-			out->ny = (A[1][0] * n.X + A[1][1] * n.Y + A[1][2] * n.Z);
-			out->nz = (A[2][0] * n.X + A[2][1] * n.Y + A[2][2] * n.Z);
-
-			if (diffuse) out->diffuse=diffuse[vi+pidx];
-			else out->diffuse=0;
-			if (uv0) reinterpret_cast<Vector2&>(verts[vi+pidx].u1)=uv0[vi+pidx];
-			else reinterpret_cast<Vector2&>(verts[vi+pidx].u2)=Vector2(0.0f,0.0f);
+		else {
+			verts[v].u1=0.0f;
+			verts[v].v1=0.0f;
+		}
+		if (uv1) {
+			verts[v].u2=uv1[v].U;
+			verts[v].v2=uv1[v].V;
+		}
+		else {
+			verts[v].u2=0.0f;
+			verts[v].v2=0.0f;
 		}
-
-		vi=cnt;
 	}
 }
 
@@ -214,6 +214,29 @@ public:
 	void							Init_For_NPatch_Rendering();
 	const GapFillerClass*	Get_Gap_Filler() const { return GapFiller; }
 
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Skinning. The vertices of a skin are deformed in runs that follow one bone, each run
+	// going through the VectorProcessorClass kernels with a single matrix. The runs are
+	// worked out when the mesh is loaded; when the vertices aren't grouped by bone in the
+	// file they index into a bone sorted copy of the vertex order instead.
+	// Deforming only reads the model and the tree, so separate meshes can be deformed on
+	// separate threads as long as Update_Skin_Runs has been called for them first.
+	// Destination pointers MUST point to arrays large enough to hold all vertices
+	/////////////////////////////////////////////////////////////////////////////////////
+	void							Update_Skin_Runs(void);
+	bool							Has_Skin_Runs(void) const														{ return SkinRuns != NULL; }
+	bool							Is_Skin_Bone_Sorted(void) const												{ return SkinOrder != NULL; }
+	int							Get_Skin_Run_Count(void) const												{ return SkinRuns ? SkinRuns->Get_Count() : 0; }
+
+	void							get_deformed_vertices(Vector3 *dst_vert, Vector3 *dst_norm, const HTreeClass * htree);
+	void							get_deformed_vertices(Vector3 *dst_vert, const HTreeClass * htree);
+	void							compose_deformed_vertex_buffer(
+										VertexFormatXYZNDUV2* verts,
+										const Vector2* uv0,
+										const Vector2* uv1,
+										const unsigned* diffuse,
+										const HTreeClass * htree);
+
 protected:
 
 	// MeshClass will set this for skins so that they can get the bone transforms
@@ -238,17 +261,8 @@ protected:
 
 	int Register_Type();
 
-	// functions to compute the deformed vertices of skins.
-	// Destination pointers MUST point to arrays large enough to hold all vertices
-	void get_deformed_vertices(Vector3 *dst_vert, Vector3 *dst_norm, const HTreeClass * htree);
-	void get_deformed_vertices(Vector3 *dst_vert, const HTreeClass * htree);
 	void get_deformed_screenspace_vertices(Vector4 *dst_vert,const RenderInfoClass & rinfo,const Matrix3D & mesh_tm,const HTreeClass * htree);
-	void compose_deformed_vertex_buffer(
-		VertexFormatXYZNDUV2* verts,
-		const Vector2* uv0,
-		const Vector2* uv1,
-		const unsigned* diffuse,
-		const HTreeClass * htree);
+	void deform_skin(Vector3 *dst_vert, Vector3 *dst_norm, const HTreeClass * htree);
 
 	// loading
 	WW3DErrorType read_chunks(ChunkLoadClass & cload,MeshLoadContextClass * context);
@@ -302,6 +316,16 @@ protected:
 	GapFillerClass *										GapFiller;
 	bool														HasBeenInUse;	// For debugging purposes!
 
+	// Skin runs, see Update_Skin_Runs. Start indexes SkinOrder when there is one, the vertices otherwise.
+	struct SkinRunStruct
+	{
+		int													Bone;
+		int													Start;
+		int													Count;
+	};
+	ShareBufferClass<SkinRunStruct> *				SkinRuns;
+	ShareBufferClass<unsigned> *						SkinOrder;
+
 	friend class MeshClass;
 	friend class MeshDeformSetClass;
 	friend class MeshDeformClass;
@@ -1623,6 +1623,9 @@ void MeshModelClass::post_process()
 	if (Get_Flag(SORT) && SortLevel==SORT_LEVEL_NONE && WW3D::Is_Munge_Sort_On_Load_Enabled()) {
 		compute_static_sort_levels();
 	}
+
+	// group the vertices of skins by bone for deforming
+	Update_Skin_Runs();
 }
 
 void MeshModelClass::post_process_fog(void)
@@ -329,8 +329,7 @@ TimeCodedMotionChannelClass::TimeCodedMotionChannelClass(void) :
 	PacketSize(0),
 	Data(NULL),
 	NumTimeCodes(0),
-	LastTimeCodeIdx(0),	// absolute index to last time code
-	CachedIdx(0)			// Last Index Used
+	LastTimeCodeIdx(0)	// absolute index to last time code
 {
 }
 
@@ -400,7 +399,6 @@ bool TimeCodedMotionChannelClass::Load_W3D(ChunkLoadClass & cload)
 	Type 		    = chan.Flags;
 	PivotIdx     = chan.Pivot;
 	PacketSize   = VectorLen+1;
-	CachedIdx	 = 0;
 	LastTimeCodeIdx = (NumTimeCodes-1) * PacketSize;
 
 	Data = new uint32[numInts];
@@ -426,14 +424,14 @@ bool TimeCodedMotionChannelClass::Load_W3D(ChunkLoadClass & cload)
  * HISTORY:                                                                                    *
  *   08/11/1997 GH  : Created.                                                                 *
  *=============================================================================================*/
-void	TimeCodedMotionChannelClass::Get_Vector(float32 frame,float * setvec)
+void	TimeCodedMotionChannelClass::Get_Vector(float32 frame,float * setvec,MotionChannelCursorStruct * cursor) const
 {
 
   uint32	tc0;
 
   tc0 = frame;
 
-  uint32 pidx = get_index( tc0 );
+  uint32 pidx = get_index( tc0, cursor );
   uint32 p2idx;
 
   if (pidx == ((NumTimeCodes - 1) * PacketSize))  {
@@ -480,7 +478,7 @@ void	TimeCodedMotionChannelClass::Get_Vector(float32 frame,float * setvec)
 }	// Get_Vector
 
 
-Quaternion TimeCodedMotionChannelClass::Get_QuatVector(float32 frame)
+Quaternion TimeCodedMotionChannelClass::Get_QuatVector(float32 frame,MotionChannelCursorStruct * cursor) const
 {
 
 	assert(VectorLen == 4);
@@ -491,7 +489,7 @@ Quaternion TimeCodedMotionChannelClass::Get_QuatVector(float32 frame)
 
 	tc0 = frame;
 
-	uint32 pidx = get_index( tc0 );
+	uint32 pidx = get_index( tc0, cursor );
 	uint32 p2idx;
 
 	if (pidx == ((NumTimeCodes - 1) * PacketSize))  {
@@ -553,7 +551,7 @@ Quaternion TimeCodedMotionChannelClass::Get_QuatVector(float32 frame)
  *   01/27/2000 JGA  : Created.                                                                *
  *=============================================================================================*/
 // New version that uses a binary search, and no cache
-uint32 TimeCodedMotionChannelClass::binary_search_index(uint32 timecode)
+uint32 TimeCodedMotionChannelClass::binary_search_index(uint32 timecode) const
 {
 	int leftIdx = 0;
 	int rightIdx = NumTimeCodes - 2;
@@ -563,9 +561,6 @@ uint32 TimeCodedMotionChannelClass::binary_search_index(uint32 timecode)
 
 	int idx = LastTimeCodeIdx;  //((rightIdx+1) * PacketSize;)
 
-	//int32		LastTimeCodeIdx;	// absolute index to last time code
-	//int32		CachedIdx;			// Last Index Used
-
 	// special case last packet
 	time = Data[idx] & ~W3D_TIMECODED_BINARY_MOVEMENT_FLAG;
 	if (timecode >= time) return(idx);
@@ -614,6 +609,8 @@ uint32 TimeCodedMotionChannelClass::binary_search_index(uint32 timecode)
  * TimeCodedMotionChannelClass::get_index / returns packet index												       *
  *                                                                                             *
  * INPUT:                                                                                      *
+ * timecode - frame to look up                                                                 *
+ * cursor - the caller's decode cursor for this channel, or NULL                               *
  *                                                                                             *
  * OUTPUT:                                                                                     *
  *                                                                                             *
@@ -622,32 +619,40 @@ uint32 TimeCodedMotionChannelClass::binary_search_index(uint32 timecode)
  * HISTORY:                                                                                    *
  *   01/27/2000 JGA  : Created.                                                                *
  *=============================================================================================*/
-uint32 TimeCodedMotionChannelClass::get_index(uint32 timecode)
+uint32 TimeCodedMotionChannelClass::get_index(uint32 timecode, MotionChannelCursorStruct * cursor) const
 {
-	assert(CachedIdx <= LastTimeCodeIdx);
+	if (cursor == NULL) {
+		return binary_search_index( timecode );
+	}
+
+	uint32 idx = cursor->Index;
+	if (idx > LastTimeCodeIdx) {
+		idx = 0;
+	}
 
 	uint32	time;
 
-	time = Data[CachedIdx] & ~W3D_TIMECODED_BINARY_MOVEMENT_FLAG;
+	time = Data[idx] & ~W3D_TIMECODED_BINARY_MOVEMENT_FLAG;
 
 	if (timecode >= time) {
 		// possibly in the current packet
 
 		// special case for end packets
-		if (CachedIdx == LastTimeCodeIdx) return(CachedIdx);
-		time = Data[CachedIdx + PacketSize]	& ~W3D_TIMECODED_BINARY_MOVEMENT_FLAG;
-		if (timecode < time) return(CachedIdx);
+		if (idx == LastTimeCodeIdx) return(idx);
+		time = Data[idx + PacketSize]	& ~W3D_TIMECODED_BINARY_MOVEMENT_FLAG;
+		if (timecode < time) return(idx);
 
 		// Do one time look-ahead before reverting to a search
-		CachedIdx+=PacketSize;
-		if (CachedIdx == LastTimeCodeIdx) return(CachedIdx);
-		time = Data[CachedIdx + PacketSize]	& ~W3D_TIMECODED_BINARY_MOVEMENT_FLAG;
-		if (timecode < time) return(CachedIdx);
+		idx+=PacketSize;
+		cursor->Index = idx;
+		if (idx == LastTimeCodeIdx) return(idx);
+		time = Data[idx + PacketSize]	& ~W3D_TIMECODED_BINARY_MOVEMENT_FLAG;
+		if (timecode < time) return(idx);
 	}
 
-	CachedIdx = binary_search_index( timecode );
+	cursor->Index = binary_search_index( timecode );
 
-	return(CachedIdx);
+	return(cursor->Index);
 
 }	// get_index
 
@@ -695,8 +700,7 @@ TimeCodedBitChannelClass::TimeCodedBitChannelClass(void) :
 	PivotIdx(0),
 	Type(0),
 	DefaultVal(0),
-	Bits(NULL),
-	CachedIdx(0)
+	Bits(NULL)
 {
 }
 
@@ -767,7 +771,6 @@ bool TimeCodedBitChannelClass::Load_W3D(ChunkLoadClass & cload)
 	Type 			 = chan.Flags;
 	PivotIdx 	 = chan.Pivot;
 	DefaultVal = chan.DefaultVal;
-	CachedIdx = 0;
 
 	uint32 bytesleft = (NumTimeCodes - 1) * sizeof(uint32);
 
@@ -793,6 +796,8 @@ bool TimeCodedBitChannelClass::Load_W3D(ChunkLoadClass & cload)
  * TimeCodedBitChannelClass::Get_Bit -- Lookup a bit in the bit channel                                 *
  *                                                                                             *
  * INPUT:                                                                                      *
+ * frame - frame to look up                                                                    *
+ * cursor - the caller's decode cursor for this channel, or NULL                               *
  *                                                                                             *
  * OUTPUT:                                                                                     *
  *                                                                                             *
@@ -801,37 +806,61 @@ bool TimeCodedBitChannelClass::Load_W3D(ChunkLoadClass & cload)
  * HISTORY:                                                                                    *
  *   1/21/98    GTH : Created.                                                                 *
  *=============================================================================================*/
-int TimeCodedBitChannelClass::Get_Bit(int frame)
+int TimeCodedBitChannelClass::Get_Bit(int frame, MotionChannelCursorStruct * cursor) const
 {
 	assert(frame >= 0);
-	assert(CachedIdx < NumTimeCodes);
 
 	int time;
 	int idx=0;
 
-	time = Bits[CachedIdx] & ~W3D_TIMECODED_BIT_MASK;
+	if (cursor != NULL) {
 
+		if (cursor->Index >= NumTimeCodes) {
+			cursor->Index = 0;
+		}
 
-	if (frame >= time) {
+		time = Bits[cursor->Index] & ~W3D_TIMECODED_BIT_MASK;
 
-		// start from here
-		idx = CachedIdx+1;
+		if (frame >= time) {
 
-	}
+			// start from here
+			idx = cursor->Index+1;
 
-	for (;idx < (int) NumTimeCodes ; idx++)  {
+		}
 
-		time = Bits[idx] &~W3D_TIMECODED_BIT_MASK;
+		for (;idx < (int) NumTimeCodes ; idx++)  {
 
-		if (frame < time) break;
+			time = Bits[idx] &~W3D_TIMECODED_BIT_MASK;
 
-	}
+			if (frame < time) break;
+
+		}
+
+		idx--;
 
-	idx--;
+		if (idx < 0) idx = 0;
+
+		cursor->Index = idx;
+
+	} else {
+
+		// No cursor, find the last time code at or before the frame
+		int left = 0;
+		int right = NumTimeCodes;
+		while (left < right) {
+			int mid = (left + right) >> 1;
+			time = Bits[mid] & ~W3D_TIMECODED_BIT_MASK;
+			if (frame < time) {
+				right = mid;
+			} else {
+				left = mid + 1;
+			}
+		}
 
-	if (idx < 0) idx = 0;
+		idx = left - 1;
 
-	CachedIdx = idx;
+		if (idx < 0) idx = 0;
+	}
 
 	return (((Bits[idx] & W3D_TIMECODED_BIT_MASK) == W3D_TIMECODED_BIT_MASK));
 
@@ -859,7 +888,7 @@ AdaptiveDeltaMotionChannelClass::AdaptiveDeltaMotionChannelClass(void) :
 	VectorLen(0),
 	Data(NULL),
 	NumFrames(0),
-	CacheData(NULL),
+	Checkpoints(NULL),
 	Scale(0.0f)
 {
 
@@ -918,9 +947,9 @@ void AdaptiveDeltaMotionChannelClass::Free(void)
 		Data = NULL;
 	}
 
-	if (CacheData) {
-		delete CacheData;
-		CacheData = NULL;
+	if (Checkpoints) {
+		delete[] Checkpoints;
+		Checkpoints = NULL;
 	}
 
 }	// Free
@@ -954,8 +983,6 @@ bool AdaptiveDeltaMotionChannelClass::Load_W3D(ChunkLoadClass & cload)
 	PivotIdx    = chan.Pivot;
 	NumFrames	= chan.NumFrames;
 	Scale			= chan.Scale;
-	CacheFrame	= 0x7FFFFFFF;	// a big number, so we know its not valid
-	CacheData   = new float[VectorLen * 2]; // cacheframe & cachedframe+1 by VectorLen
 
 	Data = new uint32[numInts];
 	Data[0] = chan.Data[0];
@@ -964,11 +991,51 @@ bool AdaptiveDeltaMotionChannelClass::Load_W3D(ChunkLoadClass & cload)
 		Free();
 		return false;
 	}
+
+	bake_checkpoints();
 	return true;
 
 }	// Load_W3D
 
 
+/***********************************************************************************************
+ * AdaptiveDeltaMotionChannelClass::bake_checkpoints -- decode every CHECKPOINT_INTERVAL'th frame *
+ *                                                                                             *
+ * Every frame is a running sum of the deltas before it, so without these a lookup has to     *
+ * decode from the start of the channel.  With them it never decodes more than                *
+ * CHECKPOINT_INTERVAL-1 frames.  The sums are done in the same order as decompress does them, *
+ * so the values are exactly the ones a decode from the start would give.                     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void AdaptiveDeltaMotionChannelClass::bake_checkpoints(void)
+{
+	assert(VectorLen <= 4);
+
+	if (NumFrames == 0) {
+		return;
+	}
+
+	uint32 count = (NumFrames + CHECKPOINT_INTERVAL - 1) / CHECKPOINT_INTERVAL;
+	Checkpoints = new float[count * VectorLen];
+
+	// Frame 0 is stored uncompressed at the start of the data
+	memcpy(&Checkpoints[0], &Data[0], VectorLen * sizeof(float));
+
+	for (uint32 i=1; i<count; i++) {
+		decompress(	(i-1) * CHECKPOINT_INTERVAL, &Checkpoints[(i-1) * VectorLen],
+						i * CHECKPOINT_INTERVAL, &Checkpoints[i * VectorLen]	);
+	}
+
+}	// bake_checkpoints
+
+
 /***********************************************************************************************
  * AdaptiveDeltaMotionChannelClass::decompress																  *
  *                                                                                             *
@@ -982,15 +1049,15 @@ bool AdaptiveDeltaMotionChannelClass::Load_W3D(ChunkLoadClass & cload)
  *   02/23/2000 JGA  : Created.                                                                *
  *=============================================================================================*/
 #define PACKET_SIZE (9)
-void AdaptiveDeltaMotionChannelClass::decompress(uint32 frame_idx, float *outdata)
+void AdaptiveDeltaMotionChannelClass::decompress(uint32 frame_idx, float *outdata) const
 {
 	// Start Over from the beginning
 	float *base	= (float *) &Data[0];	// pointer to our true know beginning values
 
-	bool done = false;
-
 	for(int vi=0; vi<VectorLen; vi++) {
 		// Decompress all the vector indices, since they will probably all be needed
+		bool done = false;
+
 		unsigned char *pPacket = (unsigned char *) Data;	// pointer to current packet
 		pPacket+= (sizeof(float) * VectorLen);					// skip non-compressed header information
 		pPacket+= PACKET_SIZE * vi;								// skip to the appropriate packet start
@@ -1054,7 +1121,7 @@ void AdaptiveDeltaMotionChannelClass::decompress(uint32 frame_idx, float *outdat
 
 } // decompress, from beginning
 
-void AdaptiveDeltaMotionChannelClass::decompress(uint32 src_idx, float *srcdata, uint32 frame_idx, float *outdata)
+void AdaptiveDeltaMotionChannelClass::decompress(uint32 src_idx, const float *srcdata, uint32 frame_idx, float *outdata) const
 {
 	// Contine decompressing from src_idx, up to frame_idx
 
@@ -1064,10 +1131,10 @@ void AdaptiveDeltaMotionChannelClass::decompress(uint32 src_idx, float *srcdata,
 	float *base	= (float *) &Data[0];	// pointer to our true know beginning values
    base += VectorLen;						// skip header information
 
-	bool done = false;
-
 	for(int vi=0; vi<VectorLen; vi++) {
 		// Decompress all the vector indices, since they will probably all be needed
+		bool done = false;
+
 		unsigned char *pPacket = (unsigned char *) base;	// pointer to current packet
 		pPacket+= PACKET_SIZE * vi;								// skip to the appropriate packet start
 		pPacket+= (PACKET_SIZE * VectorLen) * ((src_idx-1)>>4); // skip out to current packet
@@ -1137,80 +1204,73 @@ void AdaptiveDeltaMotionChannelClass::decompress(uint32 src_idx, float *srcdata,
 
 
 /***********************************************************************************************
- * AdaptiveDeltaMotionChannelClass::getframe returns decompressed data for frame/vectorindex   *
+ * AdaptiveDeltaMotionChannelClass::getframes -- returns decompressed data for frame and frame+1 *
  *                                                                                             *
  * INPUT:                                                                                      *
+ * frame_idx - frame to decode, clamped to the last frame                                      *
+ * cursor - decode cursor to work from, left holding the result                                *
  *                                                                                             *
  * OUTPUT:                                                                                     *
+ * VectorLen values for frame_idx followed by VectorLen values for frame_idx+1 (the last frame *
+ * is repeated at the end of the channel)                                                      *
  *                                                                                             *
  * WARNINGS:                                                                                   *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *   02/18/2000 JGA  : Created.                                                                 *
+ *   02/18/2000 JGA  : Created.                                                                *
  *=============================================================================================*/
-float AdaptiveDeltaMotionChannelClass::getframe(uint32 frame_idx, uint32 vector_idx)
+const float * AdaptiveDeltaMotionChannelClass::getframes(uint32 frame_idx, MotionChannelCursorStruct & cursor) const
 {
+	assert(VectorLen <= 4);
+
 	// Make sure frame_idx is valid
 
 	if (frame_idx >= NumFrames) frame_idx = NumFrames - 1;
 
-	// Check to see if the data is already in cache?
-
-	if (CacheFrame == frame_idx) {
-		return(CacheData[vector_idx]);
-	}
-
-	if ((CacheFrame+1) == frame_idx) {
-		return(CacheData[vector_idx + VectorLen]);
-	}
-
-	if (frame_idx < CacheFrame)  {
-		// Requested Frame isn't cached, so cache it, and frame_idx+1, and return the decompressed data
-      // from frame_idx
-
-      decompress(frame_idx, &CacheData[0]);
-
-      if (frame_idx != (NumFrames - 1))  {
-      	decompress(frame_idx, &CacheData[0], frame_idx+1, &CacheData[VectorLen]);
-      }
+	// Check to see if the data is already in the cursor?
 
-      CacheFrame = frame_idx;
-
-      return(CacheData[vector_idx]);
+	if (cursor.Frame == frame_idx) {
+		return(cursor.Data);
 	}
 
-   // Copy last known Cached data down
-
-   if (frame_idx == (CacheFrame + 2))  {
+	float *cur	= &cursor.Data[0];
+	float *next	= &cursor.Data[VectorLen];
 
-      // Sliding window
-   	memcpy(&CacheData[0], &CacheData[VectorLen], VectorLen * sizeof(float));
+	if ((cursor.Frame + 1) == frame_idx) {
 
-      CacheFrame++;
+		// Sliding window
+		memcpy(cur, next, VectorLen * sizeof(float));
 
-      decompress(CacheFrame, &CacheData[0], frame_idx, &CacheData[VectorLen]);
-
-    	return(CacheData[VectorLen + vector_idx]);
-   }
-
-   // Else just use last known frame to decompress forwards
+	} else {
 
-   assert(VectorLen <= 4);
+		// Decode forwards from the cursor if that is no further than the nearest checkpoint,
+		// otherwise from the checkpoint
 
-   float temp[4];
+		uint32 checkpoint = frame_idx - (frame_idx % CHECKPOINT_INTERVAL);
 
-   memcpy(&temp[0], &CacheData[VectorLen], VectorLen * sizeof(float));
+		if ((cursor.Frame < frame_idx) && ((cursor.Frame + 1) >= checkpoint)) {
+			decompress(cursor.Frame + 1, next, frame_idx, cur);
+		} else {
+			const float *src = &Checkpoints[(checkpoint / CHECKPOINT_INTERVAL) * VectorLen];
+			if (checkpoint == frame_idx) {
+				memcpy(cur, src, VectorLen * sizeof(float));
+			} else {
+				decompress(checkpoint, src, frame_idx, cur);
+			}
+		}
+	}
 
-   decompress(CacheFrame, &temp[0], frame_idx, &CacheData[0]);
-   CacheFrame = frame_idx;
+	cursor.Frame = frame_idx;
 
-   if (frame_idx != (NumFrames - 1))  {
-   	decompress(CacheFrame, &CacheData[0], frame_idx+1, &CacheData[VectorLen]);
-   }
+	if (frame_idx != (NumFrames - 1))  {
+		decompress(frame_idx, cur, frame_idx+1, next);
+	} else {
+		memcpy(next, cur, VectorLen * sizeof(float));
+	}
 
-   return(CacheData[vector_idx]);
+	return(cursor.Data);
 
-} // getframe
+} // getframes
 
 /***********************************************************************************************
  * AdaptiveDeltaMotionChannelClass::Get_Vector -- returns the vector for the specified frame # *
@@ -1222,19 +1282,24 @@ float AdaptiveDeltaMotionChannelClass::getframe(uint32 frame_idx, uint32 vector_
  * WARNINGS:                                                                                   *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *   02/18/2000 JGA  : Created.                                                                 *
+ *   02/18/2000 JGA  : Created.                                                                *
  *=============================================================================================*/
-void	AdaptiveDeltaMotionChannelClass::Get_Vector(float32 frame,float * setvec)
+void	AdaptiveDeltaMotionChannelClass::Get_Vector(float32 frame,float * setvec,MotionChannelCursorStruct * cursor) const
 {
 
 	uint32 frame1 = frame;
 
 	float ratio = frame - frame1;
 
-	float value1 = getframe(frame1);
-	float value2 = getframe(frame1 + 1);
+	MotionChannelCursorStruct temp;
+	if (cursor == NULL) {
+		temp.Reset();
+		cursor = &temp;
+	}
+
+	const float *values = getframes(frame1, *cursor);
 
-   *setvec = WWMath::Lerp(value1,value2,ratio);
+   *setvec = WWMath::Lerp(values[0],values[VectorLen],ratio);
 
 
 }	// Get_Vector
@@ -1243,25 +1308,27 @@ void	AdaptiveDeltaMotionChannelClass::Get_Vector(float32 frame,float * setvec)
 //
 //  Special Case Quats, so we can use Slerp
 //
-Quaternion AdaptiveDeltaMotionChannelClass::Get_QuatVector(float32 frame)
+Quaternion AdaptiveDeltaMotionChannelClass::Get_QuatVector(float32 frame,MotionChannelCursorStruct * cursor) const
 {
 
+	assert(VectorLen == 4);
+
 	uint32 frame1 = frame;
-	uint32 frame2 = frame1+1;
 	float ratio = frame - frame1;
 
+	MotionChannelCursorStruct temp;
+	if (cursor == NULL) {
+		temp.Reset();
+		cursor = &temp;
+	}
+
+	const float *values = getframes(frame1, *cursor);
+
 	Quaternion q1(1);
-	q1.Set( getframe(frame1, 0),
-			  getframe(frame1, 1),
-			  getframe(frame1, 2),
-			  getframe(frame1, 3) );
+	q1.Set( values[0], values[1], values[2], values[3] );
 
 	Quaternion q2(1);
-
-	q2.Set( getframe(frame2, 0),
-			  getframe(frame2, 1),
-			  getframe(frame2, 2),
-			  getframe(frame2, 3) );
+	q2.Set( values[4], values[5], values[6], values[7] );
 
 
 	Quaternion q(1);
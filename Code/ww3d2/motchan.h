@@ -163,6 +163,26 @@ WWINLINE int BitChannelClass::Get_Bit(int frame) const
 	}
 }
 
+/******************************************************************************
+
+	MotionChannelCursorStruct is the decode position in one of the compressed
+	channels below.  The channels themselves are read-only once loaded and can
+	be shared by any number of objects playing the animation; each object keeps
+	its own cursors (see HAnimCursorClass) so playing forwards only decodes the
+	frames it steps over.  Lookups without a cursor are still valid, they just
+	start from the nearest checkpoint (adaptive delta) or search (time coded).
+
+******************************************************************************/
+
+struct MotionChannelCursorStruct
+{
+	void		Reset(void)			{ Frame = 0x7FFFFFFF; Index = 0; }
+
+	uint32	Frame;				// adaptive delta: frame decoded into Data
+	uint32	Index;				// time coded: index of the last packet used
+	float		Data[8];				// adaptive delta: values for Frame and Frame+1, x VectorLen
+};
+
 /******************************************************************************
 
 	TimeCodedMotionChannelClass is used to store motion.  Motion data
@@ -184,9 +204,9 @@ public:
 	bool	Load_W3D(ChunkLoadClass & cload);
 	int	Get_Type(void) { return Type; }
 	int	Get_Pivot(void) { return PivotIdx; }
-	void	Get_Vector(float32 frame, float * setvec);
+	void	Get_Vector(float32 frame, float * setvec, MotionChannelCursorStruct * cursor = NULL) const;
 
-	Quaternion Get_QuatVector(float32 frame);
+	Quaternion Get_QuatVector(float32 frame, MotionChannelCursorStruct * cursor = NULL) const;
 
 private:
 
@@ -198,14 +218,13 @@ private:
 	uint32	NumTimeCodes;		// Number of packets
 
 	uint32	LastTimeCodeIdx;	// absolute index to last time code
-	uint32	CachedIdx;			// Last Index Used
 
 	uint32	*	Data;			 	// pointer to packet data
 
 	void 		Free(void);
 	void 		set_identity(float * setvec);
-	uint32	get_index(uint32 timecode);
-	uint32	binary_search_index(uint32 timecode);
+	uint32	get_index(uint32 timecode, MotionChannelCursorStruct * cursor) const;
+	uint32	binary_search_index(uint32 timecode) const;
 
 	friend class HCompressedAnimClass;
 };
@@ -221,12 +240,17 @@ public:
 	bool	Load_W3D(ChunkLoadClass & cload);
 	int	Get_Type(void) { return Type; }
 	int	Get_Pivot(void) { return PivotIdx; }
-	void	Get_Vector(float32 frame, float * setvec);
+	void	Get_Vector(float32 frame, float * setvec, MotionChannelCursorStruct * cursor = NULL) const;
 
-	Quaternion Get_QuatVector(float32 frame);
+	Quaternion Get_QuatVector(float32 frame, MotionChannelCursorStruct * cursor = NULL) const;
 
 private:
 
+	enum
+	{
+		CHECKPOINT_INTERVAL = 64,	// frames between baked checkpoints, a multiple of the 16 frame packets
+	};
+
 	uint32	PivotIdx;			// what pivot is this channel applied to
 	uint32	Type;					// what type of channel is this
 	int		VectorLen;			// size of each individual vector
@@ -237,14 +261,14 @@ private:
 
 	uint32  *Data;				 	// pointer to packet data
 
-	uint32	CacheFrame;
-	float	  *CacheData;			// the data for CachedFrame, and CachedFrame+1, x VectorLen
+	float	  *Checkpoints;		// decoded values for every CHECKPOINT_INTERVAL'th frame, x VectorLen
 
 	void 		Free(void);
+	void		bake_checkpoints(void);
 
-	float		getframe(uint32 frame_idx, uint32 vector_idx=0);
-   void		decompress(uint32 frame_idx, float *outdata);
-   void		decompress(uint32 src_idx, float *srcdata, uint32 frame_idx, float *outdata);
+	const float *	getframes(uint32 frame_idx, MotionChannelCursorStruct & cursor) const;
+   void		decompress(uint32 frame_idx, float *outdata) const;
+   void		decompress(uint32 src_idx, const float *srcdata, uint32 frame_idx, float *outdata) const;
 
 	friend class HCompressedAnimClass;
 };
@@ -269,7 +293,7 @@ public:
 	bool	Load_W3D(ChunkLoadClass & cload);
 	int	Get_Type(void) { return Type; }
 	int	Get_Pivot(void) { return PivotIdx; }
-	int	Get_Bit(int frame);
+	int	Get_Bit(int frame, MotionChannelCursorStruct * cursor = NULL) const;
 
 private:
 
@@ -278,7 +302,6 @@ private:
 	int		DefaultVal;
 
 	uint32	NumTimeCodes;
-	uint32	CachedIdx;
 
 	uint32	*Bits;
 
@@ -50,6 +50,12 @@
 #include "texture.h"
 #include "dx8wrapper.h"
 #include "vector3.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PART_BUF_SSE2
+#include <emmintrin.h>
+#endif
 
 // A random permutation of the numbers 0 to 15 - used for LOD particle decimation.
 // It was generated by the amazingly high-tech method of pulling numbers out of a hat.
@@ -119,6 +125,10 @@ ParticleBufferClass::ParticleBufferClass
 	NewNum(0),
 	BoundingBox(Vector3(0,0,0),Vector3(0,0,0)),
 	BoundingBoxDirty(true),
+	VisualStateTime(0),
+	VisualStateFrame(0),
+	VisualStateDirty(true),
+	LastRenderFrame(0),
 	NumColorKeyFrames(0),
 	ColorKeyFrameTimes(NULL),
 	ColorKeyFrameValues(NULL),
@@ -336,6 +346,10 @@ ParticleBufferClass::ParticleBufferClass(const ParticleBufferClass & src) :
 	NewNum(0),
 	BoundingBox(Vector3(0,0,0),Vector3(0,0,0)),
 	BoundingBoxDirty(true),
+	VisualStateTime(0),
+	VisualStateFrame(0),
+	VisualStateDirty(true),
+	LastRenderFrame(0),
 	NumColorKeyFrames(src.NumColorKeyFrames),
 	ColorKeyFrameTimes(NULL),
 	ColorKeyFrameValues(NULL),
@@ -792,6 +806,8 @@ void ParticleBufferClass::Render(RenderInfoClass & rinfo)
 {
 	WWPROFILE("ParticleBuffer::Render");
 
+	LastRenderFrame = WW3D::Get_Frame_Count();
+
 	unsigned int sort_level = SORT_LEVEL_NONE;
 
 	if (!WW3D::Is_Sorting_Enabled())
@@ -1096,6 +1112,8 @@ void ParticleBufferClass::Render_Line_Group(RenderInfoClass & rinfo)
 // position (and therefore the size of the particle system as a whole)
 void ParticleBufferClass::Scale(float scale)
 {
+	VisualStateDirty = true;
+
 	// Scale all size keyframes, keyframe deltas, random size entries,
 	// MaxSize and SizeRandom.
 	unsigned int i;
@@ -1334,6 +1352,7 @@ int ParticleBufferClass::Calculate_Cost_Value_Arrays(float screen_area, float *v
 
 void ParticleBufferClass::Reset_Colors(ParticlePropertyStruct<Vector3> &new_props)
 {
+	VisualStateDirty = true;
 
 	unsigned int i;	// Used in loops
 	unsigned int ui_previous_key_time = 0;
@@ -1495,6 +1514,8 @@ void ParticleBufferClass::Reset_Colors(ParticlePropertyStruct<Vector3> &new_prop
 
 void ParticleBufferClass::Reset_Opacity(ParticlePropertyStruct<float> &new_props)
 {
+	VisualStateDirty = true;
+
 	unsigned int i;	// Used in loops
 	unsigned int ui_previous_key_time = 0;
 	unsigned int ui_current_key_time = 0;
@@ -1651,6 +1672,8 @@ void ParticleBufferClass::Reset_Opacity(ParticlePropertyStruct<float> &new_props
 
 void ParticleBufferClass::Reset_Size(ParticlePropertyStruct<float> &new_props)
 {
+	VisualStateDirty = true;
+
 
 	unsigned int i;	// Used in loops
 	unsigned int ui_previous_key_time = 0;
@@ -1819,6 +1842,8 @@ void ParticleBufferClass::Reset_Size(ParticlePropertyStruct<float> &new_props)
 
 void ParticleBufferClass::Reset_Rotations(ParticlePropertyStruct<float> &new_props, float orient_rnd)
 {
+	VisualStateDirty = true;
+
 
 	unsigned int i;	// Used in loops
 	unsigned int ui_previous_key_time = 0;
@@ -2029,6 +2054,8 @@ void ParticleBufferClass::Reset_Rotations(ParticlePropertyStruct<float> &new_pro
 
 void ParticleBufferClass::Reset_Frames(ParticlePropertyStruct<float> &new_props)
 {
+	VisualStateDirty = true;
+
 
 	unsigned int i;	// Used in loops
 	unsigned int ui_previous_key_time = 0;
@@ -2190,6 +2217,8 @@ void ParticleBufferClass::Reset_Frames(ParticlePropertyStruct<float> &new_props)
 
 void ParticleBufferClass::Reset_Blur_Times(ParticlePropertyStruct<float> &new_blur_times)
 {
+	VisualStateDirty = true;
+
 
 	unsigned int i;	// Used in loops
 	unsigned int ui_previous_key_time = 0;
@@ -2401,6 +2430,285 @@ void ParticleBufferClass::Update_Cached_Bounding_Volumes(void) const
 }
 
 
+/*
+** Particle update kernels.
+**
+** The particles are stored oldest first, so as the visual state update walks them the
+** keyframe that applies can only move back.  Rather than checking the keyframe for every
+** particle and property, Find_Key_Run finds the run of particles that share the current
+** keyframe and the kernels below interpolate the whole run at once, four particles at a
+** time where SSE2 is available.  The SSE2 paths do the same operations in the same order
+** as the scalar loops, so the results don't depend on which one ran.
+*/
+static inline unsigned int Find_Key_Run
+(
+	const unsigned int * time_stamps,
+	unsigned int current_time,
+	const unsigned int * key_times,
+	unsigned int & key,
+	unsigned int first,
+	unsigned int last
+)
+{
+	// This loop must terminate because the 0th keytime is 0, which also means that every
+	// remaining particle belongs to the 0th keyframe.
+	for (; (current_time - time_stamps[first]) < key_times[key]; key--);
+	if (key == 0) return last;
+
+	unsigned int part = first + 1;
+	while (part < last && (current_time - time_stamps[part]) >= key_times[key]) part++;
+	return part;
+}
+
+#ifdef PART_BUF_SSE2
+
+// Entries part to part+3 of a randomizer table.
+static inline __m128 Load_Random4(const float * table, unsigned int mask, unsigned int part)
+{
+	unsigned int index = part & mask;
+	if (index + 3 <= mask) {
+		return _mm_loadu_ps(table + index);
+	}
+	return _mm_setr_ps(table[index], table[(part + 1) & mask], table[(part + 2) & mask], table[(part + 3) & mask]);
+}
+
+// (float)(current_time - time_stamps[part] - key_time) for four particles, with base
+// holding current_time - key_time.
+static inline __m128 Load_Delta_Times4(const unsigned int * time_stamps, __m128i base, unsigned int part)
+{
+	return _mm_cvtepi32_ps(_mm_sub_epi32(base, _mm_loadu_si128((const __m128i *)(time_stamps + part))));
+}
+
+static inline void Store_Bytes4(uint8 * out, __m128i values)
+{
+	values = _mm_and_si128(values, _mm_set1_epi32(0xFF));
+	values = _mm_packs_epi32(values, values);
+	values = _mm_packus_epi16(values, values);
+	int bytes = _mm_cvtsi128_si32(values);
+	memcpy(out, &bytes, sizeof(bytes));
+}
+
+#endif
+
+// value + delta * dt + random, for alpha, size and ucoord. Size can't go negative.
+static void Interpolate_Float_Run
+(
+	float * out,
+	const unsigned int * time_stamps,
+	unsigned int current_time,
+	unsigned int first,
+	unsigned int last,
+	unsigned int key_time,
+	float value,
+	float delta,
+	const float * random,
+	unsigned int random_mask,
+	bool clamp_negative
+)
+{
+	unsigned int part = first;
+
+#ifdef PART_BUF_SSE2
+	__m128i base4 = _mm_set1_epi32((int)(current_time - key_time));
+	__m128 value4 = _mm_set1_ps(value);
+	__m128 delta4 = _mm_set1_ps(delta);
+	__m128 zero4 = _mm_setzero_ps();
+	for (; part + 4 <= last; part += 4) {
+		__m128 dt4 = Load_Delta_Times4(time_stamps, base4, part);
+		__m128 result = _mm_add_ps(_mm_add_ps(value4, _mm_mul_ps(delta4, dt4)), Load_Random4(random, random_mask, part));
+		if (clamp_negative) {
+			result = _mm_and_ps(result, _mm_cmpge_ps(result, zero4));
+		}
+		_mm_storeu_ps(out + part, result);
+	}
+#endif
+
+	for (; part < last; part++) {
+		float result = value + delta * (float)(current_time - time_stamps[part] - key_time) + random[part & random_mask];
+		if (clamp_negative) {
+			result = (result >= 0.0f) ? result : 0.0f;
+		}
+		out[part] = result;
+	}
+}
+
+// Same as Interpolate_Float_Run, but wrapped to a byte for the frame index.
+static void Interpolate_Frame_Run
+(
+	uint8 * out,
+	const unsigned int * time_stamps,
+	unsigned int current_time,
+	unsigned int first,
+	unsigned int last,
+	unsigned int key_time,
+	float value,
+	float delta,
+	const float * random,
+	unsigned int random_mask
+)
+{
+	unsigned int part = first;
+
+#ifdef PART_BUF_SSE2
+	__m128i base4 = _mm_set1_epi32((int)(current_time - key_time));
+	__m128 value4 = _mm_set1_ps(value);
+	__m128 delta4 = _mm_set1_ps(delta);
+	for (; part + 4 <= last; part += 4) {
+		__m128 dt4 = Load_Delta_Times4(time_stamps, base4, part);
+		__m128 result = _mm_add_ps(_mm_add_ps(value4, _mm_mul_ps(delta4, dt4)), Load_Random4(random, random_mask, part));
+		Store_Bytes4(out + part, _mm_cvttps_epi32(result));
+	}
+#endif
+
+	for (; part < last; part++) {
+		float tmp_frame = value + delta * (float)(current_time - time_stamps[part] - key_time) + random[part & random_mask];
+		out[part] = (uint)(((int)(tmp_frame)) & 0xFF);
+	}
+}
+
+// Orientation integrates the rotation keyframe, plus a random spin and starting angle.
+static void Interpolate_Orientation_Run
+(
+	uint8 * out,
+	const unsigned int * time_stamps,
+	unsigned int current_time,
+	unsigned int first,
+	unsigned int last,
+	unsigned int key_time,
+	float orientation,
+	float rotation,
+	float half_rotation_delta,
+	const float * random_rotation,
+	unsigned int random_rotation_mask,
+	const float * random_orientation,
+	unsigned int random_orientation_mask
+)
+{
+	unsigned int part = first;
+
+#ifdef PART_BUF_SSE2
+	__m128i current4 = _mm_set1_epi32((int)current_time);
+	__m128i base4 = _mm_set1_epi32((int)(current_time - key_time));
+	__m128 orientation4 = _mm_set1_ps(orientation);
+	__m128 rotation4 = _mm_set1_ps(rotation);
+	__m128 half_delta4 = _mm_set1_ps(half_rotation_delta);
+	__m128 scale4 = _mm_set1_ps(256.0f);
+	for (; part + 4 <= last; part += 4) {
+		__m128 dt4 = Load_Delta_Times4(time_stamps, base4, part);
+		__m128 age4 = Load_Delta_Times4(time_stamps, current4, part);
+		__m128 result = _mm_add_ps(orientation4, _mm_mul_ps(_mm_add_ps(rotation4, _mm_mul_ps(half_delta4, dt4)), dt4));
+		result = _mm_add_ps(result, _mm_mul_ps(Load_Random4(random_rotation, random_rotation_mask, part), age4));
+		result = _mm_add_ps(result, Load_Random4(random_orientation, random_orientation_mask, part));
+		Store_Bytes4(out + part, _mm_cvttps_epi32(_mm_mul_ps(result, scale4)));
+	}
+#endif
+
+	for (; part < last; part++) {
+		unsigned int part_age = current_time - time_stamps[part];
+		float f_delta_t = (float)(part_age - key_time);
+		float tmp_orient = orientation +
+			(rotation + half_rotation_delta * f_delta_t) * f_delta_t +
+			random_rotation[part & random_rotation_mask] * (float)part_age +
+			random_orientation[part & random_orientation_mask];
+		out[part] = (uint)(((int)(tmp_orient * 256.0f)) & 0xFF);
+	}
+}
+
+/*
+** Moves count particles along by dt. With acceleration the velocities are updated too; if
+** prev_pos is given the particles start from there (ping-pong position buffers). The
+** arrays are treated as flat float arrays, three floats to a particle.
+*/
+static void Advance_Particles
+(
+	Vector3 * position,
+	const Vector3 * prev_pos,
+	Vector3 * velocity,
+	unsigned int count,
+	float dt,
+	const Vector3 * accel_p,
+	const Vector3 * delta_v
+)
+{
+	unsigned int i = 0;
+
+#ifdef PART_BUF_SSE2
+	static_assert(sizeof(Vector3) == 3 * sizeof(float), "particle kernels need packed Vector3s");
+
+	float * pos = &position[0].X;
+	float * vel = &velocity[0].X;
+	__m128 dt4 = _mm_set1_ps(dt);
+
+	if (accel_p == NULL) {
+		for (; i + 4 <= count; i += 4) {
+			for (int j = 0; j < 12; j += 4) {
+				__m128 p = _mm_loadu_ps(pos + 3 * i + j);
+				__m128 v = _mm_loadu_ps(vel + 3 * i + j);
+				_mm_storeu_ps(pos + 3 * i + j, _mm_add_ps(p, _mm_mul_ps(v, dt4)));
+			}
+		}
+	} else {
+		// Four particles are twelve floats, which is three registers of repeating x,y,z.
+		const Vector3 & a = *accel_p;
+		const Vector3 & d = *delta_v;
+		__m128 accel4[3] = {	_mm_setr_ps(a.X, a.Y, a.Z, a.X),
+									_mm_setr_ps(a.Y, a.Z, a.X, a.Y),
+									_mm_setr_ps(a.Z, a.X, a.Y, a.Z)	};
+		__m128 delta4[3] = {	_mm_setr_ps(d.X, d.Y, d.Z, d.X),
+									_mm_setr_ps(d.Y, d.Z, d.X, d.Y),
+									_mm_setr_ps(d.Z, d.X, d.Y, d.Z)	};
+		const float * prev = (prev_pos != NULL) ? &prev_pos[0].X : NULL;
+		for (; i + 4 <= count; i += 4) {
+			for (int j = 0; j < 3; j++) {
+				int offset = 3 * i + 4 * j;
+				__m128 v = _mm_loadu_ps(vel + offset);
+				__m128 p;
+				if (prev != NULL) {
+					p = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(prev + offset), _mm_mul_ps(v, dt4)), accel4[j]);
+				} else {
+					p = _mm_add_ps(_mm_loadu_ps(pos + offset), _mm_add_ps(_mm_mul_ps(v, dt4), accel4[j]));
+				}
+				_mm_storeu_ps(pos + offset, p);
+				_mm_storeu_ps(vel + offset, _mm_add_ps(v, delta4[j]));
+			}
+		}
+	}
+#endif
+
+	if (accel_p == NULL) {
+		for (; i < count; i++) {
+			position[i] += velocity[i] * dt;
+		}
+	} else if (prev_pos != NULL) {
+		for (; i < count; i++) {
+			position[i] = prev_pos[i] + velocity[i] * dt + *accel_p;
+			velocity[i] += *delta_v;
+		}
+	} else {
+		for (; i < count; i++) {
+			position[i] += velocity[i] * dt + *accel_p;
+			velocity[i] += *delta_v;
+		}
+	}
+}
+
+
+void ParticleBufferClass::Update_State(bool update_visual)
+{
+	// Same as what Render() would do, except the bounding box gets done too
+	Update_Bounding_Box();
+	if (update_visual && DecimationThreshold < LodCount - 1) {
+		Update_Visual_Particle_State();
+	}
+}
+
+
+bool ParticleBufferClass::Was_Rendered_Last_Frame(void) const
+{
+	return LastRenderFrame + 1 == WW3D::Get_Frame_Count();
+}
+
+
 void ParticleBufferClass::Update_Kinematic_Particle_State(void)
 {
 	// Note: elapsed may be very large indeed the first time the object is
@@ -2443,6 +2751,16 @@ void ParticleBufferClass::Update_Visual_Particle_State(void)
 							  (RenderMode==W3D_EMITTER_RENDER_MODE_LINEGRP_PRISM));
 	if (!Color && !Alpha && !Size && !Orientation && !Frame && !UCoord && !is_linegroup) return;
 
+	// The particles only change when the sync time does and the ping-pong position buffers
+	// swap every frame, so if neither has moved on (and the keyframes haven't been reset)
+	// the visual state is still good.
+	unsigned int current_time = WW3D::Get_Sync_Time();
+	unsigned int frame_count = WW3D::Get_Frame_Count();
+	if (!VisualStateDirty && VisualStateTime == current_time && VisualStateFrame == frame_count) return;
+	VisualStateTime = current_time;
+	VisualStateFrame = frame_count;
+	VisualStateDirty = false;
+
 	// In the general case, a range in a circular buffer can be composed of up
 	// to two subranges. Find the Start - End subranges.
 	unsigned int sub1_end;		// End of subrange 1.
@@ -2454,19 +2772,9 @@ void ParticleBufferClass::Update_Visual_Particle_State(void)
 		sub1_end = MaxNum;
 		sub2_start = 0;
 	}
+	const unsigned int range_start[2] = { Start, sub2_start };
+	const unsigned int range_end[2] = { sub1_end, End };
 
-	unsigned int current_time = WW3D::Get_Sync_Time();
-
-	// The following back-to-back pair of "for" loops traverses the circular
-	// buffer subranges in proper order.
-	unsigned int ckey = NumColorKeyFrames - 1;
-	unsigned int akey = NumAlphaKeyFrames - 1;
-	unsigned int skey = NumSizeKeyFrames - 1;
-	unsigned int rkey = NumRotationKeyFrames - 1;
-	unsigned int fkey = NumFrameKeyFrames - 1;
-	unsigned int bkey = NumBlurTimeKeyFrames -1;
-
-	unsigned int part;
 	Vector3 *color = Color ? Color->Get_Array(): NULL;
 	float *alpha = Alpha ? Alpha->Get_Array(): NULL;
 	float *size = Size ? Size->Get_Array(): NULL;
@@ -2478,209 +2786,118 @@ void ParticleBufferClass::Update_Visual_Particle_State(void)
 	Vector3 *position=NULL;
 
 	if (PingPongPosition) {
-		int pingpong = WW3D::Get_Frame_Count() & 0x1;
+		int pingpong = frame_count & 0x1;
 		position = Position[pingpong]->Get_Array();
 	} else {
 		position = Position[0]->Get_Array();
 	}
 
+	// Frame and ucoord are mutually exclusive
+	WWASSERT(frame==NULL || ucoord==NULL);
 
-	for (part = Start; part < sub1_end; part++) {
-
-		unsigned int part_age = current_time - TimeStamp[part];
-
-		// Ensure the current color keyframe is correct, and calculate color state
-		if (color) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < ColorKeyFrameTimes[ckey]; ckey--);
-
-			color[part] = ColorKeyFrameValues[ckey] +
-							ColorKeyFrameDeltas[ckey] * (float)(part_age - ColorKeyFrameTimes[ckey]) +
-							RandomColorEntries[part & NumRandomColorEntriesMinus1];
-		}
-
-		// Ensure the current alpha keyframe is correct, and calculate alpha state
-		if (alpha) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < AlphaKeyFrameTimes[akey]; akey--);
-
-			alpha[part] = AlphaKeyFrameValues[akey] +
-				AlphaKeyFrameDeltas[akey] * (float)(part_age - AlphaKeyFrameTimes[akey]) +
-				RandomAlphaEntries[part & NumRandomAlphaEntriesMinus1];
+	// Each property walks the two subranges in order, one keyframe run at a time. The
+	// current keyframe carries over from the first subrange into the second.
+	unsigned int part;
+	unsigned int run_end;
+
+	if (color) {
+		unsigned int key = NumColorKeyFrames - 1;
+		for (int range = 0; range < 2; range++) {
+			for (part = range_start[range]; part < range_end[range]; part = run_end) {
+				run_end = Find_Key_Run(TimeStamp, current_time, ColorKeyFrameTimes, key, part, range_end[range]);
+				const Vector3 & value = ColorKeyFrameValues[key];
+				const Vector3 & delta = ColorKeyFrameDeltas[key];
+				unsigned int key_time = ColorKeyFrameTimes[key];
+				for (; part < run_end; part++) {
+					color[part] = value +
+						delta * (float)(current_time - TimeStamp[part] - key_time) +
+						RandomColorEntries[part & NumRandomColorEntriesMinus1];
+				}
+			}
 		}
+	}
 
-		// Ensure the current size keyframe is correct, and calculate size state
-		if (size) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < SizeKeyFrameTimes[skey]; skey--);
-
-			size[part] = SizeKeyFrameValues[skey] +
-				SizeKeyFrameDeltas[skey] * (float)(part_age - SizeKeyFrameTimes[skey]) +
-				RandomSizeEntries[part & NumRandomSizeEntriesMinus1];
-
-			// Size (unlike color and alpha) isn't clamped in the engine, so we need to clamp
-			// negative values to zero here:
-			size[part] = (size[part] >= 0.0f) ? size[part] : 0.0f;
+	if (alpha) {
+		unsigned int key = NumAlphaKeyFrames - 1;
+		for (int range = 0; range < 2; range++) {
+			for (part = range_start[range]; part < range_end[range]; part = run_end) {
+				run_end = Find_Key_Run(TimeStamp, current_time, AlphaKeyFrameTimes, key, part, range_end[range]);
+				Interpolate_Float_Run(	alpha, TimeStamp, current_time, part, run_end, AlphaKeyFrameTimes[key],
+												AlphaKeyFrameValues[key], AlphaKeyFrameDeltas[key],
+												RandomAlphaEntries, NumRandomAlphaEntriesMinus1, false	);
+			}
 		}
+	}
 
-		// Ensure the current rotation keyframe is correct, and calculate orientation state
-		if (orientation) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < RotationKeyFrameTimes[rkey]; rkey--);
-
-			float f_delta_t = (float)(part_age - RotationKeyFrameTimes[rkey]);
-			float tmp_orient = OrientationKeyFrameValues[rkey] +
-				(RotationKeyFrameValues[rkey] + HalfRotationKeyFrameDeltas[rkey] * f_delta_t) * f_delta_t +
-				RandomRotationEntries[part & NumRandomRotationEntriesMinus1] * (float)part_age +
-				RandomOrientationEntries[part & NumRandomOrientationEntriesMinus1];
-
-			orientation[part] = (uint)(((int)(tmp_orient * 256.0f)) & 0xFF);
+	if (size) {
+		// Size (unlike color and alpha) isn't clamped in the engine, so the kernel clamps
+		// negative values to zero.
+		unsigned int key = NumSizeKeyFrames - 1;
+		for (int range = 0; range < 2; range++) {
+			for (part = range_start[range]; part < range_end[range]; part = run_end) {
+				run_end = Find_Key_Run(TimeStamp, current_time, SizeKeyFrameTimes, key, part, range_end[range]);
+				Interpolate_Float_Run(	size, TimeStamp, current_time, part, run_end, SizeKeyFrameTimes[key],
+												SizeKeyFrameValues[key], SizeKeyFrameDeltas[key],
+												RandomSizeEntries, NumRandomSizeEntriesMinus1, true	);
+			}
 		}
+	}
 
-		// Ensure the current frame keyframe is correct, and calculate frame state
-		if (frame) {
-			// Frame and ucoord are mutually exclusive
-			WWASSERT(ucoord==NULL);
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < FrameKeyFrameTimes[fkey]; fkey--);
-
-			float tmp_frame = FrameKeyFrameValues[fkey] +
-				FrameKeyFrameDeltas[fkey] * (float)(part_age - FrameKeyFrameTimes[fkey]) +
-				RandomFrameEntries[part & NumRandomFrameEntriesMinus1];
-
-			frame[part] = (uint)(((int)(tmp_frame)) & 0xFF);
+	if (orientation) {
+		unsigned int key = NumRotationKeyFrames - 1;
+		for (int range = 0; range < 2; range++) {
+			for (part = range_start[range]; part < range_end[range]; part = run_end) {
+				run_end = Find_Key_Run(TimeStamp, current_time, RotationKeyFrameTimes, key, part, range_end[range]);
+				Interpolate_Orientation_Run(	orientation, TimeStamp, current_time, part, run_end, RotationKeyFrameTimes[key],
+														OrientationKeyFrameValues[key], RotationKeyFrameValues[key], HalfRotationKeyFrameDeltas[key],
+														RandomRotationEntries, NumRandomRotationEntriesMinus1,
+														RandomOrientationEntries, NumRandomOrientationEntriesMinus1	);
+			}
 		}
+	}
 
-		// Ensure the current frame keyframe is correct, and calculate frame state
+	if (frame || ucoord) {
 		// ucoord is the same as frame but in float
-		if (ucoord) {
-			// Frame and ucoord are mutually exclusive
-			WWASSERT(frame==NULL);
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < FrameKeyFrameTimes[fkey]; fkey--);
-
-			ucoord[part] = FrameKeyFrameValues[fkey] +
-				FrameKeyFrameDeltas[fkey] * (float)(part_age - FrameKeyFrameTimes[fkey]) +
-				RandomFrameEntries[part & NumRandomFrameEntriesMinus1];
-		}
-
-		if (tailposition) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			float blur_time = BlurTimeKeyFrameValues[0];
-			if (BlurTimeKeyFrameTimes) {
-				for (; part_age < BlurTimeKeyFrameTimes[bkey]; bkey--);
-				blur_time = BlurTimeKeyFrameValues[bkey] +
-					BlurTimeKeyFrameDeltas[bkey] * (float)(part_age - BlurTimeKeyFrameTimes[bkey]) +
-					RandomBlurTimeEntries[part & NumRandomBlurTimeEntriesMinus1];
+		unsigned int key = NumFrameKeyFrames - 1;
+		for (int range = 0; range < 2; range++) {
+			for (part = range_start[range]; part < range_end[range]; part = run_end) {
+				run_end = Find_Key_Run(TimeStamp, current_time, FrameKeyFrameTimes, key, part, range_end[range]);
+				if (frame) {
+					Interpolate_Frame_Run(	frame, TimeStamp, current_time, part, run_end, FrameKeyFrameTimes[key],
+													FrameKeyFrameValues[key], FrameKeyFrameDeltas[key],
+													RandomFrameEntries, NumRandomFrameEntriesMinus1	);
+				} else {
+					Interpolate_Float_Run(	ucoord, TimeStamp, current_time, part, run_end, FrameKeyFrameTimes[key],
+													FrameKeyFrameValues[key], FrameKeyFrameDeltas[key],
+													RandomFrameEntries, NumRandomFrameEntriesMinus1, false	);
+				}
 			}
-			tailposition[part]=position[part]-Velocity[part]*blur_time*1000;
 		}
 	}
 
-	for (part = sub2_start; part < End; part++) {
-
-		unsigned int part_age = current_time - TimeStamp[part];
-
-		// Ensure the current color keyframe is correct, and calculate color state
-		if (color) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < ColorKeyFrameTimes[ckey]; ckey--);
-
-			color[part] =
-					ColorKeyFrameValues[ckey] +
-					ColorKeyFrameDeltas[ckey] * (float)(part_age - ColorKeyFrameTimes[ckey]) +
-					RandomColorEntries[part & NumRandomColorEntriesMinus1];
-		}
-
-		// Ensure the current alpha keyframe is correct, and calculate alpha state
-		if (alpha) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < AlphaKeyFrameTimes[akey]; akey--);
-
-			alpha[part] = AlphaKeyFrameValues[akey] +
-				AlphaKeyFrameDeltas[akey] * (float)(part_age - AlphaKeyFrameTimes[akey]) +
-				RandomAlphaEntries[part & NumRandomAlphaEntriesMinus1];
-		}
-
-		// Ensure the current size keyframe is correct, and calculate size state
-		if (size) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < SizeKeyFrameTimes[skey]; skey--);
-
-			size[part] = SizeKeyFrameValues[skey] +
-				SizeKeyFrameDeltas[skey] * (float)(part_age - SizeKeyFrameTimes[skey]) +
-				RandomSizeEntries[part & NumRandomSizeEntriesMinus1];
-
-			// Size (unlike color) isn't clamped in the engine, so we need to
-			// clamp negative values to zero here:
-			size[part] = (size[part] >= 0.0f) ? size[part] : 0.0f;
-		}
-
-		// Ensure the current rotation keyframe is correct, and calculate orientation state
-		if (orientation) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < RotationKeyFrameTimes[rkey]; rkey--);
-
-			float f_delta_t = (float)(part_age - RotationKeyFrameTimes[rkey]);
-			float tmp_orient = OrientationKeyFrameValues[rkey] +
-				(RotationKeyFrameValues[rkey] + HalfRotationKeyFrameDeltas[rkey] * f_delta_t) * f_delta_t +
-				RandomRotationEntries[part & NumRandomRotationEntriesMinus1] * (float)part_age +
-				RandomOrientationEntries[part & NumRandomOrientationEntriesMinus1];
-
-			orientation[part] = (uint)(((int)(tmp_orient * 256.0f)) & 0xFF);
-		}
-
-		// Ensure the current frame keyframe is correct, and calculate frame state
-		if (frame) {
-			// Frame and ucoord are mutually exclusive
-			WWASSERT(ucoord==NULL);
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < FrameKeyFrameTimes[fkey]; fkey--);
-
-			float tmp_frame = FrameKeyFrameValues[fkey] +
-				FrameKeyFrameDeltas[fkey] * (float)(part_age - FrameKeyFrameTimes[fkey]) +
-				RandomFrameEntries[part & NumRandomFrameEntriesMinus1];
-
-			frame[part] = (uint)(((int)(tmp_frame)) & 0xFF);
-		}
-
-		// Ensure the current frame keyframe is correct, and calculate frame state
-		// ucoord is the same as frame but in float
-		if (ucoord) {
-			// Frame and ucoord are mutually exclusive
-			WWASSERT(frame==NULL);
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < FrameKeyFrameTimes[fkey]; fkey--);
-
-			ucoord[part] = FrameKeyFrameValues[fkey] +
-				FrameKeyFrameDeltas[fkey] * (float)(part_age - FrameKeyFrameTimes[fkey]) +
-				RandomFrameEntries[part & NumRandomFrameEntriesMinus1];
-		}
-
-		if (tailposition) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			float blur_time = BlurTimeKeyFrameValues[0];
-			if (BlurTimeKeyFrameTimes) {
-				for (; part_age < BlurTimeKeyFrameTimes[bkey]; bkey--);
-				blur_time = BlurTimeKeyFrameValues[bkey] +
-					BlurTimeKeyFrameDeltas[bkey] * (float)(part_age - BlurTimeKeyFrameTimes[bkey]) +
-					RandomBlurTimeEntries[part & NumRandomBlurTimeEntriesMinus1];
+	if (tailposition) {
+		unsigned int key = NumBlurTimeKeyFrames - 1;
+		for (int range = 0; range < 2; range++) {
+			for (part = range_start[range]; part < range_end[range]; part = run_end) {
+				if (BlurTimeKeyFrameTimes) {
+					run_end = Find_Key_Run(TimeStamp, current_time, BlurTimeKeyFrameTimes, key, part, range_end[range]);
+					float value = BlurTimeKeyFrameValues[key];
+					float delta = BlurTimeKeyFrameDeltas[key];
+					unsigned int key_time = BlurTimeKeyFrameTimes[key];
+					for (; part < run_end; part++) {
+						float blur_time = value +
+							delta * (float)(current_time - TimeStamp[part] - key_time) +
+							RandomBlurTimeEntries[part & NumRandomBlurTimeEntriesMinus1];
+						tailposition[part]=position[part]-Velocity[part]*blur_time*1000;
+					}
+				} else {
+					run_end = range_end[range];
+					float blur_time = BlurTimeKeyFrameValues[0];
+					for (; part < run_end; part++) {
+						tailposition[part]=position[part]-Velocity[part]*blur_time*1000;
+					}
+				}
 			}
-			tailposition[part]=position[part]-Velocity[part]*blur_time*1000;
 		}
 	}
 }
@@ -2879,7 +3096,6 @@ void ParticleBufferClass::Update_Non_New_Particles(unsigned int elapsed)
 	// to two subranges. Find the Start - End subranges.
 	unsigned int sub1_end;		// End of subrange 1.
 	unsigned int sub2_start;	// Start of subrange 2.
-	unsigned int i;				// Loop index.
 	if ((Start < End) || ((Start == End) && NonNewNum ==0)) {
 		sub1_end = End;
 		sub2_start = End;
@@ -2890,55 +3106,32 @@ void ParticleBufferClass::Update_Non_New_Particles(unsigned int elapsed)
 
 	float fp_elapsed_time = (float)elapsed;
 
-	// Update position and velocity for all particles.
+	// position is the current frame position, prev_pos is the previous frames position (only if
+	// we have enabled pingpong position buffers). Without acceleration the ping-pong buffers
+	// are moved on from the current position like the others.
+	Vector3 *position;
+	Vector3 *prev_pos = NULL;
 	if (PingPongPosition) {
-
 		int pingpong = WW3D::Get_Frame_Count() & 0x1;
-		Vector3 *position = Position[pingpong]->Get_Array();
-		Vector3 *prev_pos = Position[pingpong ^ 0x1]->Get_Array();
-
+		position = Position[pingpong]->Get_Array();
 		if (HasAccel) {
-			Vector3 delta_v = Accel * fp_elapsed_time;
-			Vector3 accel_p = Accel * (0.5f * fp_elapsed_time * fp_elapsed_time);
-			for (i = Start; i < sub1_end; i++) {
-				position[i] = prev_pos[i] + Velocity[i] * fp_elapsed_time + accel_p;
-				Velocity[i] += delta_v;
-			}
-			for (i = sub2_start; i < End; i++) {
-				position[i] = prev_pos[i] + Velocity[i] * fp_elapsed_time + accel_p;
-				Velocity[i] += delta_v;
-			}
-		} else {
-			for (i = Start; i < sub1_end; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time;
-			}
-			for (i = sub2_start; i < End; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time;
-			}
+			prev_pos = Position[pingpong ^ 0x1]->Get_Array();
 		}
 	} else {
+		position = Position[0]->Get_Array();
+	}
 
-		Vector3 *position = Position[0]->Get_Array();
-
-		if (HasAccel) {
-			Vector3 delta_v = Accel * fp_elapsed_time;
-			Vector3 accel_p = Accel * (0.5f * fp_elapsed_time * fp_elapsed_time);
-			for (i = Start; i < sub1_end; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time + accel_p;
-				Velocity[i] += delta_v;
-			}
-			for (i = sub2_start; i < End; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time + accel_p;
-				Velocity[i] += delta_v;
-			}
-		} else {
-			for (i = Start; i < sub1_end; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time;
-			}
-			for (i = sub2_start; i < End; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time;
-			}
-		}
+	// Update position and velocity for all particles.
+	if (HasAccel) {
+		Vector3 delta_v = Accel * fp_elapsed_time;
+		Vector3 accel_p = Accel * (0.5f * fp_elapsed_time * fp_elapsed_time);
+		Advance_Particles(	position + Start, prev_pos ? prev_pos + Start : NULL, Velocity + Start,
+									sub1_end - Start, fp_elapsed_time, &accel_p, &delta_v	);
+		Advance_Particles(	position + sub2_start, prev_pos ? prev_pos + sub2_start : NULL, Velocity + sub2_start,
+									End - sub2_start, fp_elapsed_time, &accel_p, &delta_v	);
+	} else {
+		Advance_Particles(position + Start, NULL, Velocity + Start, sub1_end - Start, fp_elapsed_time, NULL, NULL);
+		Advance_Particles(position + sub2_start, NULL, Velocity + sub2_start, End - sub2_start, fp_elapsed_time, NULL, NULL);
 	}
 }
 
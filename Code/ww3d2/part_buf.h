@@ -174,6 +174,16 @@ class ParticleBufferClass : public RenderObjClass
 		// buffer - it is done this way to avoid needless copying.
 		NewParticleStruct * Add_Uninitialized_New_Particle(void);
 
+		// Bring the particles up to the current sync time without drawing them, along with
+		// their visual state if update_visual is set. Only the buffer itself is touched, so
+		// different buffers can be updated on different threads at once (see
+		// ParticleBatchClass). Render() won't redo work that has been done here.
+		void Update_State(bool update_visual);
+
+		// Was the buffer drawn on the last frame? Used to guess which buffers are going to
+		// need their visual state this frame.
+		bool Was_Rendered_Last_Frame(void) const;
+
 		//	Change the acceleration of the particles on the fly
 		void Set_Acceleration (const Vector3 &acceleration)	{ Accel = acceleration;  HasAccel = ((Accel.X != 0) || (Accel.Y != 0) || (Accel.Z != 0)); }
 
@@ -308,6 +318,13 @@ class ParticleBufferClass : public RenderObjClass
 		AABoxClass		BoundingBox;
 		bool				BoundingBoxDirty;
 
+		// The visual state only has to be worked out once for a given sync time and frame,
+		// unless the keyframes change underneath it.
+		unsigned int	VisualStateTime;
+		unsigned int	VisualStateFrame;
+		bool				VisualStateDirty;
+		unsigned int	LastRenderFrame;	// Frame count the buffer was last drawn on.
+
 		// At least one keyframe must exist for each property (time 0).
 		// If a randomizer is zero and there are no additional keyframes for
 		// that property (or the keyframes are all equal), all the arrays for
@@ -0,0 +1,66 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "partbatch.h"
+#include "part_buf.h"
+#include "jobsystem.h"
+#include "wwdebug.h"
+#include "wwprofile.h"
+
+
+/*
+** ParticleBatchClass
+*/
+ParticleBatchClass::ParticleBatchClass(void) :
+	Jobs(&JobSystemClass::Get_Shared())
+{
+}
+
+ParticleBatchClass::~ParticleBatchClass(void)
+{
+}
+
+void ParticleBatchClass::Set_Job_System(JobSystemClass * jobs)
+{
+	WWASSERT(jobs != NULL);
+	Jobs = jobs;
+}
+
+void ParticleBatchClass::Add(ParticleBufferClass * buffer,bool update_visual)
+{
+	WWASSERT(buffer != NULL);
+
+	UpdateStruct update;
+	update.Buffer = buffer;
+	update.UpdateVisual = update_visual;
+	Updates.Add(update);
+}
+
+void ParticleBatchClass::Update(void)
+{
+	WWPROFILE("Particle Batch");
+
+	Jobs->Parallel_For(Updates.Count(),BUFFERS_PER_JOB,
+		[this](int first,int last) {
+			for (int i=first; i<last; i++) {
+				Updates[i].Buffer->Update_State(Updates[i].UpdateVisual);
+			}
+		},
+		"Particle Update");
+	Updates.Reset_Active();
+}
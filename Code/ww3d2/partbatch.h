@@ -0,0 +1,83 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "always.h"
+#include "vector.h"
+
+class ParticleBufferClass;
+class JobSystemClass;
+
+
+/**
+** ParticleBatchClass
+** Brings a list of particle buffers up to the current sync time, spreading them over the
+** threads of the job system.  Each buffer is updated exactly as it would be when it is next
+** culled or rendered on the calling thread (see ParticleBufferClass::Update_State), so the
+** results don't depend on the thread count.
+**
+** The buffers share nothing while they are updated, but their emitters must have been
+** given their Emit() call for the frame before Update() is called.
+*/
+class ParticleBatchClass
+{
+public:
+
+	enum
+	{
+		BUFFERS_PER_JOB = 2,
+	};
+
+	ParticleBatchClass(void);
+	~ParticleBatchClass(void);
+
+	/*
+	** Job system to update the buffers on, JobSystemClass::Get_Shared by default.
+	*/
+	void				Set_Job_System(JobSystemClass * jobs);
+	JobSystemClass *	Get_Job_System(void) const		{ return Jobs; }
+
+	/*
+	** Queue up buffers to update.  The visual state (colors, sizes, frames and so on) is
+	** only worth working out for buffers that are going to be drawn.  Nothing happens
+	** until Update() is called.
+	*/
+	void				Add(ParticleBufferClass * buffer,bool update_visual);
+
+	int				Get_Count(void) const				{ return Updates.Count(); }
+	void				Reset(void)								{ Updates.Reset_Active(); }
+
+	/*
+	** Update every queued buffer and empty the queue.
+	*/
+	void				Update(void);
+
+private:
+
+	struct UpdateStruct
+	{
+		bool operator== (const UpdateStruct &)	{ return false; }
+		bool operator!= (const UpdateStruct &)	{ return true; }
+
+		ParticleBufferClass *	Buffer;
+		bool							UpdateVisual;
+	};
+
+	JobSystemClass *							Jobs;
+	DynamicVectorClass<UpdateStruct>		Updates;
+};
@@ -35,35 +35,43 @@
  *   PredictiveLODOptimizerClass::Clear -- clear object list and total cost*
  *   PredictiveLODOptimizerClass::Add_Object -- adds object to list, cost  *
  *   PredictiveLODOptimizerClass::Optimize_LODs -- does LOD optimization   *
+ *   PredictiveLODOptimizerClass::Update_Context -- updates kept queues    *
+ *   PredictiveLODOptimizerClass::Enable_Incremental -- keep queues or not *
  *   PredictiveLODOptimizerClass::Free -- releases all memory used.        *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #include "predlod.h"
 #include <memory.h>
+#include <math.h>
+#include <chrono>
+#include <unordered_map>
 
 /* NOTE: The LODHeapNode and LODHeap classes are defined here for use in the
  * Optimize_LODs() member function. */
 
 // A node entry for a heap. It has no son/father pointers since it will be
-// used in an array implementation of a heap.
+// used in an array implementation of a heap. The slot identifies the item
+// within the heap's position array.
 
 /*
 **	NOTE: LODHeapNodes contain pointers to RenderObjClass, but these pointers
 ** are NOT tracked via refcounting. This is because the heaps are created and
 ** destroyed within one function, so all references created are necessary;
 ** and performing Add_Ref and Release_Ref every time a pointer is copied
-** would hurt performance.
+** would hurt performance. (The incremental contexts, whose heaps outlive the
+** function, hold one reference per object in their slots instead.)
 */
 
 class LODHeapNode {
 	public:
-		LODHeapNode(void)												{ Item = NULL; }
-		LODHeapNode (float key)										{ Item = NULL; Key = key; }
-		LODHeapNode (RenderObjClass * item, float key)		{ Item = item; Key = key; }
+		LODHeapNode(void)												{ Item = NULL; Slot = 0; }
+		LODHeapNode (float key)										{ Item = NULL; Key = key; Slot = 0; }
+		LODHeapNode (RenderObjClass * item, float key, int slot)	{ Item = item; Key = key; Slot = slot; }
 
 		~LODHeapNode(void)											{ }
 
 		RenderObjClass *	Get_Item(void)							{ return(Item); }
+		int					Get_Slot(void)							{ return(Slot); }
 
 		float						Get_Key(void)						{ return(Key); }
 		void						Set_Key(float key)				{ Key = key; }
@@ -78,27 +86,39 @@ class LODHeapNode {
 	private:
 		RenderObjClass *Item;
 		float Key;
+		int Slot;
 };
 
-// A Heap implemented as a complete binary tree in an array.
+// A Heap implemented as a complete binary tree in an array. Positions[slot]
+// always holds the index of the node with that slot, so the key of any item
+// can be changed without searching the heap for it.
 class LODHeap {
 	public:
-		// This constructor receives an array of HeapNodes and arranges it to
-		// fulfil the heap condition. Note: the array will be used inside the
-		// heap, so it should never be used or deleted outside. The resulting
-		// heap is full - no nodes can be added until some are removed.
-		LODHeap(int count, LODHeapNode *NodeArray) {
+		// This constructor receives an array of HeapNodes and an array of
+		// positions indexed by their slots. If build is set it arranges the
+		// nodes to fulfil the heap condition, otherwise they must already be
+		// a heap (built by an earlier LODHeap). Note: the arrays will be used
+		// inside the heap but are not owned by it. Nodes can only be inserted
+		// if the node array has room for them.
+		LODHeap(int count, LODHeapNode *NodeArray, int *PositionArray, bool build) {
 			Nodes = NodeArray;
-			Num = Max = count;
-			// Now build a heap from the array by working backwards, building
-			// subheaps from the bottom up. (starting at the middle of the array
-			// since the single-node subtrees at the leaves are already heaps)
-			int index;
-			for (index = Num/2; index >= 1; index--) Downheap(index);
+			Positions = PositionArray;
+			Num = count;
+			if (build) {
+				int index;
+				for (index = 1; index <= Num; index++) Positions[Nodes[index].Get_Slot()] = index;
+				// Now build a heap from the array by working backwards, building
+				// subheaps from the bottom up. (starting at the middle of the array
+				// since the single-node subtrees at the leaves are already heaps)
+				for (index = Num/2; index >= 1; index--) Downheap(index);
+			}
 		}
 
 		~LODHeap(void) {
-//			delete []Nodes;
+		}
+
+		int Count(void) {
+			return Num;
 		}
 
 		LODHeapNode	*Top(void) {
@@ -112,30 +132,48 @@ class LODHeap {
 			Downheap(1);
 		}
 
-		// This searches for an entry which has a certain Item value, and
-		// changes its key to a new one. The heap is then adjusted accordingly.
-		void Change_Key(RenderObjClass *item, float new_key) {
-			for (int i=1; i <= Num; i++) {
-				if (Nodes[i].Get_Item() == item) {
-					float old_key = Nodes[i].Get_Key();
-					Nodes[i].Set_Key(new_key);
-					// If the key has been decreased, adjust the node downwards.
-					// Otherwise, adjust it upwards.
-					if (new_key < old_key) Downheap(i);
-					else Upheap(i);
-					break;
-				}
+		// This changes the key of the entry with the given slot to a new one.
+		// The heap is then adjusted accordingly.
+		void Change_Key(int slot, float new_key) {
+			int i = Positions[slot];
+			float old_key = Nodes[i].Get_Key();
+			Nodes[i].Set_Key(new_key);
+			// If the key has been decreased, adjust the node downwards.
+			// Otherwise, adjust it upwards.
+			if (new_key < old_key) Downheap(i);
+			else Upheap(i);
+		}
+
+		// Adds a node at the bottom of the heap and moves it up into place.
+		void Insert(const LODHeapNode & node) {
+			Num++;
+			Nodes[Num] = node;
+			Upheap(Num);
+		}
+
+		// Removes the entry with the given slot, filling its place with the
+		// last node of the heap.
+		void Remove(int slot) {
+			int i = Positions[slot];
+			Positions[slot] = 0;
+			if (i == Num) {
+				Num--;
+				return;
 			}
+			float old_key = Nodes[i].Get_Key();
+			Nodes[i] = Nodes[Num];
+			Num--;
+			if (Nodes[i].Get_Key() < old_key) Downheap(i);
+			else Upheap(i);
 		}
 
 	private:
 		LODHeap(void) {}	// Just to ensure the default constructor is not used.
 
-		// The node and key arrays have one extra entry because entry [0] is
-		// reserved for various uses.
-		LODHeapNode *		Nodes;	// The nodes
+		// The node array has one extra entry because entry [0] is not used.
+		LODHeapNode *		Nodes;		// The nodes
+		int *					Positions;	// index of the node of each slot
 
-		int					Max;		// The maximum number of nodes
 		int					Num;		// the current number of nodes
 
 		// Two utility methods used by various other methods: both take a
@@ -145,15 +183,15 @@ class LODHeap {
 		// Upheap takes an entry with a (possibly) overlarge key and moves it
 		// up until the heap condition is satisfied. (this is a private
 		// method, so no error checking is needed).
-		// Note that Upheap puts a sentinel in Nodes[0].
 		void Upheap(int index) {
 			LODHeapNode node = Nodes[index];
-			Nodes[0].Set_Key(FLT_MAX);
-			while (Nodes[index/2] <= node) {
+			while ((index > 1) && (Nodes[index/2] <= node)) {
 				Nodes[index] = Nodes[index/2];
+				Positions[Nodes[index].Get_Slot()] = index;
 				index = index/2;
 			}
 			Nodes[index] = node;
+			Positions[node.Get_Slot()] = index;
 		}
 
 		// Downheap takes an entry with a (possibly) oversmall key and moves it
@@ -166,20 +204,102 @@ class LODHeap {
 				if ((child_index < Num) && (Nodes[child_index] < Nodes[child_index+1])) child_index++;
 				if (node >= Nodes[child_index]) break;
 				Nodes[index] = Nodes[child_index];
+				Positions[Nodes[index].Get_Slot()] = index;
 				index = child_index;
 			}
 			Nodes[index] = node;
+			Positions[node.Get_Slot()] = index;
+		}
+};
+
+// The priority queues of one incremental context, kept between calls to
+// Optimize_LODs. Every object in the queues has a slot which holds a
+// reference to it and the screen area and lod level its keys were last set
+// for.
+struct LODSlotStruct {
+	RenderObjClass *	Item;
+	float					Area;
+	int					LODLevel;
+	unsigned				Stamp;		// last call the object was added for
+};
+
+class LODContextClass {
+	public:
+		LODContextClass(void) :
+			Nodes1(NULL), Nodes2(NULL), Positions1(NULL), Positions2(NULL), Slots(NULL),
+			FreeSlots(NULL), Capacity(0), SlotCount(0), FreeCount(0), Count(0), Stamp(0)		{ }
+		~LODContextClass(void)								{ Reset(); }
+
+		// Releases every object and all memory.
+		void Reset(void) {
+			for (int i = 0; i < SlotCount; i++) {
+				if (Slots[i].Item) Slots[i].Item->Release_Ref();
+			}
+			delete [] Nodes1;
+			delete [] Nodes2;
+			delete [] Positions1;
+			delete [] Positions2;
+			delete [] Slots;
+			delete [] FreeSlots;
+			Nodes1 = Nodes2 = NULL;
+			Positions1 = Positions2 = FreeSlots = NULL;
+			Slots = NULL;
+			Capacity = SlotCount = FreeCount = Count = 0;
+			SlotMap.clear();
+		}
+
+		// Makes room for the given number of slots.
+		void Reserve(int slots) {
+			if (slots <= Capacity) return;
+			int new_capacity = MAX(slots, MAX(2 * Capacity, 64));
+			Grow(Nodes1, Capacity + 1, new_capacity + 1);
+			Grow(Nodes2, Capacity + 1, new_capacity + 1);
+			Grow(Positions1, Capacity, new_capacity);
+			Grow(Positions2, Capacity, new_capacity);
+			Grow(Slots, Capacity, new_capacity);
+			Grow(FreeSlots, Capacity, new_capacity);
+			Capacity = new_capacity;
+		}
+
+		LODHeapNode *		Nodes1;			// min current value queue
+		LODHeapNode *		Nodes2;			// max post increment value queue
+		int *					Positions1;
+		int *					Positions2;
+		LODSlotStruct *	Slots;
+		int *					FreeSlots;
+		int					Capacity;		// slots allocated
+		int					SlotCount;		// slots used so far, some may be free
+		int					FreeCount;
+		int					Count;			// nodes in each queue
+		unsigned				Stamp;
+		std::unordered_map<RenderObjClass *,int>	SlotMap;
+
+	private:
+		template <class T> static void Grow(T * & array, int old_size, int new_size) {
+			T * new_array = new T[new_size];
+			if (array) {
+				for (int i = 0; i < old_size; i++) new_array[i] = array[i];
+				delete [] array;
+			}
+			array = new_array;
 		}
 };
 
+static LODContextClass _Contexts[PredictiveLODOptimizerClass::MAX_CONTEXTS];
+
 // Static PredictiveLODOptimizerClass data members:
 RenderObjClass **	PredictiveLODOptimizerClass::ObjectArray = NULL;
+float *				PredictiveLODOptimizerClass::AreaArray = NULL;
 int					PredictiveLODOptimizerClass::ArraySize = 0;
 int					PredictiveLODOptimizerClass::NumObjects = 0;
 float					PredictiveLODOptimizerClass::TotalCost = 0.0f;
 LODHeapNode *		PredictiveLODOptimizerClass::VisibleObjArray1;
 LODHeapNode	*		PredictiveLODOptimizerClass::VisibleObjArray2;
+int *					PredictiveLODOptimizerClass::VisibleObjPositions;
 int					PredictiveLODOptimizerClass::VisibleObjArraySize;
+bool					PredictiveLODOptimizerClass::Incremental = false;
+float					PredictiveLODOptimizerClass::AreaThreshold = 0.02f;
+PredictiveLODOptimizerClass::StatsStruct	PredictiveLODOptimizerClass::Stats[MAX_CONTEXTS];
 
 
 /**************************************************************************
@@ -223,7 +343,7 @@ void PredictiveLODOptimizerClass::Clear(void)
  * HISTORY:                                                               *
  *   03/12/1999 NH  : Created.                                            *
  *========================================================================*/
-void PredictiveLODOptimizerClass::Add_Object(RenderObjClass *robj)
+void PredictiveLODOptimizerClass::Add_Object(RenderObjClass *robj, float screen_area)
 {
 	// If array present but too small, free it and copy it to new array.
 	if (ObjectArray) {
@@ -233,16 +353,23 @@ void PredictiveLODOptimizerClass::Add_Object(RenderObjClass *robj)
 			memcpy(new_array, ObjectArray, sizeof(RenderObjClass *) * NumObjects);
 			delete [] ObjectArray;
 			ObjectArray = new_array;
+			float *new_area_array = new float[new_array_size];
+			memcpy(new_area_array, AreaArray, sizeof(float) * NumObjects);
+			delete [] AreaArray;
+			AreaArray = new_area_array;
 			ArraySize = new_array_size;
 		}
 	} else {
 		// Create new object array.
 		ObjectArray = new RenderObjClass *[100];
+		AreaArray = new float[100];
+		ArraySize = 100;
 	}
 
 	// Copy pointer and add ref
 	ObjectArray[NumObjects] = robj;
 	ObjectArray[NumObjects]->Add_Ref();
+	AreaArray[NumObjects] = screen_area;
 	NumObjects++;
 
 	float cost = robj->Get_Cost();
@@ -257,6 +384,7 @@ void PredictiveLODOptimizerClass::Add_Object(RenderObjClass *robj)
  * PredictiveLODOptimizerClass::Optimize_LODs -- does LOD optimization    *
  *                                                                        *
  * INPUT:	float max_cost - the upper bound on the total scene Cost.     *
+ *          int context - incremental context the objects belong to.      *
  *                                                                        *
  * OUTPUT:	none.                                                         *
  *                                                                        *
@@ -274,30 +402,55 @@ void PredictiveLODOptimizerClass::Add_Object(RenderObjClass *robj)
  *   SIGGRAPH '93 Proceedings, pp. 247-253.                               *
  *   Modifications have been made to support screensize clamping of LODs. *
  *========================================================================*/
-void PredictiveLODOptimizerClass::Optimize_LODs(float max_cost)
+void PredictiveLODOptimizerClass::Optimize_LODs(float max_cost, int context)
 {
-	if (!ObjectArray || NumObjects == 0) return;
-
-	AllocVisibleObjArrays(NumObjects);
+	WWASSERT((context >= 0) && (context < MAX_CONTEXTS));
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	StatsStruct & stats = Stats[context];
+	memset(&stats, 0, sizeof(stats));
+
+	LODHeapNode *nodes1, *nodes2;
+	int *positions1, *positions2;
+	int count;
+	LODSlotStruct *slots = NULL;		// incremental slots, whose lod levels are kept up to date
+
+	if (Incremental) {
+		// Bring the queues kept from the last call up to date with this set of objects.
+		Update_Context(context);
+		LODContextClass & ctx = _Contexts[context];
+		nodes1 = ctx.Nodes1;
+		nodes2 = ctx.Nodes2;
+		positions1 = ctx.Positions1;
+		positions2 = ctx.Positions2;
+		count = ctx.Count;
+		slots = ctx.Slots;
+	} else {
+		if (!ObjectArray || NumObjects == 0) return;
 
-	// Allocate and fill arrays. (one extra entry since the zeroth entry is not used).
-//	LODHeapNode *visible_obj_array1 = new LODHeapNode[NumObjects + 1];
-//	LODHeapNode *visible_obj_array2 = new LODHeapNode[NumObjects + 1];
+		AllocVisibleObjArrays(NumObjects);
 
-	// Insert objects into arrays: (0th entry reserved for sentinel values)
-	for (int i = 0; i < NumObjects; i++) {
-		RenderObjClass *robj = ObjectArray[i];
-		// We use minus Value for the first queue to make it ordered by minimum Value.
-		VisibleObjArray1[i + 1] = LODHeapNode(robj, -(robj->Get_Value()));
-		VisibleObjArray2[i + 1] = LODHeapNode(robj, robj->Get_Post_Increment_Value());
+		// Insert objects into arrays: (0th entry is not used)
+		for (int i = 0; i < NumObjects; i++) {
+			RenderObjClass *robj = ObjectArray[i];
+			// We use minus Value for the first queue to make it ordered by minimum Value.
+			VisibleObjArray1[i + 1] = LODHeapNode(robj, -(robj->Get_Value()), i);
+			VisibleObjArray2[i + 1] = LODHeapNode(robj, robj->Get_Post_Increment_Value(), i);
+		}
+		nodes1 = VisibleObjArray1;
+		nodes2 = VisibleObjArray2;
+		positions1 = VisibleObjPositions;
+		positions2 = VisibleObjPositions + NumObjects;
+		count = NumObjects;
+		stats.Added = NumObjects;
+		stats.Updated = NumObjects;
 	}
+	stats.ObjectCount = count;
+	if (count == 0) return;
 
-	// Build priority queues:
-	LODHeap min_current_value_queue(NumObjects, VisibleObjArray1);
-	LODHeap max_post_increment_value_queue(NumObjects, VisibleObjArray2);
-	// These memory areas now are pointed to within the heaps:
-//	visible_obj_array1 = NULL;
-//	visible_obj_array2 = NULL;
+	// Build priority queues (the incremental ones already are):
+	LODHeap min_current_value_queue(count, nodes1, positions1, !Incremental);
+	LODHeap max_post_increment_value_queue(count, nodes2, positions2, !Incremental);
 
 	// Main loop: iteratively increment/decrement tuples.
 	bool done = false;
@@ -319,15 +472,18 @@ void PredictiveLODOptimizerClass::Optimize_LODs(float max_cost)
 
 			// Get (incrementable) tuple with maximum next value.
 		 	max_data = max_post_increment_value_queue.Top()->Get_Item();
+			int slot = max_post_increment_value_queue.Top()->Get_Slot();
 
 			// Increment tuple (and update TotalCost accordingly).
 			TotalCost -= max_data->Get_Cost();
 			max_data->Increment_LOD();
 			TotalCost += max_data->Get_Cost();
+			stats.LODChanges++;
+			if (slots) slots[slot].LODLevel = max_data->Get_LOD_Level();
 
 			// Update priority queues with incremented tuple.
 			max_post_increment_value_queue.Change_Key_Top(max_data->Get_Post_Increment_Value());
-			min_current_value_queue.Change_Key(max_data, -(max_data->Get_Value()));
+			min_current_value_queue.Change_Key(slot, -(max_data->Get_Value()));
 		}
 
 		// Decrement decerementable tuples with minimum current value.
@@ -342,15 +498,18 @@ void PredictiveLODOptimizerClass::Optimize_LODs(float max_cost)
 
 			// Get (decrementable) tuple with minimum current value.
 		 	min_data = min_current_value_queue.Top()->Get_Item();
+			int slot = min_current_value_queue.Top()->Get_Slot();
 
 			// Decrement tuple (and update TotalCost accordingly).
 			TotalCost -= min_data->Get_Cost();
 			min_data->Decrement_LOD();
 			TotalCost += min_data->Get_Cost();
+			stats.LODChanges++;
+			if (slots) slots[slot].LODLevel = min_data->Get_LOD_Level();
 
 			// Update priority queues with incremented tuple.
 			min_current_value_queue.Change_Key_Top(-(min_data->Get_Value()));
-			max_post_increment_value_queue.Change_Key(min_data, min_data->Get_Post_Increment_Value());
+			max_post_increment_value_queue.Change_Key(slot, min_data->Get_Post_Increment_Value());
 
 			// Check termination criterion (same tuple incremented and decremented).
 			if (max_data == min_data) {
@@ -362,6 +521,122 @@ void PredictiveLODOptimizerClass::Optimize_LODs(float max_cost)
 
 	// Clear optimizer:
 	Clear();
+
+	stats.Milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/**************************************************************************
+ * PredictiveLODOptimizerClass::Update_Context -- updates kept queues     *
+ *                                                                        *
+ * INPUT:	int context - the incremental context to update.              *
+ *                                                                        *
+ * OUTPUT:	none.                                                         *
+ *                                                                        *
+ * WARNINGS:                                                              *
+ *                                                                        *
+ * COMMENTS:                                                              *
+ *   Objects new to the context are inserted into the queues, objects     *
+ *   whose screen area changed by more than the area threshold (or whose  *
+ *   area is not known) or whose lod level or lowest lod changed get      *
+ *   their keys updated, and objects which were not added this time are   *
+ *   removed and released.                                                *
+ *========================================================================*/
+void PredictiveLODOptimizerClass::Update_Context(int context)
+{
+	LODContextClass & ctx = _Contexts[context];
+	StatsStruct & stats = Stats[context];
+
+	ctx.Stamp++;
+	ctx.Reserve(ctx.SlotCount + NumObjects);
+
+	LODHeap min_current_value_queue(ctx.Count, ctx.Nodes1, ctx.Positions1, false);
+	LODHeap max_post_increment_value_queue(ctx.Count, ctx.Nodes2, ctx.Positions2, false);
+
+	for (int i = 0; i < NumObjects; i++) {
+		RenderObjClass *robj = ObjectArray[i];
+		float area = AreaArray[i];
+
+		std::unordered_map<RenderObjClass *,int>::iterator it = ctx.SlotMap.find(robj);
+		if (it == ctx.SlotMap.end()) {
+			int slot = (ctx.FreeCount > 0) ? ctx.FreeSlots[--ctx.FreeCount] : ctx.SlotCount++;
+			LODSlotStruct & rec = ctx.Slots[slot];
+			rec.Item = robj;
+			rec.Item->Add_Ref();
+			rec.Area = area;
+			rec.LODLevel = robj->Get_LOD_Level();
+			rec.Stamp = ctx.Stamp;
+			ctx.SlotMap[robj] = slot;
+
+			min_current_value_queue.Insert(LODHeapNode(robj, -(robj->Get_Value()), slot));
+			max_post_increment_value_queue.Insert(LODHeapNode(robj, robj->Get_Post_Increment_Value(), slot));
+			stats.Added++;
+			continue;
+		}
+
+		int slot = it->second;
+		LODSlotStruct & rec = ctx.Slots[slot];
+		if (rec.Stamp == ctx.Stamp) continue;	// added more than once
+		rec.Stamp = ctx.Stamp;
+
+		// Objects can change their own lod level between calls (HLodClass::Prepare_LOD
+		// raises it to the lowest one allowed at their screen size), and an area change
+		// under the threshold can still move that lowest lod. Either way the keys are
+		// stale whatever the area, and could let the optimizer take the object below it.
+		int lod = robj->Get_LOD_Level();
+		float value = robj->Get_Value();
+		bool at_min_lod = (value == RenderObjClass::AT_MIN_LOD);
+		bool keyed_at_min_lod = (ctx.Nodes1[ctx.Positions1[slot]].Get_Key() == -RenderObjClass::AT_MIN_LOD);
+		if (	(lod != rec.LODLevel) || (at_min_lod != keyed_at_min_lod) ||
+				(area < 0.0f) || (rec.Area < 0.0f) || (fabs(area - rec.Area) > AreaThreshold * rec.Area))
+		{
+			rec.Area = area;
+			rec.LODLevel = lod;
+			min_current_value_queue.Change_Key(slot, -value);
+			max_post_increment_value_queue.Change_Key(slot, robj->Get_Post_Increment_Value());
+			stats.Updated++;
+		}
+	}
+
+	// Drop the objects which weren't added this time.
+	for (int slot = 0; slot < ctx.SlotCount; slot++) {
+		LODSlotStruct & rec = ctx.Slots[slot];
+		if (rec.Item && rec.Stamp != ctx.Stamp) {
+			min_current_value_queue.Remove(slot);
+			max_post_increment_value_queue.Remove(slot);
+			ctx.SlotMap.erase(rec.Item);
+			rec.Item->Release_Ref();
+			rec.Item = NULL;
+			ctx.FreeSlots[ctx.FreeCount++] = slot;
+			stats.Removed++;
+		}
+	}
+
+	ctx.Count = min_current_value_queue.Count();
+}
+
+
+/**************************************************************************
+ * PredictiveLODOptimizerClass::Enable_Incremental -- keep queues or not  *
+ *                                                                        *
+ * INPUT:	bool onoff - true to keep the queues between calls.           *
+ *                                                                        *
+ * OUTPUT:	none.                                                         *
+ *                                                                        *
+ * WARNINGS:                                                              *
+ *                                                                        *
+ *========================================================================*/
+void PredictiveLODOptimizerClass::Enable_Incremental(bool onoff)
+{
+	if (!onoff) Free_Contexts();
+	Incremental = onoff;
+}
+
+
+const PredictiveLODOptimizerClass::StatsStruct & PredictiveLODOptimizerClass::Get_Statistics(int context)
+{
+	WWASSERT((context >= 0) && (context < MAX_CONTEXTS));
+	return Stats[context];
 }
 
 
@@ -384,6 +659,8 @@ void PredictiveLODOptimizerClass::Free(void)
 	if (ObjectArray) {
 		delete [] ObjectArray;
 		ObjectArray = NULL;
+		delete [] AreaArray;
+		AreaArray = NULL;
 		ArraySize = 0;
 	}
 
@@ -391,7 +668,18 @@ void PredictiveLODOptimizerClass::Free(void)
 	if (VisibleObjArray1) delete[] VisibleObjArray1;
 	VisibleObjArray1=NULL;
 	VisibleObjArray2=NULL;
+	if (VisibleObjPositions) delete[] VisibleObjPositions;
+	VisibleObjPositions=NULL;
 	VisibleObjArraySize = 0;
+
+	Free_Contexts();
+}
+
+void PredictiveLODOptimizerClass::Free_Contexts(void)
+{
+	for (int i = 0; i < MAX_CONTEXTS; i++) {
+		_Contexts[i].Reset();
+	}
 }
 
 void PredictiveLODOptimizerClass::AllocVisibleObjArrays(int num_objects)
@@ -401,6 +689,8 @@ void PredictiveLODOptimizerClass::AllocVisibleObjArrays(int num_objects)
 		if (VisibleObjArray1) delete[] VisibleObjArray1;	// Only the first array is actually allocated
 		VisibleObjArray1=new LODHeapNode[2*(num_objects + 1)];
 		VisibleObjArray2=VisibleObjArray1+(num_objects + 1);
+		if (VisibleObjPositions) delete[] VisibleObjPositions;
+		VisibleObjPositions=new int[2*num_objects];
 	}
 }
 
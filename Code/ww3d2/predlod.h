@@ -57,30 +57,72 @@ class LODHeapNode;
 /*
 ** PredictiveLODOptimizerClass: Class which performs the predictive LOD
 ** optimization. All the members of this class are static.
+**
+** Normally the priority queues are built from scratch on every call to
+** Optimize_LODs. In incremental mode they are kept from one call to the next
+** instead: objects which were added last time keep their place in the queues,
+** and their keys are only updated if their screen area has changed by more
+** than the area threshold (a fraction of the area the keys were set for), or
+** their lod level or lowest allowed lod has been changed by something other
+** than the optimizer.
+** Objects which are not added again drop out of the queues. Each context
+** keeps its own queues, so callers which optimize separate sets of objects
+** every frame should give each set its own context.
 */
 class PredictiveLODOptimizerClass {
 
 	public:
 
+		enum
+		{
+			MAX_CONTEXTS = 4,
+		};
+
+		struct StatsStruct
+		{
+			int				ObjectCount;		// objects optimized
+			int				Added;				// objects which entered the queues
+			int				Removed;				// objects which dropped out of the queues
+			int				Updated;				// objects whose keys were updated
+			int				LODChanges;			// lod increments and decrements
+			float				Milliseconds;		// time spent in Optimize_LODs
+		};
+
 		static void		Clear(void);
-		static void		Add_Object(RenderObjClass *robj);
+		static void		Add_Object(RenderObjClass *robj, float screen_area = -1.0f);
 		static void		Add_Cost(float cost)								{ TotalCost += cost; }
-		static void		Optimize_LODs(float max_cost);
+		static void		Optimize_LODs(float max_cost, int context = 0);
 		static float	Get_Total_Cost(void)								{ return TotalCost; }
 		static void		Free(void);	// frees all memory
 
+		static void		Enable_Incremental(bool onoff);
+		static bool		Is_Incremental_Enabled(void)					{ return Incremental; }
+		static void		Set_Area_Threshold(float threshold)			{ AreaThreshold = threshold; }
+		static float	Get_Area_Threshold(void)						{ return AreaThreshold; }
+
+		// Statistics of the last Optimize_LODs call for the given context
+		static const StatsStruct &	Get_Statistics(int context = 0);
+
 	private:
 		static void		AllocVisibleObjArrays(int num_objects);
+		static void		Update_Context(int context);
+		static void		Free_Contexts(void);
 
 		static RenderObjClass **	ObjectArray;
+		static float *					AreaArray;		// screen area of each object, negative if unknown
 		static int						ArraySize;
 		static int						NumObjects;
 		static float					TotalCost;
 
 		static LODHeapNode *VisibleObjArray1;
 		static LODHeapNode *VisibleObjArray2;
+		static int *VisibleObjPositions;
 		static int VisibleObjArraySize;
 
+		static bool						Incremental;
+		static float					AreaThreshold;
+		static StatsStruct			Stats[MAX_CONTEXTS];
+
 };
 
 #endif
@@ -0,0 +1,157 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "radixsort.h"
+
+
+RadixSortClass::RadixSortClass(void) :
+	Capacity(0)
+{
+	Keys[0] = Keys[1] = NULL;
+	Indices[0] = Indices[1] = NULL;
+}
+
+RadixSortClass::~RadixSortClass(void)
+{
+	Release_Memory();
+}
+
+void RadixSortClass::Release_Memory(void)
+{
+	for (int i=0; i<2; i++) {
+		delete [] Keys[i];
+		delete [] Indices[i];
+		Keys[i] = NULL;
+		Indices[i] = NULL;
+	}
+	Capacity = 0;
+}
+
+void RadixSortClass::Reserve(unsigned count)
+{
+	if (count <= Capacity) {
+		return;
+	}
+
+	// Grow by half again so a slowly rising count doesn't reallocate every frame
+	Release_Memory();
+	Capacity = MAX(count,Capacity + Capacity / 2);
+	for (int i=0; i<2; i++) {
+		Keys[i] = new unsigned[Capacity];
+		Indices[i] = new unsigned[Capacity];
+	}
+}
+
+const unsigned * RadixSortClass::Sort(const float * keys,unsigned count,bool descending)
+{
+	Reserve(count);
+	unsigned flip = descending ? 0xFFFFFFFF : 0;
+	for (unsigned i=0; i<count; i++) {
+		Keys[0][i] = Float_To_Key(keys[i]) ^ flip;
+	}
+	return Sort_Keys(count);
+}
+
+const unsigned * RadixSortClass::Sort(const unsigned * keys,unsigned count)
+{
+	Reserve(count);
+	if (count > 0) {
+		memcpy(Keys[0],keys,count * sizeof(unsigned));
+	}
+	return Sort_Keys(count);
+}
+
+/*
+** Sorts the keys in Keys[0]. One read of the keys builds the histograms for every pass and
+** spots keys that are already in order, which is common for the far-to-near order the
+** polygons often arrive in.
+*/
+const unsigned * RadixSortClass::Sort_Keys(unsigned count)
+{
+	unsigned * keys = Keys[0];
+	unsigned * indices = Indices[0];
+	for (unsigned i=0; i<count; i++) {
+		indices[i] = i;
+	}
+	if (count < 2) {
+		return indices;
+	}
+
+	if (count < INSERTION_SORT_COUNT) {
+		for (unsigned i=1; i<count; i++) {
+			unsigned key = keys[i];
+			unsigned index = indices[i];
+			unsigned j = i;
+			for (; j > 0 && keys[j-1] > key; j--) {
+				keys[j] = keys[j-1];
+				indices[j] = indices[j-1];
+			}
+			keys[j] = key;
+			indices[j] = index;
+		}
+		return indices;
+	}
+
+	unsigned histograms[PASS_COUNT][RADIX_SIZE];
+	memset(histograms,0,sizeof(histograms));
+	bool sorted = true;
+	unsigned prev = keys[0];
+	for (unsigned i=0; i<count; i++) {
+		unsigned key = keys[i];
+		sorted &= (key >= prev);
+		prev = key;
+		for (int pass=0; pass<PASS_COUNT; pass++) {
+			histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+		}
+	}
+	if (sorted) {
+		return indices;
+	}
+
+	int src = 0;
+	for (int pass=0; pass<PASS_COUNT; pass++) {
+		unsigned * histogram = histograms[pass];
+		unsigned shift = pass * RADIX_BITS;
+
+		// Every key has the same digit, so this pass wouldn't move anything
+		if (histogram[(keys[0] >> shift) & (RADIX_SIZE - 1)] == count) {
+			continue;
+		}
+
+		unsigned offset = 0;
+		for (int digit=0; digit<RADIX_SIZE; digit++) {
+			unsigned digit_count = histogram[digit];
+			histogram[digit] = offset;
+			offset += digit_count;
+		}
+
+		const unsigned * src_keys = Keys[src];
+		const unsigned * src_indices = Indices[src];
+		unsigned * dst_keys = Keys[src ^ 1];
+		unsigned * dst_indices = Indices[src ^ 1];
+		for (unsigned i=0; i<count; i++) {
+			unsigned key = src_keys[i];
+			unsigned dst = histogram[(key >> shift) & (RADIX_SIZE - 1)]++;
+			dst_keys[dst] = key;
+			dst_indices[dst] = src_indices[i];
+		}
+		src ^= 1;
+	}
+
+	return Indices[src];
+}
@@ -0,0 +1,90 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "always.h"
+
+#include <string.h>
+
+
+/**
+** RadixSortClass
+** Stable LSD radix sort for the sort keys of the translucent polygon pool.  Keys are sorted
+** a byte at a time (skipping bytes that are the same in every key), so the cost is linear
+** in the key count and the passes stream through memory instead of jumping around the way
+** a comparison sort does.  Floats are mapped to unsigned keys that sort in the same order.
+**
+** Sort() hands back the indices of the keys in sorted order; equal keys keep the order
+** they were given in.  The scratch buffers are kept from one sort to the next, so a sorter
+** that lives across frames stops allocating once it has seen the largest frame.
+*/
+class RadixSortClass
+{
+public:
+
+	RadixSortClass(void);
+	~RadixSortClass(void);
+
+	/*
+	** Sort count float keys, smallest first unless descending is set.  The returned
+	** array belongs to the sorter and is good until the next call.
+	*/
+	const unsigned *		Sort(const float * keys,unsigned count,bool descending = false);
+
+	/*
+	** Sort count unsigned keys, smallest first.
+	*/
+	const unsigned *		Sort(const unsigned * keys,unsigned count);
+
+	/*
+	** Free the scratch buffers.
+	*/
+	void						Release_Memory(void);
+
+	/*
+	** Maps a float to an unsigned key that sorts in the same order: negative floats have
+	** all their bits flipped, positive ones just the sign bit.
+	*/
+	static unsigned		Float_To_Key(float value)
+	{
+		unsigned bits;
+		memcpy(&bits,&value,sizeof(bits));
+		unsigned mask = (unsigned)(-(int)(bits >> 31)) | 0x80000000;
+		return bits ^ mask;
+	}
+
+private:
+
+	enum
+	{
+		RADIX_BITS = 8,
+		RADIX_SIZE = 1 << RADIX_BITS,
+		PASS_COUNT = 32 / RADIX_BITS,
+		INSERTION_SORT_COUNT = 32,	// below this many keys an insertion sort is quicker
+	};
+
+	void						Reserve(unsigned count);
+	const unsigned *		Sort_Keys(unsigned count);
+
+	RadixSortClass(const RadixSortClass &);
+	RadixSortClass & operator = (const RadixSortClass &);
+
+	unsigned					Capacity;
+	unsigned *				Keys[2];
+	unsigned *				Indices[2];
+};
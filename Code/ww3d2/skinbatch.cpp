@@ -0,0 +1,84 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "skinbatch.h"
+#include "meshmdl.h"
+#include "jobsystem.h"
+#include "wwdebug.h"
+#include "wwprofile.h"
+
+
+/*
+** SkinBatchClass
+*/
+SkinBatchClass::SkinBatchClass(void) :
+	Jobs(&JobSystemClass::Get_Shared())
+{
+}
+
+SkinBatchClass::~SkinBatchClass(void)
+{
+}
+
+void SkinBatchClass::Set_Job_System(JobSystemClass * jobs)
+{
+	WWASSERT(jobs != NULL);
+	Jobs = jobs;
+}
+
+void SkinBatchClass::Add(MeshModelClass * model,const HTreeClass * htree,VertexFormatXYZNDUV2 * verts)
+{
+	WWASSERT(model != NULL);
+	WWASSERT(htree != NULL);
+	WWASSERT(verts != NULL);
+
+	/*
+	** Anything the model would set up on first use is done here, on the calling thread.
+	*/
+	if (!model->Has_Skin_Runs()) {
+		model->Update_Skin_Runs();
+	}
+
+	SkinStruct skin;
+	skin.Model = model;
+	skin.HTree = htree;
+	skin.Verts = verts;
+	skin.UV0 = model->Get_UV_Array_By_Index(0);
+	skin.UV1 = model->Get_UV_Array_By_Index(1);
+	skin.Diffuse = model->Get_Color_Array(0,false);
+	Skins.Add(skin);
+}
+
+void SkinBatchClass::Deform(const SkinStruct & skin)
+{
+	skin.Model->compose_deformed_vertex_buffer(skin.Verts,skin.UV0,skin.UV1,skin.Diffuse,skin.HTree);
+}
+
+void SkinBatchClass::Update(void)
+{
+	WWPROFILE("Skin Batch");
+
+	Jobs->Parallel_For(Skins.Count(),MESHES_PER_JOB,
+		[this](int first,int last) {
+			for (int i=first; i<last; i++) {
+				Deform(Skins[i]);
+			}
+		},
+		"Skin Deform");
+	Skins.Reset_Active();
+}
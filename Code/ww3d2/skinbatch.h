@@ -0,0 +1,91 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "always.h"
+#include "vector.h"
+
+class HTreeClass;
+class JobSystemClass;
+class MeshModelClass;
+class Vector2;
+struct VertexFormatXYZNDUV2;
+
+
+/**
+** SkinBatchClass
+** Deforms a list of skins into their vertex buffers, spreading them over the threads of the
+** job system.  Each skin is composed exactly as MeshModelClass::compose_deformed_vertex_buffer
+** does it on the calling thread, so the results don't depend on the thread count.
+**
+** The skins only read their models and hierarchies while they are deformed, so the trees
+** must be up to date and nothing may animate them until Update() returns.  Every skin needs
+** its own part of the destination buffer.
+*/
+class SkinBatchClass
+{
+public:
+
+	enum
+	{
+		MESHES_PER_JOB = 2,
+	};
+
+	SkinBatchClass(void);
+	~SkinBatchClass(void);
+
+	/*
+	** Job system to deform the skins on, JobSystemClass::Get_Shared by default.
+	*/
+	void				Set_Job_System(JobSystemClass * jobs);
+	JobSystemClass *	Get_Job_System(void) const		{ return Jobs; }
+
+	/*
+	** Queue up a skin model to deform by the given hierarchy into the given vertices.
+	** Nothing happens until Update() is called.
+	*/
+	void				Add(MeshModelClass * model,const HTreeClass * htree,VertexFormatXYZNDUV2 * verts);
+
+	int				Get_Count(void) const				{ return Skins.Count(); }
+	void				Reset(void)								{ Skins.Reset_Active(); }
+
+	/*
+	** Deform every queued skin and empty the queue.
+	*/
+	void				Update(void);
+
+private:
+
+	struct SkinStruct
+	{
+		bool operator== (const SkinStruct &)	{ return false; }
+		bool operator!= (const SkinStruct &)	{ return true; }
+
+		MeshModelClass *			Model;
+		const HTreeClass *		HTree;
+		VertexFormatXYZNDUV2 *	Verts;
+		const Vector2 *			UV0;
+		const Vector2 *			UV1;
+		const unsigned *			Diffuse;
+	};
+
+	void				Deform(const SkinStruct & skin);
+
+	JobSystemClass *						Jobs;
+	DynamicVectorClass<SkinStruct>	Skins;
+};
@@ -25,6 +25,9 @@
 #include <d3d9.h>
 #include <d3dx9math.h>
 #include "statistics.h"
+#include "radixsort.h"
+#include "rawfile.h"
+#include "wwstring.h"
 #include <wwprofile.h>
 
 bool SortingRendererClass::_EnableTriangleDraw=true;
@@ -39,147 +42,6 @@ struct ShortVectorIStruct
 	ShortVectorIStruct() {}
 };
 
-struct TempIndexStruct
-{
-	ShortVectorIStruct tri;
-	unsigned short idx;
-
-	TempIndexStruct() {}
-	TempIndexStruct(const ShortVectorIStruct& tri_, unsigned short idx_)
-		:
-		tri(tri_),
-		idx(idx_)
-	{
-	}
-};
-
-// ----------------------------------------------------------------------------
-//
-// InsertionSort (T* array, K *keys, int l, int r)
-// Performs insertion sort on array 'array' elements [l-r]. Uses values from array
-// 'keys' as sort keys.
-//
-// ----------------------------------------------------------------------------
-
-template <class T, class K>
-void InsertionSort (
-	T* array,		// array to sort
-	K* keys,			// sort keys
-	int l,			//	first item
-	int r)			//	last item
-{
-	for (int i = l+1; i < r; i++) {
-		K v=keys[i];
-		T tv=array[i];
-		int j=i;
-
-		while (keys[j-1] > v) {
-			keys[j]=keys[j-1];
-			array[j]=array[j-1];
-			j--;
-			if (j == l) break;
-		};
-		keys[j]=v;
-		array[j]=tv;
-	}
-}
-
-// ----------------------------------------------------------------------------
-//
-//	QuickSort (T* array, K* a, int l, int r)
-//
-//	Performs quicksort on array 'array'. Uses values from array 'keys' as sort keys.
-//
-// Once the length of the array to be sorted is less than 8, the routine calls
-// InsertionSort() to perform the actual sorting work.
-//
-// ----------------------------------------------------------------------------
-
-template <class T, class K>
-void QuickSort (
-	T* array,		//	array to sort
-	K* keys,			// sort keys
-	int l,			// first element
-	int r)			// last element
-{
-	if (r-l <= 8) {
-		InsertionSort(array,keys,l,r+1);
-		return;
-	}
-
-	K t;
-	K v=keys[r];
-	T ttemp;
-	int i=l-1;
-	int j=r;
-
-	do {
-		do { i++; } while (i<r && keys[i]<v);
-		do { j--; } while (j>0 && keys[j]>v);
-
-		WWASSERT(j>=0);
-		WWASSERT(i<=r);
-
-		ttemp=array[i]; array[i]=array[j]; array[j]=ttemp;
-		t=keys[i]; keys[i]=keys[j]; keys[j]=t;
-	} while (j>i);
-
-	array[j]=array[i];
-	array[i]=array[r];
-	array[r]=ttemp;
-	keys[j]=keys[i];
-	keys[i]=keys[r];
-	keys[r]=t;
-
-	if (i-1>l) QuickSort(array,keys,l,i-1);
-	if (r>i+1) QuickSort(array,keys,i+1,r);
-}
-
-// ----------------------------------------------------------------------------
-//
-// Sorts and array. Uses values from array 'keys' as sort keys.
-//
-// ----------------------------------------------------------------------------
-
-template <class T, class K>
-void Sort (
-	T* array,		// array to sort
-	K *keys,	// sort keys
-	int count)		// array element count
-{
-	bool do_insertion = false;
-
-	if (count<=1) return;									// only one element.. return..
-
-	int c=0;														// count number of rise pairs
-	int i;
-	for (i = 1; i < count; i++)
-	if (keys[i] >= keys[i-1]) c++;
-
-	if (c+1 == count) return;								// array already sorted
-	if (c<50) do_insertion=true;							// array smaller than 50 should use insertion sort
-
-	if (c<count/3) {											// if array is not rising
-		T tmp;
-		K tval;
-
-		for (i=0;i<count/2;i++) {
-			int neg = count-1-i;
-
-			tmp=array[i]; array[i]=array[neg]; array[neg]=tmp;
-			tval=keys[i]; keys[i] = keys[neg]; keys[neg]=tval;
-		}
-
-		if (!c) return;
-
-		do_insertion = true;
-	}
-	if (do_insertion) InsertionSort(array,keys,0,count);
-	else QuickSort(array,keys,0,count-1);			// quick sort
-}
-
-// ----------------------------------------------------------------------------
-
 struct SortingNodeStruct : DLNodeClass<SortingNodeStruct>
 {
 	RenderStateStruct sorting_state;
@@ -195,8 +57,15 @@ struct SortingNodeStruct : DLNodeClass<SortingNodeStruct>
 
 static DLListClass<SortingNodeStruct> sorted_list;
 static DLListClass<SortingNodeStruct> clean_list;
+static unsigned sorted_list_count;
 static unsigned total_sorting_vertices;
 
+// The nodes are sorted by view space depth when they're flushed and the polygons in the
+// pool are sorted by the depth of their vertices. The sorters keep their scratch buffers from frame to frame.
+static RadixSortClass node_sorter;
+static RadixSortClass polygon_sorter;
+static StringClass capture_filename;
+
 static SortingNodeStruct* Get_Sorting_Struct()
 {
 
@@ -225,18 +94,9 @@ static unsigned polygon_z_array_count;
 static unsigned node_id_array_count;
 static unsigned sorted_node_id_array_count;
 static unsigned polygon_index_array_count;
-TempIndexStruct* temp_index_array;
-unsigned temp_index_array_count;
-
-static TempIndexStruct* Get_Temp_Index_Array(unsigned count)
-{
-	if (count>temp_index_array_count) {
-		delete[] temp_index_array;
-		temp_index_array=new TempIndexStruct[count];
-		temp_index_array_count=count;
-	}
-	return temp_index_array;
-}
+static SortingNodeStruct** node_array;
+static float* node_z_array;
+static unsigned node_array_count;
 
 static float* Get_Vertex_Z_Array(unsigned count)
 {
@@ -268,6 +128,29 @@ static unsigned * Get_Node_Id_Array(unsigned count)
 	return node_id_array;
 }
 
+static unsigned * Get_Sorted_Node_Id_Array(unsigned count)
+{
+	if (count>sorted_node_id_array_count) {
+		delete[] sorted_node_id_array;
+		sorted_node_id_array=new unsigned[count];
+		sorted_node_id_array_count=count;
+	}
+	return sorted_node_id_array;
+}
+
+static void Get_Node_Arrays(unsigned count,SortingNodeStruct**& nodes,float*& node_z)
+{
+	if (count>node_array_count) {
+		delete[] node_array;
+		delete[] node_z_array;
+		node_array=new SortingNodeStruct*[count];
+		node_z_array=new float[count];
+		node_array_count=count;
+	}
+	nodes=node_array;
+	node_z=node_z_array;
+}
+
 static ShortVectorIStruct* Get_Polygon_Index_Array(unsigned count)
 {
 	if (count>polygon_index_array_count) {
@@ -328,18 +211,9 @@ void SortingRendererClass::Insert_Triangles(
 		&mtx);
 	state->transformed_center=Vector3(transformed_vec[0],transformed_vec[1],transformed_vec[2]);
 
-	SortingNodeStruct* node=sorted_list.Head();
-	while (node) {
-		if (state->transformed_center.Z>node->transformed_center.Z) {
-			if (sorted_list.Head()==sorted_list.Tail())
-				sorted_list.Add_Head(state);
-			else
-				state->Insert_Before(node);
-			break;
-		}
-		node=node->Succ();
-	}
-	if (!node) sorted_list.Add_Tail(state);
+	// The nodes are put in order when they are flushed
+	sorted_list.Add_Tail(state);
+	sorted_list_count++;
 
 #ifdef WWDEBUG
 	unsigned short* indices=NULL;
@@ -559,12 +433,20 @@ void SortingRendererClass::Flush_Sorting_Pool()
 		}
 	}
 
-	TempIndexStruct* tis=Get_Temp_Index_Array(overlapping_polygon_count);
-	unsigned a;
-	for (a=0;a<overlapping_polygon_count;++a) {
-		tis[a]=TempIndexStruct(polygon_idx_array[a],node_id_array_ptr[a]);
+	if (!capture_filename.Is_Empty()) {
+		RawFileClass file(capture_filename);
+		if (file.Open(RawFileClass::WRITE)) {
+			file.Write(polygon_z_array_ptr,overlapping_polygon_count*sizeof(float));
+			file.Close();
+		}
+		capture_filename="";
 	}
-	Sort<TempIndexStruct,float>(tis,polygon_z_array_ptr,overlapping_polygon_count);
+
+	// Sort the polygons by depth. The sort is stable and the polygons went in node by node,
+	// so polygons at the same depth stay in node order.
+	const unsigned* order=polygon_sorter.Sort(polygon_z_array_ptr,overlapping_polygon_count);
+	unsigned* sorted_node_id_array_ptr=Get_Sorted_Node_Id_Array(overlapping_polygon_count);
+	unsigned a;
 
 	DynamicIBAccessClass dyn_ib_access(BUFFER_TYPE_DYNAMIC_DX8,overlapping_polygon_count*3);
 	{
@@ -572,7 +454,8 @@ void SortingRendererClass::Flush_Sorting_Pool()
 		ShortVectorIStruct* sorted_polygon_index_array=(ShortVectorIStruct*)lock.Get_Index_Array();
 
 		for (a=0;a<overlapping_polygon_count;++a) {
-			sorted_polygon_index_array[a]=tis[a].tri;
+			sorted_polygon_index_array[a]=polygon_idx_array[order[a]];
+			sorted_node_id_array_ptr[a]=node_id_array_ptr[order[a]];
 		}
 	}
 
@@ -588,9 +471,9 @@ void SortingRendererClass::Flush_Sorting_Pool()
 
 	unsigned count_to_render=1;
 	unsigned start_index=0;
-	node_id=tis[0].idx;
+	node_id=sorted_node_id_array_ptr[0];
 	for (unsigned i=1;i<overlapping_polygon_count;++i) {
-		if (node_id!=tis[i].idx) {
+		if (node_id!=sorted_node_id_array_ptr[i]) {
 			SortingNodeStruct* state=overlapping_nodes[node_id];
 			Apply_Render_State(state->sorting_state);
 
@@ -602,7 +485,7 @@ void SortingRendererClass::Flush_Sorting_Pool()
 
 			count_to_render=0;
 			start_index=i;
-			node_id=tis[i].idx;
+			node_id=sorted_node_id_array_ptr[i];
 		}
 		count_to_render++;
 	}
@@ -644,8 +527,24 @@ void SortingRendererClass::Flush()
 	DX8Wrapper::Get_Transform(D3DTS_VIEW,old_view);
 	DX8Wrapper::Get_Transform(D3DTS_WORLD,old_world);
 
+	// Put the nodes in order, largest view space z first. Nodes at the same depth stay in
+	// the order they were inserted in.
+	SortingNodeStruct** nodes;
+	float* node_z;
+	Get_Node_Arrays(sorted_list_count,nodes,node_z);
+	unsigned node_count=0;
 	while (SortingNodeStruct* state=sorted_list.Head()) {
 		state->Remove();
+		WWASSERT(node_count<sorted_list_count);
+		nodes[node_count]=state;
+		node_z[node_count]=state->transformed_center.Z;
+		node_count++;
+	}
+	sorted_list_count=0;
+	const unsigned* node_order=node_sorter.Sort(node_z,node_count,true);
+
+	for (unsigned n=0;n<node_count;++n) {
+		SortingNodeStruct* state=nodes[node_order[n]];
 
 		if ((state->sorting_state.index_buffer_type==BUFFER_TYPE_SORTING || state->sorting_state.index_buffer_type==BUFFER_TYPE_DYNAMIC_SORTING) &&
 			(state->sorting_state.vertex_buffer_type==BUFFER_TYPE_SORTING || state->sorting_state.vertex_buffer_type==BUFFER_TYPE_DYNAMIC_SORTING)) {
@@ -675,6 +574,18 @@ void SortingRendererClass::Flush()
 
 }
 
+// ----------------------------------------------------------------------------
+//
+// Write the depth keys of the next flush of the polygon pool to a file, as raw floats,
+// for the sort benchmark (see Tools/SortBench).
+//
+// ----------------------------------------------------------------------------
+
+void SortingRendererClass::Capture_Sort_Keys(const char* filename)
+{
+	capture_filename=filename;
+}
+
 // ----------------------------------------------------------------------------
 
 void SortingRendererClass::Deinit()
@@ -712,8 +623,14 @@ void SortingRendererClass::Deinit()
 	delete[] polygon_index_array;
 	polygon_index_array=NULL;
 	polygon_index_array_count=0;
-	delete[] temp_index_array;
-	temp_index_array=NULL;
-	temp_index_array_count=0;
+	delete[] node_array;
+	node_array=NULL;
+	delete[] node_z_array;
+	node_z_array=NULL;
+	node_array_count=0;
+	sorted_list_count=0;
+
+	node_sorter.Release_Memory();
+	polygon_sorter.Release_Memory();
 }
 
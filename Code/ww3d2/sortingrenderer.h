@@ -52,6 +52,8 @@ public:
 	static void Flush();
 	static void Deinit();
 
+	static void Capture_Sort_Keys(const char* filename);
+
 	static void _Enable_Triangle_Draw(bool enable) { _EnableTriangleDraw=enable; }
 	static bool _Is_Triangle_Draw_Enabled() { return _EnableTriangleDraw; }
 };
@@ -19,6 +19,7 @@
 #include "stripoptimizer.h"
 #include "hashtemplate.h"
 #include "wwdebug.h"
+#include "vector3.h"
 
 template <class T> inline void swap (T& a, T& b)
 {
@@ -301,6 +302,345 @@ void StripOptimizerClass::Optimize_Triangle_Order (int *tris, int triangle_count
 
 }
 
+/*****************************************************************************
+ *
+ * Function:		StripOptimizerClass::Optimize_Vertex_Cache()
+ *
+ * Description:		Reorders an indexed triangle list for the post-transform
+ *					vertex cache. This is Tipsify (Sander, Nehab, Barczak:
+ *					"Fast Triangle Reordering for Vertex Locality and Reduced
+ *					Overdraw"): fan around a vertex, emitting all of its
+ *					remaining triangles, then move on to the vertex of that
+ *					fan that is still in the cache and has the most left to
+ *					do. When none qualifies, back up through the vertices
+ *					emitted recently and finally walk the vertex list.
+ *					Runs in linear time.
+ *
+ *					A new cluster starts each time the next fanning vertex is
+ *					no longer in the cache; reordering whole clusters costs
+ *					next to nothing in cache misses (see Optimize_Overdraw).
+ *
+ * Parameters:		tris			- triangle_count*3 indices, reordered in place
+ *					vertex_count	- one more than the largest index
+ *					cache_size		- FIFO entries to optimize for
+ *					cluster_starts	- optional, receives the first triangle of each cluster
+ *
+ *****************************************************************************/
+
+int StripOptimizerClass::Optimize_Vertex_Cache (int* tris, int triangle_count, int vertex_count, int cache_size, int* cluster_starts)
+{
+	if (triangle_count <= 0)
+		return 0;
+	WWASSERT(tris);
+	WWASSERT(cache_size > 0);
+
+	// vertex -> triangle adjacency, by counting sort
+	int* live		= new int[vertex_count];					// triangles left to emit for each vertex
+	int* adj_start	= new int[vertex_count+1];
+	int* adj		= new int[triangle_count*3];
+	int i;
+	for (i = 0; i < vertex_count; i++)
+		live[i] = 0;
+	for (i = 0; i < triangle_count*3; i++)
+	{
+		WWASSERT(tris[i] >= 0 && tris[i] < vertex_count);
+		live[tris[i]]++;
+	}
+	adj_start[0] = 0;
+	for (i = 0; i < vertex_count; i++)
+		adj_start[i+1] = adj_start[i] + live[i];
+	int* fill = new int[vertex_count];
+	for (i = 0; i < vertex_count; i++)
+		fill[i] = adj_start[i];
+	for (i = 0; i < triangle_count*3; i++)
+		adj[fill[tris[i]]++] = i/3;
+	delete[] fill;
+
+	int*	cache_time	= new int[vertex_count];				// time stamp the vertex entered the cache
+	bool*	emitted		= new bool[triangle_count];
+	int*	dead_end	= new int[triangle_count*3];			// vertices of emitted triangles, most recent last
+	int*	candidates	= new int[triangle_count*3];
+	int*	out			= new int[triangle_count*3];
+	for (i = 0; i < vertex_count; i++)
+		cache_time[i] = 0;
+	for (i = 0; i < triangle_count; i++)
+		emitted[i] = false;
+
+	int		time			= cache_size+1;
+	int		dead_end_count	= 0;
+	int		cursor			= 0;								// vertex list position for when the dead end stack runs out
+	int		out_count		= 0;
+	int		cluster_count	= 0;
+	int		fan				= -1;
+	while (fan < 0 && cursor < vertex_count)
+	{
+		if (live[cursor] > 0)
+			fan = cursor;
+		cursor++;
+	}
+
+	while (fan >= 0)
+	{
+		// a fanning vertex that fell out of the cache starts a new cluster
+		if (time-cache_time[fan] > cache_size)
+		{
+			if (cluster_starts)
+				cluster_starts[cluster_count] = out_count/3;
+			cluster_count++;
+		}
+
+		// emit every remaining triangle around the fanning vertex
+		int candidate_count = 0;
+		for (int a = adj_start[fan]; a < adj_start[fan+1]; a++)
+		{
+			int t = adj[a];
+			if (emitted[t])
+				continue;
+			for (int k = 0; k < 3; k++)
+			{
+				int v = tris[t*3+k];
+				out[out_count++] = v;
+				dead_end[dead_end_count++] = v;
+				candidates[candidate_count++] = v;
+				live[v]--;
+				if (time-cache_time[v] > cache_size)
+					cache_time[v] = time++;
+			}
+			emitted[t] = true;
+		}
+
+		// pick the candidate still in the cache after its own fan that is oldest, so its slot gets used before it's gone
+		int next		= -1;
+		int best		= -1;
+		for (i = 0; i < candidate_count; i++)
+		{
+			int v = candidates[i];
+			if (live[v] <= 0)
+				continue;
+			int priority = 0;
+			if (time-cache_time[v]+2*live[v] <= cache_size)
+				priority = time-cache_time[v];
+			if (priority > best)
+			{
+				best = priority;
+				next = v;
+			}
+		}
+
+		// dead end: back up through the recent vertices, then walk the vertex list
+		while (next < 0 && dead_end_count > 0)
+		{
+			int v = dead_end[--dead_end_count];
+			if (live[v] > 0)
+				next = v;
+		}
+		while (next < 0 && cursor < vertex_count)
+		{
+			if (live[cursor] > 0)
+				next = cursor;
+			cursor++;
+		}
+		fan = next;
+	}
+
+	WWASSERT(out_count == triangle_count*3);
+
+	for (i = 0; i < out_count; i++)
+		tris[i] = out[i];
+
+	delete[] out;
+	delete[] candidates;
+	delete[] dead_end;
+	delete[] emitted;
+	delete[] cache_time;
+	delete[] adj;
+	delete[] adj_start;
+	delete[] live;
+
+	return cluster_count;
+}
+
+/*****************************************************************************
+ *
+ * Function:		StripOptimizerClass::Optimize_Overdraw()
+ *
+ * Description:		Sorts the clusters from Optimize_Vertex_Cache so the ones
+ *					whose average normal points away from the middle of the
+ *					mesh are drawn first. Those are the ones that tend to
+ *					cover the rest of the mesh, so more of what comes after
+ *					them fails the depth test. Only the cluster order
+ *					changes; equal keys keep their order.
+ *
+ * Parameters:		verts			- vertex positions, indexed by tris
+ *					cluster_starts	- first triangle of each cluster, ascending
+ *
+ *****************************************************************************/
+
+struct ClusterKey
+{
+	float	Key;
+	int		Index;
+
+	// sorts descending by key, ties in original order
+	bool operator< (const ClusterKey& s) const { return (Key > s.Key) || (Key == s.Key && Index < s.Index); }
+	bool operator> (const ClusterKey& s) const { return s < *this; }
+};
+
+void StripOptimizerClass::Optimize_Overdraw (int* tris, int triangle_count, const Vector3* verts, int vertex_count, const int* cluster_starts, int cluster_count)
+{
+	if (triangle_count <= 0 || cluster_count <= 1)
+		return;
+	WWASSERT(tris && verts && cluster_starts);
+
+	// area weighted centroid of the whole mesh
+	Vector3 mesh_center(0,0,0);
+	float mesh_area = 0.0f;
+	int i;
+	for (i = 0; i < triangle_count; i++)
+	{
+		const Vector3& p0 = verts[tris[i*3]];
+		const Vector3& p1 = verts[tris[i*3+1]];
+		const Vector3& p2 = verts[tris[i*3+2]];
+		float area = Vector3::Cross_Product(p1-p0,p2-p0).Length();
+		mesh_center += (p0+p1+p2) * area;
+		mesh_area += area;
+	}
+	if (mesh_area <= 0.0f)
+		return;
+	mesh_center /= 3.0f*mesh_area;
+
+	ClusterKey* keys = new ClusterKey[cluster_count];
+	for (int c = 0; c < cluster_count; c++)
+	{
+		int start	= cluster_starts[c];
+		int end		= (c+1 < cluster_count) ? cluster_starts[c+1] : triangle_count;
+		WWASSERT(start < end && end <= triangle_count);
+
+		// area weighted normal (the cross products sum up to that) and centroid
+		Vector3 normal(0,0,0);
+		Vector3 center(0,0,0);
+		float area = 0.0f;
+		for (i = start; i < end; i++)
+		{
+			const Vector3& p0 = verts[tris[i*3]];
+			const Vector3& p1 = verts[tris[i*3+1]];
+			const Vector3& p2 = verts[tris[i*3+2]];
+			Vector3 n = Vector3::Cross_Product(p1-p0,p2-p0);
+			float a = n.Length();
+			normal += n;
+			center += (p0+p1+p2) * a;
+			area += a;
+		}
+
+		keys[c].Index	= c;
+		keys[c].Key		= 0.0f;
+		float length = normal.Length();
+		if (area > 0.0f && length > 0.0f)
+		{
+			center /= 3.0f*area;
+			keys[c].Key = Vector3::Dot_Product(center-mesh_center,normal) / length;
+		}
+	}
+
+	Quick_Sort(keys,cluster_count);
+
+	int* out = new int[triangle_count*3];
+	int* o = out;
+	for (int c = 0; c < cluster_count; c++)
+	{
+		int src		= keys[c].Index;
+		int start	= cluster_starts[src];
+		int end		= (src+1 < cluster_count) ? cluster_starts[src+1] : triangle_count;
+		for (i = start*3; i < end*3; i++)
+			*o++ = tris[i];
+	}
+	WWASSERT(o == out+triangle_count*3);
+
+	for (i = 0; i < triangle_count*3; i++)
+		tris[i] = out[i];
+
+	delete[] out;
+	delete[] keys;
+}
+
+/*****************************************************************************
+ *
+ * Function:		StripOptimizerClass::Optimize_Vertex_Fetch()
+ *
+ * Description:		Renumbers the vertices in the order the triangle list
+ *					first references them, so the vertex fetches of an
+ *					optimized list run through the vertex buffer front to
+ *					back. The vertex data has to be moved to match: the
+ *					vertex at old index i goes to remap[i].
+ *
+ * Parameters:		remap			- vertex_count entries
+ *
+ *****************************************************************************/
+
+int StripOptimizerClass::Optimize_Vertex_Fetch (int* tris, int triangle_count, int vertex_count, int* remap)
+{
+	WWASSERT(remap);
+	int i;
+	for (i = 0; i < vertex_count; i++)
+		remap[i] = -1;
+
+	int next = 0;
+	for (i = 0; i < triangle_count*3; i++)
+	{
+		int v = tris[i];
+		WWASSERT(v >= 0 && v < vertex_count);
+		if (remap[v] < 0)
+			remap[v] = next++;
+		tris[i] = remap[v];
+	}
+
+	int used = next;
+	for (i = 0; i < vertex_count; i++)
+	if (remap[i] < 0)
+		remap[i] = next++;
+
+	return used;
+}
+
+/*****************************************************************************
+ *
+ * Function:		StripOptimizerClass::Compute_ACMR()
+ *
+ * Description:		Simulates a FIFO post-transform cache over the list and
+ *					returns the vertices transformed per triangle: 3 for no
+ *					reuse at all, about 0.5 at best for a regular grid.
+ *
+ *****************************************************************************/
+
+float StripOptimizerClass::Compute_ACMR (const int* tris, int triangle_count, int vertex_count, int cache_size)
+{
+	if (triangle_count <= 0)
+		return 0.0f;
+	WWASSERT(tris);
+
+	// a vertex is in the cache if fewer than cache_size misses happened since it was loaded
+	int* cache_time = new int[vertex_count];
+	int i;
+	for (i = 0; i < vertex_count; i++)
+		cache_time[i] = 0;
+
+	int time = cache_size+1;
+	int misses = 0;
+	for (i = 0; i < triangle_count*3; i++)
+	{
+		int v = tris[i];
+		WWASSERT(v >= 0 && v < vertex_count);
+		if (time-cache_time[v] > cache_size)
+		{
+			cache_time[v] = time++;
+			misses++;
+		}
+	}
+
+	delete[] cache_time;
+	return (float)misses / (float)triangle_count;
+}
+
 
 /*****************************************************************************
  *
@@ -25,6 +25,8 @@
 
 #include "always.h"
 
+class Vector3;
+
 
 // strip data =
 //
@@ -43,6 +45,26 @@ public:
 	static void Optimize_Triangle_Order(int* tris, int triangle_count); // Sorts triangles (three indices each) into near-optimal access order
 
 	static int Get_Strip_Index_Count(const int* strips, int strips_count);
+
+	// Indexed triangle list optimizations. The triangles keep their own vertex order (and so their winding),
+	// only the order of the triangles in the list changes.
+
+	enum { DEFAULT_CACHE_SIZE = 16 };		// entries in the simulated post-transform vertex cache (FIFO)
+
+	// Reorders triangles for the post-transform vertex cache (Tipsify). Returns the number of clusters the list
+	// was split into; if cluster_starts isn't NULL it receives the first triangle of each (up to triangle_count entries).
+	static int Optimize_Vertex_Cache(int* tris, int triangle_count, int vertex_count, int cache_size = DEFAULT_CACHE_SIZE, int* cluster_starts = NULL);
+
+	// Reorders whole clusters from Optimize_Vertex_Cache so the ones facing away from the middle of the mesh come
+	// first, which cuts overdraw on opaque geometry without touching the order inside a cluster.
+	static void Optimize_Overdraw(int* tris, int triangle_count, const Vector3* verts, int vertex_count, const int* cluster_starts, int cluster_count);
+
+	// Renumbers the vertices in the order the triangles first use them so vertex fetches walk memory forwards.
+	// remap[old index] receives the new index (unused vertices go last); returns the number of vertices used.
+	static int Optimize_Vertex_Fetch(int* tris, int triangle_count, int vertex_count, int* remap);
+
+	// Average cache miss ratio: transformed vertices per triangle with a FIFO cache of the given size.
+	static float Compute_ACMR(const int* tris, int triangle_count, int vertex_count, int cache_size = DEFAULT_CACHE_SIZE);
 };
 
 #endif // WW3D2_STRIP_OPTIMIZER_H__
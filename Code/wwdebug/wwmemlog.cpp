@@ -36,6 +36,12 @@
  * Functions:                                                                                  *
  *   WWMemoryLogClass::Allocate_Memory -- allocates memory                                     *
  *   WWMemoryLogClass::Release_Memory -- frees memory                                          *
+ *   WWMemoryLogClass::Update_Allocation_Rates -- recomputes the per-category allocation rates *
+ *   WWMemoryLogClass::Take_Snapshot -- copies the memory counters                             *
+ *   WWMemoryLogClass::Write_Snapshot -- appends a snapshot to a text file                     *
+ *   WWMemoryLogClass::Read_Snapshots -- reads the snapshots back from a text file             *
+ *   WWMemoryLogClass::Format_Snapshot_Diff -- describes what changed between two snapshots    *
+ *   WWMemoryLogClass::Snapshot -- takes a snapshot and appends it to the snapshot file        *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #include "always.h"
@@ -45,7 +51,11 @@
 #include "vector.h"
 #include "FastAllocator.h"
 #include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
 #include <thread>
+#include <time.h>
 
 #ifndef __unix
 #include <windows.h>
@@ -126,19 +136,37 @@ static const char * _MemoryCategoryNames[] =
 class MemoryCounterClass
 {
 public:
-	MemoryCounterClass(void) : CurrentAllocation(0), PeakAllocation(0) { }
+	MemoryCounterClass(void) : CurrentAllocation(0), PeakAllocation(0), AllocationCount(0), FreeCount(0), BytesAllocated(0), BytesReleased(0) { }
 
-	void		Memory_Allocated(int size)						{ CurrentAllocation+=size; PeakAllocation = std::max(PeakAllocation,CurrentAllocation); }
-	void		Memory_Released(int size)						{ CurrentAllocation-=size; }
+	void		Memory_Allocated(int size)						{ CurrentAllocation+=size; PeakAllocation = std::max(PeakAllocation,CurrentAllocation); AllocationCount++; BytesAllocated+=size; }
+	void		Memory_Released(int size)						{ CurrentAllocation-=size; FreeCount++; BytesReleased+=size; }
 
 	int		Get_Current_Allocated_Memory(void)			{ return CurrentAllocation; }
 	int		Get_Peak_Allocated_Memory(void)				{ return PeakAllocation; }
+	uint64_t	Get_Allocation_Count(void)						{ return AllocationCount; }
+	uint64_t	Get_Allocated_Bytes(void)						{ return BytesAllocated; }
+
+	void		Get_Snapshot(WWMemorySnapshotStruct::CategoryStruct & category);
 
 protected:
 	int		CurrentAllocation;
 	int		PeakAllocation;
+	uint64_t	AllocationCount;
+	uint64_t	FreeCount;
+	uint64_t	BytesAllocated;
+	uint64_t	BytesReleased;
 };
 
+void MemoryCounterClass::Get_Snapshot(WWMemorySnapshotStruct::CategoryStruct & category)
+{
+	category.Current = CurrentAllocation;
+	category.Peak = PeakAllocation;
+	category.Allocations = AllocationCount;
+	category.Frees = FreeCount;
+	category.BytesAllocated = BytesAllocated;
+	category.BytesReleased = BytesReleased;
+}
+
 
 
 /**
@@ -215,8 +243,18 @@ class MemLogClass
 {
 public:
 
+	MemLogClass(void);
+
 	int				Get_Current_Allocated_Memory(int category);
 	int				Get_Peak_Allocated_Memory(int category);
+	uint64_t			Get_Allocation_Count(int category);
+	uint64_t			Get_Allocated_Bytes(int category);
+
+	void				Update_Allocation_Rates(void);
+	float				Get_Allocation_Rate(int category);
+	float				Get_Allocated_Byte_Rate(int category);
+
+	void				Get_Snapshot(WWMemorySnapshotStruct & snapshot);
 
 	/*
 	** Interface for recording allocations and de-allocations
@@ -234,6 +272,14 @@ private:
 	MemoryCounterClass		_MemoryCounters[MEM_COUNT];
 	ActiveCategoryClass		_ActiveCategoryTracker;
 
+	/*
+	** Counts at the last rate update and the rates worked out from them
+	*/
+	uint64_t						_RateTime;
+	uint64_t						_RateAllocationCounts[MEM_COUNT];
+	uint64_t						_RateAllocatedBytes[MEM_COUNT];
+	float							_AllocationRates[MEM_COUNT];
+	float							_AllocatedByteRates[MEM_COUNT];
 };
 
 
@@ -245,6 +291,7 @@ private:
 */
 static MemLogClass *				_TheMemLog = NULL;
 static bool							_MemLogAllocated = false;
+static char							_SnapshotFile[260] = { 0 };
 
 #if MEMLOG_USE_MUTEX
 static void *						_MemLogMutex = NULL;
@@ -415,6 +462,31 @@ ActiveCategoryStackClass & ActiveCategoryClass::Get_Active_Stack(void)
 ** MemLogClass Implementation
 **
 ***************************************************************************************************/
+
+/*
+** Milliseconds since the program started, for the rates and the snapshots.  The clock
+** starts with the first call, which is when the log is created.
+*/
+static int64_t					_LogStartTime = 0;
+
+static uint64_t Get_Log_Time(void)
+{
+	static const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	if (_LogStartTime == 0) {
+		_LogStartTime = (int64_t)time(NULL);
+	}
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start).count();
+}
+
+MemLogClass::MemLogClass(void) :
+	_RateTime(Get_Log_Time())
+{
+	memset(_RateAllocationCounts,0,sizeof(_RateAllocationCounts));
+	memset(_RateAllocatedBytes,0,sizeof(_RateAllocatedBytes));
+	memset(_AllocationRates,0,sizeof(_AllocationRates));
+	memset(_AllocatedByteRates,0,sizeof(_AllocatedByteRates));
+}
+
 int MemLogClass::Get_Current_Allocated_Memory(int category)
 {
 	MemLogMutexLockClass lock;
@@ -427,6 +499,61 @@ int MemLogClass::Get_Peak_Allocated_Memory(int category)
 	return _MemoryCounters[category].Get_Peak_Allocated_Memory();
 }
 
+uint64_t MemLogClass::Get_Allocation_Count(int category)
+{
+	MemLogMutexLockClass lock;
+	return _MemoryCounters[category].Get_Allocation_Count();
+}
+
+uint64_t MemLogClass::Get_Allocated_Bytes(int category)
+{
+	MemLogMutexLockClass lock;
+	return _MemoryCounters[category].Get_Allocated_Bytes();
+}
+
+void MemLogClass::Update_Allocation_Rates(void)
+{
+	MemLogMutexLockClass lock;
+
+	uint64_t now = Get_Log_Time();
+	if (now < _RateTime + 1000) {
+		return;
+	}
+
+	float oo_seconds = 1000.0f / (float)(now - _RateTime);
+	for (int i=0; i<MEM_COUNT; i++) {
+		uint64_t count = _MemoryCounters[i].Get_Allocation_Count();
+		uint64_t bytes = _MemoryCounters[i].Get_Allocated_Bytes();
+		_AllocationRates[i] = (float)(count - _RateAllocationCounts[i]) * oo_seconds;
+		_AllocatedByteRates[i] = (float)(bytes - _RateAllocatedBytes[i]) * oo_seconds;
+		_RateAllocationCounts[i] = count;
+		_RateAllocatedBytes[i] = bytes;
+	}
+	_RateTime = now;
+}
+
+float MemLogClass::Get_Allocation_Rate(int category)
+{
+	MemLogMutexLockClass lock;
+	return _AllocationRates[category];
+}
+
+float MemLogClass::Get_Allocated_Byte_Rate(int category)
+{
+	MemLogMutexLockClass lock;
+	return _AllocatedByteRates[category];
+}
+
+void MemLogClass::Get_Snapshot(WWMemorySnapshotStruct & snapshot)
+{
+	MemLogMutexLockClass lock;
+	snapshot.Milliseconds = Get_Log_Time();
+	snapshot.StartTime = _LogStartTime;
+	for (int i=0; i<MEM_COUNT; i++) {
+		_MemoryCounters[i].Get_Snapshot(snapshot.Categories[i]);
+	}
+}
+
 void MemLogClass::Init()
 {
 	{
@@ -494,6 +621,26 @@ int WWMemoryLogClass::Get_Peak_Allocated_Memory(int category)
 	return Get_Log()->Get_Peak_Allocated_Memory(category);
 }
 
+uint64_t WWMemoryLogClass::Get_Allocation_Count(int category)
+{
+	return Get_Log()->Get_Allocation_Count(category);
+}
+
+uint64_t WWMemoryLogClass::Get_Allocated_Bytes(int category)
+{
+	return Get_Log()->Get_Allocated_Bytes(category);
+}
+
+float WWMemoryLogClass::Get_Allocation_Rate(int category)
+{
+	return Get_Log()->Get_Allocation_Rate(category);
+}
+
+float WWMemoryLogClass::Get_Allocated_Byte_Rate(int category)
+{
+	return Get_Log()->Get_Allocated_Byte_Rate(category);
+}
+
 void WWMemoryLogClass::Push_Active_Category([[maybe_unused]] int category)
 {
 #if (DISABLE_MEMLOG == 0)
@@ -754,3 +901,269 @@ void WWMemoryLogClass::Init()
 {
 	Get_Log()->Init();
 }
+
+
+/***************************************************************************************************
+**
+** Snapshots
+**
+***************************************************************************************************/
+
+/***********************************************************************************************
+ * WWMemoryLogClass::Update_Allocation_Rates -- recomputes the per-category allocation rates   *
+ *                                                                                             *
+ *    The rates are worked out from how far the counters have moved since the last update, so *
+ *    calls less than a second apart just keep the current rates.                              *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WWMemoryLogClass::Update_Allocation_Rates(void)
+{
+	Get_Log()->Update_Allocation_Rates();
+}
+
+
+/***********************************************************************************************
+ * WWMemoryLogClass::Take_Snapshot -- copies the memory counters                               *
+ *                                                                                             *
+ * INPUT:   snapshot -- filled in with the counters of every category                          *
+ *          label    -- what the snapshot is of, e.g. "Post_Load_Level C&C_Field.mix"          *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WWMemoryLogClass::Take_Snapshot(WWMemorySnapshotStruct & snapshot,const char * label)
+{
+	memset(&snapshot,0,sizeof(snapshot));
+	snprintf(snapshot.Label,sizeof(snapshot.Label),"%s",(label != NULL) ? label : "");
+	snapshot.Time = (int64_t)time(NULL);
+	Get_Log()->Get_Snapshot(snapshot);
+}
+
+
+/***********************************************************************************************
+ * WWMemoryLogClass::Write_Snapshot -- appends a snapshot to a text file                       *
+ *                                                                                             *
+ *    Each snapshot is a "snapshot" line with the times and the label, a line per category     *
+ *    and an "end" line.  The categories are written by name so that files stay readable if   *
+ *    categories are added.                                                                    *
+ *                                                                                             *
+ * INPUT:   filename -- file to append to; it is created if it doesn't exist                   *
+ *          snapshot -- snapshot to write                                                      *
+ *                                                                                             *
+ * OUTPUT:  true if the snapshot was written                                                   *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool WWMemoryLogClass::Write_Snapshot(const char * filename,const WWMemorySnapshotStruct & snapshot)
+{
+	FILE * file = fopen(filename,"at");
+	if (file == NULL) {
+		return false;
+	}
+
+	fprintf(file,"snapshot %lld %lld %llu %s\n",(long long)snapshot.Time,(long long)snapshot.StartTime,
+		(unsigned long long)snapshot.Milliseconds,snapshot.Label);
+	for (int i=0; i<MEM_COUNT; i++) {
+		const WWMemorySnapshotStruct::CategoryStruct & category = snapshot.Categories[i];
+		fprintf(file,"%s %d %d %llu %llu %llu %llu\n",_MemoryCategoryNames[i],category.Current,category.Peak,
+			(unsigned long long)category.Allocations,(unsigned long long)category.Frees,
+			(unsigned long long)category.BytesAllocated,(unsigned long long)category.BytesReleased);
+	}
+	fprintf(file,"end\n");
+
+	bool ok = (ferror(file) == 0);
+	fclose(file);
+	return ok;
+}
+
+
+/***********************************************************************************************
+ * WWMemoryLogClass::Read_Snapshots -- reads the snapshots back from a text file               *
+ *                                                                                             *
+ * INPUT:   filename  -- file written by Write_Snapshot                                        *
+ *          snapshots -- the snapshots in the file are added to this                           *
+ *                                                                                             *
+ * OUTPUT:  number of snapshots read, or -1 if the file couldn't be opened                     *
+ *                                                                                             *
+ * WARNINGS: Categories the file has but this build doesn't are skipped.                       *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+int WWMemoryLogClass::Read_Snapshots(const char * filename,DynamicVectorClass<WWMemorySnapshotStruct> & snapshots)
+{
+	FILE * file = fopen(filename,"rt");
+	if (file == NULL) {
+		return -1;
+	}
+
+	int count = 0;
+	bool in_snapshot = false;
+	WWMemorySnapshotStruct snapshot;
+	char line[512];
+	while (fgets(line,sizeof(line),file) != NULL) {
+		line[strcspn(line,"\r\n")] = 0;
+
+		long long time_value = 0;
+		long long start_time = 0;
+		unsigned long long ms = 0;
+		int label_start = 0;
+		if (sscanf(line,"snapshot %lld %lld %llu %n",&time_value,&start_time,&ms,&label_start) == 3) {
+			memset(&snapshot,0,sizeof(snapshot));
+			snapshot.Time = time_value;
+			snapshot.StartTime = start_time;
+			snapshot.Milliseconds = ms;
+			snprintf(snapshot.Label,sizeof(snapshot.Label),"%s",line + label_start);
+			in_snapshot = true;
+
+		} else if (in_snapshot && strcmp(line,"end") == 0) {
+			snapshots.Add(snapshot);
+			in_snapshot = false;
+			count++;
+
+		} else if (in_snapshot) {
+			char name[64];
+			WWMemorySnapshotStruct::CategoryStruct category;
+			unsigned long long allocations,frees,bytes_allocated,bytes_released;
+			if (sscanf(line,"%63s %d %d %llu %llu %llu %llu",name,&category.Current,&category.Peak,
+				&allocations,&frees,&bytes_allocated,&bytes_released) == 7)
+			{
+				category.Allocations = allocations;
+				category.Frees = frees;
+				category.BytesAllocated = bytes_allocated;
+				category.BytesReleased = bytes_released;
+				for (int i=0; i<MEM_COUNT; i++) {
+					if (strcmp(name,_MemoryCategoryNames[i]) == 0) {
+						snapshot.Categories[i] = category;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	fclose(file);
+	return count;
+}
+
+
+/***********************************************************************************************
+ * WWMemoryLogClass::Format_Snapshot_Diff -- describes what changed between two snapshots      *
+ *                                                                                             *
+ *    Writes a table with a line per category that changed: the allocated memory before and   *
+ *    after, the growth, and the allocations, frees and allocation rate in between.  The       *
+ *    categories that grew most come first.                                                    *
+ *                                                                                             *
+ * INPUT:   before      -- the earlier snapshot                                                *
+ *          after       -- the later snapshot                                                  *
+ *          buffer      -- where to write the table                                            *
+ *          buffer_size -- size of the buffer; the table is cut short if it doesn't fit        *
+ *                                                                                             *
+ * OUTPUT:  length of the text written                                                         *
+ *                                                                                             *
+ * WARNINGS: Snapshots from different runs of the program can be compared but the counts of    *
+ *           allocations and frees only make sense within one run.                             *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+int WWMemoryLogClass::Format_Snapshot_Diff(const WWMemorySnapshotStruct & before,const WWMemorySnapshotStruct & after,char * buffer,int buffer_size)
+{
+	WWASSERT(buffer != NULL && buffer_size > 0);
+
+	int length = 0;
+	auto append = [&](const char * format,auto... args) {
+		if (length < buffer_size - 1) {
+			int written = snprintf(buffer + length,buffer_size - length,format,args...);
+			if (written > 0) {
+				length = std::min(length + written,buffer_size - 1);
+			}
+		}
+	};
+
+	/*
+	** Counters restart with the program, so only use them if after came later in the same run
+	*/
+	bool same_run = (after.StartTime == before.StartTime) && (after.Milliseconds >= before.Milliseconds);
+	float seconds = same_run ? (float)(after.Milliseconds - before.Milliseconds) / 1000.0f : (float)(after.Time - before.Time);
+
+	append("Memory diff \"%s\" -> \"%s\", %.1f seconds%s\n",before.Label,after.Label,seconds,
+		same_run ? "" : " (different runs)");
+	append("%-18s %12s %12s %12s %12s %12s %10s\n","Category","Before(KB)","After(KB)","Change(KB)","Allocs","Frees","Allocs/s");
+
+	int order[MEM_COUNT];
+	for (int i=0; i<MEM_COUNT; i++) {
+		order[i] = i;
+	}
+	std::stable_sort(order,order + MEM_COUNT,[&](int a,int b) {
+		return (after.Categories[a].Current - before.Categories[a].Current) > (after.Categories[b].Current - before.Categories[b].Current);
+	});
+
+	int total_before = 0;
+	int total_after = 0;
+	for (int i=0; i<MEM_COUNT; i++) {
+		const WWMemorySnapshotStruct::CategoryStruct & b = before.Categories[order[i]];
+		const WWMemorySnapshotStruct::CategoryStruct & a = after.Categories[order[i]];
+		total_before += b.Current;
+		total_after += a.Current;
+
+		uint64_t allocations = same_run ? a.Allocations - b.Allocations : 0;
+		uint64_t frees = same_run ? a.Frees - b.Frees : 0;
+		if (a.Current == b.Current && allocations == 0 && frees == 0) {
+			continue;
+		}
+		append("%-18s %12.1f %12.1f %+12.1f %12llu %12llu %10.1f\n",_MemoryCategoryNames[order[i]],
+			b.Current / 1024.0f,a.Current / 1024.0f,(a.Current - b.Current) / 1024.0f,
+			(unsigned long long)allocations,(unsigned long long)frees,
+			seconds > 0.0f ? (float)allocations / seconds : 0.0f);
+	}
+	append("%-18s %12.1f %12.1f %+12.1f\n","TOTAL",total_before / 1024.0f,total_after / 1024.0f,(total_after - total_before) / 1024.0f);
+	return length;
+}
+
+
+/***********************************************************************************************
+ * WWMemoryLogClass::Snapshot -- takes a snapshot and appends it to the snapshot file          *
+ *                                                                                             *
+ *    Does nothing unless a snapshot file has been set with Set_Snapshot_File.                 *
+ *                                                                                             *
+ * INPUT:   label -- what the snapshot is of                                                   *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WWMemoryLogClass::Snapshot(const char * label)
+{
+	if (_SnapshotFile[0] == 0) {
+		return;
+	}
+
+	WWMemorySnapshotStruct snapshot;
+	Take_Snapshot(snapshot,label);
+	if (!Write_Snapshot(_SnapshotFile,snapshot)) {
+		WWDEBUG_SAY(("WWMemoryLogClass: couldn't write snapshot to %s\n",_SnapshotFile));
+	}
+}
+
+void WWMemoryLogClass::Set_Snapshot_File(const char * filename)
+{
+	snprintf(_SnapshotFile,sizeof(_SnapshotFile),"%s",(filename != NULL) ? filename : "");
+}
+
+const char * WWMemoryLogClass::Get_Snapshot_File(void)
+{
+	return _SnapshotFile;
+}
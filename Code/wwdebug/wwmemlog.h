@@ -45,8 +45,10 @@
 #define WWMEMLOG_H
 
 #include <cstdlib>
+#include <stdint.h>
 
 class MemLogClass;
+template<class T> class DynamicVectorClass;
 
 /**
 ** Memory Log Categories
@@ -78,6 +80,40 @@ enum
 
 
 
+/**
+** WWMemorySnapshotStruct
+** Copy of the memory log counters at one point in time.  Snapshots can be appended to a
+** text file and read back, and two of them compared to see which categories grew in
+** between.  The allocation counts and byte totals only ever go up, so the difference
+** between two snapshots is the traffic in between even if the current size didn't change.
+*/
+struct WWMemorySnapshotStruct
+{
+	// Stubbed equality operators so you can have dynamic vectors of snapshots
+	bool operator == (const WWMemorySnapshotStruct &)	{ return false; }
+	bool operator != (const WWMemorySnapshotStruct &)	{ return true; }
+
+	struct CategoryStruct
+	{
+		int				Current;				// bytes allocated right now
+		int				Peak;					// most bytes ever allocated at once
+		uint64_t			Allocations;		// allocations since startup
+		uint64_t			Frees;				// frees since startup
+		uint64_t			BytesAllocated;	// bytes allocated since startup
+		uint64_t			BytesReleased;		// bytes freed since startup
+	};
+
+	enum { MAX_LABEL_LEN = 64 };
+
+	char					Label[MAX_LABEL_LEN];
+	int64_t				Time;					// wall clock time, seconds since 1970
+	int64_t				StartTime;			// wall clock time the program started, which tells runs apart
+	uint64_t				Milliseconds;		// time since the program started
+	CategoryStruct		Categories[MEM_COUNT];
+};
+
+
+
 /**
 ** WWMemoryLogClass
 ** This interface can provide information on how much memory has been allocated to each
@@ -107,6 +143,32 @@ public:
 	static int				Get_Current_Allocated_Memory(int category);
 	static int				Get_Peak_Allocated_Memory(int category);
 
+	/*
+	** Allocation traffic per category.  The counts run from startup.  The rates are
+	** averaged over at least a second between calls to Update_Allocation_Rates, which
+	** whoever displays them should call every frame.
+	*/
+	static uint64_t		Get_Allocation_Count(int category);
+	static uint64_t		Get_Allocated_Bytes(int category);
+	static void				Update_Allocation_Rates(void);
+	static float			Get_Allocation_Rate(int category);		// allocations per second
+	static float			Get_Allocated_Byte_Rate(int category);	// bytes allocated per second
+
+	/*
+	** Snapshots.  Snapshot takes one and appends it to the snapshot file if one has been
+	** set, so calls can be left in places like level loads and cost nothing until someone
+	** asks for the file.  Format_Snapshot_Diff writes a table of what changed between two
+	** snapshots, biggest growth first, and returns the length written.
+	*/
+	static void				Take_Snapshot(WWMemorySnapshotStruct & snapshot,const char * label);
+	static bool				Write_Snapshot(const char * filename,const WWMemorySnapshotStruct & snapshot);
+	static int				Read_Snapshots(const char * filename,DynamicVectorClass<WWMemorySnapshotStruct> & snapshots);
+	static int				Format_Snapshot_Diff(const WWMemorySnapshotStruct & before,const WWMemorySnapshotStruct & after,char * buffer,int buffer_size);
+
+	static void				Set_Snapshot_File(const char * filename);
+	static const char *	Get_Snapshot_File(void);
+	static void				Snapshot(const char * label);
+
 	/*
 	** Interface for the debug version of new and delete
 	*/
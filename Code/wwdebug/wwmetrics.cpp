@@ -0,0 +1,329 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "wwmetrics.h"
+#include "wwdebug.h"
+#include "mutex.h"
+#include "rawfile.h"
+#include "thread.h"
+
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <system_error>
+
+/*
+** The registry is an intrusive singly linked list.  Members of one family are kept
+** adjacent so the dump only has to compare with the previous entry to know when to
+** emit a new header.
+*/
+static WWMetricClass *	_MetricListHead = NULL;
+
+static FastCriticalSectionClass &Registry_Lock(void)
+{
+	// Function-local so it is usable by metrics constructed during static initialization
+	static FastCriticalSectionClass _lock;
+	return _lock;
+}
+
+
+/*
+** WWMetricClass
+*/
+WWMetricClass::WWMetricClass(MetricType type, const char *name, const char *help, const char *labels) :
+	Type(type),
+	Name(name),
+	Help(help),
+	Labels(labels ? labels : ""),
+	Next(NULL)
+{
+	WWASSERT(name != NULL && help != NULL);
+	WWMetricsManager::Link(this);
+}
+
+WWMetricClass::~WWMetricClass(void)
+{
+	WWMetricsManager::Unlink(this);
+}
+
+void WWMetricClass::Write_Sample(StringClass &out, const char *suffix, const char *extra_label, double value) const
+{
+	StringClass line;
+	const bool has_labels = !Labels.Is_Empty();
+	const bool has_extra = (extra_label != NULL && extra_label[0] != 0);
+
+	line = Name;
+	line += suffix;
+	if (has_labels || has_extra) {
+		line += '{';
+		if (has_labels) {
+			line += Labels;
+		}
+		if (has_labels && has_extra) {
+			line += ',';
+		}
+		if (has_extra) {
+			line += extra_label;
+		}
+		line += '}';
+	}
+
+	// Range check first: converting NaN or an out of range double to an integer is undefined.
+	StringClass number;
+	if (std::isnan(value)) {
+		number = " NaN\n";
+	} else if (std::isinf(value)) {
+		number = (value > 0.0) ? " +Inf\n" : " -Inf\n";
+	} else if (value < 9.0e15 && value > -9.0e15 && std::trunc(value) == value) {
+		number.Format(" %lld\n", (long long)value);
+	} else {
+		number.Format(" %.9g\n", value);
+	}
+	line += number;
+	out += line;
+}
+
+
+/*
+** WWCounterClass
+*/
+void WWCounterClass::Write_Samples(StringClass &out) const
+{
+	Write_Sample(out, "", NULL, (double)Get());
+}
+
+
+/*
+** WWGaugeClass
+*/
+void WWGaugeClass::Add(double delta)
+{
+	double current = Value.load(std::memory_order_relaxed);
+	while (!Value.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+	}
+}
+
+void WWGaugeClass::Write_Samples(StringClass &out) const
+{
+	Write_Sample(out, "", NULL, Get());
+}
+
+
+/*
+** WWHistogramClass
+*/
+WWHistogramClass::WWHistogramClass(const char *name, const char *help, const float *upper_bounds, int bound_count, const char *labels) :
+	WWMetricClass(TYPE_HISTOGRAM, name, help, labels),
+	BoundCount(0),
+	Count(0),
+	Sum(0.0)
+{
+	WWASSERT(bound_count >= 0 && bound_count <= MAX_BUCKETS);
+	if (bound_count > MAX_BUCKETS) {
+		bound_count = MAX_BUCKETS;
+	}
+	for (int i = 0; i < bound_count; ++i) {
+		WWASSERT(i == 0 || upper_bounds[i] > upper_bounds[i - 1]);
+		UpperBounds[i] = upper_bounds[i];
+	}
+	BoundCount = bound_count;
+
+	for (int i = 0; i <= MAX_BUCKETS; ++i) {
+		Buckets[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+void WWHistogramClass::Observe(float value)
+{
+	// Bucket counts are few enough that a linear scan beats a binary search
+	int bucket = 0;
+	while (bucket < BoundCount && value > UpperBounds[bucket]) {
+		++bucket;
+	}
+	Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	Count.fetch_add(1, std::memory_order_relaxed);
+
+	double current = Sum.load(std::memory_order_relaxed);
+	while (!Sum.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+	}
+}
+
+void WWHistogramClass::Write_Samples(StringClass &out) const
+{
+	StringClass le;
+	uint64_t cumulative = 0;
+	for (int i = 0; i < BoundCount; ++i) {
+		cumulative += Buckets[i].load(std::memory_order_relaxed);
+		le.Format("le=\"%g\"", UpperBounds[i]);
+		Write_Sample(out, "_bucket", le, (double)cumulative);
+	}
+	cumulative += Buckets[BoundCount].load(std::memory_order_relaxed);
+	Write_Sample(out, "_bucket", "le=\"+Inf\"", (double)cumulative);
+	Write_Sample(out, "_sum", NULL, Get_Sum());
+	Write_Sample(out, "_count", NULL, (double)cumulative);
+}
+
+
+/*
+** WWMetricsManager
+*/
+void WWMetricsManager::Link(WWMetricClass *metric)
+{
+	FastCriticalSectionClass::LockClass lock(Registry_Lock());
+
+	/*
+	** Insert after the last member of the same family, or at the end of the list.
+	*/
+	WWMetricClass **link = &_MetricListHead;
+	WWMetricClass **insert = NULL;
+	while (*link != NULL) {
+		if (strcmp((*link)->Name, metric->Name) == 0) {
+			WWASSERT((*link)->Type == metric->Type);
+			insert = &(*link)->Next;
+		}
+		link = &(*link)->Next;
+	}
+	if (insert == NULL) {
+		insert = link;
+	}
+	metric->Next = *insert;
+	*insert = metric;
+}
+
+void WWMetricsManager::Unlink(WWMetricClass *metric)
+{
+	FastCriticalSectionClass::LockClass lock(Registry_Lock());
+
+	for (WWMetricClass **link = &_MetricListHead; *link != NULL; link = &(*link)->Next) {
+		if (*link == metric) {
+			*link = metric->Next;
+			metric->Next = NULL;
+			return;
+		}
+	}
+}
+
+void WWMetricsManager::Write_Text(StringClass &out)
+{
+	static const char * _type_names[] = { "counter", "gauge", "histogram" };
+
+	FastCriticalSectionClass::LockClass lock(Registry_Lock());
+
+	StringClass header;
+	const char *family = NULL;
+	for (WWMetricClass *metric = _MetricListHead; metric != NULL; metric = metric->Next) {
+		if (family == NULL || strcmp(family, metric->Name) != 0) {
+			family = metric->Name;
+			header.Format("# HELP %s %s\n# TYPE %s %s\n", metric->Name, metric->Help, metric->Name, _type_names[metric->Type]);
+			out += header;
+		}
+		metric->Write_Samples(out);
+	}
+}
+
+bool WWMetricsManager::Write_File(const char *filename)
+{
+	WWASSERT(filename != NULL);
+
+	StringClass text;
+	Write_Text(text);
+
+	StringClass temp_name(filename);
+	temp_name += ".tmp";
+
+	RawFileClass file(temp_name);
+	if (!file.Open(FileClass::WRITE)) {
+		return false;
+	}
+	const size_t length = text.Get_Length();
+	WWASSERT(length <= static_cast<size_t>(std::numeric_limits<int>::max()));
+	const bool written = (file.Write(text.Peek_Buffer(), static_cast<int>(length)) == static_cast<int>(length));
+	file.Close();
+	if (!written) {
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temp_name.Peek_Buffer(), filename, error);
+	return !error;
+}
+
+
+/*
+** Dump thread
+*/
+class MetricsDumpThreadClass : public ThreadClass
+{
+public:
+	MetricsDumpThreadClass(const char *filename, unsigned interval_ms) :
+		ThreadClass("Metrics dump thread"),
+		FileName(filename),
+		IntervalMs(interval_ms)
+	{
+	}
+
+protected:
+	virtual void Thread_Function(void) override
+	{
+		unsigned elapsed = 0;
+		while (mRunning) {
+			// Sleep in short slices so Stop() doesn't have to wait a full interval
+			Sleep_Ms(50);
+			elapsed += 50;
+			if (elapsed >= IntervalMs) {
+				elapsed = 0;
+				if (!WWMetricsManager::Write_File(FileName)) {
+					WWDEBUG_SAY(("WWMetricsManager: failed to write %s\n", FileName.Peek_Buffer()));
+				}
+			}
+		}
+	}
+
+private:
+	StringClass		FileName;
+	unsigned			IntervalMs;
+};
+
+static MetricsDumpThreadClass *	_DumpThread = NULL;
+
+void WWMetricsManager::Start_Dump_Thread(const char *filename, unsigned interval_ms)
+{
+	WWASSERT(filename != NULL && filename[0] != 0);
+	Stop_Dump_Thread();
+
+	if (interval_ms < 100) {
+		interval_ms = 100;
+	}
+	_DumpThread = new MetricsDumpThreadClass(filename, interval_ms);
+	_DumpThread->Set_Priority(-1);
+	_DumpThread->Execute();
+}
+
+void WWMetricsManager::Stop_Dump_Thread(void)
+{
+	if (_DumpThread != NULL) {
+		_DumpThread->Stop();
+		delete _DumpThread;
+		_DumpThread = NULL;
+	}
+}
+
+bool WWMetricsManager::Is_Dump_Thread_Running(void)
+{
+	return _DumpThread != NULL;
+}
@@ -0,0 +1,167 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "wwstring.h"
+
+#include <atomic>
+#include <cstdint>
+
+/*
+** WWMetricClass
+** Base class of the always-on server metrics.  Every metric links itself into a global
+** registry when it is constructed and unlinks itself when it is destroyed, so metrics can
+** be static globals or be created and destroyed at runtime (e.g. one per connected client).
+**
+** Updating a metric never takes a lock; all values are relaxed atomics so any thread may
+** update them.  Only registration and the text dump take the registry lock.
+**
+** Metrics with the same name but different labels form one family and are written under
+** a single # HELP / # TYPE header.  The name and help strings must be static; the label
+** string (e.g. "client=\"1.2.3.4:4848\"") is copied.
+*/
+class WWMetricClass
+{
+public:
+	enum MetricType
+	{
+		TYPE_COUNTER = 0,
+		TYPE_GAUGE,
+		TYPE_HISTOGRAM,
+	};
+
+	WWMetricClass(MetricType type, const char *name, const char *help, const char *labels);
+	virtual ~WWMetricClass(void);
+
+	MetricType				Get_Type(void) const			{ return Type; }
+	const char *			Get_Name(void) const			{ return Name; }
+	const char *			Get_Help(void) const			{ return Help; }
+	const char *			Get_Labels(void) const		{ return Labels; }
+
+	// Append the sample lines (without the # HELP / # TYPE header) in text exposition format
+	virtual void			Write_Samples(StringClass &out) const = 0;
+
+protected:
+	void						Write_Sample(StringClass &out, const char *suffix, const char *extra_label, double value) const;
+
+private:
+	WWMetricClass(const WWMetricClass &);
+	WWMetricClass &operator=(const WWMetricClass &);
+
+	MetricType				Type;
+	const char *			Name;
+	const char *			Help;
+	StringClass				Labels;
+	WWMetricClass *		Next;
+
+	friend class WWMetricsManager;
+};
+
+
+/*
+** WWCounterClass
+** Monotonically increasing count, e.g. packets sent.
+*/
+class WWCounterClass : public WWMetricClass
+{
+public:
+	WWCounterClass(const char *name, const char *help, const char *labels = NULL) :
+		WWMetricClass(TYPE_COUNTER, name, help, labels), Value(0)	{}
+
+	void						Increment(uint64_t count = 1)	{ Value.fetch_add(count, std::memory_order_relaxed); }
+	uint64_t					Get(void) const					{ return Value.load(std::memory_order_relaxed); }
+
+	virtual void			Write_Samples(StringClass &out) const override;
+
+private:
+	std::atomic<uint64_t> Value;
+};
+
+
+/*
+** WWGaugeClass
+** A value that can go up and down, e.g. server fps or the bandwidth of one client.
+*/
+class WWGaugeClass : public WWMetricClass
+{
+public:
+	WWGaugeClass(const char *name, const char *help, const char *labels = NULL) :
+		WWMetricClass(TYPE_GAUGE, name, help, labels), Value(0.0)		{}
+
+	void						Set(double value)					{ Value.store(value, std::memory_order_relaxed); }
+	void						Add(double delta);
+	double					Get(void) const					{ return Value.load(std::memory_order_relaxed); }
+
+	virtual void			Write_Samples(StringClass &out) const override;
+
+private:
+	std::atomic<double>	Value;
+};
+
+
+/*
+** WWHistogramClass
+** Fixed-bucket histogram.  Bucket upper bounds are given in ascending order; an implicit
+** +Inf bucket catches everything above the last bound.  Counts are stored per bucket and
+** accumulated when the histogram is written.
+*/
+class WWHistogramClass : public WWMetricClass
+{
+public:
+	enum { MAX_BUCKETS = 32 };
+
+	WWHistogramClass(const char *name, const char *help, const float *upper_bounds, int bound_count, const char *labels = NULL);
+
+	void						Observe(float value);
+	uint64_t					Get_Count(void) const			{ return Count.load(std::memory_order_relaxed); }
+	double					Get_Sum(void) const				{ return Sum.load(std::memory_order_relaxed); }
+
+	virtual void			Write_Samples(StringClass &out) const override;
+
+private:
+	int						BoundCount;
+	float						UpperBounds[MAX_BUCKETS];
+	std::atomic<uint64_t> Buckets[MAX_BUCKETS + 1];
+	std::atomic<uint64_t> Count;
+	std::atomic<double>	Sum;
+};
+
+
+/*
+** WWMetricsManager
+** Dumps every registered metric in the Prometheus text exposition format.  Write_File
+** writes to a temporary file and renames it over the target so a scraper never sees a
+** partially written file.  Start_Dump_Thread spawns a low priority thread that does this
+** every interval_ms milliseconds until Stop_Dump_Thread is called.
+*/
+class WWMetricsManager
+{
+public:
+	static void				Write_Text(StringClass &out);
+	static bool				Write_File(const char *filename);
+
+	static void				Start_Dump_Thread(const char *filename, unsigned interval_ms);
+	static void				Stop_Dump_Thread(void);
+	static bool				Is_Dump_Thread_Running(void);
+
+private:
+	static void				Link(WWMetricClass *metric);
+	static void				Unlink(WWMetricClass *metric);
+
+	friend class WWMetricClass;
+};
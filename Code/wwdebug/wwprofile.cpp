@@ -40,6 +40,7 @@
  *   WWProfileHierachyNodeClass::Return -- Stop timing, record results                         *
  *   WWProfileManager::Start_Profile -- Begin a named profile                                  *
  *   WWProfileManager::Stop_Profile -- Stop timing and record the results.                     *
+ *   WWProfileManager::Add_Profile -- Record time that was measured somewhere else             *
  *   WWProfileManager::Reset -- Reset the contents of the profiling system                     *
  *   WWProfileManager::Increment_Frame_Counter -- Increment the frame counter                  *
  *   WWProfileManager::Get_Time_Since_Reset -- returns the elapsed time since last reset       *
@@ -387,6 +388,38 @@ void	WWProfileManager::Stop_Root_Profile( void )
 }
 
 
+/***********************************************************************************************
+ * WWProfileManager::Add_Profile -- Record time that was measured somewhere else               *
+ *                                                                                             *
+ *    Adds calls and time to the named child of the current node, as if the sample had been    *
+ *    taken there.  This is how work done on other threads, which the profiler otherwise       *
+ *    ignores, gets into the tree; the thread that did the work times it and the profiled      *
+ *    thread hands the totals over here.                                                       *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * name - static string pointer to the name of the record                                      *
+ * calls - number of calls to add                                                              *
+ * seconds - time to add                                                                       *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Like the other profile calls this does nothing on any thread but the profiled one.          *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void	WWProfileManager::Add_Profile( const char * name, int calls, float seconds )
+{
+    if (std::this_thread::get_id() != ThreadID) {
+		return;
+	}
+
+	WWProfileHierachyNodeClass * node = CurrentNode->Get_Sub_Node( name );
+	node->Set_Total_Calls( node->Get_Total_Calls() + calls );
+	node->Set_Total_Time( node->Get_Total_Time() + seconds );
+}
+
+
 /***********************************************************************************************
  * WWProfileManager::Reset -- Reset the contents of the profiling system                       *
  *                                                                                             *
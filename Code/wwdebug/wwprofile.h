@@ -167,6 +167,8 @@ public:
 	static	void								Start_Root_Profile( const char * name );
 	static	void								Stop_Root_Profile( void );
 
+	static	void								Add_Profile( const char * name, int calls, float seconds );
+
 	static	void								Reset( void );
 	static	void								Increment_Frame_Counter( void );
 	static	int								Get_Frame_Count_Since_Reset( void )		{ return FrameCounter; }
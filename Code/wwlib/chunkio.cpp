@@ -64,6 +64,7 @@
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #include "chunkio.h"
+#include "mappedfile.h"
 #include <string.h>
 #include <assert.h>
 #include <algorithm>
@@ -399,6 +400,10 @@ int ChunkSaveClass::Cur_Chunk_Depth(void)
  *=============================================================================================*/
 ChunkLoadClass::ChunkLoadClass(FileClass * file) :
 	File(file),
+	View(NULL),
+	Memory(NULL),
+	MemorySize(0),
+	MemoryPos(0),
 	StackIndex(0),
 	InMicroChunk(false),
 	MicroChunkPosition(0)
@@ -406,6 +411,139 @@ ChunkLoadClass::ChunkLoadClass(FileClass * file) :
 	memset(PositionStack,0,sizeof(PositionStack));
 	memset(HeaderStack,0,sizeof(HeaderStack));
 	memset(&MCHeader,0,sizeof(MCHeader));
+
+	// If the file is just a view of mapped memory, parse it in place
+	MappedViewFileClass * view = dynamic_cast<MappedViewFileClass *>(file);
+	if ((view != NULL) && view->Is_Open()) {
+		View = view;
+		Memory = (const uint8 *)view->Get_View_Data();
+		MemorySize = view->Get_View_Size();
+		MemoryPos = view->Tell();
+	}
+}
+
+
+/***********************************************************************************************
+ * ChunkLoadClass::ChunkLoadClass -- Constructor for a loader over a memory span               *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *  data - start of the chunk data                                                             *
+ *  size - number of bytes in the span                                                         *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *  The span has to stay valid for the lifetime of the loader                                  *
+ *                                                                                             *
+ *=============================================================================================*/
+ChunkLoadClass::ChunkLoadClass(const void * data, uint32 size) :
+	File(NULL),
+	View(NULL),
+	Memory((const uint8 *)data),
+	MemorySize(size),
+	MemoryPos(0),
+	StackIndex(0),
+	InMicroChunk(false),
+	MicroChunkPosition(0)
+{
+	assert(data != NULL);
+	memset(PositionStack,0,sizeof(PositionStack));
+	memset(HeaderStack,0,sizeof(HeaderStack));
+	memset(&MCHeader,0,sizeof(MCHeader));
+}
+
+
+ChunkLoadClass::~ChunkLoadClass()
+{
+}
+
+
+/*
+** Low level access to whatever the chunks are being read from
+*/
+bool ChunkLoadClass::Source_Read(void * buf, uint32 nbytes)
+{
+	if (Memory != NULL) {
+		Load_View_Position();
+		if (MemorySize - MemoryPos < nbytes) {
+			return false;
+		}
+		memcpy(buf,Memory + MemoryPos,nbytes);
+		MemoryPos += nbytes;
+		Store_View_Position();
+		return true;
+	}
+
+	const size_t clamped_to_int = std::min(static_cast<size_t>(nbytes), static_cast<size_t>(std::numeric_limits<int>::max()));
+	assert(clamped_to_int == nbytes);
+	const int nbytes_int = static_cast<int>(clamped_to_int);
+	return (File->Read(buf, nbytes_int) == nbytes_int);
+}
+
+bool ChunkLoadClass::Source_Skip(uint32 nbytes)
+{
+	if (Memory != NULL) {
+		Load_View_Position();
+		if (MemorySize - MemoryPos < nbytes) {
+			MemoryPos = MemorySize;
+			Store_View_Position();
+			return false;
+		}
+		MemoryPos += nbytes;
+		Store_View_Position();
+		return true;
+	}
+
+	uint32 curpos=File->Tell();
+	return (File->Seek(nbytes,SEEK_CUR)-curpos == (int)nbytes);
+}
+
+// Keep the position of a mapped view and the loader parsing it in place in step both ways:
+// the view's position is picked up before every access, since the caller may seek or read
+// the file between calls, and handed back after it.
+inline void ChunkLoadClass::Load_View_Position()
+{
+	if (View != NULL) {
+		MemoryPos = std::min(View->Get_View_Position(),MemorySize);
+	}
+}
+
+inline void ChunkLoadClass::Store_View_Position()
+{
+	if (View != NULL) {
+		View->Set_View_Position(MemoryPos);
+	}
+}
+
+// Returns false if nbytes would run past the end of the current chunk or micro chunk
+bool ChunkLoadClass::Check_Bounds(uint32 nbytes)
+{
+	const uint32 chunk_size = HeaderStack[StackIndex - 1].Get_Size();
+	const uint32 chunk_pos = PositionStack[StackIndex - 1];
+	if (chunk_pos + nbytes > chunk_size) {
+		return false;
+	}
+
+	if (InMicroChunk) {
+		assert(MicroChunkPosition >= 0);
+		const size_t micro_pos = static_cast<size_t>(MicroChunkPosition);
+		const size_t micro_size = MCHeader.Get_Size();
+		if (micro_pos + nbytes > micro_size) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void ChunkLoadClass::Advance(uint32 nbytes)
+{
+	// Update our position in the chunk
+	PositionStack[StackIndex - 1] += nbytes;
+
+	// Update our position in the micro chunk if we are in one
+	if (InMicroChunk) {
+		MicroChunkPosition += static_cast<int>(nbytes);
+	}
 }
 
 
@@ -435,7 +573,7 @@ bool ChunkLoadClass::Open_Chunk()
 	}
 
 	// read the chunk header
-	if (File->Read(&HeaderStack[StackIndex],sizeof(ChunkHeader)) != sizeof(ChunkHeader)) {
+	if (!Source_Read(&HeaderStack[StackIndex],sizeof(ChunkHeader))) {
 		return false;
 	}
 
@@ -472,12 +610,20 @@ bool ChunkLoadClass::Peek_Next_Chunk(uint32 * set_id,uint32 * set_size)
 
 	// peek at the next chunk header, return false if the read fails
 	ChunkHeader temp_header;
-	if (File->Read(&temp_header,sizeof(ChunkHeader)) != sizeof(ChunkHeader)) {
-		return false;
-	}
+	if (Memory != NULL) {
+		Load_View_Position();
+		if (MemorySize - MemoryPos < sizeof(ChunkHeader)) {
+			return false;
+		}
+		memcpy(&temp_header,Memory + MemoryPos,sizeof(ChunkHeader));
+	} else {
+		if (File->Read(&temp_header,sizeof(ChunkHeader)) != sizeof(ChunkHeader)) {
+			return false;
+		}
 
-	int seek_offset = sizeof(ChunkHeader);
-	File->Seek(-seek_offset,SEEK_CUR);
+		int seek_offset = sizeof(ChunkHeader);
+		File->Seek(-seek_offset,SEEK_CUR);
+	}
 
 	if (set_id != NULL) {
 		*set_id = temp_header.Get_Type();
@@ -513,7 +659,7 @@ bool ChunkLoadClass::Close_Chunk()
 	int pos = PositionStack[StackIndex-1];
 
 	if (pos < csize) {
-		File->Seek(csize - pos,SEEK_CUR);
+		Source_Skip(csize - pos);
 	}
 
 	StackIndex--;
@@ -649,7 +795,7 @@ bool ChunkLoadClass::Close_Micro_Chunk()
 	// seek the file past this micro chunk
 	if (pos < csize) {
 
-		File->Seek(csize - pos,SEEK_CUR);
+		Source_Skip(csize - pos);
 
 		// update the tracking variables for where we are in the normal chunk.
 		if (StackIndex > 0) {
@@ -707,28 +853,16 @@ uint32 ChunkLoadClass::Seek(uint32 nbytes)
 {
 	assert(StackIndex >= 1);
 
-	// Don't seek if we would go past the end of the current chunk
-	if (PositionStack[StackIndex-1] + nbytes > (int)HeaderStack[StackIndex-1].Get_Size()) {
+	// Don't seek if we would go past the end of the current chunk or micro chunk
+	if (!Check_Bounds(nbytes)) {
 		return 0;
 	}
 
-	// Don't read if we are in a micro chunk and would go past the end of it
-	if (InMicroChunk && MicroChunkPosition + nbytes > MCHeader.Get_Size()) {
+	if (!Source_Skip(nbytes)) {
 		return 0;
 	}
 
-	uint32 curpos=File->Tell();
-	if (File->Seek(nbytes,SEEK_CUR)-curpos != (int)nbytes) {
-		return 0;
-	}
-
-	// Update our position in the chunk
-	PositionStack[StackIndex-1] += nbytes;
-
-	// Update our position in the micro chunk if we are in one
-	if (InMicroChunk) {
-		MicroChunkPosition += nbytes;
-	}
+	Advance(nbytes);
 
 	return nbytes;
 }
@@ -749,43 +883,20 @@ uint32 ChunkLoadClass::Read(void * buf,size_t nbytes)
 {
 	assert(StackIndex >= 1);
 
-	// Don't read if we would go past the end of the current chunk
 	const size_t clamped_to_u32 = std::min(nbytes, static_cast<size_t>(std::numeric_limits<uint32>::max()));
 	assert(clamped_to_u32 == nbytes);
 	const uint32 nbytes32 = static_cast<uint32>(clamped_to_u32);
 
-	const uint32 chunk_size = HeaderStack[StackIndex - 1].Get_Size();
-	const uint32 chunk_pos = PositionStack[StackIndex - 1];
-	if (chunk_pos + nbytes32 > chunk_size) {
+	// Don't read if we would go past the end of the current chunk or micro chunk
+	if (!Check_Bounds(nbytes32)) {
 		return 0;
 	}
 
-	// Don't read if we are in a micro chunk and would go past the end of it
-	if (InMicroChunk) {
-		assert(MicroChunkPosition >= 0);
-		const size_t micro_pos = static_cast<size_t>(MicroChunkPosition);
-		const size_t micro_size = MCHeader.Get_Size();
-		if (micro_pos + nbytes32 > micro_size) {
-			return 0;
-		}
-	}
-
-	const size_t clamped_to_int = std::min(clamped_to_u32, static_cast<size_t>(std::numeric_limits<int>::max()));
-	assert(clamped_to_int == clamped_to_u32);
-	const int nbytes_int = static_cast<int>(clamped_to_int);
-
-	if (File->Read(buf, nbytes_int) != nbytes_int) {
+	if (!Source_Read(buf, nbytes32)) {
 		return 0;
 	}
 
-	// Update our position in the chunk
-	PositionStack[StackIndex - 1] += nbytes32;
-
-	// Update our position in the micro chunk if we are in one
-	if (InMicroChunk) {
-		MicroChunkPosition += static_cast<int>(nbytes32);
-	}
-
+	Advance(nbytes32);
 	return nbytes32;
 }
 
@@ -864,4 +975,3 @@ uint32 ChunkLoadClass::Read(IOQuaternionStruct * q)
 	assert(q != NULL);
 	return Read(q,sizeof(*q));
 }
-
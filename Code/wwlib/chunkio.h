@@ -187,18 +187,31 @@ private:
 };
 
 
+class MappedViewFileClass;
+
 /**************************************************************************************
 **
 ** ChunkLoadClass
 ** wrap an instance of one of these objects around an opened file
 ** to easily parse the chunks in the file
 **
+**  When the file is a view of a mapped archive (see MappedViewFileClass) or the
+**  loader is constructed over a memory span, the chunks are parsed straight out of
+**  memory instead of through the virtual FileClass calls.  The loader picks up the
+**  view's position before every access and hands it back after, so the file can be
+**  sought, read directly or handed to another loader at any time, just as with a
+**  file backed loader, and the loader never touches the file again once it is done
+**  reading (callers often close and return the file before the loader goes out of
+**  scope).
+**
 **************************************************************************************/
 class ChunkLoadClass
 {
 public:
 
 	ChunkLoadClass(FileClass * file);
+	ChunkLoadClass(const void * data, uint32 size);
+	~ChunkLoadClass();
 
 	// Chunk methods
 	bool					Open_Chunk();
@@ -224,6 +237,7 @@ public:
 	// Seek over a block of bytes in the stream (same as Read but don't copy the data to a buffer)
 	uint32				Seek(uint32 nbytes);
 
+
 	// Sneak peek at the next chunk that will be opened.  Beware, if you need
 	// this, then you are probably hacking so be careful!
 	bool					Peek_Next_Chunk(uint32 * set_id,uint32 * set_size);
@@ -232,7 +246,20 @@ private:
 
 	enum { MAX_STACK_DEPTH = 256 };
 
+	bool					Source_Read(void * buf, uint32 nbytes);
+	bool					Source_Skip(uint32 nbytes);
+	bool					Check_Bounds(uint32 nbytes);
+	void					Advance(uint32 nbytes);
+	void					Load_View_Position();
+	void					Store_View_Position();
+
 	FileClass *			File;
+	MappedViewFileClass *	View;						// File, when it is a mapped view being parsed in place
+
+	// Memory span support
+	const uint8 *		Memory;
+	uint32				MemorySize;
+	uint32				MemoryPos;
 
 	// Chunk reading support
 	int					StackIndex;
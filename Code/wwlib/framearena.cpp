@@ -0,0 +1,209 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "framearena.h"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+
+std::atomic<unsigned>	FrameArenaClass::_Frame(0);
+
+
+FrameArenaClass::FrameArenaClass(size_t capacity) :
+	Block(NULL),
+	Capacity(capacity),
+	BlockUsed(0),
+	Overflow(NULL),
+	OverflowUsed(0),
+	FrameHighWater(0),
+	AutoGrow(true),
+	ScopeDepth(0),
+	Frame(0)
+{
+	Block = new char[Capacity];
+	memset(&Stats,0,sizeof(Stats));
+	Stats.Capacity = Capacity;
+}
+
+FrameArenaClass::~FrameArenaClass(void)
+{
+	WWASSERT(ScopeDepth == 0);
+	Free_Overflow(NULL);
+	delete [] Block;
+}
+
+void * FrameArenaClass::Alloc(size_t size,size_t alignment)
+{
+	WWASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	Stats.Allocations++;
+	char * ptr = Align(Block + BlockUsed,alignment);
+	if (Overflow == NULL && ptr + size <= Block + Capacity) {
+		size_t used = (ptr + size) - Block;
+		Stats.Used += used - BlockUsed;
+		BlockUsed = used;
+		return ptr;
+	}
+	return Alloc_Overflow(size,alignment);
+}
+
+/*
+** Once the main block has run out everything goes to overflow blocks, so that the arena
+** stays in allocation order and a marker can tell what came after it.
+*/
+void * FrameArenaClass::Alloc_Overflow(size_t size,size_t alignment)
+{
+	Stats.OverflowAllocations++;
+
+	if (Overflow != NULL) {
+		char * base = (char *)Overflow;
+		char * ptr = Align(base + OverflowUsed,alignment);
+		if (ptr + size <= base + sizeof(OverflowBlockStruct) + Overflow->Size) {
+			size_t used = (ptr + size) - base;
+			Stats.Used += used - OverflowUsed;
+			OverflowUsed = used;
+			return ptr;
+		}
+	}
+
+	size_t block_size = std::max(size + alignment,(size_t)OVERFLOW_BLOCK_SIZE);
+	OverflowBlockStruct * block = (OverflowBlockStruct *)malloc(sizeof(OverflowBlockStruct) + block_size);
+	WWASSERT(block != NULL);
+	block->Next = Overflow;
+	block->Size = block_size;
+	Overflow = block;
+
+	char * base = (char *)block;
+	char * ptr = Align(base + sizeof(OverflowBlockStruct),alignment);
+	OverflowUsed = (ptr + size) - base;
+	Stats.Used += size;
+	return ptr;
+}
+
+/*
+** Frees the overflow blocks newer than last.
+*/
+void FrameArenaClass::Free_Overflow(OverflowBlockStruct * last)
+{
+	while (Overflow != last) {
+		WWASSERT(Overflow != NULL);
+		OverflowBlockStruct * next = Overflow->Next;
+		free(Overflow);
+		Overflow = next;
+	}
+}
+
+FrameArenaClass::MarkerStruct FrameArenaClass::Get_Marker(void) const
+{
+	MarkerStruct marker;
+	marker.Used = Stats.Used;
+	marker.Overflow = Overflow;
+	marker.Offset = (Overflow != NULL) ? OverflowUsed : BlockUsed;
+	return marker;
+}
+
+void FrameArenaClass::Rewind(const MarkerStruct & marker)
+{
+	WWASSERT(marker.Used <= Stats.Used);
+
+	/*
+	** Keep track of how much the frame needed before giving it back, for Reset.
+	*/
+	FrameHighWater = std::max(FrameHighWater,Stats.Used);
+
+	Free_Overflow((OverflowBlockStruct *)marker.Overflow);
+	if (Overflow != NULL) {
+		OverflowUsed = marker.Offset;
+	} else {
+		BlockUsed = marker.Offset;
+	}
+	Stats.Used = marker.Used;
+}
+
+void FrameArenaClass::Reset(void)
+{
+	WWASSERT(ScopeDepth == 0);
+
+	size_t frame_used = std::max(Stats.Used,FrameHighWater);
+	bool overflowed = (Overflow != NULL) || (frame_used > Capacity);
+	Free_Overflow(NULL);
+	BlockUsed = 0;
+	OverflowUsed = 0;
+
+	Stats.HighWater = std::max(Stats.HighWater,frame_used);
+	Stats.Used = 0;
+	Stats.Allocations = 0;
+	Stats.OverflowAllocations = 0;
+	Stats.Frames++;
+
+	/*
+	** Grow to what the frame needed plus a quarter again, so a frame that needs a little
+	** more than the last one doesn't overflow again straight away.  The frame can have
+	** overflowed with room to spare if the last allocation didn't fit in what was left.
+	*/
+	if (overflowed) {
+		Stats.OverflowFrames++;
+		if (AutoGrow && Capacity < MAX_CAPACITY) {
+			delete [] Block;
+			size_t needed = std::max(frame_used,Capacity);
+			Capacity = std::min(needed + needed / 4,(size_t)MAX_CAPACITY);
+			Block = new char[Capacity];
+			Stats.Capacity = Capacity;
+			Stats.Grows++;
+		}
+	}
+	FrameHighWater = 0;
+}
+
+bool FrameArenaClass::Owns(const void * ptr) const
+{
+	if (ptr >= Block && ptr < Block + Capacity) {
+		return true;
+	}
+	for (OverflowBlockStruct * block = Overflow; block != NULL; block = block->Next) {
+		if (ptr >= block + 1 && ptr < (char *)(block + 1) + block->Size) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+** Clears the counts that run across frames; the ones for the current frame are kept.
+*/
+void FrameArenaClass::Reset_Stats(void)
+{
+	Stats.HighWater = 0;
+	Stats.Frames = 0;
+	Stats.OverflowFrames = 0;
+	Stats.Grows = 0;
+}
+
+FrameArenaClass & FrameArenaClass::Thread_Arena(void)
+{
+	static thread_local FrameArenaClass _arena;
+
+	unsigned frame = _Frame.load(std::memory_order_relaxed);
+	if (_arena.Frame != frame && _arena.ScopeDepth == 0) {
+		_arena.Frame = frame;
+		_arena.Reset();
+	}
+	return _arena;
+}
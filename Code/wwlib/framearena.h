@@ -0,0 +1,268 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "always.h"
+#include "vector.h"
+#include "wwdebug.h"
+
+#include <atomic>
+#include <new>
+#include <stddef.h>
+#include <type_traits>
+
+/**
+** FrameArenaClass
+** Linear allocator for scratch memory that only lives until the end of the frame: result
+** lists, temporary arrays and the like.  Allocating just bumps a pointer through one big
+** block and nothing is ever freed on its own; the whole arena is emptied at once by Reset,
+** or back to an earlier point by Rewind.  No destructors are run, so only put things in
+** it that don't need one.
+**
+** When the block runs out the arena carries on in overflow blocks taken from the heap,
+** which are freed by the next Reset.  If a frame overflowed, Reset grows the block to fit
+** that frame so the next one doesn't have to.
+**
+** Every thread has an arena of its own in Thread_Arena.  Begin_Frame marks the start of
+** a frame, and each thread arena resets itself the first time it's used in a new frame,
+** so memory from it is good until the thread next asks for its arena after the frame
+** ends.  An arena isn't thread safe; only the thread it belongs to may use it.
+*/
+class FrameArenaClass
+{
+public:
+
+	enum
+	{
+		DEFAULT_CAPACITY		= 256 * 1024,
+		MAX_CAPACITY			= 64 * 1024 * 1024,
+		OVERFLOW_BLOCK_SIZE	= 64 * 1024,
+		DEFAULT_ALIGNMENT		= alignof(max_align_t),
+	};
+
+	struct StatsStruct
+	{
+		size_t			Capacity;				// size of the main block
+		size_t			Used;						// bytes handed out since the last reset, overflow included
+		size_t			HighWater;				// most bytes used in one frame since the stats were reset
+		int				Allocations;			// allocations since the last reset
+		int				OverflowAllocations;	// allocations since the last reset that went to an overflow block
+		int				Frames;					// resets since the stats were reset
+		int				OverflowFrames;		// of those, the ones that found the arena had overflowed
+		int				Grows;					// times the main block was grown since the stats were reset
+	};
+
+	/*
+	** Where the arena is up to, for Rewind.
+	*/
+	struct MarkerStruct
+	{
+		size_t			Used;
+		void *			Overflow;			// overflow block being allocated from, if any
+		size_t			Offset;				// bytes used in it, or in the main block
+	};
+
+	FrameArenaClass(size_t capacity = DEFAULT_CAPACITY);
+	~FrameArenaClass(void);
+
+	/*
+	** Allocation.  Alloc_Array default constructs the elements, so they have to be
+	** trivially destructible.
+	*/
+	void *					Alloc(size_t size,size_t alignment = DEFAULT_ALIGNMENT);
+	template<class T> T *	Alloc_Array(int count);
+
+	/*
+	** Emptying the arena.  Rewind gives back everything allocated since the marker was
+	** taken; Reset gives back everything and counts a frame in the stats.
+	*/
+	MarkerStruct			Get_Marker(void) const;
+	void						Rewind(const MarkerStruct & marker);
+	void						Reset(void);
+
+	/*
+	** Whether Reset may grow the main block when a frame overflows.  Defaults to true.
+	*/
+	void						Set_Auto_Grow(bool onoff)			{ AutoGrow = onoff; }
+
+	bool						Owns(const void * ptr) const;
+	size_t					Get_Used(void) const					{ return Stats.Used; }
+	const StatsStruct &	Get_Stats(void) const				{ return Stats; }
+	void						Reset_Stats(void);
+
+	/*
+	** Per-thread arenas and the frame they are on.
+	*/
+	static FrameArenaClass &	Thread_Arena(void);
+	static void						Begin_Frame(void)				{ _Frame.fetch_add(1,std::memory_order_relaxed); }
+	static unsigned				Get_Frame(void)				{ return _Frame.load(std::memory_order_relaxed); }
+
+private:
+
+	FrameArenaClass(const FrameArenaClass &);
+	FrameArenaClass & operator = (const FrameArenaClass &);
+
+	struct OverflowBlockStruct
+	{
+		OverflowBlockStruct *	Next;			// older block
+		size_t						Size;			// bytes after the header
+	};
+
+	void *					Alloc_Overflow(size_t size,size_t alignment);
+	void						Free_Overflow(OverflowBlockStruct * last);
+	static char *			Align(char * ptr,size_t alignment)	{ return (char *)(((size_t)ptr + alignment - 1) & ~(alignment - 1)); }
+
+	char *					Block;
+	size_t					Capacity;
+	size_t					BlockUsed;
+	OverflowBlockStruct *	Overflow;			// newest overflow block, the one being allocated from
+	size_t					OverflowUsed;		// bytes used in it, header included
+	size_t					FrameHighWater;	// most bytes used at once since the last reset
+	bool						AutoGrow;
+	int						ScopeDepth;
+	unsigned					Frame;
+	StatsStruct				Stats;
+
+	static std::atomic<unsigned>	_Frame;
+
+	friend class FrameArenaScopeClass;
+};
+
+template<class T>
+T * FrameArenaClass::Alloc_Array(int count)
+{
+	static_assert(std::is_trivially_destructible<T>::value,"frame arena objects are never destroyed");
+	WWASSERT(count >= 0);
+	T * array = (T *)Alloc(count * sizeof(T),alignof(T));
+	for (int i = 0; i < count; i++) {
+		new (array + i) T;
+	}
+	return array;
+}
+
+
+/**
+** FrameArenaScopeClass
+** Sentry which gives back everything allocated from an arena during its lifetime.  While
+** one is open on a thread arena, the arena doesn't reset itself for a new frame.
+*/
+class FrameArenaScopeClass
+{
+public:
+	FrameArenaScopeClass(FrameArenaClass & arena = FrameArenaClass::Thread_Arena()) :
+		Arena(arena),
+		Marker(arena.Get_Marker())
+	{
+		Arena.ScopeDepth++;
+	}
+
+	~FrameArenaScopeClass(void)
+	{
+		Arena.ScopeDepth--;
+		Arena.Rewind(Marker);
+	}
+
+	FrameArenaClass &		Get_Arena(void)				{ return Arena; }
+
+private:
+	FrameArenaScopeClass(const FrameArenaScopeClass &);
+	FrameArenaScopeClass & operator = (const FrameArenaScopeClass &);
+
+	FrameArenaClass &					Arena;
+	FrameArenaClass::MarkerStruct	Marker;
+};
+
+
+/**
+** FrameArenaSTLAllocator
+** STL allocator taking memory from a frame arena (the calling thread's by default).
+** Deallocating does nothing; the memory comes back when the arena is emptied, so the
+** container must be gone by then.
+*/
+template<class T>
+class FrameArenaSTLAllocator
+{
+public:
+	typedef T	value_type;
+
+	FrameArenaSTLAllocator(void) : Arena(&FrameArenaClass::Thread_Arena())	{}
+	FrameArenaSTLAllocator(FrameArenaClass & arena) : Arena(&arena)				{}
+	template<class T1> FrameArenaSTLAllocator(const FrameArenaSTLAllocator<T1> & that) : Arena(that.Arena) {}
+
+	T *		allocate(size_t n)					{ return (T *)Arena->Alloc(n * sizeof(T),alignof(T)); }
+	void		deallocate(T *,size_t)				{}
+
+	FrameArenaClass *		Arena;
+};
+
+template<class T,class T1>
+WWINLINE bool operator == (const FrameArenaSTLAllocator<T> & a,const FrameArenaSTLAllocator<T1> & b) { return a.Arena == b.Arena; }
+template<class T,class T1>
+WWINLINE bool operator != (const FrameArenaSTLAllocator<T> & a,const FrameArenaSTLAllocator<T1> & b) { return a.Arena != b.Arena; }
+
+
+/**
+** FrameArenaVectorClass
+** DynamicVectorClass whose array lives in a frame arena (the calling thread's by default).
+** It doubles when it fills up rather than growing by the growth step, and the arrays it
+** outgrows stay in the arena until it is emptied.  The vector must be gone by then.
+*/
+template<class T>
+class FrameArenaVectorClass : public DynamicVectorClass<T>
+{
+	static_assert(std::is_trivially_destructible<T>::value,"frame arena objects are never destroyed");
+
+public:
+	FrameArenaVectorClass(int size = 0,FrameArenaClass & arena = FrameArenaClass::Thread_Arena()) :
+		Arena(arena)
+	{
+		if (size > 0) {
+			Resize(size);
+		}
+	}
+
+	virtual bool		Resize(int newsize,T const * array = 0) override
+	{
+		if (newsize > 0 && array == NULL) {
+			array = (T const *)Arena.Alloc(newsize * sizeof(T),alignof(T));
+		}
+		return DynamicVectorClass<T>::Resize(newsize,array);
+	}
+
+	/*
+	** DynamicVectorClass only grows arrays it allocated itself, so make room before
+	** handing over.
+	*/
+	bool					Add(T const & object)					{ Grow_If_Full(); return DynamicVectorClass<T>::Add(object); }
+	bool					Add_Head(T const & object)				{ Grow_If_Full(); return DynamicVectorClass<T>::Add_Head(object); }
+	bool					Insert(int index,T const & object)	{ Grow_If_Full(); return DynamicVectorClass<T>::Insert(index,object); }
+	T *					Uninitialized_Add(void)					{ Grow_If_Full(); return DynamicVectorClass<T>::Uninitialized_Add(); }
+
+private:
+	FrameArenaVectorClass(const FrameArenaVectorClass &);
+	FrameArenaVectorClass & operator = (const FrameArenaVectorClass &);
+
+	void					Grow_If_Full(void)
+	{
+		if (this->ActiveCount >= this->VectorMax) {
+			Resize(this->VectorMax > 0 ? this->VectorMax * 2 : 16);
+		}
+	}
+
+	FrameArenaClass &		Arena;
+};
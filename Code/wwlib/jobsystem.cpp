@@ -0,0 +1,436 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "jobsystem.h"
+#include "thread.h"
+#include "wwprofile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+
+/*
+** The job system and queue slot of the calling thread, set for worker threads only.
+*/
+static thread_local JobSystemClass *	_CurrentSystem = NULL;
+static thread_local int						_CurrentSlot = 0;
+
+
+/**
+** JobQueueClass
+** One thread's queue of jobs.  The owner pushes and pops at the back, other threads steal
+** from the front.  Size mirrors the count so that thieves can skip empty queues without
+** taking the lock.
+*/
+class JobQueueClass
+{
+public:
+	JobQueueClass(void) : Jobs(NULL), Capacity(0), Head(0), Count(0), Size(0)	{ }
+	~JobQueueClass(void)																		{ delete [] Jobs; }
+
+	void				Push(const JobStruct & job);
+	bool				Pop(JobStruct & job);
+	bool				Steal(JobStruct & job);
+	bool				Is_Empty(void) const		{ return Size.load(std::memory_order_relaxed) == 0; }
+
+private:
+	void				Grow(void);
+
+	std::mutex			Mutex;
+	JobStruct *			Jobs;				// ring buffer, Capacity is a power of two
+	int					Capacity;
+	int					Head;				// oldest job
+	int					Count;
+	std::atomic<int>	Size;
+};
+
+void JobQueueClass::Grow(void)
+{
+	int capacity = MAX(Capacity * 2,64);
+	JobStruct * jobs = new JobStruct[capacity];
+	for (int i=0; i<Count; i++) {
+		jobs[i] = Jobs[(Head + i) & (Capacity - 1)];
+	}
+	delete [] Jobs;
+	Jobs = jobs;
+	Capacity = capacity;
+	Head = 0;
+}
+
+void JobQueueClass::Push(const JobStruct & job)
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	if (Count == Capacity) {
+		Grow();
+	}
+	Jobs[(Head + Count) & (Capacity - 1)] = job;
+	Count++;
+	Size.store(Count,std::memory_order_relaxed);
+}
+
+bool JobQueueClass::Pop(JobStruct & job)
+{
+	if (Is_Empty()) {
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(Mutex);
+	if (Count == 0) {
+		return false;
+	}
+	Count--;
+	job = Jobs[(Head + Count) & (Capacity - 1)];
+	Size.store(Count,std::memory_order_relaxed);
+	return true;
+}
+
+bool JobQueueClass::Steal(JobStruct & job)
+{
+	if (Is_Empty()) {
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(Mutex);
+	if (Count == 0) {
+		return false;
+	}
+	job = Jobs[Head];
+	Head = (Head + 1) & (Capacity - 1);
+	Count--;
+	Size.store(Count,std::memory_order_relaxed);
+	return true;
+}
+
+
+/**
+** JobWorkerClass
+** One worker thread of the job system.
+*/
+class JobWorkerClass : public ThreadClass
+{
+public:
+	JobWorkerClass(JobSystemClass * system,int slot,const char * name) :
+		ThreadClass(name),
+		System(system),
+		Slot(slot)
+	{
+	}
+
+protected:
+	virtual void Thread_Function(void) override;
+
+	JobSystemClass *	System;
+	int					Slot;
+};
+
+void JobWorkerClass::Thread_Function(void)
+{
+	_CurrentSystem = System;
+	_CurrentSlot = Slot;
+
+	for (;;) {
+		if (System->Run_One(Slot)) {
+			continue;
+		}
+
+		/*
+		** Nothing to do.  A job pushed after the check above sees SleepingWorkers and
+		** takes the pool lock to wake us, so it can't be missed.
+		*/
+		std::unique_lock<std::mutex> lock(System->PoolMutex);
+		System->SleepingWorkers++;
+		System->WakeEvent.wait(lock,[this] { return System->Quit || System->QueuedJobs > 0; });
+		System->SleepingWorkers--;
+		if (System->Quit) {
+			return;
+		}
+	}
+}
+
+
+/*
+** JobSystemClass
+*/
+JobSystemClass::JobSystemClass(void) :
+	ThreadCount(1),
+	OwnerThread(ThreadClass::Get_Current_Thread_ID()),
+	WorkerCount(0),
+	QueuedJobs(0),
+	SleepingWorkers(0),
+	Quit(false),
+	JobsRun(0),
+	JobsStolen(0)
+{
+	memset(Workers,0,sizeof(Workers));
+	for (int i=0; i<MAX_THREADS; i++) {
+		Queues[i] = new JobQueueClass;
+	}
+	for (int i=0; i<MAX_PROFILED_JOBS; i++) {
+		Profiles[i].Name = NULL;
+		Profiles[i].Calls = 0;
+		Profiles[i].Nanoseconds = 0;
+	}
+}
+
+JobSystemClass::~JobSystemClass(void)
+{
+	WWASSERT(QueuedJobs == 0);
+	Stop_Workers();
+	for (int i=0; i<MAX_THREADS; i++) {
+		delete Queues[i];
+	}
+}
+
+JobSystemClass & JobSystemClass::Get_Shared(void)
+{
+	static JobSystemClass _shared;
+	return _shared;
+}
+
+void JobSystemClass::Set_Thread_Count(int count)
+{
+	WWASSERT(QueuedJobs == 0);
+
+	count = std::clamp(count,1,(int)MAX_THREADS);
+	if (count != ThreadCount) {
+		Stop_Workers();
+		ThreadCount = count;
+		Start_Workers();
+	}
+}
+
+void JobSystemClass::Start_Workers(void)
+{
+	WWASSERT(WorkerCount == 0);
+
+	Quit = false;
+	for (int i=1; i<ThreadCount; i++) {
+		char name[32];
+		snprintf(name,sizeof(name),"Job%d",i);
+		Workers[WorkerCount] = new JobWorkerClass(this,i,name);
+		Workers[WorkerCount]->Execute();
+		WorkerCount++;
+	}
+}
+
+void JobSystemClass::Stop_Workers(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(PoolMutex);
+		Quit = true;
+	}
+	WakeEvent.notify_all();
+
+	for (int i=0; i<WorkerCount; i++) {
+		Workers[i]->Stop();
+		delete Workers[i];
+		Workers[i] = NULL;
+	}
+	WorkerCount = 0;
+}
+
+int JobSystemClass::Get_Slot(void) const
+{
+	if (_CurrentSystem == this) {
+		return _CurrentSlot;
+	}
+
+	// anybody else would share the owner's queue and per thread data
+	WWASSERT(ThreadClass::Get_Current_Thread_ID() == OwnerThread);
+	return 0;
+}
+
+void JobSystemClass::Run(JobFunctionType function,void * data,JobCounterClass * counter,const char * name)
+{
+	WWASSERT(function != NULL);
+
+	if (counter != NULL) {
+		counter->Count++;
+	}
+
+	JobStruct job;
+	job.Function = function;
+	job.Data = data;
+	job.Name = name;
+	job.Counter = counter;
+	Submit(job);
+}
+
+void JobSystemClass::Run_After(JobCounterClass & dependency,JobFunctionType function,void * data,JobCounterClass * counter,const char * name)
+{
+	WWASSERT(function != NULL);
+	WWASSERT(&dependency != counter);
+
+	if (counter != NULL) {
+		counter->Count++;
+	}
+
+	JobStruct job;
+	job.Function = function;
+	job.Data = data;
+	job.Name = name;
+	job.Counter = counter;
+
+	/*
+	** The last job of the dependency takes the waiting list under the same lock after its
+	** count gets to zero, so the job is either parked in time or started here.
+	*/
+	{
+		std::lock_guard<std::mutex> lock(dependency.WaitingMutex);
+		if (dependency.Count > 0) {
+			dependency.Waiting.Add(job);
+			return;
+		}
+	}
+	Submit(job);
+}
+
+void JobSystemClass::Submit(const JobStruct & job)
+{
+	if (Is_Deterministic()) {
+		Execute(job);
+		return;
+	}
+
+	Queues[Get_Slot()]->Push(job);
+	QueuedJobs++;
+	if (SleepingWorkers > 0) {
+		{
+			std::lock_guard<std::mutex> lock(PoolMutex);
+		}
+		WakeEvent.notify_one();
+	}
+}
+
+bool JobSystemClass::Run_One(int slot)
+{
+	JobStruct job;
+	if (Queues[slot]->Pop(job)) {
+		QueuedJobs--;
+		Execute(job);
+		return true;
+	}
+
+	for (int i=1; i<ThreadCount; i++) {
+		int victim = slot + i;
+		if (victim >= ThreadCount) {
+			victim -= ThreadCount;
+		}
+		if (Queues[victim]->Steal(job)) {
+			QueuedJobs--;
+			JobsStolen++;
+			Execute(job);
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystemClass::Execute(const JobStruct & job)
+{
+	if (job.Name != NULL) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		job.Function(job.Data);
+		Record_Profile(job.Name,std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	} else {
+		job.Function(job.Data);
+	}
+	JobsRun++;
+	Finish(job.Counter);
+}
+
+void JobSystemClass::Finish(JobCounterClass * counter)
+{
+	if (counter == NULL) {
+		return;
+	}
+
+	/*
+	** Busy keeps Wait_For from returning, and the counter from going away, until this
+	** thread is done with it.
+	*/
+	counter->Busy++;
+	if (--counter->Count == 0) {
+		DynamicVectorClass<JobStruct> ready;
+		{
+			std::lock_guard<std::mutex> lock(counter->WaitingMutex);
+			for (int i=0; i<counter->Waiting.Count(); i++) {
+				ready.Add(counter->Waiting[i]);
+			}
+			counter->Waiting.Reset_Active();
+		}
+		counter->Busy--;
+
+		for (int i=0; i<ready.Count(); i++) {
+			Submit(ready[i]);
+		}
+		return;
+	}
+	counter->Busy--;
+}
+
+void JobSystemClass::Wait_For(JobCounterClass & counter)
+{
+	if (Is_Deterministic()) {
+		WWASSERT(counter.Is_Done());		// waiting on a dependency which never finishes
+	} else {
+		int slot = Get_Slot();
+		while (!counter.Is_Done()) {
+			if (!Run_One(slot)) {
+				ThreadClass::Switch_Thread();
+			}
+		}
+	}
+
+	if (ThreadClass::Get_Current_Thread_ID() == OwnerThread) {
+		Flush_Profile();
+	}
+}
+
+void JobSystemClass::Record_Profile(const char * name,long long nanoseconds)
+{
+	for (int i=0; i<MAX_PROFILED_JOBS; i++) {
+		const char * slot_name = Profiles[i].Name;
+		if (slot_name == NULL && Profiles[i].Name.compare_exchange_strong(slot_name,name)) {
+			slot_name = name;
+		}
+
+		// a failed exchange leaves the name another thread got in first in slot_name
+		if (slot_name != name && strcmp(slot_name,name) != 0) {
+			continue;
+		}
+		Profiles[i].Calls++;
+		Profiles[i].Nanoseconds += nanoseconds;
+		return;
+	}
+}
+
+void JobSystemClass::Flush_Profile(void)
+{
+	for (int i=0; i<MAX_PROFILED_JOBS; i++) {
+		const char * name = Profiles[i].Name;
+		if (name == NULL) {
+			return;
+		}
+		int calls = Profiles[i].Calls.exchange(0);
+		long long nanoseconds = Profiles[i].Nanoseconds.exchange(0);
+		if (calls > 0) {
+			WWProfileManager::Add_Profile(name,calls,(float)(nanoseconds * 1.0e-9));
+		}
+	}
+}
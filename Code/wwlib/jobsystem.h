@@ -0,0 +1,283 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "always.h"
+#include "vector.h"
+#include "wwdebug.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+class JobSystemClass;
+class JobQueueClass;
+class JobWorkerClass;
+
+
+typedef void (*JobFunctionType)(void * data);
+
+/*
+** One queued job.  The name is optional; named jobs are timed (see JobSystemClass).
+*/
+struct JobStruct
+{
+	bool operator== (const JobStruct &)	{ return false; }
+	bool operator!= (const JobStruct &)	{ return true; }
+
+	JobFunctionType		Function;
+	void *					Data;
+	const char *			Name;
+	class JobCounterClass *	Counter;
+};
+
+
+/**
+** JobCounterClass
+** Counts the jobs that were started with it and haven't finished yet.  Wait on it to join
+** them, or hand it to JobSystemClass::Run_After to hold other jobs back until it is done.
+** A counter has to outlive the jobs that use it, which Wait_For takes care of.
+*/
+class JobCounterClass
+{
+public:
+
+	JobCounterClass(void) : Count(0), Busy(0)		{ }
+	~JobCounterClass(void)								{ WWASSERT(Is_Done() && Waiting.Count() == 0); }
+
+	bool				Is_Done(void) const				{ return Count == 0 && Busy == 0; }
+	int				Get_Count(void) const			{ return Count; }
+
+private:
+
+	JobCounterClass(const JobCounterClass &);
+	JobCounterClass & operator = (const JobCounterClass &);
+
+	std::atomic<int>					Count;		// jobs not finished yet
+	std::atomic<int>					Busy;			// threads still finishing a job of this counter
+	std::mutex							WaitingMutex;
+	DynamicVectorClass<JobStruct>	Waiting;		// jobs to start once Count gets to zero
+
+	friend class JobSystemClass;
+};
+
+
+/**
+** JobSystemClass
+** A pool of worker threads which run small jobs.  Every thread has its own queue; a thread
+** runs the newest job of its own queue first and, when that is empty, steals the oldest
+** job from another, so jobs which start more jobs keep their data warm on one thread while
+** the other threads take the bigger, older pieces.  Besides the workers, only the thread
+** that made the job system may start or wait for jobs; it uses the first queue.
+**
+** Waiting for a counter runs queued jobs instead of blocking, so jobs can start more jobs
+** and wait for them (fork/join) without tying up the pool.  Parallel_For and Fork_Join
+** are built on that.
+**
+** With a thread count of one there are no workers and every job runs on the calling thread
+** as soon as it is started (or, with Run_After, as soon as its dependency is done), always
+** in the same order.  Use that to debug anything that goes wrong with threads.
+**
+** Get_Shared returns the job system the engine's subsystems share, so that they don't each
+** keep a pool of their own.  It starts out deterministic; the job_threads console command
+** or the program sets its thread count.  Tools which time one subsystem can make their own
+** and hand it to that subsystem instead.
+**
+** Named jobs are timed on whatever thread runs them, and added up by name.  The first
+** pointer seen for a name is kept and handed to the profiler, so names have to outlive
+** the job system (string literals do).  The totals are handed to
+** WWProfileManager as children of the current profile node whenever the thread that made
+** the job system finishes a Wait_For, so they show up under the WWPROFILE scope that waited.
+** They add up the time on every thread, and a job's time includes any jobs it ran while it
+** waited for others.
+*/
+class JobSystemClass
+{
+public:
+
+	enum
+	{
+		MAX_THREADS = 16,
+		MAX_PROFILED_JOBS = 64,
+	};
+
+	JobSystemClass(void);
+	~JobSystemClass(void);
+
+	static JobSystemClass &	Get_Shared(void);
+
+	/*
+	** Number of threads to use, including the calling thread.  One gives the deterministic
+	** mode.  Only change it while no jobs are running.
+	*/
+	void				Set_Thread_Count(int count);
+	int				Get_Thread_Count(void) const		{ return ThreadCount; }
+	bool				Is_Deterministic(void) const		{ return ThreadCount <= 1; }
+
+	/*
+	** Which of the Get_Thread_Count threads this is, from zero, for picking per thread data.
+	** The thread that made the job system gets zero and the workers the rest; no other
+	** thread may ask, since it would share a slot with one of them.
+	*/
+	int				Get_Thread_Slot(void) const		{ return Get_Slot(); }
+
+	/*
+	** Start a job.  The counter, if there is one, counts it until it has finished.
+	** Run_After holds the job back until the dependency counter is done.
+	*/
+	void				Run(JobFunctionType function,void * data,JobCounterClass * counter = NULL,const char * name = NULL);
+	void				Run_After(JobCounterClass & dependency,JobFunctionType function,void * data,JobCounterClass * counter = NULL,const char * name = NULL);
+
+	/*
+	** Run jobs until every job of the counter has finished.
+	*/
+	void				Wait_For(JobCounterClass & counter);
+
+	/*
+	** Call func(first,last) over [0,count) in runs of batch_size, spread over the threads,
+	** and wait for them all.
+	*/
+	template <class T> void	Parallel_For(int count,int batch_size,const T & func,const char * name = NULL);
+
+	/*
+	** Call a() and b(), possibly at the same time, and wait for both.  b is started as a
+	** job, so in the deterministic mode it runs first.
+	*/
+	template <class A,class B> void	Fork_Join(const A & a,const B & b,const char * name = NULL);
+
+	/*
+	** Hand the job times collected so far to WWProfileManager.  Wait_For does this itself
+	** on the thread that made the job system.
+	*/
+	void				Flush_Profile(void);
+
+	/*
+	** Jobs run and jobs taken from another thread's queue since the last reset.
+	*/
+	int				Get_Jobs_Run(void) const			{ return JobsRun; }
+	int				Get_Jobs_Stolen(void) const		{ return JobsStolen; }
+	void				Reset_Stats(void)						{ JobsRun = 0; JobsStolen = 0; }
+
+private:
+
+	struct ProfileStruct
+	{
+		std::atomic<const char *>	Name;
+		std::atomic<int>				Calls;
+		std::atomic<long long>		Nanoseconds;
+	};
+
+	template <class T> struct ParallelForStruct
+	{
+		const T *			Func;
+		int					Count;
+		int					BatchSize;
+		std::atomic<int>	Next;
+	};
+
+	template <class T> static void	Parallel_For_Job(void * data);
+	template <class T> static void	Call_Job(void * data);
+
+	int				Get_Slot(void) const;
+	void				Submit(const JobStruct & job);
+	bool				Run_One(int slot);
+	void				Execute(const JobStruct & job);
+	void				Finish(JobCounterClass * counter);
+	void				Record_Profile(const char * name,long long nanoseconds);
+
+	void				Start_Workers(void);
+	void				Stop_Workers(void);
+
+	int						ThreadCount;
+	unsigned					OwnerThread;
+	JobQueueClass *		Queues[MAX_THREADS];
+
+	/*
+	** Worker pool.  Idle workers sleep on WakeEvent until there is something queued.
+	*/
+	JobWorkerClass *		Workers[MAX_THREADS];
+	int						WorkerCount;
+	std::mutex				PoolMutex;
+	std::condition_variable	WakeEvent;
+	std::atomic<int>		QueuedJobs;
+	std::atomic<int>		SleepingWorkers;
+	bool						Quit;
+
+	std::atomic<int>		JobsRun;
+	std::atomic<int>		JobsStolen;
+
+	ProfileStruct			Profiles[MAX_PROFILED_JOBS];
+
+	friend class JobWorkerClass;
+};
+
+
+template <class T>
+void JobSystemClass::Parallel_For_Job(void * data)
+{
+	ParallelForStruct<T> * job = (ParallelForStruct<T> *)data;
+	for (;;) {
+		int first = job->Next.fetch_add(job->BatchSize);
+		if (first >= job->Count) {
+			return;
+		}
+		(*job->Func)(first,MIN(first + job->BatchSize,job->Count));
+	}
+}
+
+template <class T>
+void JobSystemClass::Call_Job(void * data)
+{
+	(*(const T *)data)();
+}
+
+template <class T>
+void JobSystemClass::Parallel_For(int count,int batch_size,const T & func,const char * name)
+{
+	if (count <= 0) {
+		return;
+	}
+	batch_size = MAX(batch_size,1);
+
+	/*
+	** One job per thread, each pulling batches until they run out.  In the deterministic
+	** mode the first job takes every batch, in order.
+	*/
+	ParallelForStruct<T> job;
+	job.Func = &func;
+	job.Count = count;
+	job.BatchSize = batch_size;
+	job.Next = 0;
+
+	int jobs = MIN((count + batch_size - 1) / batch_size,ThreadCount);
+	JobCounterClass counter;
+	for (int i=0; i<jobs; i++) {
+		Run(&Parallel_For_Job<T>,&job,&counter,name);
+	}
+	Wait_For(counter);
+}
+
+template <class A,class B>
+void JobSystemClass::Fork_Join(const A & a,const B & b,const char * name)
+{
+	JobCounterClass counter;
+	Run(&Call_Job<B>,(void *)&b,&counter,name);
+	a();
+	Wait_For(counter);
+}
@@ -0,0 +1,129 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mappedfile.h"
+#include "wwdebug.h"
+
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+MappedFileClass::MappedFileClass(void) :
+	Data(NULL),
+	Size(0),
+#ifdef _WIN32
+	FileHandle(INVALID_HANDLE_VALUE),
+	MappingHandle(NULL)
+#else
+	FileDescriptor(-1)
+#endif
+{
+}
+
+MappedFileClass::~MappedFileClass(void)
+{
+	Unmap();
+}
+
+bool MappedFileClass::Map(const char *filename)
+{
+	WWASSERT(filename != NULL);
+	Unmap();
+
+#ifdef _WIN32
+	FileHandle = ::CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (FileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!::GetFileSizeEx(FileHandle, &file_size) || file_size.QuadPart == 0 || file_size.HighPart != 0) {
+		Unmap();
+		return false;
+	}
+
+	MappingHandle = ::CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (MappingHandle == NULL) {
+		Unmap();
+		return false;
+	}
+
+	Data = ::MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (Data == NULL) {
+		Unmap();
+		return false;
+	}
+	Size = file_size.LowPart;
+#else
+	FileDescriptor = ::open(filename, O_RDONLY);
+	if (FileDescriptor < 0) {
+		return false;
+	}
+
+	struct stat info;
+	if (::fstat(FileDescriptor, &info) != 0 || info.st_size == 0 || (uint64_t)info.st_size > 0xffffffffu) {
+		Unmap();
+		return false;
+	}
+
+	void *view = ::mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, FileDescriptor, 0);
+	if (view == MAP_FAILED) {
+		Unmap();
+		return false;
+	}
+	Data = view;
+	Size = (unsigned)info.st_size;
+#endif
+
+	return true;
+}
+
+void MappedFileClass::Unmap(void)
+{
+#ifdef _WIN32
+	if (Data != NULL) {
+		::UnmapViewOfFile(Data);
+	}
+	if (MappingHandle != NULL) {
+		::CloseHandle(MappingHandle);
+		MappingHandle = NULL;
+	}
+	if (FileHandle != INVALID_HANDLE_VALUE) {
+		::CloseHandle(FileHandle);
+		FileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (Data != NULL) {
+		::munmap(const_cast<void *>(Data), Size);
+	}
+	if (FileDescriptor >= 0) {
+		::close(FileDescriptor);
+		FileDescriptor = -1;
+	}
+#endif
+	Data = NULL;
+	Size = 0;
+}
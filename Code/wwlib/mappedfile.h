@@ -0,0 +1,112 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "always.h"
+#include "ramfile.h"
+#include "wwstring.h"
+
+// ****************************************************************************
+//
+// MappedFileClass maps a whole file read-only into the address space. The
+// mapping is shared, so several processes mapping the same file share the
+// same physical pages. The view stays valid until Unmap() is called or the
+// object is destroyed.
+//
+// ****************************************************************************
+
+class MappedFileClass
+{
+public:
+	MappedFileClass(void);
+	~MappedFileClass(void);
+
+	bool				Map(const char *filename);
+	void				Unmap(void);
+
+	bool				Is_Mapped(void) const		{ return Data != NULL; }
+	const void *	Get_Data(void) const			{ return Data; }
+	unsigned			Get_Size(void) const			{ return Size; }
+
+private:
+	MappedFileClass(const MappedFileClass &);
+	MappedFileClass &operator=(const MappedFileClass &);
+
+	const void *	Data;
+	unsigned			Size;
+
+#ifdef _WIN32
+	void *			FileHandle;
+	void *			MappingHandle;
+#else
+	int				FileDescriptor;
+#endif
+};
+
+
+// ****************************************************************************
+//
+// MappedViewFileClass is a read-only FileClass over a range of a mapping.
+// Reads copy out of the mapped pages, Get_View_Data() gives callers that can
+// use the bytes in place a pointer without any copy at all. The view doesn't
+// own the mapping, which has to outlive it.
+//
+// ****************************************************************************
+
+class MappedViewFileClass : public RAMFileClass
+{
+public:
+	MappedViewFileClass(const void *data, unsigned size, const char *filename) :
+		RAMFileClass(const_cast<void *>(data), (int)size),
+		ViewData(data),
+		ViewSize(size),
+		Filename(filename)
+	{
+	}
+
+	const void *					Get_View_Data(void) const		{ return ViewData; }
+	unsigned							Get_View_Size(void) const		{ return ViewSize; }
+
+	// Reads and moves the position without going through the virtual Seek, for loaders
+	// that parse the view in place and keep the position in step as they go.
+	unsigned							Get_View_Position(void)				{ return (unsigned)RAMFileClass::Seek(0, SEEK_CUR); }
+	void								Set_View_Position(unsigned pos)	{ RAMFileClass::Seek((int)pos, SEEK_SET); }
+
+	virtual char const *			File_Name(void) const override			{ return Filename; }
+	virtual int						Open(char const *, int access=READ) override	{ return Open(access); }
+	virtual int						Open(int access=READ) override			{ return (access == READ) ? RAMFileClass::Open(READ) : false; }
+	virtual int						Write(void const *, int) override		{ return 0; }
+	virtual void					Bias(int start, int length=-1) override
+	{
+		// RAMFileClass::Bias takes the length literally, so turn -1 into "the rest of the
+		// view" the way RawFileClass does and keep the range inside the view.
+		const int view_size = (int)ViewSize;
+		start = (start < 0) ? 0 : ((start > view_size) ? view_size : start);
+		if (length < 0 || length > view_size - start) {
+			length = view_size - start;
+		}
+		RAMFileClass::Bias(start, length);
+		ViewData = (const char *)ViewData + start;
+		ViewSize = (unsigned)length;
+	}
+
+private:
+	const void *	ViewData;
+	unsigned			ViewSize;
+	StringClass		Filename;
+};
@@ -38,6 +38,12 @@
  *   ObjectPoolClass::Free_Object -- releases obj back into the pool                           *
  *   ObjectPoolClass::Allocate_Object_Memory -- internal function which returns memory for an  *
  *   ObjectPoolClass::Free_Object_Memory -- internal function, returns object's memory to the  *
+ *   ObjectPoolClass::Get_Stats -- returns the statistics of the pool                          *
+ *   ObjectPoolClass::Pop_Free_Object -- takes an object off the shared free list              *
+ *   ObjectPoolClass::Refill_Magazine -- fills the calling thread's magazine from the pool     *
+ *   ObjectPoolClass::Return_Objects -- gives objects from a magazine back to the pool         *
+ *   ObjectPoolClass::Claim_Magazine -- makes the calling thread's magazine serve this pool    *
+ *   ObjectPoolClass::Get_Magazine -- returns the calling thread's magazine                    *
  *   AutoPoolClass::operator new -- overriden new which calls the internal ObjectPool          *
  *   AutoPoolClass::operator delete -- overriden delete which calls the internal ObjectPool    *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
@@ -59,6 +65,23 @@
 
 
 
+/*
+** ObjectPoolStatsStruct
+** Statistics of an ObjectPoolClass.  Hits are allocations and frees served by a thread's
+** magazine without touching the pool; they are added in whenever the thread's magazine
+** next goes to the pool, so they lag a little.  Misses are trips to the shared free list
+** and Contentions are the misses which found another thread holding the pool's lock.
+*/
+struct ObjectPoolStatsStruct
+{
+	int		Hits;
+	int		Misses;
+	int		Contentions;
+	int		FreeObjectCount;		// objects on the shared free list (not in magazines)
+	int		TotalObjectCount;
+};
+
+
 /**********************************************************************************************
 ** ObjectPoolClass
 **
@@ -67,6 +90,15 @@
 ** and freeing lots of little objects directly off the heap.  Through the use of this
 ** class, far fewer allocations will be actually made.
 **
+** If MAGAZINE_SIZE is non-zero, every thread keeps a magazine of free objects for the
+** pool.  Allocating and freeing use the calling thread's magazine without locking; the
+** magazine goes to the shared free list, under the lock, for MAGAZINE_SIZE objects at a
+** time when it runs dry or when it holds twice that many.  A thread has one magazine per
+** pool type, so if it alternates between two pools of the same type the magazine moves
+** back and forth between them.  A thread's magazine is given back when the thread exits,
+** so a pool with magazines has to outlive the threads that use it; static pools (such as
+** the ones behind AutoPoolClass) do.
+**
 ** Example Usage:
 **
 ** ObjectPoolClass<ListNodeClass,256>  NodePool;
@@ -74,7 +106,7 @@
 ** NodePool.Free_Object(node);
 **
 **********************************************************************************************/
-template<class T,int BLOCK_SIZE = 64>
+template<class T,int BLOCK_SIZE = 64,int MAGAZINE_SIZE = 0>
 class ObjectPoolClass
 {
 public:
@@ -88,12 +120,55 @@ public:
 	T *		Allocate_Object_Memory(void);
 	void		Free_Object_Memory(T * obj);
 
+	void		Get_Stats(ObjectPoolStatsStruct & stats);
+
 protected:
 
+	/*
+	** Each block starts with a pointer to the next block, padded so that the objects
+	** after it are aligned.
+	*/
+	static size_t	Block_Header_Size(void)	{ return ((sizeof(void *) + alignof(T) - 1) / alignof(T)) * alignof(T); }
+
+	/*
+	** A thread's magazine.  It is trivially destructible so that it stays usable while
+	** static objects are destroyed; MagazineGuardClass hands its objects back when the
+	** thread exits and closes it, after which the thread goes straight to the pool.
+	** Both are function-local thread_locals (see Get_Magazine and Claim_Magazine) since
+	** GCC can't emit a thread_local static data member of a class template that needs a
+	** destructor, and they are only instantiated for pools with a magazine.
+	*/
+	struct MagazineStruct
+	{
+		ObjectPoolClass *	Pool;
+		T *					Head;
+		int					Count;
+		int					Hits;
+		bool					Closed;
+	};
+
+	class MagazineGuardClass
+	{
+	public:
+		MagazineGuardClass(void)	{ }
+		~MagazineGuardClass(void);
+		void	Touch(void)				{ }
+	};
+
+	T *		Pop_Free_Object(void);
+	void		Refill_Magazine(MagazineStruct & magazine);
+	void		Return_Objects(MagazineStruct & magazine,int count);
+	void		Claim_Magazine(MagazineStruct & magazine);
+
+	static MagazineStruct &	Get_Magazine(void);
+
 	T	*		FreeListHead;
-	uint32 *	BlockListHead;
+	void *	BlockListHead;
 	int		FreeObjectCount;
 	int		TotalObjectCount;
+	int		Hits;
+	int		Misses;
+	int		Contentions;
 	FastCriticalSectionClass ObjectPoolCS;
 
 };
@@ -107,6 +182,8 @@ protected:
 ** object pool behavior.  The new and delete operators for your class will call
 ** to the internal ObjectPoolClass for fast allocation and de-allocation.  This
 ** is very well suited to being the base class for a list node class for example.
+** A non-zero MAGAZINE_SIZE gives every thread a magazine of free objects (see
+** ObjectPoolClass).
 **
 ** Notes:
 ** - The array forms of new and delete are not supported
@@ -133,7 +210,7 @@ protected:
 ** }
 **
 **********************************************************************************************/
-template<class T, int BLOCK_SIZE = 64>
+template<class T, int BLOCK_SIZE = 64, int MAGAZINE_SIZE = 0>
 class AutoPoolClass
 {
 public:
@@ -141,6 +218,8 @@ public:
 	static void *	operator new(size_t size);
 	static void		operator delete(void * memory);
 
+	static void		Get_Pool_Stats(ObjectPoolStatsStruct & stats)	{ Allocator.Get_Stats(stats); }
+
 private:
 
 	// not implemented
@@ -148,7 +227,7 @@ private:
 	static void		operator delete[] (void * memory);
 
 	// This must be staticly declared by user
-	static ObjectPoolClass<T,BLOCK_SIZE>	Allocator;
+	static ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>	Allocator;
 
 };
 
@@ -157,8 +236,8 @@ private:
 ** Macro to declare the allocator for your class.  Put this in the cpp file for
 ** the class.
 */
-template<typename T, int BLOCKSIZE>
-ObjectPoolClass<T, BLOCKSIZE> AutoPoolClass<T, BLOCKSIZE>::Allocator;
+template<typename T, int BLOCKSIZE, int MAGAZINESIZE>
+ObjectPoolClass<T, BLOCKSIZE, MAGAZINESIZE> AutoPoolClass<T, BLOCKSIZE, MAGAZINESIZE>::Allocator;
 #define DEFINE_AUTO_POOL(T,BLOCKSIZE)
 /*
 #define DEFINE_AUTO_POOL(T,BLOCKSIZE) \
@@ -180,12 +259,15 @@ ObjectPoolClass<T,BLOCKSIZE> AutoPoolClass<T,BLOCKSIZE>::Allocator;
  *                                                                                             *
  * HISTORY:                                                                                    *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE>
-ObjectPoolClass<T,BLOCK_SIZE>::ObjectPoolClass(void) :
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::ObjectPoolClass(void) :
 	FreeListHead(NULL),
 	BlockListHead(NULL),
 	FreeObjectCount(0),
-	TotalObjectCount(0)
+	TotalObjectCount(0),
+	Hits(0),
+	Misses(0),
+	Contentions(0)
 {
 }
 
@@ -202,16 +284,25 @@ ObjectPoolClass<T,BLOCK_SIZE>::ObjectPoolClass(void) :
  *                                                                                             *
  * HISTORY:                                                                                    *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE>
-ObjectPoolClass<T,BLOCK_SIZE>::~ObjectPoolClass(void)
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::~ObjectPoolClass(void)
 {
+	// take back whatever the calling thread's magazine holds
+	if constexpr (MAGAZINE_SIZE > 0) {
+		MagazineStruct & magazine = Get_Magazine();
+		if (magazine.Pool == this) {
+			Return_Objects(magazine,magazine.Count);
+			magazine.Pool = NULL;
+		}
+	}
+
 	// assert that the user gave back all of the memory he was using
 	WWASSERT(FreeObjectCount == TotalObjectCount);
 
 	// delete all of the blocks we allocated
 	int block_count = 0;
 	while (BlockListHead != NULL) {
-		uint32 * next_block = *(uint32 **)BlockListHead;
+		void * next_block = *(void **)BlockListHead;
 		::operator delete(BlockListHead);
 		BlockListHead = next_block;
 		block_count++;
@@ -235,8 +326,8 @@ ObjectPoolClass<T,BLOCK_SIZE>::~ObjectPoolClass(void)
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE>
-T * ObjectPoolClass<T,BLOCK_SIZE>::Allocate_Object(void)
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+T * ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Allocate_Object(void)
 {
 	// allocate memory for the object
 	T * obj = Allocate_Object_Memory();
@@ -257,8 +348,8 @@ T * ObjectPoolClass<T,BLOCK_SIZE>::Allocate_Object(void)
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE>
-void ObjectPoolClass<T,BLOCK_SIZE>::Free_Object(T * obj)
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+void ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Free_Object(T * obj)
 {
 	// destruct the object
 	obj->T::~T();
@@ -279,21 +370,126 @@ void ObjectPoolClass<T,BLOCK_SIZE>::Free_Object(T * obj)
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE>
-T * ObjectPoolClass<T,BLOCK_SIZE>::Allocate_Object_Memory(void)
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+T * ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Allocate_Object_Memory(void)
+{
+	if constexpr (MAGAZINE_SIZE > 0) {
+		MagazineStruct & magazine = Get_Magazine();
+		if (!magazine.Closed) {
+			if (magazine.Pool != this || magazine.Head == NULL) {
+				Refill_Magazine(magazine);
+			} else {
+				magazine.Hits++;
+			}
+
+			T * obj = magazine.Head;
+			magazine.Head = *(T**)(obj);
+			magazine.Count--;
+			return obj;
+		}
+	}
+
+	FastCriticalSectionClass::LockClass lock(ObjectPoolCS,Contentions);
+	Misses++;
+	return Pop_Free_Object();
+}
+
+
+/***********************************************************************************************
+ * ObjectPoolClass::Free_Object_Memory -- internal function, returns object's memory to the po *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *   7/29/99    GTH : Created.                                                                 *
+ *=============================================================================================*/
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+void ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Free_Object_Memory(T * obj)
+{
+	WWASSERT(obj != NULL);
+
+	if constexpr (MAGAZINE_SIZE > 0) {
+		MagazineStruct & magazine = Get_Magazine();
+		if (!magazine.Closed) {
+			if (magazine.Pool != this) {
+				Claim_Magazine(magazine);
+			}
+
+			*(T**)(obj) = magazine.Head;
+			magazine.Head = obj;
+			magazine.Count++;
+			magazine.Hits++;
+
+			// keep one magazine's worth, give the rest back
+			if (magazine.Count >= 2 * MAGAZINE_SIZE) {
+				Return_Objects(magazine,MAGAZINE_SIZE);
+			}
+			return;
+		}
+	}
+
+	FastCriticalSectionClass::LockClass lock(ObjectPoolCS,Contentions);
+	Misses++;
+	*(T**)(obj) = FreeListHead;		// Link to the Head
+	FreeListHead = obj;					// Set the Head
+	FreeObjectCount++;
+}
+
+
+/***********************************************************************************************
+ * ObjectPoolClass::Get_Stats -- returns the statistics of the pool                            *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+void ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Get_Stats(ObjectPoolStatsStruct & stats)
 {
 	FastCriticalSectionClass::LockClass lock(ObjectPoolCS);
+	stats.Hits = Hits;
+	stats.Misses = Misses;
+	stats.Contentions = Contentions;
+	stats.FreeObjectCount = FreeObjectCount;
+	stats.TotalObjectCount = TotalObjectCount;
+}
+
 
+/***********************************************************************************************
+ * ObjectPoolClass::Pop_Free_Object -- takes an object off the shared free list                *
+ *                                                                                             *
+ * If there are no free objects, another block of objects will be allocated.  The caller must  *
+ * hold the lock.                                                                              *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+T * ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Pop_Free_Object(void)
+{
 	if ( FreeListHead == 0 ) {
 
 		// No free objects, allocate another block
-		uint32 * tmp_block_head = BlockListHead;
-		BlockListHead = (uint32*)::operator new( sizeof(T) * BLOCK_SIZE + sizeof(uint32 *));
+		void * tmp_block_head = BlockListHead;
+		BlockListHead = ::operator new( sizeof(T) * BLOCK_SIZE + Block_Header_Size() );
 		// Link this block into the block list
 		*(void **)BlockListHead = tmp_block_head;
 
 		// Link the objects in the block into the free object list
-		FreeListHead = (T*)(BlockListHead + 1);
+		FreeListHead = (T*)((char *)BlockListHead + Block_Header_Size());
 		for ( int i = 0; i < BLOCK_SIZE; i++ ) {
 			*(T**)(&(FreeListHead[i])) = &(FreeListHead[i+1]);	// link up the elements
 		}
@@ -312,7 +508,7 @@ T * ObjectPoolClass<T,BLOCK_SIZE>::Allocate_Object_Memory(void)
 
 
 /***********************************************************************************************
- * ObjectPoolClass::Free_Object_Memory -- internal function, returns object's memory to the po *
+ * ObjectPoolClass::Refill_Magazine -- fills the calling thread's magazine from the pool       *
  *                                                                                             *
  * INPUT:                                                                                      *
  *                                                                                             *
@@ -321,17 +517,117 @@ T * ObjectPoolClass<T,BLOCK_SIZE>::Allocate_Object_Memory(void)
  * WARNINGS:                                                                                   *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE>
-void ObjectPoolClass<T,BLOCK_SIZE>::Free_Object_Memory(T * obj)
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+void ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Refill_Magazine(MagazineStruct & magazine)
 {
-	FastCriticalSectionClass::LockClass lock(ObjectPoolCS);
+	if (magazine.Pool != this) {
+		Claim_Magazine(magazine);
+	}
 
-	WWASSERT(obj != NULL);
-	*(T**)(obj) = FreeListHead;		// Link to the Head
-	FreeListHead = obj;					// Set the Head
-	FreeObjectCount++;
+	FastCriticalSectionClass::LockClass lock(ObjectPoolCS,Contentions);
+	Misses++;
+	Hits += magazine.Hits;
+	magazine.Hits = 0;
+
+	for (int i = magazine.Count; i < MAGAZINE_SIZE; i++) {
+		T * obj = Pop_Free_Object();
+		*(T**)(obj) = magazine.Head;
+		magazine.Head = obj;
+		magazine.Count++;
+	}
+}
+
+
+/***********************************************************************************************
+ * ObjectPoolClass::Return_Objects -- gives objects from a magazine back to the pool           *
+ *                                                                                             *
+ * INPUT:   magazine - a magazine serving this pool                                            *
+ *          count - number of objects to give back                                             *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+void ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Return_Objects(MagazineStruct & magazine,int count)
+{
+	WWASSERT(magazine.Pool == this);
+	WWASSERT(count <= magazine.Count);
+
+	FastCriticalSectionClass::LockClass lock(ObjectPoolCS,Contentions);
+	Misses++;
+	Hits += magazine.Hits;
+	magazine.Hits = 0;
+
+	for (int i = 0; i < count; i++) {
+		T * obj = magazine.Head;
+		magazine.Head = *(T**)(obj);
+		*(T**)(obj) = FreeListHead;
+		FreeListHead = obj;
+	}
+	magazine.Count -= count;
+	FreeObjectCount += count;
+}
+
+
+/***********************************************************************************************
+ * ObjectPoolClass::Claim_Magazine -- makes the calling thread's magazine serve this pool      *
+ *                                                                                             *
+ * Whatever the magazine holds goes back to the pool it was serving.                           *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+void ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Claim_Magazine(MagazineStruct & magazine)
+{
+	// make sure the magazine is handed back when this thread exits
+	static thread_local MagazineGuardClass _guard;
+	_guard.Touch();
+
+	if (magazine.Pool != NULL) {
+		magazine.Pool->Return_Objects(magazine,magazine.Count);
+	}
+	magazine.Pool = this;
+}
+
+
+/***********************************************************************************************
+ * ObjectPoolClass::Get_Magazine -- returns the calling thread's magazine                      *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+typename ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::MagazineStruct & ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::Get_Magazine(void)
+{
+	static thread_local MagazineStruct _magazine;
+	return _magazine;
+}
+
+
+template<class T,int BLOCK_SIZE,int MAGAZINE_SIZE>
+ObjectPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::MagazineGuardClass::~MagazineGuardClass(void)
+{
+	MagazineStruct & magazine = Get_Magazine();
+	if (magazine.Pool != NULL) {
+		magazine.Pool->Return_Objects(magazine,magazine.Count);
+		magazine.Pool = NULL;
+	}
+	magazine.Closed = true;
 }
 
 
@@ -347,8 +643,8 @@ void ObjectPoolClass<T,BLOCK_SIZE>::Free_Object_Memory(T * obj)
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T, int BLOCK_SIZE>
-void * AutoPoolClass<T,BLOCK_SIZE>::operator new( [[maybe_unused]] size_t size )
+template<class T, int BLOCK_SIZE, int MAGAZINE_SIZE>
+void * AutoPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::operator new( [[maybe_unused]] size_t size )
 {
 	WWASSERT(size == sizeof(T));
 	return (void *)(Allocator.Allocate_Object_Memory());
@@ -367,8 +663,8 @@ void * AutoPoolClass<T,BLOCK_SIZE>::operator new( [[maybe_unused]] size_t size )
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T, int BLOCK_SIZE>
-void AutoPoolClass<T,BLOCK_SIZE>::operator delete( void * memory )
+template<class T, int BLOCK_SIZE, int MAGAZINE_SIZE>
+void AutoPoolClass<T,BLOCK_SIZE,MAGAZINE_SIZE>::operator delete( void * memory )
 {
 	if ( memory == 0 ) return;
 	Allocator.Free_Object_Memory((T*)memory);
@@ -71,15 +71,36 @@ MixFileFactoryClass::MixFileFactoryClass( const char * mix_filename, FileFactory
 	IsValid (false),
 	BaseOffset (0),
 	Factory (NULL),
-	IsModified (false)
+	IsModified (false),
+	HashTable (NULL),
+	HashMask (0)
 {
 //	WWDEBUG_SAY(( "MixFileFactory( %s )\n", mix_filename ));
 	MixFilename	= mix_filename;
 	Factory		= factory;
 	FilenameList.Set_Growth_Step (1000);
 
+	Load_Mix_Header();
+}
+
+MixFileFactoryClass::~MixFileFactoryClass( void )
+{
+	Free_Hash_Index();
+	Unmap_Mix_File();
+	FileInfo.Resize(0);
+}
+
+void	MixFileFactoryClass::Load_Mix_Header( void )
+{
+	Free_Hash_Index();
+	FileInfo.Resize(0);
+	FileCount	= 0;
+	NamesOffset	= 0;
+	BaseOffset	= 0;
+	IsValid		= false;
+
 	// First, open the mix file
-	FileClass * file = factory->Get_File( mix_filename );
+	FileClass * file = Factory->Get_File( MixFilename );
 
 //	WWASSERT( file );
 
@@ -126,21 +147,135 @@ MixFileFactoryClass::MixFileFactoryClass( const char * mix_filename, FileFactory
 		if ( IsValid ) {
 			BaseOffset	= 0;
 			NamesOffset	= header.names_offset;
-			WWDEBUG_SAY(( "MixFileFactory( %s ) loaded successfully  %d files\n", MixFilename, FileInfo.Length() ));
+			Build_Hash_Index();
+			Map_Mix_File( file );
+			WWDEBUG_SAY(( "MixFileFactory( %s ) loaded successfully  %d files%s\n", (const char *)MixFilename, FileInfo.Length(), Is_Mapped() ? " (mapped)" : "" ));
 		} else {
 			FileInfo.Resize(0);
 		}
 
-		factory->Return_File( file );
+		Factory->Return_File( file );
 
 	} else {
-		WWDEBUG_SAY(( "MixFileFactory( %s ) FAILED\n", mix_filename ));
+		WWDEBUG_SAY(( "MixFileFactory( %s ) FAILED\n", (const char *)MixFilename ));
 	}
 }
 
-MixFileFactoryClass::~MixFileFactoryClass( void )
+/*
+**	Running total of mix bytes mapped by all factories.  A 32-bit process only has a couple
+** of gigabytes of address space, so past the budget the mixes are read through the file
+** instead.
+*/
+static const size_t	MIX_MAP_BUDGET		= (sizeof( void * ) > 4) ? (size_t)-1 : ((size_t)256 << 20);
+static size_t			MixMappedBytes		= 0;
+
+void	MixFileFactoryClass::Map_Mix_File( FileClass * file )
 {
-	FileInfo.Resize(0);
+	//
+	//	Only a mix that is a whole file on disk can be mapped.  One that lives inside
+	// another archive comes back as a view or a biased file, and its name is the member
+	// name rather than a path.
+	//
+	RawFileClass * raw_file = dynamic_cast<RawFileClass *>( file );
+	if ( raw_file == NULL || raw_file->BiasStart != 0 || raw_file->BiasLength != -1 ) {
+		return;
+	}
+
+	const int file_size = raw_file->Size();
+	if ( file_size <= 0 || (size_t)file_size > MIX_MAP_BUDGET - MixMappedBytes ) {
+		return;
+	}
+
+	if ( !MixImage.Map( raw_file->File_Name() ) ) {
+		return;
+	}
+	if ( (int)MixImage.Get_Size() != file_size ) {
+		MixImage.Unmap();
+		return;
+	}
+
+	//
+	//	Every member has to lie inside the mapping before we hand out views of it
+	//
+	const unsigned int image_size = MixImage.Get_Size();
+	for ( int index = 0; index < FileInfo.Length(); index ++ ) {
+		const FileInfoStruct & info = FileInfo[index];
+		if ( info.Offset > image_size || info.Size > image_size - info.Offset ) {
+			WWDEBUG_SAY(( "MixFileFactory( %s ) bad file entry, not mapping\n", MixFilename ));
+			MixImage.Unmap();
+			return;
+		}
+	}
+
+	MixMappedBytes += MixImage.Get_Size();
+}
+
+void	MixFileFactoryClass::Unmap_Mix_File( void )
+{
+	if ( MixImage.Is_Mapped() ) {
+		MixMappedBytes -= MixImage.Get_Size();
+		MixImage.Unmap();
+	}
+}
+
+static inline unsigned int Mix_Hash_Slot( unsigned int crc, unsigned int mask )
+{
+	// The CRCs are already well mixed, just fold the high bits in for small tables
+	return (crc ^ (crc >> 16)) & mask;
+}
+
+void	MixFileFactoryClass::Build_Hash_Index( void )
+{
+	Free_Hash_Index();
+
+	const int count = FileInfo.Length();
+	if ( count == 0 ) {
+		return;
+	}
+
+	unsigned int table_size = 16;
+	while ( table_size < (unsigned int)count * 2 ) {
+		table_size <<= 1;
+	}
+	HashTable = new int[table_size];
+	HashMask = table_size - 1;
+	for ( unsigned int slot = 0; slot < table_size; slot ++ ) {
+		HashTable[slot] = -1;
+	}
+
+	for ( int index = 0; index < count; index ++ ) {
+		unsigned int slot = Mix_Hash_Slot( FileInfo[index].CRC, HashMask );
+		while ( HashTable[slot] != -1 ) {
+			slot = (slot + 1) & HashMask;
+		}
+		HashTable[slot] = index;
+	}
+}
+
+void	MixFileFactoryClass::Free_Hash_Index( void )
+{
+	delete [] HashTable;
+	HashTable = NULL;
+	HashMask = 0;
+}
+
+int	MixFileFactoryClass::Find_File_Index( unsigned int crc ) const
+{
+	if ( HashTable == NULL ) {
+		return -1;
+	}
+
+	//
+	//	The table is at most half full, so a probe always reaches an empty slot
+	//
+	unsigned int slot = Mix_Hash_Slot( crc, HashMask );
+	for ( int index = HashTable[slot]; index != -1; index = HashTable[slot] ) {
+		if ( FileInfo[index].CRC == crc ) {
+			return index;
+		}
+		slot = (slot + 1) & HashMask;
+	}
+	return -1;
 }
 
 bool	MixFileFactoryClass::Build_Filename_List (DynamicVectorClass<StringClass> &list)
@@ -151,11 +286,39 @@ bool	MixFileFactoryClass::Build_Filename_List (DynamicVectorClass<StringClass> &
 
 	bool retval = false;
 
+	//
+	//	Read the names straight out of the mapping if we have one
+	//
+	if ( MixImage.Is_Mapped() ) {
+		const uint8 * image = (const uint8 *)MixImage.Get_Data();
+		const unsigned int image_size = MixImage.Get_Size();
+		unsigned int pos = NamesOffset;
+
+		int file_count = 0;
+		if ( pos <= image_size && image_size - pos >= sizeof( file_count ) ) {
+			::memcpy( &file_count, image + pos, sizeof( file_count ) );
+			pos += sizeof( file_count );
+			retval = true;
+
+			for (int index = 0; index < file_count && pos < image_size; index ++) {
+				uint8 name_len = image[pos ++];
+				if ( image_size - pos < name_len ) {
+					break;
+				}
+				StringClass filename;
+				::memcpy( filename.Get_Buffer( name_len ), image + pos, name_len );
+				pos += name_len;
+				list.Add( filename );
+			}
+		}
+		return retval;
+	}
+
 	//
 	//	Attempt to open the file
 	//
-	RawFileClass *file = (RawFileClass *)Factory->Get_File( MixFilename );
-	if ( file != NULL && file->Open ( RawFileClass::READ ) ) {
+	FileClass *file = Factory->Get_File( MixFilename );
+	if ( file != NULL && file->Open ( FileClass::READ ) ) {
 
 		//
 		//	Seek to the names offset header
@@ -198,9 +361,12 @@ bool	MixFileFactoryClass::Build_Filename_List (DynamicVectorClass<StringClass> &
 			}
 		}
 
-		//
-		//	Close the file
-		//
+	}
+
+	//
+	//	Close the file
+	//
+	if ( file != NULL ) {
 		Factory->Return_File( file );
 	}
 
@@ -214,39 +380,25 @@ FileClass * MixFileFactoryClass::Get_File( char const *filename )
 	}
 //	WWDEBUG_SAY(( "MixFileFactoryClass::Get_File( %s )\n", filename ));
 
-	RawFileClass *file = NULL;
+	FileClass *file = NULL;
 
-	//	Create the key block that will be used to binary search for the file.
-	unsigned int crc = CRC_Stringi( filename );
+	int index = Find_File_Index( CRC_Stringi( filename ) );
+	if ( index != -1 ) {
+		const FileInfoStruct & info = FileInfo[index];
 
-	//	Binary search for the file in this mixfile. If it is found, then create the file
-	FileInfoStruct * info = NULL;
-	FileInfoStruct * base = &FileInfo[0];
-	int stride = FileInfo.Length();
-	while (stride > 0) {
-		int pivot = stride / 2;
-		FileInfoStruct * tryptr = base + pivot;
-		if (crc < tryptr->CRC) {
-			stride = pivot;
-		} else {
-			if (tryptr->CRC == crc) {
-				info = tryptr;
-				break;
-			}
-		   base = tryptr + 1;
-			stride -= pivot + 1;
+		//
+		//	Hand out a view of the mapped archive when we can, it saves the open and
+		// the read syscalls.
+		//
+		if ( MixImage.Is_Mapped() ) {
+			const char * data = (const char *)MixImage.Get_Data() + BaseOffset + info.Offset;
+			return new MappedViewFileClass( data, info.Size, filename );
 		}
-	}
 
-	if ( info != NULL) {
-//		WWDEBUG_SAY(( "MixFileFactoryClass::Get_File( %s ) FOUND\n", filename ));
-		file = (RawFileClass *)Factory->Get_File( MixFilename );
+		file = Factory->Get_File( MixFilename );
 		if ( file ) {
-			file->Bias( BaseOffset + info->Offset, info->Size );
+			file->Bias( BaseOffset + info.Offset, info.Size );
 		}
-//		WWDEBUG_SAY(( "MixFileFactoryClass::Get_File( %s ) FOUND\n", filename ));
-	} else {
-//		WWDEBUG_SAY(( "MixFileFactoryClass::Get_File( %s ) NOT FOUND\n", filename ));
 	}
 
 	return file;
@@ -254,11 +406,29 @@ FileClass * MixFileFactoryClass::Get_File( char const *filename )
 
 void	MixFileFactoryClass::Return_File( FileClass * file )
 {
-	if ( file != NULL ) {
+	if ( dynamic_cast<MappedViewFileClass *>( file ) != NULL ) {
+		delete file;
+	} else if ( file != NULL ) {
 		Factory->Return_File( file );
 	}
 }
 
+const void *	MixFileFactoryClass::Get_File_Data( char const *filename, unsigned &size )
+{
+	size = 0;
+	if ( !MixImage.Is_Mapped() ) {
+		return NULL;
+	}
+
+	int index = Find_File_Index( CRC_Stringi( filename ) );
+	if ( index == -1 ) {
+		return NULL;
+	}
+
+	size = FileInfo[index].Size;
+	return (const char *)MixImage.Get_Data() + BaseOffset + FileInfo[index].Offset;
+}
+
 
 /*
 **
@@ -322,7 +492,8 @@ MixFileFactoryClass::Flush_Changes (void)
 	//	Try to find a temp filename
 	//
 	StringClass full_path;
-	if (Get_Temp_Filename (path, full_path)) {
+	bool created = Get_Temp_Filename (path, full_path);
+	if (created) {
 		MixFileCreator new_mix_file (full_path);
 
 		//
@@ -363,10 +534,21 @@ MixFileFactoryClass::Flush_Changes (void)
 	}
 
 	//
-	//	Delete the old mix file and rename the new one
+	//	Delete the old mix file and rename the new one.  The mapping has to go first,
+	// a mapped file can't be deleted.  Then read the new header back in so lookups,
+	// views and the mapping all point at the new file.
 	//
-	::DeleteFileA (MixFilename);
-	::MoveFileA (full_path, MixFilename);
+	if (created) {
+		Unmap_Mix_File ();
+		::DeleteFileA (MixFilename);
+		::MoveFileA (full_path, MixFilename);
+		Load_Mix_Header ();
+
+		if (FilenameList.Count () > 0) {
+			FilenameList.Delete_All ();
+			Build_Filename_List (FilenameList);
+		}
+	}
 
 	//
 	//	Reset the lists
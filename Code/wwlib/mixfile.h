@@ -50,6 +50,7 @@
 #endif
 
 #include "vector.h"
+#include "mappedfile.h"
 
 class FileClass;
 
@@ -68,6 +69,12 @@ public:
 	virtual FileClass * Get_File( char const *filename ) override;
 	virtual void Return_File( FileClass *file )override;
 
+	//
+	//	Zero-copy access. Returns a pointer into the mapped archive, or NULL if the
+	//	file isn't in this mix or the mix couldn't be mapped.
+	//
+	const void *	Get_File_Data( char const *filename, unsigned &size );
+
 	//
 	//	Filename access
 	//
@@ -87,6 +94,7 @@ public:
 	//	Information
 	//
 	bool		Is_Valid (void) const	{ return IsValid; }
+	bool		Is_Mapped (void) const	{ return MixImage.Is_Mapped (); }
 
 private:
 
@@ -94,6 +102,12 @@ private:
 	//	Utility functions
 	//
 	bool		Get_Temp_Filename (const char *path, StringClass &full_path);
+	void		Load_Mix_Header (void);
+	void		Map_Mix_File (FileClass *file);
+	void		Unmap_Mix_File (void);
+	void		Build_Hash_Index (void);
+	void		Free_Hash_Index (void);
+	int		Find_File_Index (unsigned int crc) const;
 
 	struct FileInfoStruct {
 		bool operator== (const FileInfoStruct &/* src*/)	{ return false; }
@@ -124,6 +138,15 @@ private:
 
 	DynamicVectorClass<AddInfoStruct>	PendingAddFileList;
 	bool											IsModified;
+
+	//
+	//	Open-addressed (linear probing) table of FileInfo indices keyed on the
+	//	filename CRC. Sized to a power of two at least twice the file count.
+	//
+	int *											HashTable;
+	unsigned int								HashMask;
+
+	MappedFileClass							MixImage;
 };
 
 /*
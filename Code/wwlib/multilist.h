@@ -96,7 +96,7 @@ private:
 ** given list and the other dimension is the list of lists that a given object
 ** is in.
 */
-class MultiListNodeClass : public AutoPoolClass<MultiListNodeClass, 256>
+class MultiListNodeClass : public AutoPoolClass<MultiListNodeClass, 256, 32>
 {
 public:
 	MultiListNodeClass(void) { Prev = Next = NextList = 0; Object = 0; List = 0; }
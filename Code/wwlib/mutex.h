@@ -89,6 +89,15 @@ class FastCriticalSectionClass
 #endif
 	}
 
+	bool Thread_Safe_Try_Set_Flag()
+	{
+#ifdef FAST_CRITICAL_IS_MUTEX
+        return mtx.try_lock();
+#else
+        return !Flag.test_and_set(std::memory_order_acq_rel);
+#endif
+	}
+
     void Thread_Safe_Clear_Flag()
 	{
 #ifdef FAST_CRITICAL_IS_MUTEX
@@ -112,6 +121,16 @@ public:
 			CriticalSection.Thread_Safe_Set_Flag();
 		}
 
+		// Also counts the times another thread was holding the lock. The count is
+		// bumped once the lock is held, so it can be a plain int guarded by the lock.
+		LockClass(FastCriticalSectionClass& critical_section, int& contention_count) : CriticalSection(critical_section)
+		{
+			if (!CriticalSection.Thread_Safe_Try_Set_Flag()) {
+				CriticalSection.Thread_Safe_Set_Flag();
+				contention_count++;
+			}
+		}
+
 		~LockClass()
 		{
 			CriticalSection.Thread_Safe_Clear_Flag();
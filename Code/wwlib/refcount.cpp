@@ -36,11 +36,14 @@
  *   RefCountClass::Set_Ref_Owner -- update the owner file/line for the given object            *
  *   RefCountClass::Remove_Active_Ref -- remove an object from the active refs list             *
  *   RefCountClass::Validate_Active_Ref -- Confirm a pointer has a node in the active ref list  *
+ *   RefCountClass::Begin_Ref_Change -- checks a plain count change for races                   *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 
 #include "refcount.h"
+#include "wwdebug.h"
 #include <windows.h>
+#include <mutex>
 
 
 #ifndef NDEBUG
@@ -50,9 +53,21 @@
 /*
 ** Static variables for the reference counting system
 */
-int							RefCountClass::TotalRefs = 0;
+std::atomic<int>			RefCountClass::TotalRefs(0);
 RefCountListClass			RefCountClass::ActiveRefList;
 
+#ifdef WWLIB_ATOMIC_REFCOUNTS
+/*
+** Objects can be created and destroyed on any thread, so the active ref list needs a lock.
+*/
+static std::mutex			_ActiveRefListMutex;
+#define ACTIVE_REF_LIST_LOCK	std::lock_guard<std::mutex> active_ref_list_lock(_ActiveRefListMutex)
+#else
+#define ACTIVE_REF_LIST_LOCK
+std::atomic<int>			RefCountClass::CrossThreadRefs(0);
+std::atomic<int>			RefCountClass::RefRaces(0);
+#endif
+
 
 
 /***********************************************************************************************
@@ -69,6 +84,7 @@ RefCountListClass			RefCountClass::ActiveRefList;
  *=============================================================================================*/
 RefCountClass *	RefCountClass::Add_Active_Ref(RefCountClass *obj)
 {
+	ACTIVE_REF_LIST_LOCK;
 	ActiveRefList.Add_Head(&(obj->ActiveRefNode));
 	obj->ActiveRefInfo.File = NULL;	// default to no debug information added.
 	obj->ActiveRefInfo.Line = 0;
@@ -117,6 +133,7 @@ void RefCountClass::Remove_Active_Ref(RefCountClass * obj)
 #ifdef PARANOID_REFCOUNTS
 	assert(Validate_Active_Ref(obj));
 #endif
+	ACTIVE_REF_LIST_LOCK;
 	obj->ActiveRefNode.Unlink();
 }
 
@@ -134,6 +151,7 @@ void RefCountClass::Remove_Active_Ref(RefCountClass * obj)
  *=============================================================================================*/
 bool RefCountClass::Validate_Active_Ref(RefCountClass * obj)
 {
+	ACTIVE_REF_LIST_LOCK;
 	RefCountNodeClass *node = ActiveRefList.First();
 	while (node) {
 		if (node->Get() == obj) return true;
@@ -170,7 +188,13 @@ RefCountClass* BreakOnReference = 0;
 #ifndef NDEBUG
 void RefCountClass::Add_Ref(void)
 {
+#ifdef WWLIB_ATOMIC_REFCOUNTS
+	NumRefs.fetch_add(1,std::memory_order_relaxed);
+#else
+	Begin_Ref_Change();
 	NumRefs++;
+	End_Ref_Change();
+#endif
 
 	// See if programmer set break on for a specific address.
 	if (this == BreakOnReference) {
@@ -207,6 +231,55 @@ void	RefCountClass::Dec_Total_Refs(RefCountClass * obj)
 
 
 
+#ifndef WWLIB_ATOMIC_REFCOUNTS
+
+/*
+** Every thread gets a small id the first time it changes a count.
+*/
+static std::atomic<unsigned>	_NextRefThread(1);
+static thread_local unsigned	_RefThread = 0;
+
+/***********************************************************************************************
+ * RefCountClass::Begin_Ref_Change -- checks a plain count change for races                    *
+ *                                                                                             *
+ * Called before the count of an object is changed, with End_Ref_Change called after.  If     *
+ * another thread is in between the two for the same object the count is being raced on.  A   *
+ * change from a different thread than the last one is reported once per object.              *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void RefCountClass::Begin_Ref_Change(void)
+{
+	if (_RefThread == 0) {
+		_RefThread = _NextRefThread.fetch_add(1,std::memory_order_relaxed);
+	}
+
+	if (RefChanging.exchange(true,std::memory_order_acquire)) {
+		RefRaces++;
+		WWDEBUG_SAY(("RefCountClass: count of %p (%s line %d) changed by two threads at once\n",
+			this,ActiveRefInfo.File ? ActiveRefInfo.File : "?",ActiveRefInfo.Line));
+		assert(0);
+	}
+
+	unsigned last_thread = RefThread.exchange(_RefThread,std::memory_order_relaxed);
+	if (last_thread != 0 && last_thread != _RefThread) {
+		CrossThreadRefs++;
+		if (!CrossThreadReported) {
+			CrossThreadReported = true;
+			WWDEBUG_SAY(("RefCountClass: count of %p (%s line %d) changed by more than one thread\n",
+				this,ActiveRefInfo.File ? ActiveRefInfo.File : "?",ActiveRefInfo.Line));
+		}
+	}
+}
+
+#endif
+
 #endif
 
 
@@ -48,6 +48,8 @@
 #include "listnode.h"
 #endif
 
+#include <atomic>
+
 class RefCountClass;
 
 
@@ -98,6 +100,27 @@ struct ActiveRefStruct
 **
 */
 
+/*
+** Thread safety
+**
+** By default the reference count is a plain int, so a ref counted object must only be
+** add-ref'd and released by one thread at a time.  Building with WWLIB_ATOMIC_REFCOUNTS
+** defined (the W3D_BUILD_OPTION_ATOMIC_REFCOUNTS cmake option) makes every reference
+** count atomic, so pointers to shared assets can be copied and released on any thread.
+** The count is only what is made thread safe; the objects themselves are not.
+**
+** Debug builds without atomic counts check every change of a count.  Two threads
+** changing the count of the same object at the same time is a race and asserts; an
+** object whose count is changed by a different thread than last time is reported once
+** and counted (see Cross_Thread_Refs), since that is only safe if the threads hand the
+** object over through some other synchronization.
+*/
+#ifdef WWLIB_ATOMIC_REFCOUNTS
+typedef std::atomic<int>		RefCountType;
+#else
+typedef int							RefCountType;
+#endif
+
 typedef DataNode<RefCountClass *>	RefCountNodeClass;
 typedef List<RefCountNodeClass *>	RefCountListClass;
 
@@ -129,11 +152,18 @@ public:
 		#endif
 	}
 
+	/*
+	** Assigning an object doesn't change who refers to it, so the count is left alone.
+	*/
+	RefCountClass & operator = (const RefCountClass & )			{ return *this; }
+
 	/*
 	** Add_Ref, call this function if you are going to keep a pointer
 	** to this object.
 	*/
-#ifdef NDEBUG
+#if defined(NDEBUG) && defined(WWLIB_ATOMIC_REFCOUNTS)
+	WWINLINE void Add_Ref(void)										{ NumRefs.fetch_add(1,std::memory_order_relaxed); }
+#elif defined(NDEBUG)
 	WWINLINE void Add_Ref(void)										{ NumRefs++; }
 #else
 	void Add_Ref(void);
@@ -143,14 +173,25 @@ public:
 	** Release_Ref, call this function when you no longer need the pointer
 	** to this object.
 	*/
-	WWINLINE void		Release_Ref(void)							{
-																				#ifndef NDEBUG
-																				Dec_Total_Refs(this);
-																				#endif
-																				NumRefs--;
-																				assert(NumRefs >= 0);
-																				if (NumRefs == 0) Delete_This();
-																			}
+	WWINLINE void		Release_Ref(void)
+	{
+		#ifndef NDEBUG
+		Dec_Total_Refs(this);
+		#endif
+
+		#if defined(WWLIB_ATOMIC_REFCOUNTS)
+		int refs = NumRefs.fetch_sub(1,std::memory_order_acq_rel) - 1;
+		#elif defined(NDEBUG)
+		int refs = --NumRefs;
+		#else
+		Begin_Ref_Change();
+		int refs = --NumRefs;
+		End_Ref_Change();
+		#endif
+
+		assert(refs >= 0);
+		if (refs == 0) Delete_This();
+	}
 
 
 	/*
@@ -190,13 +231,14 @@ private:
 	/*
 	** Current reference count of this object
 	*/
-	int					NumRefs;
+	RefCountType		NumRefs;
 
 	/*
 	** Sum of all references to RefCountClass's.  Should equal zero after
-	** everything has been released.
+	** everything has been released.  Objects on different threads change it at
+	** the same time even when their own counts are plain.
 	*/
-	static int			TotalRefs;
+	static std::atomic<int>	TotalRefs;
 
 	/*
 	** increments the total reference count
@@ -247,6 +289,30 @@ public:
 	*/
 	static bool							Validate_Active_Ref(RefCountClass * obj);
 
+#ifndef WWLIB_ATOMIC_REFCOUNTS
+
+	/*
+	** Race detection for the plain counts: bracket every change of NumRefs.
+	*/
+	void									Begin_Ref_Change(void);
+	void									End_Ref_Change(void)		{ RefChanging.store(false,std::memory_order_release); }
+
+	/*
+	** Number of times a count was changed by a different thread than last time,
+	** and number of times two threads were caught changing one at once.
+	*/
+	static int							Cross_Thread_Refs(void)	{ return CrossThreadRefs; }
+	static int							Ref_Races(void)			{ return RefRaces; }
+
+	std::atomic<unsigned>			RefThread{0};				// thread which last changed the count
+	std::atomic<bool>					RefChanging{false};		// the count is being changed
+	bool									CrossThreadReported = false;
+
+	static std::atomic<int>			CrossThreadRefs;
+	static std::atomic<int>			RefRaces;
+
+#endif
+
 #endif
 
 };
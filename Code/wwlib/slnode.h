@@ -57,7 +57,7 @@ template	<class T> class SList;
 //	manage a	singularly linked	list of objects.
 //
 
-class	GenericSLNode : public AutoPoolClass<GenericSLNode, 256>
+class	GenericSLNode : public AutoPoolClass<GenericSLNode, 256, 32>
 {
 	protected:
 		void* Internal_Get_Next(void) { return NodeNext; };
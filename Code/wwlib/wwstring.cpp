@@ -38,6 +38,7 @@
 #include "win.h"
 #include "wwmemlog.h"
 #include "mutex.h"
+#include "framearena.h"
 #include <stdio.h>
 
 
@@ -242,20 +243,40 @@ StringClass::Format_Args (const char *format, va_list arg_list )
 	//
 	// Make a guess at the maximum length of the resulting string
 	//
-	char temp_buffer[512] = { 0 };
+	char temp_buffer[512];
 	int retval = 0;
 
 	//
-	//	Format the string
+	//	Format the string, keeping a copy of the arguments in case
+	// it doesn't fit
 	//
+	va_list arg_copy;
+	va_copy (arg_copy, arg_list);
+	retval = vsnprintf (temp_buffer, sizeof (temp_buffer), format, arg_list);
 
-	retval = vsnprintf (temp_buffer, 512, format, arg_list);
+	if (retval >= (int)sizeof (temp_buffer)) {
 
-	//
-	//	Copy the string into our buffer
-	//
-	(*this) = temp_buffer;
+		//
+		//	Too long for the stack buffer, so format it again into frame
+		// arena scratch of the exact size rather than truncating
+		//
+		FrameArenaScopeClass arena_scope;
+		char *long_buffer = (char *)arena_scope.Get_Arena ().Alloc (retval + 1);
+		vsnprintf (long_buffer, retval + 1, format, arg_copy);
+		(*this) = long_buffer;
+
+	} else {
+
+		//
+		//	Copy the string into our buffer
+		//
+		if (retval < 0) {
+			temp_buffer[0] = 0;
+		}
+		(*this) = temp_buffer;
+	}
 
+	va_end (arg_copy);
 	return retval;
 }
 
@@ -271,21 +292,7 @@ StringClass::Format (const char *format, ...)
 	va_list arg_list;
 	va_start (arg_list, format);
 
-	//
-	// Make a guess at the maximum length of the resulting string
-	//
-	char temp_buffer[512] = { 0 };
-	int retval = 0;
-
-	//
-	//	Format the string
-	//
-	retval = vsnprintf (temp_buffer, 512, format, arg_list);
-
-	//
-	//	Copy the string into our buffer
-	//
-	(*this) = temp_buffer;
+	int retval = Format_Args (format, arg_list);
 
 	va_end (arg_list);
 	return retval;
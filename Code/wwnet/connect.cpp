@@ -2475,6 +2475,7 @@ void cConnection::Service_Send(bool is_urgent)
             ThisFrameTimeMs, false);
 
          if (is_updated) {
+				PRHost[rhost_id]->Update_Metrics();
 				PRHost[rhost_id]->Adjust_Resend_Timeout();
 				PRHost[rhost_id]->Adjust_Flow_If_Necessary(sample_time_ms);
 			}
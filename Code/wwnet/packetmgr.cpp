@@ -47,6 +47,8 @@
 #include "wwmemlog.h"
 #include "crc.h"
 #include "wwprofile.h"
+#include "wwmetrics.h"
+#include "framearena.h"
 #include "connect.h"
 #include <algorithm>
 #include "socket_wrapper.h"
@@ -57,6 +59,21 @@
 */
 PacketManagerClass PacketManager;
 
+/*
+** Totals exported through WWMetricsManager. Per client gauges live in the BandwidthList entries.
+*/
+static WWGaugeClass _TotalBandwidthInMetric("w3d_net_total_bandwidth_in_bps", "Total compressed bandwidth in, in bits per second.");
+static WWGaugeClass _TotalBandwidthOutMetric("w3d_net_total_bandwidth_out_bps", "Total compressed bandwidth out, in bits per second.");
+
+/*
+** Hash for the ip/port index of the bandwidth stats list.
+*/
+template <> inline unsigned int HashTemplateKeyClass<PacketBandwidthKeyStruct>::Get_Hash_Value(const PacketBandwidthKeyStruct &key)
+{
+	unsigned int hval = key.IPAddress ^ (key.IPAddress >> 16) ^ ((unsigned int)key.Port * 0x9e3779b1);
+	return hval ^ (hval >> 15);
+}
+
 /***********************************************************************************************
  * PacketManagerClass::Add_Bit -- Add a bit to a delta compressed packet stream                *
  *                                                                                             *
@@ -185,6 +202,8 @@ PacketManagerClass::PacketManagerClass(void)
  *=============================================================================================*/
 PacketManagerClass::~PacketManagerClass(void)
 {
+	Free_Stats_Metrics();
+
 	if (SendBuffers) {
 		delete [] SendBuffers;
 		SendBuffers = NULL;
@@ -905,7 +924,12 @@ WWPROFILE("PMgr Flush");
 			*/
 			crc = _byteswap_ulong(crc);
 #endif //(0)
-			char *crc_and_buffer = (char*)_alloca(SendBuffers[i].PacketSendLength + sizeof(crc));
+			/*
+			** Stage the CRC and payload in frame arena scratch. _alloca here grew the stack by
+			** a packet for every buffer in the loop and only gave it back when Flush returned.
+			*/
+			FrameArenaScopeClass arena_scope;
+			char *crc_and_buffer = (char*)arena_scope.Get_Arena().Alloc(SendBuffers[i].PacketSendLength + sizeof(crc));
 			*((unsigned int*) crc_and_buffer) = crc;
 			memcpy(crc_and_buffer + sizeof(crc), (const char*)SendBuffers[i].PacketBuffer, SendBuffers[i].PacketSendLength);
 
@@ -1260,7 +1284,9 @@ void PacketManagerClass::Reset_Stats(void)
 {
 	CriticalSectionClass::LockClass lock(CriticalSection);
 	WWDEBUG_SAY(("PacketManagerClass Resetting stats\n"));
+	Free_Stats_Metrics();
 	BandwidthList.Delete_All();
+	BandwidthIndex.Remove_All();
 	LastStatsUpdate = TIMEGETTIME();
 	ResetStatsIn = true;
 	ResetStatsOut = true;
@@ -1288,12 +1314,15 @@ void PacketManagerClass::Reset_Stats(void)
 int PacketManagerClass::Get_Stats_Index(unsigned int ip_address, unsigned short port, bool can_create)
 {
 	/*
-	** Find the stats struct entry for this ip/port.
+	** Find the stats struct entry for this ip/port. Entries are only ever added to the end of the
+	** list until it's emptied, so the indices in the hash stay valid.
 	*/
-	for (int i=0 ; i<BandwidthList.Count() ; i++) {
-		if (ip_address == BandwidthList[i].IPAddress && port == BandwidthList[i].Port) {
-			return(i);
-		}
+	PacketBandwidthKeyStruct key;
+	key.IPAddress = ip_address;
+	key.Port = port;
+	int index = -1;
+	if (BandwidthIndex.Get(key, index)) {
+		return(index);
 	}
 
 	if (can_create) {
@@ -1311,7 +1340,15 @@ int PacketManagerClass::Get_Stats_Index(unsigned int ip_address, unsigned short
 		stats.UncompressedBandwidthOut = 0;
 		stats.CompressedBandwidthIn = 0;
 		stats.CompressedBandwidthOut = 0;
+
+		StringClass labels;
+		labels.Format("client=\"%u.%u.%u.%u:%u\"",
+			ip_address & 0xff, (ip_address >> 8) & 0xff, (ip_address >> 16) & 0xff, (ip_address >> 24) & 0xff, port);
+		stats.BandwidthInMetric = new WWGaugeClass("w3d_net_client_bandwidth_in_bps", "Compressed bandwidth in per client, in bits per second.", labels);
+		stats.BandwidthOutMetric = new WWGaugeClass("w3d_net_client_bandwidth_out_bps", "Compressed bandwidth out per client, in bits per second.", labels);
+
 		BandwidthList.Add(stats);
+		BandwidthIndex.Insert(key, BandwidthList.Count()-1);
 		return(BandwidthList.Count()-1);
 	}
 	return(-1);
@@ -1319,6 +1356,30 @@ int PacketManagerClass::Get_Stats_Index(unsigned int ip_address, unsigned short
 
 
 
+/***********************************************************************************************
+ * PacketManager::Free_Stats_Metrics -- Release the per client metrics in the stats list       *
+ *                                                                                             *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:    Nothing                                                                           *
+ *                                                                                             *
+ * OUTPUT:   Nothing                                                                           *
+ *                                                                                             *
+ * WARNINGS: Caller must hold the critical section if the list can be in use                   *
+ *                                                                                             *
+ *=============================================================================================*/
+void PacketManagerClass::Free_Stats_Metrics(void)
+{
+	for (int i=0 ; i<BandwidthList.Count() ; i++) {
+		delete BandwidthList[i].BandwidthInMetric;
+		delete BandwidthList[i].BandwidthOutMetric;
+		BandwidthList[i].BandwidthInMetric = NULL;
+		BandwidthList[i].BandwidthOutMetric = NULL;
+	}
+}
+
+
+
 /***********************************************************************************************
  * PacketManager::Register_Packet_In -- Register an incoming packet for bandwidth stats        *
  *                                                                                             *
@@ -1494,8 +1555,14 @@ void PacketManagerClass::Update_Stats(bool forced)
 				stats->UncompressedBytesIn = 0;
 				TotalUncompressedBandwidthIn += stats->UncompressedBandwidthIn;
 			}
+
+			stats->BandwidthInMetric->Set(stats->CompressedBandwidthIn);
+			stats->BandwidthOutMetric->Set(stats->CompressedBandwidthOut);
 		}
 
+		_TotalBandwidthInMetric.Set(TotalCompressedBandwidthIn);
+		_TotalBandwidthOutMetric.Set(TotalCompressedBandwidthOut);
+
 		/*
 		** Just debug output.
 		*/
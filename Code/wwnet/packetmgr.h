@@ -42,6 +42,7 @@
 #include "mutex.h"
 #include "wwdebug.h"
 #include "vector.h"
+#include "hashtemplate.h"
 #include "network-typedefs.h"
 
 #ifdef WWASSERT
@@ -124,6 +125,18 @@ struct PacketDeltaHeaderStruct {
 **
 */
 class PacketManagerClass;
+class WWGaugeClass;
+
+/*
+** Key of the packet manager's per ip/port bandwidth stats.
+*/
+struct PacketBandwidthKeyStruct {
+	unsigned int	IPAddress;
+	unsigned short	Port;
+
+	bool operator == (PacketBandwidthKeyStruct const &key) const { return IPAddress == key.IPAddress && Port == key.Port; }
+};
+
 class PacketManagerClass
 {
 	public:
@@ -230,11 +243,14 @@ class PacketManagerClass
 			unsigned int	UncompressedBandwidthOut;
 			unsigned int	CompressedBandwidthIn;
 			unsigned int	CompressedBandwidthOut;
+			WWGaugeClass *	BandwidthInMetric;
+			WWGaugeClass *	BandwidthOutMetric;
 
 			bool operator == (BandwidthStatsStruct const &stats);
 			bool operator != (BandwidthStatsStruct const &stats);
 		};
 		int Get_Stats_Index(unsigned int ip_address, unsigned short port, bool can_create = true);
+		void Free_Stats_Metrics(void);
 		void Register_Packet_In(unsigned char *ip_address, unsigned short port, unsigned int compressed_size, unsigned int uncompressed_size);
 		void Register_Packet_Out(unsigned char *ip_address, unsigned short port, unsigned int compressed_size, unsigned int uncompressed_size);
 
@@ -322,6 +338,7 @@ class PacketManagerClass
 		** Bandwidth measurement.
 		*/
 		DynamicVectorClass<BandwidthStatsStruct> BandwidthList;
+		HashTemplateClass<PacketBandwidthKeyStruct, int> BandwidthIndex;		// ip/port -> BandwidthList index
 		unsigned int TotalCompressedBandwidthIn;
 		unsigned int TotalCompressedBandwidthOut;
 		unsigned int TotalUncompressedBandwidthIn;
@@ -35,6 +35,7 @@
 #include "connect.h"
 #include "wwdebug.h"
 #include "packetmgr.h"
+#include "wwmetrics.h"
 #include <algorithm>
 
 bool cRemoteHost::AllowExtraModemBandwidthThrottling = true;
@@ -76,7 +77,9 @@ cRemoteHost::cRemoteHost() :
 	IsOutgoingFlooded(false),
 	TotalResentPacketsInQueue(0),
 	NextOutgoingFloodActionTime(0),
-	NumOutgoingFloods(0)
+	NumOutgoingFloods(0),
+	PacketlossMetric(NULL),
+	PingMetric(NULL)
 {
    //WWDEBUG_SAY(("cRemoteHost::cRemoteHost\n"));
 
@@ -182,6 +185,9 @@ cRemoteHost::~cRemoteHost()
          delete p_packet;
       }
    }
+
+	delete PacketlossMetric;
+	delete PingMetric;
 }
 
 //------------------------------------------------------------------------------------
@@ -667,6 +673,22 @@ bool cRemoteHost::Was_Recently_Loading(unsigned int time)
 
 
 
+//------------------------------------------------------------------------------------
+void cRemoteHost::Update_Metrics(void)
+{
+	if (PacketlossMetric == NULL) {
+		StringClass labels;
+		labels.Format("rhost=\"%d\"", Id);
+		PacketlossMetric = new WWGaugeClass("w3d_net_rhost_packetloss_percent",
+			"Percentage of unreliable packets lost from a remote host over the last stats sample.", labels);
+		PingMetric = new WWGaugeClass("w3d_net_rhost_ping_ms",
+			"Average internal ping time to a remote host, in milliseconds.", labels);
+	}
+
+	PacketlossMetric->Set(Stats.Get_Pc_Packetloss_Received());
+	PingMetric->Set(AverageInternalPingtimeMs);
+}
+
 //------------------------------------------------------------------------------------
 void cRemoteHost::Adjust_Resend_Timeout(void)
 {
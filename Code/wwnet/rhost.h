@@ -40,6 +40,8 @@
 #include "win.h"
 #include "network-typedefs.h"
 
+class WWGaugeClass;
+
 //const USHORT MAX_MESSAGE_TYPES = 256;
 
 
@@ -137,6 +139,7 @@ class cRemoteHost
 
       void Adjust_Flow_If_Necessary(float sample_time_ms);
 		void Adjust_Resend_Timeout(void);
+		void Update_Metrics(void);
 
 		void	Set_Id(int id)									{WWASSERT(id >= 0); Id = id;}
 		int	Get_Id(void)									{WWASSERT(Id >= 0); return Id;}
@@ -215,6 +218,12 @@ class cRemoteHost
 		unsigned int	NextOutgoingFloodActionTime;
 		int				NumOutgoingFloods;
 
+		//
+		// Exported through WWMetricsManager, created on the first stats sample.
+		//
+		WWGaugeClass *	PacketlossMetric;
+		WWGaugeClass *	PingMetric;
+
 		static bool		AllowExtraModemBandwidthThrottling;
 		static int		PriorityUpdateRate;
 
@@ -145,6 +145,23 @@ FloodfillGridClass::Initialize
 ///////////////////////////////////////////////////////////////////////
 void
 FloodfillGridClass::Collect_Boxes (const AABoxClass &vol)
+{
+	Collect_Boxes (vol, m_CollectionList);
+	return ;
+}
+
+
+///////////////////////////////////////////////////////////////////////
+//
+//	Collect_Boxes
+//
+//	Fills the caller's list instead of the shared collection list, so
+// several threads can query the grid at once while nothing is being
+// added to or removed from it.
+//
+///////////////////////////////////////////////////////////////////////
+void
+FloodfillGridClass::Collect_Boxes (const AABoxClass &vol, BODY_BOX_LIST &list) const
 {
 	int min_cell_x = 0;
 	int min_cell_y = 0;
@@ -157,7 +174,7 @@ FloodfillGridClass::Collect_Boxes (const AABoxClass &vol)
 	AABoxClass bounding_box;
 	bounding_box.Extent = m_BoxExtent;
 
-	m_CollectionList.Delete_All ();
+	list.Delete_All ();
 
 	//
 	//	Loop over all the cells this volume touches
@@ -176,7 +193,7 @@ FloodfillGridClass::Collect_Boxes (const AABoxClass &vol)
 				//	Does this box overlap the collection volume?
 				//
 				if (CollisionMath::Overlap_Test (vol, bounding_box) != CollisionMath::OUTSIDE) {
-					m_CollectionList.Add (curr_box);
+					list.Add (curr_box);
 				}
 			}
 		}
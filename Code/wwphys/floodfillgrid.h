@@ -90,6 +90,7 @@ public:
 	//	Collection methods
 	//
 	void						Collect_Boxes (const AABoxClass &vol);
+	void						Collect_Boxes (const AABoxClass &vol, BODY_BOX_LIST &list) const;
 	BODY_BOX_LIST &		Get_Collection_List (void);
 	FloodfillBoxClass *	Find_Box (const Vector3 &pos);
 	int						Compute_Box_Count(const AABoxClass & vol);
@@ -106,7 +107,7 @@ protected:
 	//	Protected methods
 	////////////////////////////////////////////////////////////////////
 	int				Get_Cell_Index (const Vector3 &pos);
-	void				Point_To_Cell (const Vector3 &pos, int *cell_x, int *cell_y);
+	void				Point_To_Cell (const Vector3 &pos, int *cell_x, int *cell_y) const;
 
 private:
 
@@ -147,7 +148,7 @@ inline Vector3 FloodfillGridClass::Get_Floodfill_Box_Extents(void)
 // Point_To_Cell
 ////////////////////////////////////////////////////////////////////
 inline void
-FloodfillGridClass::Point_To_Cell (const Vector3 &pos, int *cell_x, int *cell_y)
+FloodfillGridClass::Point_To_Cell (const Vector3 &pos, int *cell_x, int *cell_y) const
 {
 	//
 	//	Convert from 'world-coords' to 'grid-coords'
@@ -43,12 +43,20 @@
 #include "meshmdl.h"
 #include "chunkio.h"
 #include <algorithm>
+#include <math.h>
+
+// Get_Heights does four positions at a time with SSE2 when the compiler targets it (always true on x64)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEIGHTDB_SSE2
+#include <emmintrin.h>
+#endif
 
 
 /////////////////////////////////////////////////////////////////////////
 //	Constants
 /////////////////////////////////////////////////////////////////////////
 const float	HEIGHT_OFFSET	= 2.0F;
+const float	MIP_PADDING		= 0.01F;
 
 enum
 {
@@ -76,6 +84,12 @@ float		HeightDBClass::m_PatchSize		= 8;
 Vector3	HeightDBClass::m_LevelMin (0, 0, 0);
 Vector3	HeightDBClass::m_LevelMax (0, 0, 0);
 
+HeightDBClass::HeightRangeStruct *	HeightDBClass::m_MipArray	= NULL;
+int		HeightDBClass::m_MipLevelCount	= 0;
+int		HeightDBClass::m_MipOffset[MAX_MIP_LEVELS];
+int		HeightDBClass::m_MipCellsX[MAX_MIP_LEVELS];
+int		HeightDBClass::m_MipCellsY[MAX_MIP_LEVELS];
+
 
 /////////////////////////////////////////////////////////////////////////
 //
@@ -146,44 +160,497 @@ HeightDBClass::Get_Height (const Vector3 &pos)
 
 			int entry_ul_x = (m_NumPointsX - 1) * percent_x;
 			int entry_ul_y = (m_NumPointsY - 1) * percent_y;
-			int entry_ur_x = entry_ul_x + 1;
-			int entry_ur_y = entry_ul_y;
-			int entry_lr_x = entry_ul_x + 1;
-			int entry_lr_y = entry_ul_y + 1;
-			int entry_ll_x = entry_ul_x;
-			int entry_ll_y = entry_ul_y + 1;
-
-			if (entry_ul_x + 1 >= m_NumPointsX) {
-				entry_ur_x = entry_ul_x;
-				entry_lr_x = entry_ul_x;
+			height = Get_Cell_Height (entry_ul_y, entry_ul_x, pos.X, pos.Y);
+		}
+	}
+
+	return height;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+//	Get_Cell_Height
+//
+//	Interpolates the heights at the corners of the grid cell whose upper
+// left entry is (row, col).  The position doesn't have to be inside the cell.
+//
+/////////////////////////////////////////////////////////////////////////
+float
+HeightDBClass::Get_Cell_Height (int row, int col, float x_pos, float y_pos)
+{
+	int entry_ul_x = col;
+	int entry_ul_y = row;
+	int entry_ur_x = entry_ul_x + 1;
+	int entry_ur_y = entry_ul_y;
+	int entry_lr_x = entry_ul_x + 1;
+	int entry_lr_y = entry_ul_y + 1;
+	int entry_ll_x = entry_ul_x;
+	int entry_ll_y = entry_ul_y + 1;
+
+	if (entry_ul_x + 1 >= m_NumPointsX) {
+		entry_ur_x = entry_ul_x;
+		entry_lr_x = entry_ul_x;
+	}
+
+	if (entry_ul_y + 1 >= m_NumPointsY) {
+		entry_lr_y = entry_ul_y;
+		entry_ll_y = entry_ul_y;
+	}
+
+	float *ul_entry = Get_Height_Entry (entry_ul_y, entry_ul_x);
+	float *ur_entry = Get_Height_Entry (entry_ur_y, entry_ur_x);
+	float *lr_entry = Get_Height_Entry (entry_lr_y, entry_lr_x);
+	float *ll_entry = Get_Height_Entry (entry_ll_y, entry_ll_x);
+
+	float local_per_x = ((x_pos - m_LevelMin.X) - (entry_ul_x * m_PatchSize)) / m_PatchSize;
+	float local_per_y = ((y_pos - m_LevelMin.Y) - (entry_ul_y * m_PatchSize)) / m_PatchSize;
+
+	//
+	//	Take the weighted average of the 4 corner values
+	//
+	float h1 = (1 - local_per_x)	* (1 - local_per_y)	* (*ul_entry);
+	float h2 = (local_per_x)		* (1 - local_per_y)	* (*ur_entry);
+	float h3 = (local_per_x)		* (local_per_y)		* (*lr_entry);
+	float h4 = (1 - local_per_x)	* (local_per_y)		* (*ll_entry);
+
+	return h1 + h2 + h3 + h4;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+//	Get_Heights
+//
+//	Same as calling Get_Height for each position, and gives exactly the
+// same results, but four positions at a time.
+//
+/////////////////////////////////////////////////////////////////////////
+void
+HeightDBClass::Get_Heights (const Vector3 *positions, float *heights, int count)
+{
+	int index = 0;
+
+#ifdef HEIGHTDB_SSE2
+	if (m_HeightArray != NULL && m_NumPointsX > 0 && m_NumPointsY > 0) {
+
+		const __m128 level_min_x	= _mm_set1_ps (m_LevelMin.X);
+		const __m128 level_min_y	= _mm_set1_ps (m_LevelMin.Y);
+		const __m128 level_size_x	= _mm_set1_ps (m_LevelMax.X - m_LevelMin.X);
+		const __m128 level_size_y	= _mm_set1_ps (m_LevelMax.Y - m_LevelMin.Y);
+		const __m128 scale_x			= _mm_set1_ps ((float)(m_NumPointsX - 1));
+		const __m128 scale_y			= _mm_set1_ps ((float)(m_NumPointsY - 1));
+		const __m128 patch_size		= _mm_set1_ps (m_PatchSize);
+		const __m128 zero				= _mm_setzero_ps ();
+		const __m128 one				= _mm_set1_ps (1.0F);
+		const __m128i last_x			= _mm_set1_epi32 (m_NumPointsX - 1);
+		const __m128i last_y			= _mm_set1_epi32 (m_NumPointsY - 1);
+
+		for (; index + 4 <= count; index += 4) {
+			const Vector3 *pos = &positions[index];
+			__m128 x = _mm_setr_ps (pos[0].X, pos[1].X, pos[2].X, pos[3].X);
+			__m128 y = _mm_setr_ps (pos[0].Y, pos[1].Y, pos[2].Y, pos[3].Y);
+			__m128 z = _mm_setr_ps (pos[0].Z, pos[1].Z, pos[2].Z, pos[3].Z);
+
+			__m128 offset_x	= _mm_sub_ps (x, level_min_x);
+			__m128 offset_y	= _mm_sub_ps (y, level_min_y);
+			__m128 percent_x	= _mm_div_ps (offset_x, level_size_x);
+			__m128 percent_y	= _mm_div_ps (offset_y, level_size_y);
+
+			//
+			//	Positions outside the data set keep their own height.  Their lanes
+			// look up entry (0,0) so the loads stay inside the array.
+			//
+			__m128 inside = _mm_and_ps (	_mm_and_ps (_mm_cmpge_ps (percent_x, zero), _mm_cmple_ps (percent_x, one)),
+													_mm_and_ps (_mm_cmpge_ps (percent_y, zero), _mm_cmple_ps (percent_y, one)));
+			percent_x = _mm_and_ps (percent_x, inside);
+			percent_y = _mm_and_ps (percent_y, inside);
+
+			__m128i ul_x = _mm_cvttps_epi32 (_mm_mul_ps (scale_x, percent_x));
+			__m128i ul_y = _mm_cvttps_epi32 (_mm_mul_ps (scale_y, percent_y));
+			__m128i lr_x = _mm_sub_epi32 (ul_x, _mm_cmplt_epi32 (ul_x, last_x));
+			__m128i lr_y = _mm_sub_epi32 (ul_y, _mm_cmplt_epi32 (ul_y, last_y));
+
+			alignas(16) int ul_col[4];
+			alignas(16) int ul_row[4];
+			alignas(16) int lr_col[4];
+			alignas(16) int lr_row[4];
+			_mm_store_si128 ((__m128i *)ul_col, ul_x);
+			_mm_store_si128 ((__m128i *)ul_row, ul_y);
+			_mm_store_si128 ((__m128i *)lr_col, lr_x);
+			_mm_store_si128 ((__m128i *)lr_row, lr_y);
+
+			alignas(16) float ul[4];
+			alignas(16) float ur[4];
+			alignas(16) float lr[4];
+			alignas(16) float ll[4];
+			for (int lane = 0; lane < 4; lane ++) {
+				const float *upper = &m_HeightArray[ul_row[lane] * m_NumPointsX];
+				const float *lower = &m_HeightArray[lr_row[lane] * m_NumPointsX];
+				ul[lane] = upper[ul_col[lane]];
+				ur[lane] = upper[lr_col[lane]];
+				lr[lane] = lower[lr_col[lane]];
+				ll[lane] = lower[ul_col[lane]];
 			}
 
-			if (entry_ul_y + 1 >= m_NumPointsY) {
-				entry_lr_y = entry_ul_y;
-				entry_ll_y = entry_ul_y;
+			__m128 local_per_x = _mm_div_ps (_mm_sub_ps (offset_x, _mm_mul_ps (_mm_cvtepi32_ps (ul_x), patch_size)), patch_size);
+			__m128 local_per_y = _mm_div_ps (_mm_sub_ps (offset_y, _mm_mul_ps (_mm_cvtepi32_ps (ul_y), patch_size)), patch_size);
+			__m128 inv_per_x = _mm_sub_ps (one, local_per_x);
+			__m128 inv_per_y = _mm_sub_ps (one, local_per_y);
+
+			//
+			//	Same operations in the same order as Get_Cell_Height
+			//
+			__m128 h1 = _mm_mul_ps (_mm_mul_ps (inv_per_x, inv_per_y), _mm_load_ps (ul));
+			__m128 h2 = _mm_mul_ps (_mm_mul_ps (local_per_x, inv_per_y), _mm_load_ps (ur));
+			__m128 h3 = _mm_mul_ps (_mm_mul_ps (local_per_x, local_per_y), _mm_load_ps (lr));
+			__m128 h4 = _mm_mul_ps (_mm_mul_ps (inv_per_x, local_per_y), _mm_load_ps (ll));
+			__m128 height = _mm_add_ps (_mm_add_ps (_mm_add_ps (h1, h2), h3), h4);
+
+			height = _mm_or_ps (_mm_and_ps (inside, height), _mm_andnot_ps (inside, z));
+			_mm_storeu_ps (&heights[index], height);
+		}
+	}
+#endif
+
+	for (; index < count; index ++) {
+		heights[index] = Get_Height (positions[index]);
+	}
+
+	return ;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+//	Cast_Ray
+//
+//	Walks down the max mip levels front to back, skipping every cell the
+// segment stays above.  Returns the fraction along the segment where it
+// first touches the height field.
+//
+/////////////////////////////////////////////////////////////////////////
+bool
+HeightDBClass::Cast_Ray (const Vector3 &p0, const Vector3 &p1, float *fraction)
+{
+	if (m_MipArray == NULL) {
+		return false;
+	}
+
+	Vector3 delta = p1 - p0;
+	return Cast_Ray_Node (m_MipLevelCount - 1, 0, 0, p0, delta, 0, 1.0F, fraction);
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+//	Cast_Ray_Node
+//
+/////////////////////////////////////////////////////////////////////////
+bool
+HeightDBClass::Cast_Ray_Node
+(
+	int				level,
+	int				row,
+	int				col,
+	const Vector3 &p0,
+	const Vector3 &delta,
+	float				t0,
+	float				t1,
+	float *			fraction
+)
+{
+	if (Clip_Ray (level, row, col, p0, delta, t0, t1) == false) {
+		return false;
+	}
+
+	//
+	//	The segment is a straight line, so its lowest point over the cell is at
+	// one of the ends
+	//
+	const HeightRangeStruct &range = m_MipArray[m_MipOffset[level] + (row * m_MipCellsX[level]) + col];
+	float z0 = p0.Z + delta.Z * t0;
+	float z1 = p0.Z + delta.Z * t1;
+	if (std::min (z0, z1) > range.Max) {
+		return false;
+	}
+
+	if (level == 0) {
+		return Cast_Ray_Cell (row, col, p0, delta, t0, t1, fraction);
+	}
+
+	//
+	//	Visit the children in the order the segment enters them.  The cells
+	// don't overlap, so the first hit found is the closest.
+	//
+	struct ChildStruct
+	{
+		int		Row;
+		int		Col;
+		float		T0;
+		float		T1;
+	};
+
+	ChildStruct children[4];
+	int child_count = 0;
+	int child_level = level - 1;
+	for (int child_row = row * 2; child_row < std::min (row * 2 + 2, m_MipCellsY[child_level]); child_row ++) {
+		for (int child_col = col * 2; child_col < std::min (col * 2 + 2, m_MipCellsX[child_level]); child_col ++) {
+			ChildStruct child = { child_row, child_col, t0, t1 };
+			if (Clip_Ray (child_level, child_row, child_col, p0, delta, child.T0, child.T1)) {
+				int slot = child_count ++;
+				while (slot > 0 && children[slot - 1].T0 > child.T0) {
+					children[slot] = children[slot - 1];
+					slot --;
+				}
+				children[slot] = child;
 			}
+		}
+	}
+
+	for (int index = 0; index < child_count; index ++) {
+		const ChildStruct &child = children[index];
+		if (Cast_Ray_Node (child_level, child.Row, child.Col, p0, delta, child.T0, child.T1, fraction)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+//	Cast_Ray_Cell
+//
+//	Over one grid cell the height is bilinear, so the height under the
+// segment is a quadratic in t.  Three samples give its coefficients exactly
+// and the first root is where the segment meets the height field.
+//
+/////////////////////////////////////////////////////////////////////////
+bool
+HeightDBClass::Cast_Ray_Cell
+(
+	int				row,
+	int				col,
+	const Vector3 &p0,
+	const Vector3 &delta,
+	float				t0,
+	float				t1,
+	float *			fraction
+)
+{
+	float tm = (t0 + t1) * 0.5F;
+	float f0 = (p0.Z + delta.Z * t0) - Get_Cell_Height (row, col, p0.X + delta.X * t0, p0.Y + delta.Y * t0);
+	float fm = (p0.Z + delta.Z * tm) - Get_Cell_Height (row, col, p0.X + delta.X * tm, p0.Y + delta.Y * tm);
+	float f1 = (p0.Z + delta.Z * t1) - Get_Cell_Height (row, col, p0.X + delta.X * t1, p0.Y + delta.Y * t1);
+
+	if (f0 <= 0) {
+		(*fraction) = t0;
+		return true;
+	}
 
-			float *ul_entry = Get_Height_Entry (entry_ul_y, entry_ul_x);
-			float *ur_entry = Get_Height_Entry (entry_ur_y, entry_ur_x);
-			float *lr_entry = Get_Height_Entry (entry_lr_y, entry_lr_x);
-			float *ll_entry = Get_Height_Entry (entry_ll_y, entry_ll_x);
+	//
+	//	f(s) = a*s^2 + b*s + f0 for s from 0 to 1 across the cell
+	//
+	float a = 2.0F * (f0 - (2.0F * fm) + f1);
+	float b = f1 - f0 - a;
+	float s = -1.0F;
 
-			float local_per_x = ((pos.X - m_LevelMin.X) - (entry_ul_x * m_PatchSize)) / m_PatchSize;
-			float local_per_y = ((pos.Y - m_LevelMin.Y) - (entry_ul_y * m_PatchSize)) / m_PatchSize;
+	if (fabs (a) < 1.0E-6F) {
+		if (b < 0) {
+			s = -f0 / b;
+		}
+	} else {
+		float discriminant = (b * b) - (4.0F * a * f0);
+		if (discriminant >= 0) {
 
 			//
-			//	Take the weighted average of the 4 corner values
+			//	Written this way so a nearly straight f doesn't lose its root to
+			// cancellation
 			//
-			float h1 = (1 - local_per_x)	* (1 - local_per_y)	* (*ul_entry);
-			float h2 = (local_per_x)		* (1 - local_per_y)	* (*ur_entry);
-			float h3 = (local_per_x)		* (local_per_y)		* (*lr_entry);
-			float h4 = (1 - local_per_x)	* (local_per_y)		* (*ll_entry);
+			float q = -0.5F * (b + ((b < 0) ? -sqrt (discriminant) : sqrt (discriminant)));
+			float s0 = q / a;
+			float s1 = (q != 0) ? (f0 / q) : s0;
+			if (s0 > s1) {
+				std::swap (s0, s1);
+			}
+			s = (s0 >= 0) ? s0 : s1;
+		}
+	}
+
+	if (s < 0 || s > 1.0F) {
+
+		//
+		//	Rounding can push a root that's right at the far edge out of range
+		//
+		if (f1 > 0) {
+			return false;
+		}
+		s = 1.0F;
+	}
+
+	(*fraction) = t0 + (t1 - t0) * s;
+	return true;
+}
+
 
-			height = h1 + h2 + h3 + h4;
+/////////////////////////////////////////////////////////////////////////
+//
+//	Clip_Ray
+//
+//	Trims [t0, t1] to the part of the segment over the cell.
+//
+/////////////////////////////////////////////////////////////////////////
+bool
+HeightDBClass::Clip_Ray
+(
+	int				level,
+	int				row,
+	int				col,
+	const Vector3 &p0,
+	const Vector3 &delta,
+	float &			t0,
+	float &			t1
+)
+{
+	Vector3 min;
+	Vector3 max;
+	Get_Cell_Extents (level, row, col, min, max);
+
+	for (int axis = 0; axis < 2; axis ++) {
+		if (delta[axis] == 0) {
+			if (p0[axis] < min[axis] || p0[axis] > max[axis]) {
+				return false;
+			}
+		} else {
+			float enter	= (min[axis] - p0[axis]) / delta[axis];
+			float exit	= (max[axis] - p0[axis]) / delta[axis];
+			if (enter > exit) {
+				std::swap (enter, exit);
+			}
+			t0 = std::max (t0, enter);
+			t1 = std::min (t1, exit);
 		}
 	}
 
-	return height;
+	return (t0 <= t1);
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+//	Get_Cell_Extents
+//
+//	XY extents of a cell in one of the mip levels.  Get_Height picks its grid
+// cell from the position as a fraction of the level size, so the cells are
+// spaced by that rather than by the patch size.
+//
+/////////////////////////////////////////////////////////////////////////
+void
+HeightDBClass::Get_Cell_Extents (int level, int row, int col, Vector3 &min, Vector3 &max)
+{
+	float cell_size_x = (m_LevelMax.X - m_LevelMin.X) / (m_NumPointsX - 1);
+	float cell_size_y = (m_LevelMax.Y - m_LevelMin.Y) / (m_NumPointsY - 1);
+
+	int first_col	= col << level;
+	int first_row	= row << level;
+	int last_col	= std::min ((col + 1) << level, m_NumPointsX - 1);
+	int last_row	= std::min ((row + 1) << level, m_NumPointsY - 1);
+
+	min.Set (m_LevelMin.X + first_col * cell_size_x, m_LevelMin.Y + first_row * cell_size_y, 0);
+	max.Set (m_LevelMin.X + last_col * cell_size_x, m_LevelMin.Y + last_row * cell_size_y, 0);
+	return ;
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+//	Build_Mip_Levels
+//
+/////////////////////////////////////////////////////////////////////////
+void
+HeightDBClass::Build_Mip_Levels (void)
+{
+	if (m_MipArray != NULL) {
+		delete [] m_MipArray;
+		m_MipArray = NULL;
+	}
+	m_MipLevelCount = 0;
+
+	if (m_HeightArray == NULL || m_NumPointsX < 2 || m_NumPointsY < 2) {
+		return ;
+	}
+
+	//
+	//	Work out the size of each level, halving until there's a single cell
+	//
+	int cells_x = m_NumPointsX - 1;
+	int cells_y = m_NumPointsY - 1;
+	int total = 0;
+	for (;;) {
+		WWASSERT (m_MipLevelCount < MAX_MIP_LEVELS);
+		m_MipOffset[m_MipLevelCount]	= total;
+		m_MipCellsX[m_MipLevelCount]	= cells_x;
+		m_MipCellsY[m_MipLevelCount]	= cells_y;
+		m_MipLevelCount ++;
+		total += cells_x * cells_y;
+
+		if (cells_x == 1 && cells_y == 1) {
+			break;
+		}
+		cells_x = (cells_x + 1) / 2;
+		cells_y = (cells_y + 1) / 2;
+	}
+
+	m_MipArray = new HeightRangeStruct[total];
+
+	//
+	//	The height over a cell is bilinear in x and y, so it's highest and lowest
+	// at the corners of the cell.  A little padding covers rounding.
+	//
+	for (int row = 0; row < m_MipCellsY[0]; row ++) {
+		for (int col = 0; col < m_MipCellsX[0]; col ++) {
+			Vector3 min;
+			Vector3 max;
+			Get_Cell_Extents (0, row, col, min, max);
+
+			float h1 = Get_Cell_Height (row, col, min.X, min.Y);
+			float h2 = Get_Cell_Height (row, col, max.X, min.Y);
+			float h3 = Get_Cell_Height (row, col, max.X, max.Y);
+			float h4 = Get_Cell_Height (row, col, min.X, max.Y);
+
+			HeightRangeStruct &range = m_MipArray[(row * m_MipCellsX[0]) + col];
+			range.Min = std::min (std::min (h1, h2), std::min (h3, h4)) - MIP_PADDING;
+			range.Max = std::max (std::max (h1, h2), std::max (h3, h4)) + MIP_PADDING;
+		}
+	}
+
+	//
+	//	Each level above covers 2x2 cells of the one below
+	//
+	for (int level = 1; level < m_MipLevelCount; level ++) {
+		const HeightRangeStruct *child_array = &m_MipArray[m_MipOffset[level - 1]];
+		HeightRangeStruct *level_array = &m_MipArray[m_MipOffset[level]];
+		int child_cells_x = m_MipCellsX[level - 1];
+		int child_cells_y = m_MipCellsY[level - 1];
+
+		for (int row = 0; row < m_MipCellsY[level]; row ++) {
+			for (int col = 0; col < m_MipCellsX[level]; col ++) {
+				HeightRangeStruct range = child_array[(row * 2 * child_cells_x) + (col * 2)];
+				for (int child_row = row * 2; child_row < std::min (row * 2 + 2, child_cells_y); child_row ++) {
+					for (int child_col = col * 2; child_col < std::min (col * 2 + 2, child_cells_x); child_col ++) {
+						const HeightRangeStruct &child = child_array[(child_row * child_cells_x) + child_col];
+						range.Min = std::min (range.Min, child.Min);
+						range.Max = std::max (range.Max, child.Max);
+					}
+				}
+				level_array[(row * m_MipCellsX[level]) + col] = range;
+			}
+		}
+	}
+
+	return ;
 }
 
 
@@ -327,6 +794,8 @@ HeightDBClass::Generate (void)
 	m_HeightArray	= temp_height_array;
 	m_NumPointsX	= temp_points_x;
 	m_NumPointsY	= temp_points_y;
+
+	Build_Mip_Levels ();
 	return ;
 }
 
@@ -344,8 +813,14 @@ HeightDBClass::Free_Data (void)
 		m_HeightArray = NULL;
 	}
 
+	if (m_MipArray != NULL) {
+		delete [] m_MipArray;
+		m_MipArray = NULL;
+	}
+
 	m_NumPointsX = 0;
 	m_NumPointsY = 0;
+	m_MipLevelCount = 0;
 	return ;
 }
 
@@ -573,6 +1048,7 @@ HeightDBClass::Load (ChunkLoadClass &cload)
 		cload.Close_Chunk ();
 	}
 
+	Build_Mip_Levels ();
 	return retval;
 }
 
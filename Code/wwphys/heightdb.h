@@ -83,6 +83,15 @@ public:
 	//	Data access
 	//
 	static float		Get_Height (const Vector3 &pos);
+	static void			Get_Heights (const Vector3 *positions, float *heights, int count);
+
+	//
+	//	Finds where the segment first drops to or below the height field.  It never
+	// misses a crossing, but the height field is a smoothed envelope of the level
+	// (see Generate), not the level geometry itself.
+	//
+	static bool			Cast_Ray (const Vector3 &p0, const Vector3 &p1, float *fraction);
+	static int			Get_Mip_Level_Count (void)	{ return m_MipLevelCount; }
 
 	//
 	//	Generation
@@ -103,6 +112,29 @@ protected:
 	static bool			Load_Variables (ChunkLoadClass &cload);
 	static void			Free_Data (void);
 	static float *		Get_Height_Entry (int row, int col);
+	static float		Get_Cell_Height (int row, int col, float x_pos, float y_pos);
+
+	//
+	//	Min/max mip levels.  Level 0 has the range of heights over each grid cell,
+	// each level above has the range over 2x2 cells of the one below, up to a
+	// single cell covering the whole level.
+	//
+	struct HeightRangeStruct
+	{
+		float		Min;
+		float		Max;
+	};
+
+	enum
+	{
+		MAX_MIP_LEVELS		= 24
+	};
+
+	static void			Build_Mip_Levels (void);
+	static void			Get_Cell_Extents (int level, int row, int col, Vector3 &min, Vector3 &max);
+	static bool			Clip_Ray (int level, int row, int col, const Vector3 &p0, const Vector3 &delta, float &t0, float &t1);
+	static bool			Cast_Ray_Node (int level, int row, int col, const Vector3 &p0, const Vector3 &delta, float t0, float t1, float *fraction);
+	static bool			Cast_Ray_Cell (int row, int col, const Vector3 &p0, const Vector3 &delta, float t0, float t1, float *fraction);
 
 	static void			Process_Render_Obj (RenderObjClass *render_obj);
 	static void			Submit_Mesh (MeshClass &mesh);
@@ -118,6 +150,12 @@ protected:
 	static float		m_PatchSize;
 	static Vector3		m_LevelMin;
 	static Vector3		m_LevelMax;
+
+	static HeightRangeStruct *	m_MipArray;
+	static int			m_MipLevelCount;
+	static int			m_MipOffset[MAX_MIP_LEVELS];
+	static int			m_MipCellsX[MAX_MIP_LEVELS];
+	static int			m_MipCellsY[MAX_MIP_LEVELS];
 };
 
 
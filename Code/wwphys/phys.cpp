@@ -118,7 +118,10 @@ PhysClass::PhysClass(void) :
 	VisObjectID(0),
 	LastVisibleFrame(0),	// JANI TEMP TEST
 	SunStatusLastUpdated(0),
-	StaticLightingCache(NULL)
+	StaticLightingCache(NULL),
+	SimulationPeriod(1),
+	SimulationPhase(0),
+	DeferredTime(0.0f)
 #if (UMBRASUPPORT)
 	,UmbraObject(NULL)
 #endif
@@ -672,6 +675,7 @@ bool PhysClass::Is_Debug_Display_Enabled(void) const
 
 bool PhysClass::Expire(void)
 {
+	PhysIslandLockClass lock;
 	ExpirationReactionType result = EXPIRATION_APPROVED;
 	if (Observer != NULL) {
 		result = Observer->Object_Expired(this);
@@ -57,6 +57,7 @@
 #include "wwstring.h"
 #include "materialeffect.h"
 #include "materialeffectlist.h"
+#include "physislands.h"
 #include "wwstring.h"
 
 #include "umbrasupport.h"
@@ -621,6 +622,15 @@ public:
 	unsigned Get_Last_Visible_Frame() const { return LastVisibleFrame; }
 	void Set_Last_Visible_Frame(unsigned frame) { LastVisibleFrame=frame; }
 
+	/*
+	** Simulation LOD.  The game can have an object timestep only once every few frames.  The
+	** time it sits out is saved up and stepped through the next time it runs.  Objects with
+	** the same period are spread over the frames by their phase.
+	*/
+	void								Set_Simulation_Period(int period,int phase)			{ SimulationPeriod = MAX(period,1); SimulationPhase = phase; }
+	int								Get_Simulation_Period(void) const						{ return SimulationPeriod; }
+	bool								Is_Simulation_Deferred(void) const						{ return Get_Flag(SIMULATION_DEFERRED); }
+
 protected:
 
 	bool									Get_Flag(unsigned int flag) const 					{ return ((Flags & flag) == flag); }
@@ -648,6 +658,7 @@ protected:
 		STATIC_LIGHTING_DIRTY =		0x00100000,		// This object's static lighting cache is dirty
 		FRICTION_DISABLED =			0x00200000,		// Friction is disabled for this object (vehicles disable body-friction when their wheels are in contact)
 		SIMULATION_DISABLED =		0x00400000,		// Turn on/off simulation for this object
+		SIMULATION_DEFERRED =		0x00800000,		// Simulation LOD has this object sitting out the current frame
 
 		IGNORE_SHIFT =					28,				// shift count for the 'ignore-me' counter
 		IGNORE_MASK =					0xF0000000,		// mask for the 'ignore-me' counter
@@ -712,6 +723,14 @@ protected:
 	*/
 	unsigned LastVisibleFrame;
 
+	/*
+	** Simulation LOD: timestep once every SimulationPeriod frames, DeferredTime is the time
+	** saved up since the last one.
+	*/
+	int								SimulationPeriod;
+	int								SimulationPhase;
+	float								DeferredTime;
+
 	/*
 	** UMBRA Testing
 	*/
@@ -724,6 +743,8 @@ private:
 	// Not Implemented:
 	PhysClass(const PhysClass & src);
 	PhysClass & operator = (const PhysClass & src);
+
+	friend class PhysicsSceneClass;
 };
 
 
@@ -749,6 +770,7 @@ inline void PhysClass::Dec_Ignore_Counter(void)
 inline CollisionReactionType PhysClass::Collision_Occurred(CollisionEventClass & event)
 {
 	if (Observer) {
+		PhysIslandLockClass lock;
 		return Observer->Collision_Occurred(event);
 	} else {
 		return COLLISION_REACTION_DEFAULT;
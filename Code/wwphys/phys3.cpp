@@ -1803,6 +1803,7 @@ bool Phys3Class::Apply_Move
 								(mesh->Get_W3D_Flags() & W3D_MESH_FLAG_SHATTERABLE) &&
 								(mesh->Is_Not_Hidden_At_All()))
 						{
+							PhysIslandLockClass lock;
 
 							PhysicsSceneClass::Get_Instance()->Shatter_Mesh(	mesh,
 																								State.Position,
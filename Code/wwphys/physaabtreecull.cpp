@@ -215,6 +215,7 @@ bool PhysAABTreeCullClass::Cast_OBBox_Recursive
 
 bool PhysAABTreeCullClass::Intersection_Test(PhysAABoxIntersectionTestClass & boxtest)
 {
+	PhysIslandLockClass lock;
 	Reset_Collection();
 	Collect_Objects(boxtest.Box);
 
@@ -236,6 +237,7 @@ bool PhysAABTreeCullClass::Intersection_Test(PhysAABoxIntersectionTestClass & bo
 
 bool PhysAABTreeCullClass::Intersection_Test(PhysOBBoxIntersectionTestClass & boxtest)
 {
+	PhysIslandLockClass lock;
 	Reset_Collection();
 	Collect_Objects(boxtest.BoundingBox);
 
@@ -257,6 +259,7 @@ bool PhysAABTreeCullClass::Intersection_Test(PhysOBBoxIntersectionTestClass & bo
 
 bool PhysAABTreeCullClass::Intersection_Test(PhysMeshIntersectionTestClass & meshtest)
 {
+	PhysIslandLockClass lock;
 	Reset_Collection();
 	Collect_Objects(meshtest.BoundingBox);
 
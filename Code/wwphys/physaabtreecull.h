@@ -69,7 +69,10 @@ public:
 	bool					Verify(StringClass & set_error_report);
 
 	/*
-	** Collision detection
+	** Collision detection.  The casts only read the tree, so they don't take the island
+	** lock: nothing in the tree moves while islands are timestepped in parallel (see
+	** PhysIslandSchedulerClass) and the collision math keeps its scratch data per thread.
+	** The intersection tests use the collection list, which is shared, and do lock.
 	*/
 	bool					Cast_Ray(PhysRayCollisionTestClass & raytest);
 	bool					Cast_AABox(PhysAABoxCollisionTestClass & boxtest);
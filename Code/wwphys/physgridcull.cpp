@@ -103,6 +103,16 @@ void PhysGridCullClass::Re_Partition(const Vector3 & min,const Vector3 & max,flo
 	WWASSERT(Scene != NULL);
 }
 
+/*
+** The grid and its collection list are shared by every island of the island timestep,
+** so moving objects in the grid and all of the collection based queries below lock.
+*/
+void PhysGridCullClass::Update_Culling(CullableClass * obj)
+{
+	PhysIslandLockClass lock;
+	TypedGridCullSystemClass<PhysClass>::Update_Culling(obj);
+}
+
 void PhysGridCullClass::Collect_Visible_Objects(const FrustumClass & frustum,VisTableClass * pvs,RefPhysListClass & visobjlist)
 {
 	Reset_Collection();
@@ -186,6 +196,7 @@ inline void PhysGridCullClass::collect_visible_objects_in_leaf
 
 bool PhysGridCullClass::Cast_Ray(PhysRayCollisionTestClass & raytest)
 {
+	PhysIslandLockClass lock;
 #if NEW_CAST_FUNCTIONS
 
 	Reset_Collection();
@@ -293,6 +304,7 @@ bool PhysGridCullClass::cast_ray_recursive
 
 bool PhysGridCullClass::Cast_AABox(PhysAABoxCollisionTestClass & boxtest)
 {
+	PhysIslandLockClass lock;
 #if NEW_CAST_FUNCTIONS
 
 	Reset_Collection();
@@ -395,6 +407,7 @@ bool PhysGridCullClass::cast_aabox_recursive
 
 bool PhysGridCullClass::Cast_OBBox(PhysOBBoxCollisionTestClass & boxtest)
 {
+	PhysIslandLockClass lock;
 #if NEW_CAST_FUNCTIONS
 
 	Reset_Collection();
@@ -498,6 +511,7 @@ bool PhysGridCullClass::cast_obbox_recursive
 
 bool PhysGridCullClass::Intersection_Test(PhysAABoxIntersectionTestClass & boxtest)
 {
+	PhysIslandLockClass lock;
 	Reset_Collection();
 	Collect_Objects(boxtest.Box);
 
@@ -519,6 +533,7 @@ bool PhysGridCullClass::Intersection_Test(PhysAABoxIntersectionTestClass & boxte
 
 bool PhysGridCullClass::Intersection_Test(PhysOBBoxIntersectionTestClass & boxtest)
 {
+	PhysIslandLockClass lock;
 	Reset_Collection();
 	Collect_Objects(boxtest.BoundingBox);
 
@@ -540,6 +555,7 @@ bool PhysGridCullClass::Intersection_Test(PhysOBBoxIntersectionTestClass & boxte
 
 bool PhysGridCullClass::Intersection_Test(PhysMeshIntersectionTestClass & meshtest)
 {
+	PhysIslandLockClass lock;
 	Reset_Collection();
 	Collect_Objects(meshtest.BoundingBox);
 
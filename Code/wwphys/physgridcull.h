@@ -64,6 +64,7 @@ public:
 	virtual ~PhysGridCullClass(void);
 
 	void	Re_Partition(const Vector3 & min,const Vector3 & max,float objdim) override;
+	void	Update_Culling(CullableClass * obj) override;
 
 	bool	Cast_Ray(PhysRayCollisionTestClass & raytest);
 	bool	Cast_AABox(PhysAABoxCollisionTestClass & boxtest);
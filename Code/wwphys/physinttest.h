@@ -46,6 +46,7 @@
 #include "inttest.h"
 #include "mesh.h"
 #include "physlist.h"
+#include "physislands.h"
 
 
 //
@@ -72,7 +73,7 @@ public:
 	{
 	}
 
-	void							Add_Intersected_Object(PhysClass * obj) { if (IntersectedObjects) IntersectedObjects->Add(obj); }
+	void							Add_Intersected_Object(PhysClass * obj) { if (IntersectedObjects) { PhysIslandLockClass lock; IntersectedObjects->Add(obj); } }
 
 public:
 	int							CollisionGroup;
@@ -106,7 +107,7 @@ public:
 	{
 	}
 
-	void							Add_Intersected_Object(PhysClass * obj) { if (IntersectedObjects) IntersectedObjects->Add(obj); }
+	void							Add_Intersected_Object(PhysClass * obj) { if (IntersectedObjects) { PhysIslandLockClass lock; IntersectedObjects->Add(obj); } }
 
 public:
 	int							CollisionGroup;
@@ -151,7 +152,7 @@ public:
 
 	bool							Cull(const Vector3 & min,const Vector3 & max);
 	bool							Cull(const AABoxClass & box);
-	void							Add_Intersected_Object(PhysClass * obj) { if (IntersectedObjects) IntersectedObjects->Add(obj); }
+	void							Add_Intersected_Object(PhysClass * obj) { if (IntersectedObjects) { PhysIslandLockClass lock; IntersectedObjects->Add(obj); } }
 
 public:
 	MeshClass *					Mesh;
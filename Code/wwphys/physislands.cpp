@@ -0,0 +1,322 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "physislands.h"
+#include "physgridcull.h"
+#include "movephys.h"
+#include "colmath.h"
+#include "jobsystem.h"
+#include "wwdebug.h"
+#include "wwprofile.h"
+
+#include <algorithm>
+#include <string.h>
+
+
+/*
+** Distance added to every swept box.  Covers objects speeding up during the frame and
+** things like contact thickness; islands that really touch have to be joined, islands
+** that merely come close cost nothing but a little parallelism.
+*/
+static const float	ISLAND_MARGIN = 1.0f;
+
+std::atomic<bool>			PhysIslandLockClass::_Parallel(false);
+std::recursive_mutex		PhysIslandLockClass::_Mutex;
+
+
+/*
+** PhysIslandSchedulerClass
+*/
+PhysIslandSchedulerClass::PhysIslandSchedulerClass(void) :
+	Jobs(&JobSystemClass::Get_Shared()),
+	Objects(NULL),
+	Steps(NULL)
+{
+	memset(&Stats,0,sizeof(Stats));
+}
+
+PhysIslandSchedulerClass::~PhysIslandSchedulerClass(void)
+{
+}
+
+void PhysIslandSchedulerClass::Set_Job_System(JobSystemClass * jobs)
+{
+	WWASSERT(jobs != NULL);
+	Jobs = jobs;
+}
+
+int PhysIslandSchedulerClass::Get_Thread_Slot(void) const
+{
+	return Jobs->Get_Thread_Slot();
+}
+
+void PhysIslandSchedulerClass::Timestep
+(
+	PhysGridCullClass * grid,
+	const DynamicVectorClass<PhysClass *> & objects,
+	const DynamicVectorClass<float> & steps
+)
+{
+	Objects = &objects;
+	Steps = &steps;
+
+	{
+		WWPROFILE("Build Islands");
+		Build_Islands(grid);
+	}
+
+	/*
+	** Islands that can't go to the workers run here first.  If only one island is left
+	** there's nothing to gain from handing it to the job system either.
+	*/
+	const int island_count = IslandStart.Count() - 1;
+	ParallelIslands.Reset_Active();
+	for (int island=0; island<island_count; island++) {
+		if (!SerialIslands[island]) {
+			ParallelIslands.Add(island);
+		}
+	}
+
+	if (Jobs->Is_Deterministic() || ParallelIslands.Count() < 2) {
+		for (int island=0; island<island_count; island++) {
+			Run_Island(island);
+		}
+		return;
+	}
+
+	for (int island=0; island<island_count; island++) {
+		if (SerialIslands[island]) {
+			Run_Island(island);
+		}
+	}
+
+	Run_Parallel_Islands();
+}
+
+int PhysIslandSchedulerClass::Get_Node(PhysClass * obj)
+{
+	std::unordered_map<PhysClass *,int>::iterator it = NodeMap.find(obj);
+	if (it != NodeMap.end()) {
+		return it->second;
+	}
+
+	/*
+	** An object that isn't being timestepped; it doesn't move, so its cull box is its
+	** swept box.
+	*/
+	int node = Parents.Count();
+	NodeMap[obj] = node;
+	Parents.Add(node);
+	SweptBoxes.Add(obj->Get_Cull_Box());
+	SerialNodes.Add(false);
+	return node;
+}
+
+int PhysIslandSchedulerClass::Find_Root(int node)
+{
+	while (Parents[node] != node) {
+		Parents[node] = Parents[Parents[node]];
+		node = Parents[node];
+	}
+	return node;
+}
+
+void PhysIslandSchedulerClass::Join(int node0,int node1)
+{
+	int root0 = Find_Root(node0);
+	int root1 = Find_Root(node1);
+	if (root0 != root1) {
+		// Keep the lower node as the root; it doesn't matter for the result but keeps it tidy
+		if (root0 < root1) {
+			Parents[root1] = root0;
+		} else {
+			Parents[root0] = root1;
+		}
+	}
+}
+
+void PhysIslandSchedulerClass::Build_Islands(PhysGridCullClass * grid)
+{
+	const DynamicVectorClass<PhysClass *> & objects = *Objects;
+	const int object_count = objects.Count();
+
+	float total_time = 0.0f;
+	for (int i=0; i<Steps->Count(); i++) {
+		total_time += (*Steps)[i];
+	}
+
+	/*
+	** Swept box for each timestepped object.
+	*/
+	NodeMap.clear();
+	Parents.Reset_Active();
+	SweptBoxes.Reset_Active();
+	SerialNodes.Reset_Active();
+
+	float max_sweep = 0.0f;
+	int first_serial = -1;
+	for (int i=0; i<object_count; i++) {
+		PhysClass * obj = objects[i];
+
+		Vector3 velocity(0,0,0);
+		MoveablePhysClass * moveable = obj->As_MoveablePhysClass();
+		if (moveable != NULL) {
+			moveable->Get_Velocity(&velocity);
+		}
+		float sweep = velocity.Length() * total_time + ISLAND_MARGIN;
+		max_sweep = std::max(max_sweep,sweep);
+
+		AABoxClass box = obj->Get_Cull_Box();
+		box.Extent += Vector3(sweep,sweep,sweep);
+
+		NodeMap[obj] = i;
+		Parents.Add(i);
+		SweptBoxes.Add(box);
+
+		/*
+		** Everything outside the grid goes in one island on the calling thread.
+		*/
+		bool serial = (obj->Get_Culling_System() != grid);
+		SerialNodes.Add(serial);
+		if (serial) {
+			if (first_serial == -1) {
+				first_serial = i;
+			} else {
+				Join(first_serial,i);
+			}
+		}
+	}
+
+	/*
+	** Join objects whose swept boxes overlap.  The grid only knows the current cull
+	** boxes, so grow the query by the largest sweep to be sure every object whose
+	** swept box could overlap this one is collected.
+	*/
+	for (int i=0; i<object_count; i++) {
+		AABoxClass query = SweptBoxes[i];
+		query.Extent += Vector3(max_sweep,max_sweep,max_sweep);
+
+		grid->Reset_Collection();
+		grid->Collect_Objects(query);
+		for (PhysClass * other = grid->Get_First_Collected_Object(); other != NULL; other = grid->Get_Next_Collected_Object(other)) {
+			if (other == objects[i]) {
+				continue;
+			}
+			int node = Get_Node(other);
+			if (CollisionMath::Intersection_Test(SweptBoxes[i],SweptBoxes[node])) {
+				Join(i,node);
+			}
+		}
+	}
+
+	/*
+	** Number the islands in the order of their first object and group the objects by
+	** island, keeping their relative order.
+	*/
+	IslandIds.Reset_Active();
+	int island_count = 0;
+	for (int i=0; i<Parents.Count(); i++) {
+		IslandIds.Add(-1);
+	}
+	for (int i=0; i<object_count; i++) {
+		int root = Find_Root(i);
+		if (IslandIds[root] == -1) {
+			IslandIds[root] = island_count++;
+		}
+	}
+
+	IslandStart.Reset_Active();
+	SerialIslands.Reset_Active();
+	for (int island=0; island<=island_count; island++) {
+		IslandStart.Add(0);
+		SerialIslands.Add(false);
+	}
+	for (int i=0; i<object_count; i++) {
+		int island = IslandIds[Find_Root(i)];
+		IslandStart[island + 1]++;
+		if (SerialNodes[i]) {
+			SerialIslands[island] = true;
+		}
+	}
+	for (int island=0; island<island_count; island++) {
+		IslandStart[island + 1] += IslandStart[island];
+	}
+
+	Members.Reset_Active();
+	IslandCursor.Reset_Active();
+	for (int i=0; i<object_count; i++) {
+		Members.Add(0);
+	}
+	for (int island=0; island<island_count; island++) {
+		IslandCursor.Add(IslandStart[island]);
+	}
+	for (int i=0; i<object_count; i++) {
+		int island = IslandIds[Find_Root(i)];
+		Members[IslandCursor[island]++] = i;
+	}
+
+	/*
+	** Statistics
+	*/
+	Stats.ObjectCount = object_count;
+	Stats.IslandCount = island_count;
+	Stats.SerialIslandCount = 0;
+	Stats.LargestIsland = 0;
+	for (int island=0; island<island_count; island++) {
+		Stats.LargestIsland = std::max(Stats.LargestIsland,IslandStart[island + 1] - IslandStart[island]);
+		if (SerialIslands[island]) {
+			Stats.SerialIslandCount++;
+		}
+	}
+}
+
+void PhysIslandSchedulerClass::Run_Island(int island)
+{
+	const DynamicVectorClass<PhysClass *> & objects = *Objects;
+	const int start = IslandStart[island];
+	const int end = IslandStart[island + 1];
+
+	for (int step=0; step<Steps->Count(); step++) {
+		const float dt = (*Steps)[step];
+		for (int i=start; i<end; i++) {
+			objects[Members[i]]->Timestep(dt);
+		}
+	}
+}
+
+void PhysIslandSchedulerClass::Run_Parallel_Islands(void)
+{
+	WWPROFILE("Parallel Islands");
+
+	/*
+	** Largest islands first so a big one doesn't end up starting last.  Ties keep
+	** island order; the order only affects the load balance.
+	*/
+	std::stable_sort(&ParallelIslands[0],&ParallelIslands[0] + ParallelIslands.Count(),
+		[this](int a,int b) { return (IslandStart[a + 1] - IslandStart[a]) > (IslandStart[b + 1] - IslandStart[b]); });
+
+	PhysIslandLockClass::_Parallel = true;
+	Jobs->Parallel_For(ParallelIslands.Count(),1,
+		[this](int first,int last) {
+			for (int i=first; i<last; i++) {
+				Run_Island(ParallelIslands[i]);
+			}
+		},
+		"Physics Island");
+	PhysIslandLockClass::_Parallel = false;
+}
@@ -0,0 +1,192 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 OpenW3D Contributors.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "always.h"
+#include "aabox.h"
+#include "vector.h"
+#include "wwdebug.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+class PhysClass;
+class PhysGridCullClass;
+class JobSystemClass;
+
+
+/**
+** PhysIslandLockClass
+** Sentry for the parts of the physics scene that interaction islands share: the dynamic
+** culling grid, the cull system collection lists and the observers.  While islands are
+** being timestepped in parallel it serializes everything that holds one; the rest of the
+** time it does nothing.  It is recursive, so an observer can call back into the scene.
+*/
+class PhysIslandLockClass
+{
+public:
+	PhysIslandLockClass(void) : Locked(false)
+	{
+		if (_Parallel.load(std::memory_order_relaxed)) {
+			_Mutex.lock();
+			Locked = true;
+		}
+	}
+
+	~PhysIslandLockClass(void)
+	{
+		if (Locked) {
+			_Mutex.unlock();
+		}
+	}
+
+	static bool		Is_Parallel(void)		{ return _Parallel.load(std::memory_order_relaxed); }
+
+private:
+	PhysIslandLockClass(const PhysIslandLockClass &);
+	PhysIslandLockClass & operator = (const PhysIslandLockClass &);
+
+	bool										Locked;
+
+	static std::atomic<bool>			_Parallel;
+	static std::recursive_mutex		_Mutex;
+
+	friend class PhysIslandSchedulerClass;
+	friend class PhysParallelQueryClass;
+};
+
+
+/**
+** PhysParallelQueryClass
+** Sentry for tools that run collision queries against the scene from several threads at
+** once, such as the pathfind sector builder's jobs.  While one exists the dynamic culling
+** grid serializes its queries through PhysIslandLockClass; the static culling tree is only
+** read, so static queries run in parallel.  Nothing may be timestepped in the meantime.
+*/
+class PhysParallelQueryClass
+{
+public:
+	PhysParallelQueryClass(void)
+	{
+		WWASSERT(PhysIslandLockClass::_Parallel == false);
+		PhysIslandLockClass::_Parallel = true;
+	}
+
+	~PhysParallelQueryClass(void)
+	{
+		PhysIslandLockClass::_Parallel = false;
+	}
+
+private:
+	PhysParallelQueryClass(const PhysParallelQueryClass &);
+	PhysParallelQueryClass & operator = (const PhysParallelQueryClass &);
+};
+
+
+/**
+** PhysIslandSchedulerClass
+** Timesteps the physics objects one interaction island at a time.  Every object gets a
+** box that covers everywhere it can reach during the frame (its cull box grown by how far
+** its velocity carries it plus a margin) and objects whose boxes overlap, directly or
+** through other objects, end up in the same island.  Objects that aren't moving but are
+** touched by a swept box join the island too, so two islands never share an object.
+**
+** Islands are independent for the frame, so they can be timestepped in any order and on
+** any thread of the job system.  Inside an island the objects are stepped in the order they
+** were given, one substep at a time, as the serial timestep does.  Across islands the order
+** is not kept: every island runs all of its substeps before the next one starts and islands
+** on different threads overlap, so observer callbacks come in a different order than in the
+** serial path and the order objects were moved around in the culling grid (and so the order
+** queries find them in) changes from run to run.  Don't count on the result being the same
+** as the serial path down to the last bit.
+**
+** Objects that live outside the dynamic culling grid (animated static objects such as
+** elevators and doors) update the static culling tree when they move, which the worker
+** threads read without a lock.  Those objects and everything in their islands are
+** stepped on the calling thread before the workers are started.
+*/
+class PhysIslandSchedulerClass
+{
+public:
+
+	struct StatsStruct
+	{
+		int				ObjectCount;			// objects timestepped last frame
+		int				IslandCount;			// islands they were split into
+		int				SerialIslandCount;	// islands that had to run on the calling thread
+		int				LargestIsland;			// object count of the largest island
+	};
+
+	PhysIslandSchedulerClass(void);
+	~PhysIslandSchedulerClass(void);
+
+	/*
+	** Job system to run the islands on, JobSystemClass::Get_Shared by default.  A
+	** deterministic one runs every island on the calling thread, in order.
+	*/
+	void						Set_Job_System(JobSystemClass * jobs);
+	JobSystemClass *		Get_Job_System(void) const					{ return Jobs; }
+
+	/*
+	** Timestep the objects by each of the given substeps.  The objects must be in the
+	** order the serial timestep would visit them.
+	*/
+	void						Timestep(	PhysGridCullClass * grid,
+												const DynamicVectorClass<PhysClass *> & objects,
+												const DynamicVectorClass<float> & steps	);
+
+	const StatsStruct &	Get_Stats(void) const						{ return Stats; }
+
+	/*
+	** Index of the calling thread in the job system: 0 for the thread that owns the scene,
+	** 1 and up for the workers.  Used to give every thread its own collision region.
+	*/
+	int						Get_Thread_Slot(void) const;
+
+private:
+
+	void						Build_Islands(PhysGridCullClass * grid);
+	int						Get_Node(PhysClass * obj);
+	int						Find_Root(int node);
+	void						Join(int node0,int node1);
+
+	void						Run_Island(int island);
+	void						Run_Parallel_Islands(void);
+
+	JobSystemClass *		Jobs;
+	StatsStruct				Stats;
+
+	/*
+	** Per-frame island data, kept around so the arrays don't get reallocated every frame.
+	** Nodes are the timestepped objects (in order) followed by any other objects their
+	** swept boxes touched.
+	*/
+	const DynamicVectorClass<PhysClass *> *	Objects;
+	const DynamicVectorClass<float> *			Steps;
+	DynamicVectorClass<AABoxClass>				SweptBoxes;
+	DynamicVectorClass<int>							Parents;
+	DynamicVectorClass<bool>						SerialNodes;
+	DynamicVectorClass<int>							IslandIds;
+	DynamicVectorClass<int>							IslandStart;	// first entry in Members for each island, plus one past the end
+	DynamicVectorClass<int>							Members;			// object indices grouped by island
+	DynamicVectorClass<int>							IslandCursor;
+	DynamicVectorClass<bool>						SerialIslands;
+	DynamicVectorClass<int>							ParallelIslands;
+	std::unordered_map<PhysClass *,int>			NodeMap;
+};
@@ -35,6 +35,9 @@
  *   PhysicsSceneClass::PhysicsSceneClass -- Constructor                                       *
  *   PhysicsSceneClass::~PhysicsSceneClass -- Destructor                                       *
  *   PhysicsSceneClass::Update -- Simulates the entire scene forward one timestep              *
+ *   PhysicsSceneClass::Timestep_Islands -- Timestep the objects one interaction island at a t *
+ *   PhysicsSceneClass::Defer_Simulation_LOD_Objects -- pick out the objects sitting this frame*
+ *   PhysicsSceneClass::Timestep_Caught_Up_Objects -- step objects through the time they sat ou*
  *   PhysicsSceneClass::Add_Dynamic_Object -- Adds a dynamic object to the scene               *
  *   PhysicsSceneClass::Internal_Add_Dynamic_Object -- internal function finishes adding a dyn *
  *   PhysicsSceneClass::Add_Static_Object -- Adds a static object to the scene                 *
@@ -61,6 +64,7 @@
  *   PhysicsSceneClass::Unregister -- Unregisters the given render object                      *
  *   PhysicsSceneClass::Set_Vis_Sample_Point -- Set the current vis sample point               *
  *   PhysicsSceneClass::Pre_Render_Processing -- processing which occurs prior to rendering    *
+ *   PhysicsSceneClass::Update_Particle_Buffers -- bring the particle buffers up to date       *
  *   PhysicsSceneClass::Post_Render_Processing -- processing that occurs after rendering       *
  *   PhysicsSceneClass::Optimize_LODs -- Set the LOD level for each object                     *
  *   PhysicsSceneClass::Render -- Render the scene                                             *
@@ -71,6 +75,7 @@
  *   PhysicsSceneClass::Re_Partition_Static_Lights -- partition the static lights              *
  *   PhysicsSceneClass::Re_Partition_Dynamic_Culling_System -- partition the dynamic culling s *
  *   PhysicsSceneClass::Re_Partition_Static_Projectors -- partition the static projectors      *
+ *   PhysicsSceneClass::Enable_Incremental_Cull_Update -- incremental light/projector updates  *
  *   PhysicsSceneClass::Update_Culling_System_Bounding_Boxes -- updates the cull systems       *
  *   PhysicsSceneClass::Get_Level_Extents -- returns the bounds of the level                   *
  *   PhysicsSceneClass::Set_Polygon_Budgets -- set the budgets for the LOD system              *
@@ -116,6 +121,7 @@
 #include "dx8wrapper.h"
 #include "physresourcemgr.h"
 #include "phys3.h"
+#include "part_buf.h"
 
 #include "umbrasupport.h"
 #include <algorithm>
@@ -214,8 +220,11 @@ PhysicsSceneClass::PhysicsSceneClass(void) :
 	CameraShakeSystem(NULL),
 	HighlightMaterialPass(NULL),
 	UpdateOnlyVisibleObjects(false),
-	CurrentFrameNumber(0)
+	IncrementalCullUpdate(false),
+	CurrentFrameNumber(0),
+	IslandTimestepEnabled(false)
 {
+	memset(&SimulationLODStats,0,sizeof(SimulationLODStats));
 	WWASSERT_PRINT(TheScene == NULL,"Only one instance of the PhysicsSceneClass is allowed.\r\n");
 	WWMEMLOG(MEM_PHYSICSDATA);
 	TheScene = this;
@@ -339,10 +348,18 @@ void PhysicsSceneClass::Update(float dt,int frameid)
 		return;
 	}
 
+	/*
+	** Hold back the objects whose simulation LOD has them sitting this frame out
+	*/
+	Defer_Simulation_LOD_Objects(dt);
+
 	/*
 	** Timestep all of the physics objects
 	*/
-	{
+	if (IslandTimestepEnabled) {
+		WWPROFILE("Timestep");
+		Timestep_Islands(dt);
+	} else {
 		WWPROFILE("Timestep");
 		float remaining = dt;
 
@@ -359,7 +376,7 @@ void PhysicsSceneClass::Update(float dt,int frameid)
 				// Little optimization hack - only update vehicles that are visible (for now update all other physics
 				// objects regardless of the visibility to avoid problems, vehicles are the most expensive anyway).
 				// This same thing is done to Post Timestep couple lines lower.
-				if (phys_obj->Is_Object_Simulating()) {
+				if (phys_obj->Is_Object_Simulating() && !phys_obj->Is_Simulation_Deferred()) {
 					if (!UpdateOnlyVisibleObjects	||
 						phys_obj->Get_Last_Visible_Frame()==CurrentFrameNumber ||
 						!phys_obj->As_VehiclePhysClass()) {
@@ -372,6 +389,11 @@ void PhysicsSceneClass::Update(float dt,int frameid)
 		}
 	}
 
+	{
+		WWPROFILE("Catch Up Timestep");
+		Timestep_Caught_Up_Objects(dt);
+	}
+
 	{
 		WWPROFILE("Post Timestep");
 		RefPhysListIterator it(&TimestepList);
@@ -379,7 +401,7 @@ void PhysicsSceneClass::Update(float dt,int frameid)
 //			if (it.Peek_Obj()->Is_Object_Simulating()) {
 //				if (!UpdateOnlyVisibleObjects || it.Peek_Obj()->Get_Last_Visible_Frame()==CurrentFrameNumber) {
 			PhysClass* phys_obj=it.Peek_Obj();
-			if (phys_obj->Is_Object_Simulating()) {
+			if (phys_obj->Is_Object_Simulating() && !phys_obj->Is_Simulation_Deferred()) {
 				if (!UpdateOnlyVisibleObjects	||
 					phys_obj->Get_Last_Visible_Frame()==CurrentFrameNumber ||
 					!phys_obj->As_VehiclePhysClass()) {
@@ -414,6 +436,128 @@ void PhysicsSceneClass::Update(float dt,int frameid)
 }
 
 
+/***********************************************************************************************
+ * PhysicsSceneClass::Timestep_Islands -- Timestep the objects one interaction island at a tim *
+ *                                                                                             *
+ * Same substeps and same object filter as the serial loop in Update, the filter is just       *
+ * evaluated once per frame rather than once per substep.                                      *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Timestep_Islands(float dt)
+{
+	IslandSteps.Reset_Active();
+	float remaining = dt;
+	while (remaining > 0) {
+		float step = std::min(remaining,MAX_TIMESTEP);
+		IslandSteps.Add(step);
+		remaining -= step;
+	}
+
+	IslandObjects.Reset_Active();
+	RefPhysListIterator it(&TimestepList);
+	for (it.First(); !it.Is_Done(); it.Next()) {
+		PhysClass* phys_obj=it.Peek_Obj();
+		if (phys_obj->Is_Object_Simulating() && !phys_obj->Is_Simulation_Deferred()) {
+			if (!UpdateOnlyVisibleObjects	||
+				phys_obj->Get_Last_Visible_Frame()==CurrentFrameNumber ||
+				!phys_obj->As_VehiclePhysClass()) {
+				IslandObjects.Add(phys_obj);
+			}
+		}
+	}
+
+	IslandScheduler.Timestep(DynamicCullingSystem,IslandObjects,IslandSteps);
+}
+
+
+/***********************************************************************************************
+ * PhysicsSceneClass::Defer_Simulation_LOD_Objects -- pick out the objects sitting this frame  *
+ *                                                                                             *
+ * Objects with a simulation period only timestep on every period'th frame.  On the other      *
+ * frames they are flagged as deferred and save up the time.  On the frame they run, objects   *
+ * with time saved up are stepped separately (see Timestep_Caught_Up_Objects), so they stay    *
+ * flagged until then.                                                                         *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * dt - length of this frame                                                                   *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Defer_Simulation_LOD_Objects(float dt)
+{
+	memset(&SimulationLODStats,0,sizeof(SimulationLODStats));
+	CatchUpObjects.Reset_Active();
+
+	RefPhysListIterator it(&TimestepList);
+	for (it.First(); !it.Is_Done(); it.Next()) {
+		PhysClass* phys_obj=it.Peek_Obj();
+		phys_obj->Set_Flag(PhysClass::SIMULATION_DEFERRED,false);
+		if (!phys_obj->Is_Object_Simulating()) {
+			continue;
+		}
+
+		if (((CurrentFrameNumber + (unsigned)phys_obj->SimulationPhase) % (unsigned)phys_obj->SimulationPeriod) != 0) {
+			phys_obj->DeferredTime += dt;
+			phys_obj->Set_Flag(PhysClass::SIMULATION_DEFERRED,true);
+			SimulationLODStats.Deferred++;
+		} else if (phys_obj->DeferredTime > 0.0f) {
+			phys_obj->Set_Flag(PhysClass::SIMULATION_DEFERRED,true);
+			CatchUpObjects.Add(phys_obj);
+			SimulationLODStats.CaughtUp++;
+		} else {
+			SimulationLODStats.Stepped++;
+		}
+	}
+}
+
+
+/***********************************************************************************************
+ * PhysicsSceneClass::Timestep_Caught_Up_Objects -- step objects through the time they sat out *
+ *                                                                                             *
+ * Each object is stepped through the time it saved up plus this frame in the usual sized      *
+ * substeps, on its own, after everything else has been timestepped.                           *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * dt - length of this frame                                                                   *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Timestep_Caught_Up_Objects(float dt)
+{
+	for (int i=0; i<CatchUpObjects.Count(); i++) {
+		PhysClass* phys_obj=CatchUpObjects[i];
+		float remaining = phys_obj->DeferredTime + dt;
+		phys_obj->DeferredTime = 0.0f;
+		phys_obj->Set_Flag(PhysClass::SIMULATION_DEFERRED,false);
+
+		if (!UpdateOnlyVisibleObjects	||
+			phys_obj->Get_Last_Visible_Frame()==CurrentFrameNumber ||
+			!phys_obj->As_VehiclePhysClass()) {
+			while (remaining > 0) {
+				float step = std::min(remaining,MAX_TIMESTEP);
+				phys_obj->Timestep(step);
+				remaining -= step;
+			}
+		}
+	}
+}
+
+
 /***********************************************************************************************
  * PhysicsSceneClass::Add_Dynamic_Object -- Adds a dynamic object to the scene                 *
  *                                                                                             *
@@ -599,6 +743,7 @@ void PhysicsSceneClass::Internal_Add_Static_Light(LightPhysClass * newlight)
  *=============================================================================================*/
 void PhysicsSceneClass::Delayed_Remove_Object(PhysClass * obj)
 {
+	PhysIslandLockClass lock;
 	if (!ReleaseList.Contains(obj)) {
 		ReleaseList.Add(obj);
 	}
@@ -1099,6 +1244,9 @@ void PhysicsSceneClass::Pre_Render_Processing(CameraClass & camera)
 		rit.Peek_Obj()->On_Frame_Update();
 	}
 
+	// Bring the particle buffers up to date, in parallel if we can
+	Update_Particle_Buffers();
+
 	// Update culling info for all of the objects in the "dirty cull" list (these are
 	// objects which were added to the scene as pure render objects so I don't assume
 	// that the I have control over when their transform or bounding box is changed...)
@@ -1159,6 +1307,39 @@ void PhysicsSceneClass::Pre_Render_Processing(CameraClass & camera)
 	REF_PTR_RELEASE(pvs);
 }
 
+/***********************************************************************************************
+ * PhysicsSceneClass::Update_Particle_Buffers -- bring the particle buffers up to date         *
+ *                                                                                             *
+ * The buffers get updated on their own when they are culled and rendered, so this only        *
+ * does the work early, spread over the job system's threads.  Visual state is only worked out *
+ * for buffers that were drawn last frame since those are likely to be drawn again.            *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Must be called after the On_Frame_Update calls, which is where the emitters emit.           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Update_Particle_Buffers(void)
+{
+	if (ParticleBatch.Get_Job_System()->Is_Deterministic()) {
+		return;
+	}
+
+	RefRenderObjListIterator rit(&UpdateList);
+	for (rit.First(); !rit.Is_Done(); rit.Next()) {
+		RenderObjClass * obj = rit.Peek_Obj();
+		if (obj->Class_ID() == RenderObjClass::CLASSID_PARTICLEBUFFER) {
+			ParticleBufferClass * buffer = (ParticleBufferClass *)obj;
+			ParticleBatch.Add(buffer,buffer->Was_Rendered_Last_Frame());
+		}
+	}
+	ParticleBatch.Update();
+}
+
 /***********************************************************************************************
  * PhysicsSceneClass::Post_Render_Processing -- processing that occurs after rendering         *
  *                                                                                             *
@@ -1186,6 +1367,16 @@ void PhysicsSceneClass::Post_Render_Processing(void)
 }
 
 
+/*
+** The dynamic and static objects are optimized separately, so each set gets its own
+** context in case the LOD optimizer keeps its queues from frame to frame.
+*/
+enum
+{
+	LOD_CONTEXT_DYNAMIC = 0,
+	LOD_CONTEXT_STATIC,
+};
+
 /***********************************************************************************************
  * PhysicsSceneClass::Optimize_LODs -- Set the LOD level for each object                       *
  *                                                                                             *
@@ -1215,7 +1406,7 @@ void PhysicsSceneClass::Optimize_LODs
 		it.Peek_Obj()->Peek_Model()->Prepare_LOD(camera);
 		it.Peek_Obj()->Set_Last_Visible_Frame(CurrentFrameNumber);
 	}
-	PredictiveLODOptimizerClass::Optimize_LODs(DynamicPolyBudget);
+	PredictiveLODOptimizerClass::Optimize_LODs(DynamicPolyBudget,LOD_CONTEXT_DYNAMIC);
 
 	// process the static objects
 	PredictiveLODOptimizerClass::Clear();
@@ -1227,7 +1418,7 @@ void PhysicsSceneClass::Optimize_LODs
 		it.Peek_Obj()->Peek_Model()->Prepare_LOD(camera);
 		it.Peek_Obj()->Set_Last_Visible_Frame(CurrentFrameNumber);
 	}
-	PredictiveLODOptimizerClass::Optimize_LODs(StaticPolyBudget);
+	PredictiveLODOptimizerClass::Optimize_LODs(StaticPolyBudget,LOD_CONTEXT_STATIC);
 }
 
 
@@ -1739,6 +1930,30 @@ void PhysicsSceneClass::Re_Partition_Static_Projectors(void)
 }
 
 
+/***********************************************************************************************
+ * PhysicsSceneClass::Enable_Incremental_Cull_Update -- incremental light/projector updates    *
+ *                                                                                             *
+ * Switches the static light and static projector trees between re-inserting moved objects     *
+ * from the root and updating them in place.  Turning it off refits the trees.                 *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * onoff - true to update incrementally                                                        *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Not applied to the vis trees; their node indices carry vis data.                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Enable_Incremental_Cull_Update(bool onoff)
+{
+	IncrementalCullUpdate = onoff;
+	StaticLightingSystem->Set_Incremental_Update(onoff);
+	StaticProjectorCullingSystem->Set_Incremental_Update(onoff);
+}
+
+
 /***********************************************************************************************
  * PhysicsSceneClass::Update_Culling_System_Bounding_Boxes -- updates the cull systems         *
  *                                                                                             *
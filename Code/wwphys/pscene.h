@@ -55,6 +55,9 @@
 #include "phystexproject.h"
 #include "simplevec.h"
 #include "vissectorstats.h"
+#include "physislands.h"
+#include "jobsystem.h"
+#include "partbatch.h"
 
 class	Matrix3D;
 class ChunkLoadClass;
@@ -943,6 +946,47 @@ public:
 	void							Set_Update_Only_Visible_Objects(bool b) { UpdateOnlyVisibleObjects=b; }
 	bool							Get_Update_Only_Visible_Objects() { return UpdateOnlyVisibleObjects; }
 
+	/*
+	** Incremental cull updates for the static light and static projector trees.  Moved
+	** lights and projectors are re-inserted from the nearest containing node instead of
+	** the root (see AABTreeCullSystemClass::Set_Incremental_Update).  The vis trees are
+	** left alone since their nodes carry vis data.  Off by default.
+	*/
+	void							Enable_Incremental_Cull_Update(bool onoff);
+	bool							Is_Incremental_Cull_Update_Enabled(void) const	{ return IncrementalCullUpdate; }
+
+	/*
+	** Island timestep.  When enabled, the objects to be timestepped are split into
+	** interaction islands by their swept bounds and the islands are timestepped on
+	** the job system (see PhysIslandSchedulerClass).  With a deterministic job system
+	** the islands are run in order on the main thread.
+	*/
+	void							Enable_Island_Timestep(bool onoff)				{ IslandTimestepEnabled = onoff; }
+	bool							Is_Island_Timestep_Enabled(void) const			{ return IslandTimestepEnabled; }
+	const PhysIslandSchedulerClass::StatsStruct &	Get_Island_Statistics(void) const	{ return IslandScheduler.Get_Stats(); }
+
+	/*
+	** Job system the island timestep and the particle updates run on, JobSystemClass::Get_Shared
+	** by default.  When it has more than one thread the particle buffers that need an update
+	** this frame are brought up to date as jobs (see ParticleBatchClass) before the scene is
+	** culled, rather than one at a time as they are culled and rendered.
+	*/
+	void							Set_Job_System(JobSystemClass * jobs)			{ IslandScheduler.Set_Job_System(jobs); ParticleBatch.Set_Job_System(jobs); }
+
+	/*
+	** Simulation LOD.  The game can give objects a simulation period (see
+	** PhysClass::Set_Simulation_Period); these are the counts for the last frame of
+	** objects timestepped as usual, objects catching up on the time they sat out and
+	** objects sitting the frame out.
+	*/
+	struct SimulationLODStatsStruct
+	{
+		int							Stepped;
+		int							CaughtUp;
+		int							Deferred;
+	};
+	const SimulationLODStatsStruct &	Get_Simulation_LOD_Statistics(void) const	{ return SimulationLODStats; }
+
 	/*
 	** Scene Class methods.  These should *only* be used when absolutely necessary since
 	** it is more efficient to operate through the physics interface (I can keep track
@@ -1248,9 +1292,42 @@ protected:
 	RefPhysListClass			DirtyCullList;		// objects that have 'dirty culling' must be re-inserted each frame...
 	RefPhysListClass			TimestepList;		// objects which need to be time-stepped go in here
 	RefPhysListClass			StaticAnimList;	// list of the StaticAnim objects, these can cast shadows, change states, etc
-	NonRefPhysListClass		CollisionRegionList;	// cached list of objects in the current collision region
+
+	/*
+	** Cached list of objects in the current collision region.  Every timestep thread
+	** has its own, see PhysIslandSchedulerClass::Get_Thread_Slot.
+	*/
+	DynamicVectorClass<PhysClass *>	CollisionRegions[JobSystemClass::MAX_THREADS];
+	DynamicVectorClass<PhysClass *> &	Get_Collision_Region(void)	{ return CollisionRegions[IslandScheduler.Get_Thread_Slot()]; }
+
+	/*
+	** Island timestep
+	*/
+	void							Timestep_Islands(float dt);
+
+	bool							IslandTimestepEnabled;
+	PhysIslandSchedulerClass	IslandScheduler;
+	DynamicVectorClass<PhysClass *>	IslandObjects;
+	DynamicVectorClass<float>			IslandSteps;
+
+	/*
+	** Particle updates
+	*/
+	void							Update_Particle_Buffers(void);
+
+	ParticleBatchClass		ParticleBatch;
+
+	/*
+	** Simulation LOD
+	*/
+	void							Defer_Simulation_LOD_Objects(float dt);
+	void							Timestep_Caught_Up_Objects(float dt);
+
+	SimulationLODStatsStruct	SimulationLODStats;
+	DynamicVectorClass<PhysClass *>	CatchUpObjects;
 
 	bool							UpdateOnlyVisibleObjects;
+	bool							IncrementalCullUpdate;
 	unsigned						CurrentFrameNumber;
 
 private:
@@ -46,6 +46,8 @@
 #include "lightcull.h"
 #include "staticphys.h"
 
+#include <algorithm>
+
 
 
 bool PhysicsSceneClass::Do_Groups_Collide(int group0,int group1)
@@ -122,12 +124,41 @@ void PhysicsSceneClass::Disable_All_Collision_Detections(int group)
 
 void PhysicsSceneClass::Set_Collision_Region(const AABoxClass & bounds,int colgroup)
 {
-	Collect_Collideable_Objects(bounds,colgroup,true,true,&CollisionRegionList);
+	DynamicVectorClass<PhysClass *> & region = Get_Collision_Region();
+	region.Reset_Active();
+
+	PhysIslandLockClass lock;
+	StaticCullingSystem->Reset_Collection();
+	StaticCullingSystem->Collect_Objects(bounds);
+	DynamicCullingSystem->Reset_Collection();
+	DynamicCullingSystem->Collect_Objects(bounds);
+
+	for (	StaticPhysClass * obj = (StaticPhysClass *)StaticCullingSystem->Get_First_Collected_Object();
+			obj != NULL;
+			obj = (StaticPhysClass *)StaticCullingSystem->Get_Next_Collected_Object(obj) )
+	{
+		if (Do_Groups_Collide(obj->Get_Collision_Group(),colgroup) && !obj->Is_Ignore_Me()) {
+			region.Add(obj);
+		}
+	}
+	for (	PhysClass * obj = DynamicCullingSystem->Get_First_Collected_Object();
+			obj != NULL;
+			obj = DynamicCullingSystem->Get_Next_Collected_Object(obj) )
+	{
+		if (Do_Groups_Collide(obj->Get_Collision_Group(),colgroup) && !obj->Is_Ignore_Me()) {
+			region.Add(obj);
+		}
+	}
+
+	// The region used to be a list that objects were added to the head of; keep its order.
+	if (region.Count() > 1) {
+		std::reverse(&region[0],&region[0] + region.Count());
+	}
 }
 
 void PhysicsSceneClass::Release_Collision_Region(void)
 {
-	CollisionRegionList.Reset_List();
+	Get_Collision_Region().Reset_Active();
 }
 
 bool PhysicsSceneClass::Cast_Ray(PhysRayCollisionTestClass & raytest,bool use_collision_region)
@@ -153,9 +184,9 @@ bool PhysicsSceneClass::Cast_Ray(PhysRayCollisionTestClass & raytest,bool use_co
 		/*
 		** Use the cached collision region list
 		*/
-		NonRefPhysListIterator it(&CollisionRegionList);
-		for ( ; !it.Is_Done(); it.Next()) {
-			PhysClass * obj = it.Peek_Obj();
+		DynamicVectorClass<PhysClass *> & region = Get_Collision_Region();
+		for (int i=0; i<region.Count(); i++) {
+			PhysClass * obj = region[i];
 			if (	Do_Groups_Collide(obj->Get_Collision_Group(),raytest.CollisionGroup) &&
 					!obj->Is_Ignore_Me()	)
 			{
@@ -206,9 +237,9 @@ bool PhysicsSceneClass::Cast_AABox(PhysAABoxCollisionTestClass & boxtest,bool us
 		/*
 		** Use the cached collision region list
 		*/
-		NonRefPhysListIterator it(&CollisionRegionList);
-		for ( ; !it.Is_Done(); it.Next()) {
-			PhysClass * obj = it.Peek_Obj();
+		DynamicVectorClass<PhysClass *> & region = Get_Collision_Region();
+		for (int i=0; i<region.Count(); i++) {
+			PhysClass * obj = region[i];
 			if (	Do_Groups_Collide(obj->Get_Collision_Group(),boxtest.CollisionGroup) &&
 					!obj->Is_Ignore_Me()	)
 			{
@@ -258,9 +289,9 @@ bool PhysicsSceneClass::Cast_OBBox(PhysOBBoxCollisionTestClass & boxtest,bool us
 		/*
 		** Use the cached collision region list
 		*/
-		NonRefPhysListIterator it(&CollisionRegionList);
-		for ( ; !it.Is_Done(); it.Next()) {
-			PhysClass * obj = it.Peek_Obj();
+		DynamicVectorClass<PhysClass *> & region = Get_Collision_Region();
+		for (int i=0; i<region.Count(); i++) {
+			PhysClass * obj = region[i];
 			if (	Do_Groups_Collide(obj->Get_Collision_Group(),boxtest.CollisionGroup) &&
 					!obj->Is_Ignore_Me()	)
 			{
@@ -294,9 +325,9 @@ bool PhysicsSceneClass::Intersection_Test(PhysAABoxIntersectionTestClass & boxte
 		/*
 		** Test for intersection with objects in the cached collision region
 		*/
-		NonRefPhysListIterator it(&CollisionRegionList);
-		for ( ; !it.Is_Done(); it.Next()) {
-			PhysClass * obj = it.Peek_Obj();
+		DynamicVectorClass<PhysClass *> & region = Get_Collision_Region();
+		for (int i=0; i<region.Count(); i++) {
+			PhysClass * obj = region[i];
 			if (	Do_Groups_Collide(obj->Get_Collision_Group(),boxtest.CollisionGroup) &&
 					!obj->Is_Ignore_Me()	)
 			{
@@ -334,9 +365,9 @@ bool PhysicsSceneClass::Intersection_Test(PhysOBBoxIntersectionTestClass & boxte
 		/*
 		** Test for intersection with objects in the cached collision region
 		*/
-		NonRefPhysListIterator it(&CollisionRegionList);
-		for ( ; !it.Is_Done(); it.Next()) {
-			PhysClass * obj = it.Peek_Obj();
+		DynamicVectorClass<PhysClass *> & region = Get_Collision_Region();
+		for (int i=0; i<region.Count(); i++) {
+			PhysClass * obj = region[i];
 			if (	Do_Groups_Collide(obj->Get_Collision_Group(),boxtest.CollisionGroup) &&
 					!obj->Is_Ignore_Me()	)
 			{
@@ -372,9 +403,9 @@ bool PhysicsSceneClass::Intersection_Test(PhysMeshIntersectionTestClass & meshte
 		/*
 		** Test for intersection with objects in the cached collision region
 		*/
-		NonRefPhysListIterator it(&CollisionRegionList);
-		for ( ; !it.Is_Done(); it.Next()) {
-			PhysClass * obj = it.Peek_Obj();
+		DynamicVectorClass<PhysClass *> & region = Get_Collision_Region();
+		for (int i=0; i<region.Count(); i++) {
+			PhysClass * obj = region[i];
 			if (	Do_Groups_Collide(obj->Get_Collision_Group(),meshtest.CollisionGroup) &&
 					!obj->Is_Ignore_Me()	)
 			{
@@ -494,6 +525,8 @@ void PhysicsSceneClass::Collect_Objects
 )
 {
 	WWASSERT(list != NULL);
+	PhysIslandLockClass lock;
+
 
 	if (static_objs) {
 		StaticCullingSystem->Reset_Collection();
@@ -517,6 +550,8 @@ void PhysicsSceneClass::Collect_Objects
 )
 {
 	WWASSERT(list != NULL);
+	PhysIslandLockClass lock;
+
 
 	if (static_objs) {
 		StaticCullingSystem->Reset_Collection();
@@ -540,6 +575,8 @@ void PhysicsSceneClass::Collect_Objects
 )
 {
 	WWASSERT(list != NULL);
+	PhysIslandLockClass lock;
+
 	if (static_objs) {
 		StaticCullingSystem->Reset_Collection();
 		StaticCullingSystem->Collect_Objects(box);
@@ -562,6 +599,8 @@ void PhysicsSceneClass::Collect_Objects
 )
 {
 	WWASSERT(list != NULL);
+	PhysIslandLockClass lock;
+
 	if (static_objs) {
 		StaticCullingSystem->Reset_Collection();
 		StaticCullingSystem->Collect_Objects(frustum);
@@ -585,6 +624,8 @@ void PhysicsSceneClass::Collect_Collideable_Objects
 )
 {
 	WWASSERT(list != NULL);
+	PhysIslandLockClass lock;
+
 	if (static_objs) {
 		StaticCullingSystem->Reset_Collection();
 		StaticCullingSystem->Collect_Objects(box);
@@ -608,6 +649,8 @@ void PhysicsSceneClass::Collect_Collideable_Objects
 )
 {
 	WWASSERT(list != NULL);
+	PhysIslandLockClass lock;
+
 	if (static_objs) {
 		StaticCullingSystem->Reset_Collection();
 		StaticCullingSystem->Collect_Objects(box);
@@ -104,6 +104,7 @@ void TimedDecorationPhysClass::Timestep(float dt)
 		*/
 		Lifetime -= dt;
 		if (Lifetime < 0.0f) {
+			PhysIslandLockClass lock;
 			ExpirationReactionType result = EXPIRATION_APPROVED;
 			if (Observer != NULL) {
 				result = Observer->Object_Expired(this);